@@ -0,0 +1,209 @@
+// internal
+#include "bench.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// a calibrated batch runs for at least this long, so clock overhead disappears
+const double MIN_BATCH_NS = 10e6;
+const unsigned int MIN_BATCHES = 5;
+const unsigned int MAX_BATCHES = 1000;
+// how much longer than measured the wall clock may run because of paused setup
+const double MAX_WALL_FACTOR = 4.0;
+
+void BenchState::pauseTiming()
+{
+	if (!running)
+		return;
+	elapsed_ns += std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+	running = false;
+}
+
+void BenchState::resumeTiming()
+{
+	if (running)
+		return;
+	started = Clock::now();
+	running = true;
+}
+
+bool parseBenchOptions(int argc, char* argv[], BenchOptions& options)
+{
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--filter" && has_value) {
+			options.filter = argv[++i];
+		}
+		else if (arg == "--out" && has_value) {
+			options.out_path = argv[++i];
+		}
+		else if (arg == "--min-time" && has_value) {
+			options.min_seconds = std::max(0.f, (float)atof(argv[++i]));
+		}
+		else if (arg == "--list") {
+			options.list = true;
+		}
+		else if (arg == "--replay" && has_value) {
+			options.replays.push_back(argv[++i]);
+		}
+		else {
+			fprintf(stderr, "usage: gen_bench [--filter TEXT] [--out FILE] [--min-time SECONDS] [--list] [--replay FILE]...\n");
+			return false;
+		}
+	}
+	return true;
+}
+
+void BenchRunner::add(const std::string& name, unsigned int items, Body body)
+{
+	benchmarks.push_back({ name, std::max(1u, items), std::move(body) });
+}
+
+double BenchRunner::runBatch(const Benchmark& benchmark, unsigned int iterations, double& wall_ns, bool& skipped)
+{
+	BenchState state;
+	state.iterations = iterations;
+	BenchState::Clock::time_point start = BenchState::Clock::now();
+	state.resumeTiming();
+	benchmark.body(state);
+	state.pauseTiming();
+	wall_ns = std::chrono::duration<double, std::nano>(BenchState::Clock::now() - start).count();
+	skipped = state.skipped;
+	return state.elapsed_ns;
+}
+
+BenchRunner::Result BenchRunner::measure(const Benchmark& benchmark, float min_seconds)
+{
+	// grow the batch until it's long enough to time, that also warms the caches.
+	// Paused setup counts against the wall clock limit so it can't take forever.
+	Result result;
+	result.name = benchmark.name;
+	result.items = benchmark.items;
+
+	unsigned int iterations = 1;
+	double wall_ns = 0.0;
+	double batch_ns = runBatch(benchmark, iterations, wall_ns, result.skipped);
+	if (result.skipped)
+		return result;
+	while (batch_ns < MIN_BATCH_NS && wall_ns < MAX_WALL_FACTOR * MIN_BATCH_NS && iterations < (1u << 30)) {
+		double grow = batch_ns > 0.0 ? MIN_BATCH_NS * 1.2 / batch_ns : 10.0;
+		iterations = (unsigned int)std::min((double)(1u << 30), iterations * std::min(10.0, std::max(2.0, grow)));
+		batch_ns = runBatch(benchmark, iterations, wall_ns, result.skipped);
+	}
+
+	std::vector<double> per_iteration;
+	double total_ns = 0.0;
+	double total_wall_ns = 0.0;
+	while (per_iteration.size() < MAX_BATCHES) {
+		if (per_iteration.size() >= MIN_BATCHES && (total_ns >= min_seconds * 1e9 || total_wall_ns >= MAX_WALL_FACTOR * min_seconds * 1e9))
+			break;
+		double ns = runBatch(benchmark, iterations, wall_ns, result.skipped);
+		per_iteration.push_back(ns / iterations);
+		total_ns += ns;
+		total_wall_ns += wall_ns;
+	}
+
+	result.iterations = iterations;
+	result.batches = (unsigned int)per_iteration.size();
+
+	double sum = 0.0;
+	for (double ns : per_iteration)
+		sum += ns;
+	result.mean_ns = sum / per_iteration.size();
+
+	double variance = 0.0;
+	for (double ns : per_iteration)
+		variance += (ns - result.mean_ns) * (ns - result.mean_ns);
+	result.stddev_ns = std::sqrt(variance / per_iteration.size());
+
+	std::sort(per_iteration.begin(), per_iteration.end());
+	result.median_ns = per_iteration[per_iteration.size() / 2];
+	result.min_ns = per_iteration.front();
+	return result;
+}
+
+bool BenchRunner::run(const BenchOptions& options)
+{
+	std::vector<Result> results;
+	for (const Benchmark& benchmark : benchmarks) {
+		if (benchmark.name.find(options.filter) == std::string::npos)
+			continue;
+		if (options.list) {
+			printf("%s\n", benchmark.name.c_str());
+			continue;
+		}
+
+		Result result = measure(benchmark, options.min_seconds);
+		if (result.skipped) {
+			fprintf(stderr, "%-40s skipped\n", result.name.c_str());
+			continue;
+		}
+		// progress on stderr, stdout may be the JSON
+		fprintf(stderr, "%-40s %12.1f ns  (+- %.1f, %u x %u)\n", result.name.c_str(),
+			result.median_ns, result.stddev_ns, result.batches, result.iterations);
+		results.push_back(result);
+	}
+
+	if (options.list)
+		return true;
+	return writeJSON(results, options.out_path);
+}
+
+bool BenchRunner::writeJSON(const std::vector<Result>& results, const std::string& path)
+{
+	std::ostringstream json;
+
+	char date[32];
+	time_t now = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	json << "{\n  \"context\": {\n";
+	json << "    \"date\": \"" << date << "\",\n";
+	json << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+	json << "    \"build_type\": \"release\",\n";
+#else
+	json << "    \"build_type\": \"debug\",\n";
+#endif
+#ifdef GEN_NO_GL_ERROR_CHECKS
+	json << "    \"gl_error_checks\": false\n";
+#else
+	json << "    \"gl_error_checks\": true\n";
+#endif
+	json << "  },\n  \"benchmarks\": [\n";
+
+	char line[512];
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result& r = results[i];
+		double items_per_second = r.median_ns > 0.0 ? r.items * 1e9 / r.median_ns : 0.0;
+		snprintf(line, sizeof(line),
+			"    {\"name\": \"%s\", \"iterations\": %u, \"batches\": %u, \"items_per_iteration\": %u, "
+			"\"median_ns\": %.3f, \"mean_ns\": %.3f, \"min_ns\": %.3f, \"stddev_ns\": %.3f, \"items_per_second\": %.1f}%s\n",
+			r.name.c_str(), r.iterations, r.batches, r.items, r.median_ns, r.mean_ns, r.min_ns, r.stddev_ns,
+			items_per_second, i + 1 < results.size() ? "," : "");
+		json << line;
+	}
+	json << "  ]\n}\n";
+
+	if (path.empty()) {
+		std::cout << json.str();
+		return true;
+	}
+
+	std::ofstream file(path);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+	file << json.str();
+	return true;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+// stlib
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// What a benchmark body gets: run `iterations` operations, pause around setup
+// that shouldn't count.
+//
+//     runner.add("ecs/get", 1000, [](BenchState& state) {
+//         for (unsigned int i = 0; i < state.iterations; i++)
+//             ... 1000 lookups ...
+//     });
+class BenchState
+{
+public:
+	unsigned int iterations = 1;
+
+	void pauseTiming();
+	void resumeTiming();
+	// For when the benchmark can't run here, it's left out of the results
+	void skip() { skipped = true; }
+
+private:
+	friend class BenchRunner;
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point started;
+	double elapsed_ns = 0.0;
+	bool running = false;
+	bool skipped = false;
+};
+
+struct BenchOptions {
+	// only benchmarks whose name contains this
+	std::string filter;
+	// JSON goes to stdout when empty
+	std::string out_path;
+	// measured time per benchmark, after calibration
+	float min_seconds = 0.5f;
+	bool list = false;
+	// recordings from gen --record to run as benchmarks
+	std::vector<std::string> replays;
+};
+
+// Parses --filter, --out, --min-time, --list and --replay, false on --help or a bad argument
+bool parseBenchOptions(int argc, char* argv[], BenchOptions& options);
+
+class BenchRunner
+{
+public:
+	using Body = std::function<void(BenchState&)>;
+
+	// items is how many things one iteration processes, for the items per second figure
+	void add(const std::string& name, unsigned int items, Body body);
+
+	// Runs every matching benchmark and writes the results as JSON
+	bool run(const BenchOptions& options);
+
+private:
+	struct Benchmark {
+		std::string name;
+		unsigned int items;
+		Body body;
+	};
+
+	struct Result {
+		std::string name;
+		unsigned int items = 1;
+		unsigned int iterations = 0;
+		unsigned int batches = 0;
+		// per iteration
+		double median_ns = 0.0;
+		double mean_ns = 0.0;
+		double min_ns = 0.0;
+		double stddev_ns = 0.0;
+		bool skipped = false;
+	};
+
+	// Measured nanoseconds, wall_ns includes the paused parts
+	static double runBatch(const Benchmark& benchmark, unsigned int iterations, double& wall_ns, bool& skipped);
+	static Result measure(const Benchmark& benchmark, float min_seconds);
+	static bool writeJSON(const std::vector<Result>& results, const std::string& path);
+
+	std::vector<Benchmark> benchmarks;
+};
+
+// One per file in bench/
+void registerEcsBenchmarks(BenchRunner& runner);
+void registerPhysicsBenchmarks(BenchRunner& runner);
+void registerAIBenchmarks(BenchRunner& runner);
+void registerRenderBenchmarks(BenchRunner& runner);
+void registerReplayBenchmarks(BenchRunner& runner, const std::vector<std::string>& paths);
@@ -0,0 +1,482 @@
+// internal
+#include "bench.hpp"
+#include "bench_fixture.hpp"
+#include "behavior_tree.hpp"
+#include "game_state.hpp"
+#include "grid_search.hpp"
+#include "maze_gen.hpp"
+#include "mg1_ai.hpp"
+#include "nav_table.hpp"
+#include "organ_navmesh.hpp"
+#include "path_service.hpp"
+#include "sim_context.hpp"
+#include "world_init.hpp"
+
+// stlib
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <unordered_set>
+
+static const unsigned int MAZE_COUNT = 32;
+
+struct Maze {
+	int cells[MAZE_ROWS][MAZE_COLUMNS];
+};
+
+// Carved like WorldSystem::minigame1_maze_gen, but from solid walls rather than the seed
+static std::vector<Maze> makeMazes(unsigned int count)
+{
+	Rng rng(1234);
+	std::vector<Maze> mazes(count);
+	for (Maze& maze : mazes) {
+		GridMap map(MAZE_COLUMNS, MAZE_ROWS, 1);
+		carveMaze(map, rng);
+		for (int y = 0; y < MAZE_ROWS; y++) {
+			for (int x = 0; x < MAZE_COLUMNS; x++)
+				maze.cells[y][x] = map.walls[map.index(x, y)];
+		}
+		// start and goal are always open, like in the game
+		maze.cells[0][0] = 0;
+		maze.cells[MAZE_ROWS - 1][MAZE_COLUMNS - 1] = 0;
+	}
+	return mazes;
+}
+
+struct LegacyHash {
+	size_t operator()(const SearchPosition p) const
+	{
+		return std::hash<int>()(p.x) ^ std::hash<int>()(p.y);
+	}
+};
+
+// generatePath as it was before the pooled A*: every queued node carries a copy
+// of its whole path and the closed set is a hash set. Kept to compare against.
+static Search legacyGeneratePath(int xStart, int yStart, int xTarget, int yTarget, int stepSize, int tolerance)
+{
+	auto heuristic = [&](int x, int y) { return abs(xTarget - x) + abs(yTarget - y); };
+	std::priority_queue<Search> pq;
+	std::unordered_set<SearchPosition, LegacyHash> visited;
+	pq.push(Search(heuristic(xStart, yStart), 0, SearchPosition(xStart, yStart)));
+
+	const Direction moves[4] = { LEFT, RIGHT, UP, DOWN };
+	const int dx[4] = { -1, 1, 0, 0 };
+	const int dy[4] = { 0, 0, -1, 1 };
+	while (!pq.empty()) {
+		Search path = pq.top();
+		if (abs(path.lastNode.x - xTarget) < tolerance && abs(path.lastNode.y - yTarget) < tolerance)
+			return path;
+		pq.pop();
+		if (visited.count(path.lastNode))
+			continue;
+		visited.insert(path.lastNode);
+
+		for (int i = 0; i < 4; i++) {
+			int x = path.lastNode.x + dx[i] * stepSize;
+			int y = path.lastNode.y + dy[i] * stepSize;
+			if (x < 0 || y < 0 || x > window_width_px || y > window_height_px)
+				continue;
+			bool wall = dx[i] != 0 ? collidesWithWallX({ x, y }, 0) : collidesWithWallY({ x, y }, 0);
+			if (wall)
+				continue;
+			Search next = Search(heuristic(x, y) + path.cost, path.cost + stepSize, SearchPosition(x, y));
+			next.dir = path.dir;
+			next.dir.push_back(moves[i]);
+			pq.push(next);
+		}
+	}
+	return Search(-1, -1, SearchPosition(0, 0));
+}
+
+// One corner to the other on every maze, the lattice gets finer as the step shrinks:
+// 16x9 points at 100 px, 160x90 at 10 px
+static void addSearchBenchmarks(BenchRunner& runner, int step, bool legacy)
+{
+	std::string name = std::string(legacy ? "ai/mg1_astar_legacy/step_" : "ai/mg1_astar/step_") + std::to_string(step);
+	runner.add(name, 1, [step, legacy](BenchState& state) {
+		state.pauseTiming();
+		std::vector<Maze> mazes = makeMazes(MAZE_COUNT);
+		SimContext ctx;
+		SimContext::Bind bind(ctx);
+		MiniGame1AI ai(ctx);
+
+		int start = step / 2;
+		int tolerance = step * 4 / 5;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const Maze& maze = mazes[i % MAZE_COUNT];
+			for (int y = 0; y < MAZE_ROWS; y++) {
+				for (int x = 0; x < MAZE_COLUMNS; x++)
+					ctx.maze[y][x] = maze.cells[y][x];
+			}
+
+			state.resumeTiming();
+			if (legacy)
+				legacyGeneratePath(start, start, window_width_px - 50, window_height_px - 50, step, tolerance);
+			else
+				ai.generatePath(start, start, window_width_px - 50, window_height_px - 50, step, tolerance);
+			state.pauseTiming();
+		}
+	});
+}
+
+// A size x size maze, then some walls knocked out so there's more than one way round
+static GridMap makeLargeMaze(int size, Rng& rng)
+{
+	GridMap map(size, size, 1);
+	carveMaze(map, rng);
+	for (int i = 0; i < size * size / 20; i++)
+		map.walls[map.index(rng.below(size), rng.below(size))] = 0;
+	return map;
+}
+
+static const unsigned int GRID_QUERIES = 64;
+
+// Query latency against maze size: random pairs of open cells on one big maze
+static void addGridBenchmarks(BenchRunner& runner, int size)
+{
+	struct Fixture {
+		GridMap map;
+		std::vector<std::pair<SearchPosition, SearchPosition>> queries;
+	};
+	auto fixture = makeFixture<Fixture>([size](Fixture& fixture) {
+		Rng rng(size);
+		fixture.map = makeLargeMaze(size, rng);
+		auto openCell = [&]() {
+			while (true) {
+				SearchPosition cell(rng.below(size), rng.below(size));
+				if (fixture.map.open(cell.x, cell.y))
+					return cell;
+			}
+		};
+		for (unsigned int i = 0; i < GRID_QUERIES; i++)
+			fixture.queries.push_back({ openCell(), openCell() });
+	});
+
+	std::string suffix = std::to_string(size) + "x" + std::to_string(size);
+	runner.add("ai/grid_astar/" + suffix, 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		AStarPool pool;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			state.resumeTiming();
+			gridAStar(data.map, query.first, query.second, pool);
+			state.pauseTiming();
+		}
+	});
+	runner.add("ai/grid_jps/" + suffix, 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		AStarPool pool;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			state.resumeTiming();
+			jumpPointSearch(data.map, query.first, query.second, pool);
+			state.pauseTiming();
+		}
+	});
+	runner.add("ai/grid_hpa/" + suffix, 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		ClusterGraph graph;
+		graph.build(data.map, 16);
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			state.resumeTiming();
+			graph.findPath(query.first, query.second);
+			state.pauseTiming();
+		}
+	});
+	// what carving a maze pays up front for the fast queries
+	runner.add("ai/grid_hpa_build/" + suffix, 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		ClusterGraph graph;
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++)
+			graph.build(data.map, 16);
+	});
+}
+
+// The minigame 1 maze's table: what it costs per maze, and queries against the
+// searches it stands in for. Random pairs of open cells over MAZE_COUNT mazes.
+static void addNavTableBenchmarks(BenchRunner& runner)
+{
+	struct Fixture {
+		std::vector<GridMap> maps;
+		std::vector<NavTable> tables;
+		std::vector<std::pair<int, int>> queries;
+	};
+	auto fixture = makeFixture<Fixture>([](Fixture& fixture) {
+		Rng rng(99);
+		for (const Maze& maze : makeMazes(MAZE_COUNT)) {
+			fixture.maps.push_back(GridMap::fromCells(&maze.cells[0][0], MAZE_COLUMNS, MAZE_ROWS));
+			fixture.tables.emplace_back();
+			fixture.tables.back().build(fixture.maps.back(), 1);
+		}
+		const GridMap& map = fixture.maps[0];
+		while (fixture.queries.size() < GRID_QUERIES) {
+			int a = (int)rng.below((uint32_t)map.cells());
+			int b = (int)rng.below((uint32_t)map.cells());
+			if (!map.walls[a] && !map.walls[b])
+				fixture.queries.push_back({ a, b });
+		}
+	});
+
+	runner.add("ai/nav_table/build", 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		NavTable table;
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++)
+			table.build(data.maps[i % MAZE_COUNT], i);
+	});
+	runner.add("ai/nav_table/path", 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			data.tables[0].path(query.first, query.second);
+		}
+	});
+	for (bool nav : { false, true }) {
+		runner.add(nav ? "ai/nav_table/astar_heuristic" : "ai/nav_table/astar_manhattan", 1, [fixture, nav](BenchState& state) {
+			state.pauseTiming();
+			Fixture& data = fixture->get();
+			AStarPool pool;
+			const GridMap& map = data.maps[0];
+			state.resumeTiming();
+			for (unsigned int i = 0; i < state.iterations; i++) {
+				const auto& query = data.queries[i % GRID_QUERIES];
+				gridAStar(map, SearchPosition(query.first % map.columns, query.first / map.columns),
+					SearchPosition(query.second % map.columns, query.second / map.columns), pool, nav ? &data.tables[0] : nullptr);
+			}
+		});
+	}
+}
+
+// The organ screens' meshes: building one, fetching it again on a later load,
+// and queries between random connected points on organ 3 next to the pixel
+// lattice search over the same boundary
+static void addOrganNavBenchmarks(BenchRunner& runner)
+{
+	const GAME_STATES organs[] = { GAME_STATES::ORGAN_1, GAME_STATES::ORGAN_2, GAME_STATES::ORGAN_3,
+		GAME_STATES::ORGAN_4, GAME_STATES::ORGAN_5, GAME_STATES::BRAIN_UNLOCKED };
+	const unsigned int ORGAN_COUNT = sizeof(organs) / sizeof(organs[0]);
+	struct Fixture {
+		std::vector<GridMap> maps;
+		std::vector<std::pair<vec2, vec2>> queries;
+	};
+	auto fixture = makeFixture<Fixture>([organs, ORGAN_COUNT](Fixture& fixture) {
+		for (unsigned int i = 0; i < ORGAN_COUNT; i++)
+			fixture.maps.push_back(GridMap::fromCells(&organBoundary((unsigned int)organs[i])[0][0], ORGAN_BOUNDARY_COLUMNS, ORGAN_BOUNDARY_ROWS));
+		std::shared_ptr<const NavMesh> mesh = organNavMesh((unsigned int)GAME_STATES::ORGAN_3);
+		Rng rng(7);
+		std::vector<vec2> points;
+		while (fixture.queries.size() < GRID_QUERIES) {
+			vec2 from((rng.below(ORGAN_BOUNDARY_COLUMNS) + 0.5f) * ORGAN_CELL_PX, (rng.below(ORGAN_BOUNDARY_ROWS) + 0.5f) * ORGAN_CELL_PX);
+			vec2 to((rng.below(ORGAN_BOUNDARY_COLUMNS) + 0.5f) * ORGAN_CELL_PX, (rng.below(ORGAN_BOUNDARY_ROWS) + 0.5f) * ORGAN_CELL_PX);
+			if (mesh->findPath(from, to, points))
+				fixture.queries.push_back({ from, to });
+		}
+	});
+
+	runner.add("ai/organ_nav/build", 1, [fixture, ORGAN_COUNT](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		NavMesh mesh;
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++)
+			mesh.build(data.maps[i % ORGAN_COUNT], (float)ORGAN_CELL_PX);
+	});
+	runner.add("ai/organ_nav/cached", 1, [organs, ORGAN_COUNT](BenchState& state) {
+		for (unsigned int i = 0; i < state.iterations; i++)
+			organNavMesh((unsigned int)organs[i % ORGAN_COUNT]);
+	});
+	runner.add("ai/organ_nav/path", 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		std::shared_ptr<const NavMesh> mesh = organNavMesh((unsigned int)GAME_STATES::ORGAN_3);
+		std::vector<vec2> points;
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			mesh->findPath(query.first, query.second, points);
+		}
+	});
+	runner.add("ai/organ_nav/lattice_astar", 1, [fixture](BenchState& state) {
+		state.pauseTiming();
+		Fixture& data = fixture->get();
+		AStarPool pool;
+		const GridMap& map = data.maps[2];
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			const auto& query = data.queries[i % GRID_QUERIES];
+			latticeAStar(map, ORGAN_CELL_PX, (int)query.first.x, (int)query.first.y, (int)query.second.x, (int)query.second.y, ORGAN_CELL_PX, ORGAN_CELL_PX / 2, pool);
+		}
+	});
+}
+
+// Carving a whole size x size maze per iteration, items are cells so the
+// per second figure stays flat as long as generation stays linear
+static void addMazeGenBenchmarks(BenchRunner& runner, int size)
+{
+	const std::pair<const char*, MAZE_ALGORITHM> algorithms[] = {
+		{ "backtracker", MAZE_ALGORITHM::BACKTRACKER },
+		{ "wilson", MAZE_ALGORITHM::WILSON },
+		{ "eller", MAZE_ALGORITHM::ELLER },
+	};
+	std::string suffix = std::to_string(size) + "x" + std::to_string(size);
+	for (const auto& algorithm : algorithms) {
+		MAZE_ALGORITHM which = algorithm.second;
+		runner.add(std::string("ai/maze_gen/") + algorithm.first + "/" + suffix, size * size, [size, which](BenchState& state) {
+			Rng rng(size);
+			for (unsigned int i = 0; i < state.iterations; i++) {
+				state.pauseTiming();
+				GridMap map(size, size, 1);
+				state.resumeTiming();
+				carveMaze(map, rng, which);
+			}
+		});
+	}
+}
+
+static bool btAbove(BehaviorCall& call)
+{
+	return call.board.values[call.key] > call.value;
+}
+
+static BT_STATUS btAdd(BehaviorCall& call)
+{
+	call.board.values[call.key] += call.value;
+	return BT_STATUS::SUCCESS;
+}
+
+// A few levels of composites over blackboard reads and writes, so the cost is the tick itself
+static const char* BENCH_TREE = R"({
+	"blackboard": { "hunger": 0, "fear": 0 },
+	"root": { "type": "parallel", "children": [
+		{ "type": "selector", "children": [
+			{ "type": "sequence", "children": [
+				{ "type": "condition", "name": "above", "key": "fear", "value": 50 },
+				{ "type": "action", "name": "add", "key": "fear", "value": -50 } ] },
+			{ "type": "sequence", "children": [
+				{ "type": "condition", "name": "above", "key": "hunger", "value": 20 },
+				{ "type": "action", "name": "add", "key": "hunger", "value": -20 } ] },
+			{ "type": "action", "name": "add", "key": "hunger", "value": 1 } ] },
+		{ "type": "succeeder", "child":
+			{ "type": "cooldown", "ms": 50, "child": { "type": "action", "name": "add", "key": "fear", "value": 7 } } } ] }
+})";
+
+// Agents sharing one compiled tree, all of them ticked in one tickAll per iteration
+static void addBehaviorTreeBenchmarks(BenchRunner& runner, unsigned int agents)
+{
+	runner.add("ai/behavior_tree/agents_" + std::to_string(agents), agents, [agents](BenchState& state) {
+		state.pauseTiming();
+		BehaviorLibrary library;
+		library.addCondition("above", btAbove);
+		library.addAction("add", btAdd);
+		BehaviorTree tree;
+		tree.compile(nlohmann::json::parse(BENCH_TREE), library);
+		SimContext ctx;
+		SimContext::Bind bind(ctx);
+		for (unsigned int i = 0; i < agents; i++)
+			ctx.registry.blackboards.insert(Entity(), tree.blackboard());
+
+		state.resumeTiming();
+		for (unsigned int i = 0; i < state.iterations; i++)
+			tree.tickAll(ctx, 1000.f / 60.f);
+	});
+}
+
+static void addChaserBenchmarks(BenchRunner& runner, const std::string& name, unsigned int chasers, bool flow_field)
+{
+	runner.add(name + std::to_string(chasers), chasers, [chasers, flow_field](BenchState& state) {
+		state.pauseTiming();
+		Maze maze = makeMazes(1)[0];
+		SimContext ctx;
+		SimContext::Bind bind(ctx);
+		ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_1;
+		for (int y = 0; y < MAZE_ROWS; y++) {
+			for (int x = 0; x < MAZE_COLUMNS; x++)
+				ctx.maze[y][x] = maze.cells[y][x];
+		}
+
+		std::vector<vec2> open_cells;
+		for (int y = 0; y < MAZE_ROWS; y++) {
+			for (int x = 0; x < MAZE_COLUMNS; x++) {
+				if (!maze.cells[y][x])
+					open_cells.push_back({ (x + 0.5f) * MAZE_CELL_PX, (y + 0.5f) * MAZE_CELL_PX });
+			}
+		}
+		Entity player;
+		ctx.registry.foregroundMotions.emplace(player).position = open_cells[0];
+		ctx.registry.players.emplace(player);
+		for (unsigned int i = 0; i < chasers; i++)
+			createRedBloodCell(open_cells[i % open_cells.size()]);
+		MiniGame1AI ai(ctx);
+		ai.flow_field_mode = flow_field;
+
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			if (i % 30 == 0)
+				ctx.registry.foregroundMotions.get(player).position = open_cells[(i / 30 * 7) % open_cells.size()];
+			state.resumeTiming();
+			ai.planPath();
+			ai.step(1000.f / 60.f);
+			state.pauseTiming();
+		}
+	});
+}
+
+void registerAIBenchmarks(BenchRunner& runner)
+{
+	for (unsigned int agents : { 1u, 100u, 10000u })
+		addBehaviorTreeBenchmarks(runner, agents);
+
+	for (int size : { 64, 256, 1024, 4096 })
+		addMazeGenBenchmarks(runner, size);
+
+	for (int size : { 64, 128, 256, 512 })
+		addGridBenchmarks(runner, size);
+	addNavTableBenchmarks(runner);
+	addOrganNavBenchmarks(runner);
+
+	for (int step : { 100, 50, 25, 10 }) {
+		addSearchBenchmarks(runner, step, false);
+		addSearchBenchmarks(runner, step, true);
+	}
+
+	// the red blood cell chasing the player across the whole maze, one request through
+	// the path service and its collection per iteration, job system hand off included
+	runner.add("ai/mg1_path_service", 1, [](BenchState& state) {
+		state.pauseTiming();
+		std::vector<Maze> mazes = makeMazes(MAZE_COUNT);
+		PathService paths;
+
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			PathRequest request;
+			request.map = GridMap::fromCells(&mazes[i % MAZE_COUNT].cells[0][0], MAZE_COLUMNS, MAZE_ROWS);
+			request.cell_px = MAZE_CELL_PX;
+			request.x_start = window_width_px - 50;
+			request.y_start = window_height_px - 50;
+			request.x_target = 50;
+			request.y_target = 50;
+			request.lattices = { { 100, 80 }, { 50, 45 } };
+
+			state.resumeTiming();
+			paths.request(std::move(request));
+			paths.collect();
+			state.pauseTiming();
+		}
+	});
+
+	// chasers following the flow field while the player wanders to a new cell every
+	// few steps, one AI step per iteration. The field is shared so the cost per chaser stays flat.
+	for (unsigned int chasers : { 1u, 10u, 100u, 1000u })
+		addChaserBenchmarks(runner, "ai/mg1_flow_field/chasers_", chasers, true);
+	// the same with every chaser planning its own A* path, at most
+	// AIScheduler::budget path requests a tick whatever the count
+	for (unsigned int chasers : { 1u, 4u, 16u })
+		addChaserBenchmarks(runner, "ai/mg1_astar_chasers/chasers_", chasers, false);
+}
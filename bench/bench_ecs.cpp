@@ -0,0 +1,103 @@
+// internal
+#include "bench.hpp"
+#include "components.hpp"
+#include "tiny_ecs.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+// Entities per container, the real motions are the component so the memory traffic matches
+static const unsigned int ECS_COUNT = 10000;
+
+static std::vector<Entity> makeEntities(unsigned int count)
+{
+	std::vector<Entity> entities(count);
+	// removal order matters for the swap-and-pop, don't benchmark the lucky case
+	std::shuffle(entities.begin(), entities.end(), std::default_random_engine(1234));
+	return entities;
+}
+
+void registerEcsBenchmarks(BenchRunner& runner)
+{
+	runner.add("ecs/insert_10k", ECS_COUNT, [](BenchState& state) {
+		std::vector<Entity> entities = makeEntities(ECS_COUNT);
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			state.pauseTiming();
+			ComponentContainer<foregroundMotion> motions;
+			state.resumeTiming();
+
+			for (Entity entity : entities)
+				motions.emplace(entity);
+
+			// the destructor frees everything, not part of inserting
+			state.pauseTiming();
+			motions.clear();
+			state.resumeTiming();
+		}
+	});
+
+	runner.add("ecs/get_10k", ECS_COUNT, [](BenchState& state) {
+		std::vector<Entity> entities = makeEntities(ECS_COUNT);
+		ComponentContainer<foregroundMotion> motions;
+		for (Entity entity : entities)
+			motions.emplace(entity);
+
+		float sum = 0.f;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			for (Entity entity : entities)
+				sum += motions.get(entity).position.x;
+		}
+		// keeps the loop from being optimized away
+		if (sum < 0.f)
+			printf("%f\n", sum);
+	});
+
+	runner.add("ecs/has_miss_10k", ECS_COUNT, [](BenchState& state) {
+		std::vector<Entity> entities = makeEntities(ECS_COUNT);
+		std::vector<Entity> others = makeEntities(ECS_COUNT);
+		ComponentContainer<foregroundMotion> motions;
+		for (Entity entity : entities)
+			motions.emplace(entity);
+
+		unsigned int found = 0;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			for (Entity entity : others)
+				found += motions.has(entity);
+		}
+		if (found != 0)
+			printf("%u\n", found);
+	});
+
+	runner.add("ecs/remove_10k", ECS_COUNT, [](BenchState& state) {
+		std::vector<Entity> entities = makeEntities(ECS_COUNT);
+		std::vector<Entity> removal_order = entities;
+		std::shuffle(removal_order.begin(), removal_order.end(), std::default_random_engine(4321));
+
+		ComponentContainer<foregroundMotion> motions;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			state.pauseTiming();
+			for (Entity entity : entities)
+				motions.emplace(entity);
+			state.resumeTiming();
+
+			for (Entity entity : removal_order)
+				motions.remove(entity);
+		}
+	});
+
+	runner.add("ecs/iterate_10k", ECS_COUNT, [](BenchState& state) {
+		std::vector<Entity> entities = makeEntities(ECS_COUNT);
+		ComponentContainer<foregroundMotion> motions;
+		for (Entity entity : entities)
+			motions.emplace(entity).velocity = { 1.f, 2.f };
+
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			for (foregroundMotion& motion : motions.components)
+				motion.position += motion.velocity * 0.016f;
+		}
+		if (motions.components[0].position.x < 0.f)
+			printf("%f\n", motions.components[0].position.x);
+	});
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// internal
+#include "headless.hpp"
+#include "render_system.hpp"
+#include "sim_context.hpp"
+
+// stlib
+#include <functional>
+#include <memory>
+
+// Offscreen context with a loaded renderer, shared by every benchmark that
+// draws or runs the world so the assets only load once
+struct RenderFixture {
+	SimContext sim;
+	HeadlessContext context;
+	RenderSystem renderer;
+	bool ready = false;
+
+	// Empties the registry, all but the renderer's screen state
+	void reset();
+};
+
+// Created on first use, not ready without an offscreen GL context
+RenderFixture* renderFixture();
+
+// Data a group of benchmarks shares, set up by whichever of them runs first so
+// registering stays cheap and filtered out groups never pay for it. Call get()
+// with the timing paused.
+//
+//     auto fixture = makeFixture<Queries>([](Queries& queries) { ... });
+//     runner.add("ai/x", 1, [fixture](BenchState& state) {
+//         state.pauseTiming();
+//         Queries& queries = fixture->get();
+//         ...
+template <typename T>
+class LazyFixture
+{
+public:
+	using Setup = std::function<void(T&)>;
+
+	explicit LazyFixture(Setup setup) : setup(std::move(setup)) {}
+
+	T& get()
+	{
+		if (!ready) {
+			setup(data);
+			ready = true;
+		}
+		return data;
+	}
+
+private:
+	Setup setup;
+	T data;
+	bool ready = false;
+};
+
+template <typename T>
+std::shared_ptr<LazyFixture<T>> makeFixture(typename LazyFixture<T>::Setup setup)
+{
+	return std::make_shared<LazyFixture<T>>(std::move(setup));
+}
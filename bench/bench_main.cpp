@@ -0,0 +1,26 @@
+// internal
+#include "bench.hpp"
+
+// stlib
+#include <cstdlib>
+
+// Benchmarks for the engine, results as JSON so runs can be compared across commits
+//   gen_bench --out before.json
+//   gen_bench --filter ecs/ --min-time 2
+//   gen_bench --filter replay/ --replay session.rec --out replay.json
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	if (!parseBenchOptions(argc, argv, options)) {
+		return EXIT_FAILURE;
+	}
+
+	BenchRunner runner;
+	registerEcsBenchmarks(runner);
+	registerPhysicsBenchmarks(runner);
+	registerAIBenchmarks(runner);
+	registerRenderBenchmarks(runner);
+	registerReplayBenchmarks(runner, options.replays);
+
+	return runner.run(options) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
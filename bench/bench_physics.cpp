@@ -0,0 +1,139 @@
+// internal
+#include "bench.hpp"
+#include "common_physics.hpp"
+#include "particle_system.hpp"
+#include "sim_context.hpp"
+#include "world_init.hpp"
+
+// stlib
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Opens the protected collision checks up to the benchmarks
+class BenchPhysics : public CommonPhysics
+{
+public:
+	BenchPhysics(SimContext& ctx) : CommonPhysics(ctx) {}
+	void step(float elapsed_ms) {}
+	using CommonPhysics::checkBoxCollision;
+	using CommonPhysics::checkMeshCollision;
+};
+
+static const unsigned int COLLISION_BODIES = 256;
+
+static std::vector<Entity> makeBodies(ECSRegistry& registry, unsigned int count, vec2 scale)
+{
+	std::default_random_engine rng(1234);
+	std::uniform_real_distribution<float> x(0.f, (float)window_width_px);
+	std::uniform_real_distribution<float> y(0.f, (float)window_height_px);
+
+	std::vector<Entity> bodies;
+	for (unsigned int i = 0; i < count; i++) {
+		Entity entity;
+		foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+		motion.position = { x(rng), y(rng) };
+		motion.scale = scale;
+		bodies.push_back(entity);
+	}
+	return bodies;
+}
+
+// A circle of triangles, about the vertex count of the obstacle meshes
+static Mesh makeCircleMesh(unsigned int segments)
+{
+	Mesh mesh;
+	ColoredVertex center;
+	center.position = { 0.f, 0.f, 0.f };
+	center.color = { 1.f, 1.f, 1.f };
+	mesh.vertices.push_back(center);
+
+	for (unsigned int i = 0; i < segments; i++) {
+		float angle = 2.f * (float)M_PI * i / segments;
+		ColoredVertex vertex = center;
+		vertex.position = { 0.5f * cos(angle), 0.5f * sin(angle), 0.f };
+		mesh.vertices.push_back(vertex);
+
+		mesh.vertex_indices.push_back(0);
+		mesh.vertex_indices.push_back((uint16_t)(1 + i));
+		mesh.vertex_indices.push_back((uint16_t)(1 + (i + 1) % segments));
+	}
+	return mesh;
+}
+
+static void particleBenchmark(BenchRunner& runner, const char* name, unsigned int count)
+{
+	runner.add(name, count, [count](BenchState& state) {
+		state.pauseTiming();
+		SimContext ctx;
+		SimContext::Bind bind(ctx);
+		std::default_random_engine rng(1234);
+		std::uniform_real_distribution<float> x(0.f, (float)window_width_px);
+		for (unsigned int i = 0; i < count; i++) {
+			Entity particle = createParticle({ x(rng), 0.f }, { 1.f, 0.f, 0.f });
+			// every minigame 5 particle is a cluster of instances
+			createInstanceRender(nullptr, TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::PARTICLE, GEOMETRY_BUFFER_ID::SPRITE,
+				INSTANCING_BUFFER_ID::PARTICLE, particle, generateParticles({ 0.f, 0.f }, { 1.f, 0.f, 0.f }));
+		}
+		state.resumeTiming();
+
+		for (unsigned int i = 0; i < state.iterations; i++)
+			stepParticles(1000.f / 60.f);
+
+		state.pauseTiming();
+	});
+}
+
+void registerPhysicsBenchmarks(BenchRunner& runner)
+{
+	// every pair, about a quarter of them overlap
+	runner.add("physics/check_box_collision", COLLISION_BODIES * COLLISION_BODIES, [](BenchState& state) {
+		state.pauseTiming();
+		SimContext ctx;
+		BenchPhysics physics(ctx);
+		std::vector<Entity> bodies = makeBodies(ctx.registry, COLLISION_BODIES, { 400.f, 300.f });
+		state.resumeTiming();
+
+		unsigned int hits = 0;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			for (Entity& a : bodies) {
+				for (Entity& b : bodies)
+					hits += physics.checkBoxCollision(a, b);
+			}
+		}
+
+		state.pauseTiming();
+		if (hits == 0)
+			printf("no collisions\n");
+	});
+
+	// one mesh against every body, with the transform of the mesh vertices each time like the game does
+	runner.add("physics/check_mesh_collision", COLLISION_BODIES, [](BenchState& state) {
+		state.pauseTiming();
+		SimContext ctx;
+		SimContext::Bind bind(ctx);
+		BenchPhysics physics(ctx);
+		std::vector<Entity> bodies = makeBodies(ctx.registry, COLLISION_BODIES, { 100.f, 100.f });
+
+		Mesh mesh = makeCircleMesh(32);
+		Entity obstacle;
+		foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(obstacle);
+		motion.position = { window_width_px / 2.f, window_height_px / 2.f };
+		motion.scale = { 600.f, 600.f };
+		ctx.registry.meshPtrs.emplace(obstacle, &mesh);
+		state.resumeTiming();
+
+		unsigned int hits = 0;
+		for (unsigned int i = 0; i < state.iterations; i++) {
+			for (Entity& body : bodies)
+				hits += physics.checkMeshCollision(obstacle, body);
+		}
+
+		state.pauseTiming();
+		if (hits == 0)
+			printf("no collisions\n");
+	});
+
+	particleBenchmark(runner, "physics/step_particles_1k", 1000);
+	particleBenchmark(runner, "physics/step_particles_10k", 10000);
+}
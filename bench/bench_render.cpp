@@ -0,0 +1,75 @@
+// internal
+#include "bench.hpp"
+#include "bench_fixture.hpp"
+#include "world_init.hpp"
+
+// stlib
+#include <cstdio>
+#include <memory>
+#include <random>
+
+void RenderFixture::reset()
+{
+	sim.registry.clear_all_components();
+	renderer.particle_pool.clear();
+	sim.registry.screenStates.emplace(renderer.screen_state_entity);
+}
+
+RenderFixture* renderFixture()
+{
+	static std::unique_ptr<RenderFixture> instance;
+	static bool tried = false;
+	if (!tried) {
+		tried = true;
+		instance.reset(new RenderFixture());
+		SimContext::Bind bind(instance->sim);
+		instance->ready = instance->context.init(window_width_px, window_height_px) && instance->renderer.init(nullptr);
+		if (!instance->ready)
+			fprintf(stderr, "No offscreen GL context, skipping the benchmarks that need one\n");
+	}
+	return instance.get();
+}
+
+namespace {
+	void spriteBenchmark(BenchRunner& runner, const char* name, unsigned int count)
+	{
+		runner.add(name, count, [count](BenchState& state) {
+			state.pauseTiming();
+			RenderFixture* f = renderFixture();
+			if (!f->ready) {
+				state.skip();
+				return;
+			}
+
+			SimContext::Bind bind(f->sim);
+			f->reset();
+
+			std::default_random_engine rng(1234);
+			std::uniform_real_distribution<float> x(0.f, (float)window_width_px);
+			std::uniform_real_distribution<float> y(0.f, (float)window_height_px);
+			for (unsigned int i = 0; i < count; i++)
+				createGenericTexture({ x(rng), y(rng) }, { 40.f, 40.f }, TEXTURE_ASSET_ID::GEN);
+
+			// the first frame pays for lazy driver work
+			f->renderer.draw();
+			glFinish();
+			state.resumeTiming();
+
+			// CPU submission plus the GPU finishing the frame
+			for (unsigned int i = 0; i < state.iterations; i++) {
+				f->renderer.draw();
+				glFinish();
+			}
+
+			state.pauseTiming();
+			f->reset();
+		});
+	}
+}
+
+void registerRenderBenchmarks(BenchRunner& runner)
+{
+	spriteBenchmark(runner, "render/draw_100_sprites", 100);
+	spriteBenchmark(runner, "render/draw_1000_sprites", 1000);
+	spriteBenchmark(runner, "render/draw_5000_sprites", 5000);
+}
@@ -0,0 +1,58 @@
+// internal
+#include "bench.hpp"
+#include "bench_fixture.hpp"
+#include "input_recording.hpp"
+#include "simulation.hpp"
+
+// stlib
+#include <cstdio>
+#include <memory>
+
+// The world has audio to open, one for every replay
+static WorldSystem* replayWorld(RenderFixture* f)
+{
+	static std::unique_ptr<WorldSystem> world;
+	if (!world) {
+		world.reset(new WorldSystem(f->sim));
+		if (!world->create_headless())
+			fprintf(stderr, "No audio device, the replays run without sound effects\n");
+	}
+	return world.get();
+}
+
+// Whole sessions recorded with gen --record. One iteration plays the recording
+// from the first tick to the last, the world's restart in between isn't timed.
+// The game logs to stdout while it plays, use --out for the JSON.
+void registerReplayBenchmarks(BenchRunner& runner, const std::vector<std::string>& paths)
+{
+	for (const std::string& path : paths) {
+		std::shared_ptr<InputRecording> recording(new InputRecording());
+		if (!recording->load(path))
+			continue;
+
+		std::string name = "replay/" + path.substr(path.find_last_of("/\\") + 1);
+		runner.add(name, recording->ticks, [recording](BenchState& state) {
+			state.pauseTiming();
+			RenderFixture* f = renderFixture();
+			if (!f->ready) {
+				state.skip();
+				return;
+			}
+
+			SimContext::Bind bind(f->sim);
+			WorldSystem& world = *replayWorld(f);
+			PhysicsSystem physics(f->sim);
+			AISystem ai(f->sim);
+			ReplayDriver replay(*recording, f->sim, world, physics, ai);
+
+			for (unsigned int i = 0; i < state.iterations; i++) {
+				f->reset();
+				replay.restart(&f->renderer);
+				state.resumeTiming();
+				while (replay.step()) {}
+				state.pauseTiming();
+			}
+			f->reset();
+		});
+	}
+}
@@ -0,0 +1,17 @@
+#version 330
+
+// From vertex shader
+in vec2 texcoord;
+in vec3 particle_color;
+in float particle_opacity;
+
+// Application data
+uniform sampler2D sampler0;
+
+// Output color
+layout(location = 0) out vec4 color;
+
+void main()
+{
+	color = vec4(particle_color, particle_opacity) * texture(sampler0, texcoord);
+}
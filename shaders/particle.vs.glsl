@@ -0,0 +1,37 @@
+#version 330
+
+// Sprite quad
+layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec2 in_texcoord;
+
+// Per instance particle state
+layout (location = 2) in vec2 in_particle_position;
+layout (location = 3) in vec3 in_particle_color;
+layout (location = 4) in float in_particle_life;
+
+// Passed to fragment shader
+out vec2 texcoord;
+out vec3 particle_color;
+out float particle_opacity;
+
+// Application data
+uniform mat3 projection;
+uniform float particle_size;
+uniform float fade_time;
+
+void main()
+{
+	texcoord = in_texcoord;
+	particle_color = in_particle_color;
+	particle_opacity = clamp(in_particle_life / fade_time, 0.0, 1.0);
+
+	// dead particles are pushed outside of clip space
+	if (in_particle_life <= 0.0) {
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+
+	vec2 world = in_particle_position + in_position.xy * particle_size;
+	vec3 pos = projection * vec3(world, 1.0);
+	gl_Position = vec4(pos.xy, in_position.z, 1.0);
+}
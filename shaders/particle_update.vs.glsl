@@ -0,0 +1,30 @@
+#version 330
+
+// Current particle state, one vertex per particle
+layout (location = 0) in vec2 in_position;
+layout (location = 1) in vec2 in_velocity;
+layout (location = 2) in vec3 in_color;
+layout (location = 3) in float in_life;
+
+// Captured with transform feedback into the other buffer
+out vec2 out_position;
+out vec2 out_velocity;
+out vec3 out_color;
+out float out_life;
+
+// Application data
+uniform float step_seconds;
+uniform vec2 gravity;
+uniform float drag;
+
+void main()
+{
+	// gravity on both axes, drag only on x (same as stepParticles)
+	vec2 velocity = in_velocity + gravity * step_seconds;
+	velocity.x *= 1.0 - drag * step_seconds;
+
+	out_position = in_position + velocity * step_seconds;
+	out_velocity = velocity;
+	out_color = in_color;
+	out_life = in_life - step_seconds;
+}
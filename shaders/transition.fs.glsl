@@ -2,6 +2,12 @@
 
 uniform sampler2D screen_texture;
 uniform float darken_screen_factor;
+uniform vec2 shake_offset;
+
+// Bit mask of active post effects, matches RenderSystem::POST_EFFECT
+uniform int post_effects;
+const int POST_FADE = 1;
+const int POST_SHAKE = 2;
 
 in vec2 texcoord;
 
@@ -16,6 +22,13 @@ vec4 fade_color(vec4 in_color)
 
 void main()
 {
-    vec4 in_color = texture(screen_texture, texcoord);
-    color = fade_color(in_color);
-}
\ No newline at end of file
+	// effects are chained in order: distort the lookup, then grade the colour
+	vec2 uv = texcoord;
+	if ((post_effects & POST_SHAKE) != 0)
+		uv = clamp(uv + shake_offset, 0.0, 1.0);
+
+    vec4 in_color = texture(screen_texture, uv);
+	if ((post_effects & POST_FADE) != 0)
+		in_color = fade_color(in_color);
+    color = in_color;
+}
@@ -0,0 +1,45 @@
+// internal
+#include "ai_scheduler.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <atomic>
+
+void AIScheduler::forEachBatch(size_t count, const std::function<void(size_t, size_t)>& work)
+{
+	PROFILE_ZONE("AIScheduler::forEachBatch");
+	size_t batch = std::max<size_t>(1, batch_size);
+	if (count <= batch || job_system.workerCount() == 0) {
+		if (count > 0)
+			work(0, count);
+		return;
+	}
+
+	std::atomic<size_t> remaining { (count + batch - 1) / batch };
+	for (size_t begin = 0; begin < count; begin += batch) {
+		size_t end = std::min(count, begin + batch);
+		job_system.submit([&work, &remaining, begin, end] {
+			work(begin, end);
+			remaining--;
+		});
+	}
+	job_system.wait([&remaining] { return remaining.load() == 0; });
+}
+
+void AIScheduler::roundRobin(size_t count, const std::function<bool(size_t)>& work)
+{
+	if (count == 0)
+		return;
+	// agents may have left since the last tick
+	size_t start = next % count;
+	unsigned int served = 0;
+	for (size_t i = 0; i < count && served < budget; i++) {
+		size_t agent = (start + i) % count;
+		if (work(agent)) {
+			served++;
+			next = agent + 1;
+		}
+	}
+}
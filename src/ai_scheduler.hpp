@@ -0,0 +1,34 @@
+#pragma once
+
+// stlib
+#include <cstddef>
+#include <functional>
+
+// Ticks many agents of one archetype together. The archetype keeps its
+// agents' state in arrays indexed by slot, the scheduler hands out slots:
+//  - forEachBatch splits them into batches spread over the job system, a
+//    batch may only touch its own slots
+//  - roundRobin gives the expensive work (path searches) to at most budget
+//    agents a tick, taking turns, so the cost per frame stays bounded however
+//    many agents there are. Turns depend on ticks, never on the clock, so
+//    replays stay deterministic.
+//
+//     scheduler.roundRobin(agents, [&](size_t i) { return wantsPath(i) && requestPath(i); });
+//     scheduler.forEachBatch(agents, [&](size_t begin, size_t end) { ... move [begin, end) ... });
+class AIScheduler
+{
+public:
+	// Calls work(begin, end) for every batch of [0, count), returns once all of them ran
+	void forEachBatch(size_t count, const std::function<void(size_t, size_t)>& work);
+	// Offers work to the agents in turn, starting after the last one it went to,
+	// until budget of them took it (returned true) or all were asked once
+	void roundRobin(size_t count, const std::function<bool(size_t)>& work);
+
+	// agents per job, fewer than this all run on the calling thread
+	size_t batch_size = 64;
+	// agents roundRobin serves per tick
+	unsigned int budget = 4;
+
+private:
+	size_t next = 0;
+};
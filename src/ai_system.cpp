@@ -1,14 +1,24 @@
 // internal
 #include "ai_system.hpp"
+#include "profiler.hpp"
 
 void AISystem::step(float elapsed_ms) {
-	if (game_state == (unsigned int)GAME_STATES::TITLE) return;
+	PROFILE_ZONE("AISystem::step");
+	if (ctx.game_state == (unsigned int)GAME_STATES::TITLE) return;
 	CommonAI* ai = getAI();
 	ai->step(elapsed_ms);
 }
 
+void AISystem::scheduleTasks(TaskGraph& graph) {
+	if (ctx.game_state != (unsigned int)GAME_STATES::MINIGAME_1) return;
+	graph.add("mg1 path search", [this] { mg1AI->planPath(); })
+		.reads(ctx.registry.foregroundMotions)
+		.reads(ctx.registry.players)
+		.reads(ctx.registry.deadlys);
+}
+
 CommonAI* AISystem::getAI() {
-	switch (game_state) {
+	switch (ctx.game_state) {
 	case (unsigned int)GAME_STATES::MINIGAME_1: {
 		return mg1AI;
 	}
@@ -3,16 +3,19 @@
 #include "common_ai.hpp"
 #include "mg1_ai.hpp"
 #include "mg2_ai.hpp"
+#include "job_system.hpp"
 
 class AISystem {
 
 public:
 
 	void step(float elapsed_ms);
-	AISystem() {
-		dummyAI = new DummyAI();
-		mg1AI = new MiniGame1AI();
-		mg2AI = new MiniGame2AI();
+	// Adds the AI work that can run alongside the other systems (mg1 path search)
+	void scheduleTasks(TaskGraph& graph);
+	AISystem(SimContext& ctx) : ctx(ctx) {
+		dummyAI = new DummyAI(ctx);
+		mg1AI = new MiniGame1AI(ctx);
+		mg2AI = new MiniGame2AI(ctx);
 	}
 
 	~AISystem() {
@@ -23,6 +26,7 @@ public:
 
 private:
 
+	SimContext& ctx;
 	CommonAI* getAI();
 	DummyAI* dummyAI;
 	MiniGame1AI* mg1AI;
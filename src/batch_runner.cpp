@@ -0,0 +1,262 @@
+// internal
+#include "batch_runner.hpp"
+#include "minigame_bots.hpp"
+#include "profiler.hpp"
+#include "simulation.hpp"
+
+// stlib
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+static const char* outcomeName(BATCH_OUTCOME outcome)
+{
+	switch (outcome) {
+	case BATCH_OUTCOME::WON: return "won";
+	case BATCH_OUTCOME::LOST: return "lost";
+	default: return "timeout";
+	}
+}
+
+bool addSweep(std::vector<SimTuning>& sets, const std::string& spec)
+{
+	size_t equals = spec.find('=');
+	if (equals == std::string::npos) {
+		fprintf(stderr, "Sweep %s isn't NAME=VALUE,VALUE,...\n", spec.c_str());
+		return false;
+	}
+	std::string name = spec.substr(0, equals);
+	std::vector<float> values;
+	std::stringstream list(spec.substr(equals + 1));
+	std::string value;
+	while (std::getline(list, value, ','))
+		values.push_back((float)atof(value.c_str()));
+	if (values.empty()) {
+		fprintf(stderr, "Sweep %s has no values\n", name.c_str());
+		return false;
+	}
+
+	if (sets.empty())
+		sets.push_back(SimTuning());
+	std::vector<SimTuning> swept;
+	for (const SimTuning& set : sets) {
+		for (float v : values) {
+			SimTuning tuning = set;
+			if (name == "mole_update_rate")
+				tuning.mole_update_rate = v;
+			else if (name == "hard_mode_time")
+				tuning.hard_mode_time = v;
+			else if (name == "mg2_duration")
+				tuning.mg2_duration = v;
+			else if (name == "brick_map")
+				tuning.brick_map = (int)v;
+			else {
+				fprintf(stderr, "No tuning value called %s\n", name.c_str());
+				return false;
+			}
+			swept.push_back(tuning);
+		}
+	}
+	sets = swept;
+	return true;
+}
+
+BatchRunner::BatchRunner(const BatchOptions& options_arg)
+	: options(options_arg)
+{
+	if (options.sets.empty())
+		options.sets.push_back(SimTuning());
+}
+
+bool BatchRunner::run()
+{
+	if (!options.script_path.empty()) {
+		if (!script.load(options.script_path))
+			return false;
+		scripted = true;
+	}
+	else {
+		SimContext probe;
+		if (!createMinigameBot(options.minigame, probe)) {
+			fprintf(stderr, "No bot plays game state %d, give the batch a recording with --batch-script\n", (int)options.minigame);
+			return false;
+		}
+	}
+
+	size_t total = options.sets.size() * (size_t)std::max(0, options.runs);
+	results.assign(total, BatchResult());
+	unsigned int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	threads = (unsigned int)std::min<size_t>(threads, std::max<size_t>(total, 1));
+
+	// games are handed out one at a time, a slow one doesn't hold up the rest
+	std::atomic<size_t> next_game { 0 };
+	std::atomic<bool> failed { false };
+	auto worker = [this, total, &next_game, &failed](unsigned int index) {
+		std::string name = "batch " + std::to_string(index);
+		profiler.setThreadName(name.c_str());
+
+		// only the collision meshes, nothing here draws
+		RenderSystem renderer;
+		if (!renderer.loadMeshes()) {
+			failed = true;
+			return;
+		}
+		for (size_t game = next_game++; game < total && !failed; game = next_game++) {
+			size_t set = game / options.runs;
+			uint32_t seed = options.seed + (uint32_t)(game % options.runs);
+			results[game] = play(renderer, set, seed);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < threads; i++)
+		pool.emplace_back(worker, i);
+	for (std::thread& thread : pool)
+		thread.join();
+
+	if (failed) {
+		fprintf(stderr, "Batch could not load the meshes\n");
+		return false;
+	}
+	return true;
+}
+
+BatchResult BatchRunner::play(RenderSystem& renderer, size_t set, uint32_t seed) const
+{
+	SimContext sim;
+	SimContext::Bind bind(sim);
+	// not world.seed, threadRng is shared by every game and only feeds particles
+	sim.seed(seed);
+	sim.tuning = options.sets[set];
+	// initScreenTexture adds this when there's a GL context
+	sim.registry.screenStates.emplace(renderer.screen_state_entity);
+
+	WorldSystem world(sim);
+	PhysicsSystem physics(sim);
+	AISystem ai(sim);
+	world.init(&renderer);
+	world.change_game_states(options.minigame);
+	unsigned int items_before = world.itemsCollected(options.minigame);
+
+	std::unique_ptr<MinigameBot> bot = scripted ? nullptr : createMinigameBot(options.minigame, sim);
+	std::vector<InputEvent> events;
+	size_t next_event = 0;
+	while (!world.last_minigame.over && sim.clock.tick < options.max_ticks) {
+		if (scripted) {
+			while (next_event < script.events.size() && script.events[next_event].tick <= sim.clock.tick)
+				world.applyInput(script.events[next_event++]);
+		}
+		else {
+			events.clear();
+			bot->think(events);
+			for (const InputEvent& event : events)
+				world.applyInput(event);
+		}
+		step_simulation(sim, world, physics, ai);
+	}
+
+	BatchResult result;
+	result.set = set;
+	result.seed = seed;
+	result.ticks = (uint32_t)sim.clock.tick;
+	result.items = world.itemsCollected(options.minigame) - items_before;
+	if (world.last_minigame.over)
+		result.outcome = world.last_minigame.won ? BATCH_OUTCOME::WON : BATCH_OUTCOME::LOST;
+	return result;
+}
+
+namespace {
+	struct SetSummary {
+		int runs = 0;
+		int wins = 0;
+		int losses = 0;
+		int timeouts = 0;
+		float mean_items = 0.f;
+		// ms of game time until the win or loss, timeouts left out
+		float mean_ms = 0.f;
+		float p50_ms = 0.f;
+		float p90_ms = 0.f;
+	};
+
+	SetSummary summarize(const std::vector<BatchResult>& results, size_t set)
+	{
+		SetSummary summary;
+		std::vector<float> finish_ms;
+		for (const BatchResult& result : results) {
+			if (result.set != set)
+				continue;
+			summary.runs++;
+			summary.mean_items += result.items;
+			if (result.outcome == BATCH_OUTCOME::TIMEOUT) {
+				summary.timeouts++;
+				continue;
+			}
+			if (result.outcome == BATCH_OUTCOME::WON)
+				summary.wins++;
+			else
+				summary.losses++;
+			finish_ms.push_back(result.ticks * FRAME_TIME);
+		}
+		if (summary.runs > 0)
+			summary.mean_items /= summary.runs;
+		if (!finish_ms.empty()) {
+			std::sort(finish_ms.begin(), finish_ms.end());
+			for (float ms : finish_ms)
+				summary.mean_ms += ms;
+			summary.mean_ms /= finish_ms.size();
+			summary.p50_ms = finish_ms[finish_ms.size() / 2];
+			summary.p90_ms = finish_ms[std::min(finish_ms.size() - 1, finish_ms.size() * 9 / 10)];
+		}
+		return summary;
+	}
+}
+
+void BatchRunner::printSummary() const
+{
+	printf("Batch: %d games of game state %d per set, %d sets\n", options.runs, (int)options.minigame, (int)options.sets.size());
+	for (size_t set = 0; set < options.sets.size(); set++) {
+		const SimTuning& tuning = options.sets[set];
+		SetSummary summary = summarize(results, set);
+		printf("  moles %.0f  hard mode %.0f  mg2 %.0f  map %d: win %.1f%%  lost %d  timeout %d  finish ms avg %.0f  p50 %.0f  p90 %.0f  items %.2f\n",
+			tuning.mole_update_rate, tuning.hard_mode_time, tuning.mg2_duration, tuning.brick_map,
+			summary.runs > 0 ? 100.f * summary.wins / summary.runs : 0.f, summary.losses, summary.timeouts,
+			summary.mean_ms, summary.p50_ms, summary.p90_ms, summary.mean_items);
+	}
+}
+
+bool BatchRunner::writeCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+	file << "minigame,mole_update_rate,hard_mode_time,mg2_duration,brick_map,runs,wins,losses,timeouts,win_rate,mean_finish_ms,p50_finish_ms,p90_finish_ms,mean_items\n";
+	for (size_t set = 0; set < options.sets.size(); set++) {
+		const SimTuning& tuning = options.sets[set];
+		SetSummary summary = summarize(results, set);
+		file << (int)options.minigame << "," << tuning.mole_update_rate << "," << tuning.hard_mode_time << ","
+			<< tuning.mg2_duration << "," << tuning.brick_map << "," << summary.runs << "," << summary.wins << ","
+			<< summary.losses << "," << summary.timeouts << "," << (summary.runs > 0 ? (float)summary.wins / summary.runs : 0.f) << ","
+			<< summary.mean_ms << "," << summary.p50_ms << "," << summary.p90_ms << "," << summary.mean_items << "\n";
+	}
+	return true;
+}
+
+bool BatchRunner::writeRunsCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+	file << "set,seed,outcome,ticks,ms,items\n";
+	for (const BatchResult& result : results)
+		file << result.set << "," << result.seed << "," << outcomeName(result.outcome) << ","
+			<< result.ticks << "," << result.ticks * FRAME_TIME << "," << result.items << "\n";
+	return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// internal
+#include "components.hpp"
+#include "input_recording.hpp"
+#include "sim_context.hpp"
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class RenderSystem;
+
+// What a batch plays: one minigame, runs games per tuning set
+struct BatchOptions {
+	GAME_STATES minigame = GAME_STATES::MINIGAME_4;
+	int runs = 100;
+	// game i of every set plays seed + i, so sets are compared on the same games
+	uint32_t seed = 1;
+	// a game still going after this many steps counts as a timeout
+	uint32_t max_ticks = 10800;
+	// 0 is one per core
+	unsigned int threads = 0;
+	// recorded input replayed in every game instead of the bot, the only way to batch minigames 1 and 3
+	std::string script_path;
+	// empty plays the defaults only
+	std::vector<SimTuning> sets;
+};
+
+// Adds one SimTuning field's values to the sweep, every existing set is
+// copied once per value: "mg2_duration=30000,40000" turns N sets into 2N.
+// Fields are mole_update_rate, hard_mode_time, mg2_duration and brick_map.
+bool addSweep(std::vector<SimTuning>& sets, const std::string& spec);
+
+enum class BATCH_OUTCOME {
+	WON = 0,
+	LOST = 1,
+	TIMEOUT = 2
+};
+
+struct BatchResult {
+	size_t set = 0;
+	uint32_t seed = 0;
+	BATCH_OUTCOME outcome = BATCH_OUTCOME::TIMEOUT;
+	uint32_t ticks = 0;
+	unsigned int items = 0;
+};
+
+// Plays many games of a minigame with no window, GL context or audio. Every
+// game gets its own SimContext, so whole games run side by side on all cores.
+// Input comes from the minigame's bot or a recording.
+//
+//     BatchRunner batch(options);
+//     if (batch.run()) batch.writeCSV("batch.csv");
+class BatchRunner
+{
+public:
+	BatchRunner(const BatchOptions& options);
+
+	bool run();
+	void printSummary() const;
+	// One row per tuning set: win rate, time to finish and items collected
+	bool writeCSV(const std::string& path) const;
+	// One row per game
+	bool writeRunsCSV(const std::string& path) const;
+
+private:
+	BatchResult play(RenderSystem& renderer, size_t set, uint32_t seed) const;
+
+	BatchOptions options;
+	InputRecording script;
+	bool scripted = false;
+	std::vector<BatchResult> results;
+};
@@ -0,0 +1,359 @@
+// internal
+#include "behavior_tree.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+
+using json = nlohmann::json;
+
+void BehaviorLibrary::addCondition(const std::string& name, BehaviorCondition condition)
+{
+	conditions[name] = condition;
+}
+
+void BehaviorLibrary::addAction(const std::string& name, BehaviorAction action)
+{
+	actions[name] = action;
+}
+
+BehaviorCondition BehaviorLibrary::condition(const std::string& name) const
+{
+	auto it = conditions.find(name);
+	return it == conditions.end() ? nullptr : it->second;
+}
+
+BehaviorAction BehaviorLibrary::action(const std::string& name) const
+{
+	auto it = actions.find(name);
+	return it == actions.end() ? nullptr : it->second;
+}
+
+static bool nodeType(const std::string& name, BT_NODE& type)
+{
+	static const std::unordered_map<std::string, BT_NODE> types = {
+		{ "sequence", BT_NODE::SEQUENCE },
+		{ "selector", BT_NODE::SELECTOR },
+		{ "parallel", BT_NODE::PARALLEL },
+		{ "inverter", BT_NODE::INVERTER },
+		{ "succeeder", BT_NODE::SUCCEEDER },
+		{ "repeat", BT_NODE::REPEAT },
+		{ "cooldown", BT_NODE::COOLDOWN },
+		{ "condition", BT_NODE::CONDITION },
+		{ "action", BT_NODE::ACTION },
+	};
+	auto it = types.find(name);
+	if (it == types.end())
+		return false;
+	type = it->second;
+	return true;
+}
+
+// An optional field of a node, false with a message if it's there but the wrong type
+static bool stringField(const json& node, const char* field, std::string& out)
+{
+	auto it = node.find(field);
+	if (it == node.end())
+		return true;
+	if (!it->is_string()) {
+		fprintf(stderr, "Behaviour tree node's '%s' isn't a string\n", field);
+		return false;
+	}
+	out = it->get<std::string>();
+	return true;
+}
+
+static bool numberField(const json& node, const char* field, float& out)
+{
+	auto it = node.find(field);
+	if (it == node.end())
+		return true;
+	if (!it->is_number()) {
+		fprintf(stderr, "Behaviour tree node's '%s' isn't a number\n", field);
+		return false;
+	}
+	out = it->get<float>();
+	return true;
+}
+
+bool BehaviorTree::compile(const json& definition, const BehaviorLibrary& library)
+{
+	nodes.clear();
+	conditions.clear();
+	actions.clear();
+	keys.clear();
+	defaults.clear();
+
+	if (!definition.is_object() || !definition.contains("root")) {
+		fprintf(stderr, "Behaviour tree has no root\n");
+		return false;
+	}
+	if (definition.contains("blackboard")) {
+		if (!definition["blackboard"].is_object()) {
+			fprintf(stderr, "Behaviour tree blackboard isn't an object\n");
+			return false;
+		}
+		for (auto it = definition["blackboard"].begin(); it != definition["blackboard"].end(); ++it) {
+			if (!it->is_number()) {
+				fprintf(stderr, "Behaviour tree blackboard key %s isn't a number\n", it.key().c_str());
+				return false;
+			}
+			keys.push_back(it.key());
+			defaults.push_back(it->get<float>());
+		}
+	}
+	if (!compileNode(definition["root"], library)) {
+		nodes.clear();
+		return false;
+	}
+	return true;
+}
+
+bool BehaviorTree::compileNode(const json& node, const BehaviorLibrary& library)
+{
+	if (nodes.size() >= UINT16_MAX) {
+		fprintf(stderr, "Behaviour tree has too many nodes\n");
+		return false;
+	}
+	if (!node.is_object()) {
+		fprintf(stderr, "Behaviour tree node isn't an object\n");
+		return false;
+	}
+	std::string type_name;
+	if (!stringField(node, "type", type_name))
+		return false;
+	BehaviorNode compiled = { BT_NODE::ACTION, 0, 0, -1, 0.f };
+	if (!nodeType(type_name, compiled.type)) {
+		fprintf(stderr, "Behaviour tree node type '%s' doesn't exist\n", type_name.c_str());
+		return false;
+	}
+	std::string key_name;
+	if (!stringField(node, "key", key_name))
+		return false;
+	if (node.contains("key")) {
+		compiled.key = (int16_t)key(key_name);
+		if (compiled.key < 0) {
+			fprintf(stderr, "Behaviour tree key '%s' isn't on the blackboard\n", key_name.c_str());
+			return false;
+		}
+	}
+
+	std::vector<const json*> children;
+	if (node.contains("children")) {
+		if (!node["children"].is_array()) {
+			fprintf(stderr, "Behaviour tree %s's children aren't an array\n", type_name.c_str());
+			return false;
+		}
+		for (const json& child : node["children"])
+			children.push_back(&child);
+	}
+	if (node.contains("child"))
+		children.push_back(&node["child"]);
+
+	switch (compiled.type) {
+	case BT_NODE::CONDITION:
+	case BT_NODE::ACTION: {
+		std::string name;
+		if (!stringField(node, "name", name) || !numberField(node, "value", compiled.param))
+			return false;
+		if (compiled.type == BT_NODE::CONDITION) {
+			BehaviorCondition condition = library.condition(name);
+			if (!condition) {
+				fprintf(stderr, "Behaviour tree condition '%s' doesn't exist\n", name.c_str());
+				return false;
+			}
+			compiled.leaf = (uint16_t)conditions.size();
+			conditions.push_back(condition);
+		}
+		else {
+			BehaviorAction action = library.action(name);
+			if (!action) {
+				fprintf(stderr, "Behaviour tree action '%s' doesn't exist\n", name.c_str());
+				return false;
+			}
+			compiled.leaf = (uint16_t)actions.size();
+			actions.push_back(action);
+		}
+		if (!children.empty()) {
+			fprintf(stderr, "Behaviour tree leaf '%s' has children\n", name.c_str());
+			return false;
+		}
+		break;
+	}
+	case BT_NODE::INVERTER:
+	case BT_NODE::SUCCEEDER:
+	case BT_NODE::REPEAT:
+	case BT_NODE::COOLDOWN:
+		if (children.size() != 1) {
+			fprintf(stderr, "Behaviour tree %s needs exactly one child\n", type_name.c_str());
+			return false;
+		}
+		if (compiled.type == BT_NODE::REPEAT && !numberField(node, "count", compiled.param))
+			return false;
+		if (compiled.type == BT_NODE::COOLDOWN && !numberField(node, "ms", compiled.param))
+			return false;
+		break;
+	case BT_NODE::PARALLEL:
+		compiled.param = (float)children.size();
+		if (!numberField(node, "success", compiled.param))
+			return false;
+		// fall through
+	case BT_NODE::SEQUENCE:
+	case BT_NODE::SELECTOR:
+		if (children.empty()) {
+			fprintf(stderr, "Behaviour tree %s has no children\n", type_name.c_str());
+			return false;
+		}
+		break;
+	}
+
+	size_t index = nodes.size();
+	nodes.push_back(compiled);
+	for (const json* child : children) {
+		if (!compileNode(*child, library))
+			return false;
+	}
+	nodes[index].end = (uint16_t)nodes.size();
+	return true;
+}
+
+bool BehaviorTree::load(const std::string& path, const BehaviorLibrary& library)
+{
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		fprintf(stderr, "Failed to open behaviour tree %s\n", path.c_str());
+		return false;
+	}
+	json definition = json::parse(file, nullptr, false);
+	if (definition.is_discarded()) {
+		fprintf(stderr, "Behaviour tree %s isn't valid JSON\n", path.c_str());
+		return false;
+	}
+	return compile(definition, library);
+}
+
+Blackboard BehaviorTree::blackboard() const
+{
+	Blackboard board;
+	board.tree = this;
+	board.values = defaults;
+	board.cursors.assign(nodes.size(), 0);
+	board.timers.assign(nodes.size(), 0.f);
+	return board;
+}
+
+int BehaviorTree::key(const std::string& name) const
+{
+	for (size_t i = 0; i < keys.size(); i++) {
+		if (keys[i] == name)
+			return (int)i;
+	}
+	return -1;
+}
+
+BT_STATUS BehaviorTree::tick(SimContext& ctx, Entity agent, Blackboard& board, float elapsed_ms) const
+{
+	if (nodes.empty())
+		return BT_STATUS::FAILURE;
+	assert(board.tree == this && board.cursors.size() == nodes.size());
+	BehaviorCall call = { ctx, agent, board, -1, 0.f };
+	return tickNode(0, call, elapsed_ms);
+}
+
+void BehaviorTree::tickAll(SimContext& ctx, float elapsed_ms) const
+{
+	PROFILE_ZONE("BehaviorTree::tickAll");
+	ComponentContainer<Blackboard>& boards = ctx.registry.blackboards;
+	size_t count = boards.components.size();
+	for (size_t i = 0; i < count; i++) {
+		if (boards.components[i].tree == this)
+			tick(ctx, boards.entities[i], boards.components[i], elapsed_ms);
+	}
+}
+
+BT_STATUS BehaviorTree::tickNode(uint16_t index, BehaviorCall& call, float elapsed_ms) const
+{
+	const BehaviorNode& node = nodes[index];
+	uint16_t first = index + 1;
+	uint16_t& cursor = call.board.cursors[index];
+
+	switch (node.type) {
+	case BT_NODE::SEQUENCE:
+	case BT_NODE::SELECTOR: {
+		// a sequence goes on while its children succeed, a selector while they fail
+		BT_STATUS keep_going = node.type == BT_NODE::SEQUENCE ? BT_STATUS::SUCCESS : BT_STATUS::FAILURE;
+		for (uint16_t child = cursor ? cursor : first; child < node.end; child = nodes[child].end) {
+			BT_STATUS status = tickNode(child, call, elapsed_ms);
+			if (status == BT_STATUS::RUNNING) {
+				cursor = child;
+				return status;
+			}
+			if (status != keep_going) {
+				cursor = 0;
+				return status;
+			}
+		}
+		cursor = 0;
+		return keep_going;
+	}
+	case BT_NODE::PARALLEL: {
+		int children = 0, successes = 0, failures = 0;
+		for (uint16_t child = first; child < node.end; child = nodes[child].end) {
+			children++;
+			BT_STATUS status = tickNode(child, call, elapsed_ms);
+			successes += status == BT_STATUS::SUCCESS;
+			failures += status == BT_STATUS::FAILURE;
+		}
+		if (successes >= node.param)
+			return BT_STATUS::SUCCESS;
+		// fails once the ones still running can't make up the difference
+		return children - failures < node.param ? BT_STATUS::FAILURE : BT_STATUS::RUNNING;
+	}
+	case BT_NODE::INVERTER: {
+		BT_STATUS status = tickNode(first, call, elapsed_ms);
+		if (status == BT_STATUS::RUNNING)
+			return status;
+		return status == BT_STATUS::SUCCESS ? BT_STATUS::FAILURE : BT_STATUS::SUCCESS;
+	}
+	case BT_NODE::SUCCEEDER:
+		return tickNode(first, call, elapsed_ms) == BT_STATUS::RUNNING ? BT_STATUS::RUNNING : BT_STATUS::SUCCESS;
+	case BT_NODE::REPEAT: {
+		BT_STATUS status = tickNode(first, call, elapsed_ms);
+		if (status == BT_STATUS::FAILURE) {
+			cursor = 0;
+			return status;
+		}
+		if (status == BT_STATUS::SUCCESS && node.param > 0.f && ++cursor >= node.param) {
+			cursor = 0;
+			return status;
+		}
+		return BT_STATUS::RUNNING;
+	}
+	case BT_NODE::COOLDOWN: {
+		// cursor is set while the child runs, it's ticked until it finishes
+		// and only then does the wait start over
+		float& timer = call.board.timers[index];
+		if (!cursor) {
+			timer += elapsed_ms;
+			if (timer <= node.param)
+				return BT_STATUS::FAILURE;
+		}
+		BT_STATUS status = tickNode(first, call, elapsed_ms);
+		cursor = status == BT_STATUS::RUNNING;
+		if (status != BT_STATUS::RUNNING)
+			timer = 0.f;
+		return status;
+	}
+	case BT_NODE::CONDITION:
+	case BT_NODE::ACTION: {
+		call.key = node.key;
+		call.value = node.param;
+		if (node.type == BT_NODE::CONDITION)
+			return conditions[node.leaf](call) ? BT_STATUS::SUCCESS : BT_STATUS::FAILURE;
+		return actions[node.leaf](call);
+	}
+	}
+	return BT_STATUS::FAILURE;
+}
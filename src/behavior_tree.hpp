@@ -0,0 +1,125 @@
+#pragma once
+
+// internal
+#include "sim_context.hpp"
+#include "tiny_ecs.hpp"
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+
+enum class BT_STATUS : uint8_t {
+	SUCCESS = 0,
+	FAILURE = 1,
+	RUNNING = 2
+};
+
+enum class BT_NODE : uint8_t {
+	// children in order until one fails, picks up at a running one next tick
+	SEQUENCE = 0,
+	// children in order until one succeeds, picks up at a running one next tick
+	SELECTOR = 1,
+	// every child each tick, succeeds once "success" of them do (all by default)
+	PARALLEL = 2,
+	// decorators, one child each
+	INVERTER = 3,
+	SUCCEEDER = 4,
+	// runs its child "count" times in a row, forever with 0
+	REPEAT = 5,
+	// fails without ticking its child until more than "ms" have gone by since
+	// the child last finished, a running child is ticked until it does
+	COOLDOWN = 6,
+	// leaves, functions looked up by name in the BehaviorLibrary
+	CONDITION = 7,
+	ACTION = 8
+};
+
+// What a leaf gets handed when it runs
+struct BehaviorCall {
+	SimContext& ctx;
+	Entity agent;
+	Blackboard& board;
+	// blackboard slot from the node's "key", -1 without one
+	int key;
+	// the node's "value", 0 without one
+	float value;
+};
+
+typedef bool (*BehaviorCondition)(BehaviorCall& call);
+typedef BT_STATUS (*BehaviorAction)(BehaviorCall& call);
+
+// The leaves a tree definition can name
+class BehaviorLibrary
+{
+public:
+	void addCondition(const std::string& name, BehaviorCondition condition);
+	void addAction(const std::string& name, BehaviorAction action);
+
+	BehaviorCondition condition(const std::string& name) const;
+	BehaviorAction action(const std::string& name) const;
+
+private:
+	std::unordered_map<std::string, BehaviorCondition> conditions;
+	std::unordered_map<std::string, BehaviorAction> actions;
+};
+
+// Flat, depth first: a node's children follow it and end is one past its
+// last descendant, so the tick walks indices instead of pointers
+struct BehaviorNode {
+	BT_NODE type;
+	// CONDITION and ACTION: index into the tree's table of that kind
+	uint16_t leaf;
+	uint16_t end;
+	int16_t key;
+	// PARALLEL "success", REPEAT "count", COOLDOWN "ms" or a leaf's "value"
+	float param;
+};
+
+// A behaviour tree compiled from JSON. It holds no per agent state, that's in
+// each agent's Blackboard component, so one tree serves any number of agents.
+//
+//     {
+//       "blackboard": { "anger": 0 },
+//       "root": { "type": "selector", "children": [
+//         { "type": "sequence", "children": [
+//           { "type": "condition", "name": "above", "key": "anger", "value": 5 },
+//           { "type": "action", "name": "charge" } ] },
+//         { "type": "cooldown", "ms": 500, "child": { "type": "action", "name": "wander" } } ] }
+//     }
+//
+//     tree.compile(definition, library);
+//     ctx.registry.blackboards.insert(agent, tree.blackboard());
+//     tree.tickAll(ctx, elapsed_ms);
+class BehaviorTree
+{
+public:
+	// False with a message on stderr if the definition doesn't compile, the tree is left empty
+	bool compile(const nlohmann::json& definition, const BehaviorLibrary& library);
+	bool load(const std::string& path, const BehaviorLibrary& library);
+
+	// A fresh blackboard for one more agent running this tree
+	Blackboard blackboard() const;
+	BT_STATUS tick(SimContext& ctx, Entity agent, Blackboard& board, float elapsed_ms) const;
+	// Ticks every agent in the registry whose blackboard runs this tree. Leaves
+	// mustn't add or remove blackboards while it runs, the call holds on to one.
+	void tickAll(SimContext& ctx, float elapsed_ms) const;
+
+	// Blackboard slot of a key the definition declared, -1 if it didn't
+	int key(const std::string& name) const;
+	size_t size() const { return nodes.size(); }
+	bool empty() const { return nodes.empty(); }
+
+private:
+	bool compileNode(const nlohmann::json& node, const BehaviorLibrary& library);
+	BT_STATUS tickNode(uint16_t index, BehaviorCall& call, float elapsed_ms) const;
+
+	std::vector<BehaviorNode> nodes;
+	std::vector<BehaviorCondition> conditions;
+	std::vector<BehaviorAction> actions;
+	std::vector<std::string> keys;
+	std::vector<float> defaults;
+};
@@ -1,4 +1,5 @@
 #include "common.hpp"
+#include "sim_context.hpp"
 
 // Note, we could also use the functions from GLM but we write the transformations here to show the uderlying math
 void Transform::scale(vec2 scale)
@@ -28,6 +29,7 @@ int choose(int n, int k) {
 	return (n * choose(n - 1, k - 1)) / k;
 }
 
+#ifndef GEN_NO_GL_ERROR_CHECKS
 bool gl_has_errors()
 {
 	GLenum error = glGetError();
@@ -63,19 +65,21 @@ bool gl_has_errors()
 
 	return true;
 }
+#endif
 
 bool collidesWithWallX(vec2 pos, int offset) {
+	SimContext& ctx = SimContext::current();
 	int xCoord = (int)pos.x / 100;
-	return GAME_MAZE[(int)(pos.y - offset) / 100][xCoord] || GAME_MAZE[(int)(pos.y + offset) / 100][xCoord];
+	return ctx.maze[(int)(pos.y - offset) / 100][xCoord] || ctx.maze[(int)(pos.y + offset) / 100][xCoord];
 }
 
 bool collidesWithWallY(vec2 pos, int offset) {
+	SimContext& ctx = SimContext::current();
 	int yCoord = (int)pos.y / 100;
-	return GAME_MAZE[yCoord][(int)(pos.x - offset)/100] || GAME_MAZE[yCoord][(int)(pos.x + offset) / 100];
+	return ctx.maze[yCoord][(int)(pos.x - offset)/100] || ctx.maze[yCoord][(int)(pos.x + offset) / 100];
 }
 
 int debugArray[36][64] = { 0 };
-int GAME_MAZE[9][16] = { 0 };
 
 int ORGAN_1_BOUNDARY[36][64] = {
 {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
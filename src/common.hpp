@@ -49,10 +49,13 @@ struct Transform {
 };
 
 int choose(int n, int k);
-bool gl_has_errors();
 
-extern unsigned int game_state;
-extern bool pause_game_state;
+// glGetError round trip, compiled out with GEN_GL_ERROR_CHECKS=OFF (the release default)
+#ifdef GEN_NO_GL_ERROR_CHECKS
+inline bool gl_has_errors() { return false; }
+#else
+bool gl_has_errors();
+#endif
 
 extern int debugArray[36][64];
 extern int ORGAN_1_BOUNDARY[36][64];
@@ -71,7 +74,6 @@ enum Direction {
 	LEFT = 3
 };
 
-extern int GAME_MAZE[9][16];
 const int GAME_MAZE_SEED[9][16] = {
 	{0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1},
 	{1, 1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0, 1},
@@ -2,21 +2,14 @@
 
 #include "tiny_ecs.hpp"
 #include "tiny_ecs_registry.hpp"
-
-struct AITreeNode {
-	// if isEnd is true, it's a leaf node, do Action, else check Decision function to go left or right
-	bool isEnd;
-	std::function<bool()> Decision;
-	AITreeNode* left;
-	AITreeNode* right;
-	std::function<void()> Action;
-};
+#include "sim_context.hpp"
 
 class CommonAI {
 public:
+	CommonAI(SimContext& ctx) : ctx(ctx) {}
 	virtual void step(float elapsed_ms) = 0;
 protected:
-	void processNode(AITreeNode* node);
+	SimContext& ctx;
 	uint TICK = 0;
 	int COMPUTE_CYCLE = 250;
 };
@@ -24,5 +17,5 @@ protected:
 class DummyAI : public CommonAI {
 public:
 	void step(float elapsed_ms) { return; }
-	DummyAI() {}
+	DummyAI(SimContext& ctx) : CommonAI(ctx) {}
 };
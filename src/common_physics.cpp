@@ -1,11 +1,10 @@
 #include "common_physics.hpp"
 
-bool keymap[512] = {};
 
 void CommonPhysics::playerMovementHandler(foregroundMotion& player_motion, float elapsed_ms) {
 	float step_seconds = elapsed_ms / 1000.f;
-	for (int i = 0; i < sizeof(keymap) / sizeof(keymap[0]); i++) {
-		if (keymap[i]) {
+	for (int i = 0; i < sizeof(ctx.input.keys) / sizeof(ctx.input.keys[0]); i++) {
+		if (ctx.input.keys[i]) {
 			switch (i) {
 			case GLFW_KEY_W:
 				player_motion.position.y += -275.f * step_seconds;
@@ -96,9 +95,10 @@ bool pointInsideAABB(vec3& point, vec2& bboxMin, vec2& bboxMax) {
 
 // Helper to get transformed vertices of a mesh according to the entity's position
 std::vector<ColoredVertex> transformVertices(Entity& meshEntity) {
-	Mesh* mesh = registry.meshPtrs.get(meshEntity);
+	SimContext& ctx = SimContext::current();
+	Mesh* mesh = ctx.registry.meshPtrs.get(meshEntity);
 	// Assuming mesh collision entities are in the foreground 
-	foregroundMotion& meshEntity_motion = registry.foregroundMotions.get(meshEntity); 
+	foregroundMotion& meshEntity_motion = ctx.registry.foregroundMotions.get(meshEntity); 
 
 	std::vector<ColoredVertex> transformedVertices;
 
@@ -205,7 +205,7 @@ bool CommonPhysics::checkMeshCollision(Entity& meshEntity, Entity& otherEntity)
 	std::vector<ColoredVertex> transformedVertices = transformVertices(meshEntity);
 
 	// Get bounding box and max/min corners for other entity
-	foregroundMotion& otherEntity_motion = registry.foregroundMotions.get(otherEntity);
+	foregroundMotion& otherEntity_motion = ctx.registry.foregroundMotions.get(otherEntity);
 	vec2 otherEntity_bbox = get_bounding_box(otherEntity);
 	vec4 otherEntity_bbox_corners = get_bbox_corners(otherEntity_bbox, otherEntity_motion.position);
 
@@ -229,7 +229,7 @@ bool CommonPhysics::checkMeshCollision(Entity& meshEntity, Entity& otherEntity)
 	}
 	
 	// 2. If not, are any edges intersection with an edge of an AABB?
-	Mesh* mesh = registry.meshPtrs.get(meshEntity);
+	Mesh* mesh = ctx.registry.meshPtrs.get(meshEntity);
 	std::vector<uint16_t>& vertexIndices = mesh->vertex_indices;
 	if (mesh_AABB_edge_intersection(transformedVertices, vertexIndices, boxMin, boxMax)) {
 		return true;
@@ -247,7 +247,7 @@ bool CommonPhysics::isColliding(Entity& meshEntity, Entity& e2) {
 	}
 
 	// Narrow phase collision check
-	if (registry.meshPtrs.has(meshEntity)) {
+	if (ctx.registry.meshPtrs.has(meshEntity)) {
 		return checkMeshCollision(meshEntity, e2);
 	}
 
@@ -293,12 +293,12 @@ void CommonPhysics::setAngleToPlayer(foregroundMotion& player_motion, foreground
 
 // probably want a component that removes the following two functions.
 vec2 CommonPhysics::get_position(Entity& e) {
-	if (registry.foregroundMotions.has(e)) {
-		foregroundMotion& motion = registry.foregroundMotions.get(e);
+	if (ctx.registry.foregroundMotions.has(e)) {
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(e);
 		return motion.position;
 	}
-	else if (registry.backgroundMotions.has(e)) {
-		backgroundMotions& staticObject = registry.backgroundMotions.get(e);
+	else if (ctx.registry.backgroundMotions.has(e)) {
+		backgroundMotions& staticObject = ctx.registry.backgroundMotions.get(e);
 		return staticObject.position;
 	}
 	else {
@@ -308,12 +308,12 @@ vec2 CommonPhysics::get_position(Entity& e) {
 }
 
 vec2 CommonPhysics::get_scale(Entity& e) {
-	if (registry.foregroundMotions.has(e)) {
-		foregroundMotion& motion = registry.foregroundMotions.get(e);
+	if (ctx.registry.foregroundMotions.has(e)) {
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(e);
 		return motion.scale;
 	}
-	else if (registry.backgroundMotions.has(e)) {
-		backgroundMotions& staticObject = registry.backgroundMotions.get(e);
+	else if (ctx.registry.backgroundMotions.has(e)) {
+		backgroundMotions& staticObject = ctx.registry.backgroundMotions.get(e);
 		return staticObject.scale;
 	}
 	else {
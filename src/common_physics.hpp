@@ -2,8 +2,8 @@
 
 #include "tiny_ecs.hpp"
 #include "tiny_ecs_registry.hpp"
+#include "sim_context.hpp"
 
-extern bool keymap[512];
 const float BBOX_SCALE = 1.02; // slightly reduces player bbox size
 
 struct BBox {
@@ -17,11 +17,14 @@ class CommonPhysics {
 
 public:
 
+	CommonPhysics(SimContext& ctx) : ctx(ctx) {}
 	virtual void step(float elapsed_ms) = 0;
 	BBox getBBoxBounds(Entity& e);
 
 protected:
 
+	SimContext& ctx;
+
 	void playerMovementHandler(foregroundMotion& player_motion, float elapsed_ms);
 	bool checkCircleCollision(Entity& e1, Entity& e2);
 	bool checkBoxCollision(Entity& e1, Entity& e2);
@@ -46,6 +46,12 @@ struct foregroundMotion {
 	vec2 velocity = { 0, 0 };
 	vec2 scale = { 10, 10 };
 	vec2 accel = { 0, 0};
+	// position before the latest fixed step, the renderer blends between the two
+	vec2 previous_position = { 0, 0 };
+	bool has_previous = false;
+
+	// Jumps straight there, no blending in from the old position
+	void teleport(vec2 to) { position = previous_position = to; }
 };
 
 // All data relevant to fixed (position) entities 
@@ -85,6 +91,9 @@ struct ScreenState
 {
 	float darken_screen_factor = -1;
 	float fadeOutTimer = 1500.f;
+	// screen shake, offset is in uv units and only applied while shake_ms > 0
+	float shake_ms = 0.f;
+	vec2 shake_offset = { 0.f, 0.f };
 };
 
 // A struct to refer to debugging graphics in the ECS
@@ -217,6 +226,21 @@ struct FinishLine {
 	
 };
 
+class BehaviorTree;
+
+// An agent's state in a BehaviorTree, one tree can run on many agents
+struct Blackboard
+{
+	const BehaviorTree* tree = nullptr;
+	// the keys the tree declared, in order
+	std::vector<float> values;
+	// per node: the child a SEQUENCE or SELECTOR picks up at, REPEAT's count so
+	// far, 1 while COOLDOWN's child is running
+	std::vector<uint16_t> cursors;
+	// per node: COOLDOWN's ms so far
+	std::vector<float> timers;
+};
+
 /**
  * The following enumerators represent global identifiers refering to graphic
  * assets. For example TEXTURE_ASSET_ID are the identifiers of each texture
@@ -351,7 +375,8 @@ enum class EFFECT_ASSET_ID {
 	FONT = MESH + 1,
 	MOLE = FONT + 1,
 	ANIMATION = MOLE + 1,
-	EFFECT_COUNT = ANIMATION + 1
+	PARTICLE = ANIMATION + 1,
+	EFFECT_COUNT = PARTICLE + 1
 };
 const int effect_count = (int)EFFECT_ASSET_ID::EFFECT_COUNT;
 
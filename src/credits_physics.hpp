@@ -8,7 +8,7 @@ class CreditsPhysics : public CommonPhysics {
 public:
 
 	void step(float elapsed_ms);
-	CreditsPhysics() {}
+	CreditsPhysics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void screenMoves_panDown(float elapsed_time);
@@ -0,0 +1,84 @@
+// internal
+#include "flow_field.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstring>
+
+bool FlowField::update(const int* walls_arg, int columns_arg, int rows_arg, int target_column, int target_row)
+{
+	size_t cells = (size_t)columns_arg * rows_arg;
+	int target_arg = target_row * columns_arg + target_column;
+	bool same_walls = columns_arg == columns && rows_arg == rows &&
+		memcmp(walls.data(), walls_arg, cells * sizeof(int)) == 0;
+	if (same_walls && target_arg == target)
+		return false;
+
+	if (!same_walls) {
+		columns = columns_arg;
+		rows = rows_arg;
+		walls.assign(walls_arg, walls_arg + cells);
+	}
+	target = target_arg;
+	build();
+	return true;
+}
+
+void FlowField::build()
+{
+	PROFILE_ZONE("FlowField::build");
+	size_t cells = (size_t)columns * rows;
+	distances.assign(cells, -1);
+	directions.resize(cells);
+	queue.resize(cells);
+	if (target < 0 || target >= (int)cells || walls[target])
+		return;
+
+	// every cell is queued at most once, so the queue never wraps
+	size_t head = 0, tail = 0;
+	distances[target] = 0;
+	queue[tail++] = target;
+
+	// neighbour offsets and the way back from the neighbour to the cell it was reached from
+	const int dx[4] = { 0, 1, 0, -1 };
+	const int dy[4] = { -1, 0, 1, 0 };
+	const Direction back[4] = { DOWN, LEFT, UP, RIGHT };
+	while (head < tail) {
+		int cell = queue[head++];
+		int column = cell % columns;
+		int row = cell / columns;
+		for (int i = 0; i < 4; i++) {
+			int next_column = column + dx[i];
+			int next_row = row + dy[i];
+			if (!contains(next_column, next_row))
+				continue;
+			int next = next_row * columns + next_column;
+			if (walls[next] || distances[next] >= 0)
+				continue;
+			distances[next] = distances[cell] + 1;
+			directions[next] = (uint8_t)back[i];
+			queue[tail++] = next;
+		}
+	}
+}
+
+bool FlowField::contains(int column, int row) const
+{
+	return column >= 0 && row >= 0 && column < columns && row < rows;
+}
+
+int FlowField::distance(int column, int row) const
+{
+	if (!contains(column, row))
+		return -1;
+	return distances[row * columns + column];
+}
+
+bool FlowField::direction(int column, int row, Direction& dir) const
+{
+	if (distance(column, row) <= 0)
+		return false;
+	dir = (Direction)directions[row * columns + column];
+	return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+
+// stlib
+#include <cstdint>
+#include <vector>
+
+// Breadth first distances to one target cell over a grid of walls, plus the
+// direction that gets one cell closer from every other cell. Any number of
+// chasers share one field, each only looks up the cell it's standing in.
+//
+//     FlowField field;
+//     field.update(&ctx.maze[0][0], MAZE_COLUMNS, MAZE_ROWS, player_column, player_row);
+//     Direction dir;
+//     if (field.direction(column, row, dir)) ... one step along dir ...
+class FlowField
+{
+public:
+	// walls is columns * rows, row major, non zero is a wall. Only rebuilds when
+	// the target cell or a wall changed, true if it did.
+	bool update(const int* walls, int columns, int rows, int target_column, int target_row);
+
+	bool contains(int column, int row) const;
+	// Steps to the target, -1 for walls and cells it can't be reached from
+	int distance(int column, int row) const;
+	// False on the target itself and wherever distance is -1
+	bool direction(int column, int row, Direction& dir) const;
+
+private:
+	void build();
+
+	int columns = 0;
+	int rows = 0;
+	int target = -1;
+	// the walls the field was built for
+	std::vector<int> walls;
+	std::vector<int> distances;
+	std::vector<uint8_t> directions;
+	std::vector<int> queue;
+};
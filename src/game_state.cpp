@@ -1,118 +1,117 @@
 #include "game_state.hpp"
 #include "json.hpp"
 #include "common.hpp"
+#include "sim_context.hpp"
 
 using json = nlohmann::json;
 
-unsigned int game_state;
-bool pause_game_state;
-
 // Needs to be called everytime moving to a new game state
 void GameState::newGameStateContainers() {
+	SimContext& ctx = SimContext::current();
 	ComponentContainer<foregroundMotion> motions;
-	registry.foregroundMotions = motions;
+	ctx.registry.foregroundMotions = motions;
 
 	ComponentContainer<backgroundMotions> staticObjects;
-	registry.backgroundMotions = staticObjects;
+	ctx.registry.backgroundMotions = staticObjects;
 
 	ComponentContainer<overlayMotions> overlayMotions;
-	registry.overlayMotions = overlayMotions;
+	ctx.registry.overlayMotions = overlayMotions;
 
 	ComponentContainer<Collision> collisions;
-	registry.collisions = collisions;
+	ctx.registry.collisions = collisions;
 
 	ComponentContainer<Player> players;
-	registry.players = players;
+	ctx.registry.players = players;
 
 	ComponentContainer<Mesh*> meshPtrs;
-	registry.meshPtrs = meshPtrs;
+	ctx.registry.meshPtrs = meshPtrs;
 
 	ComponentContainer<RenderRequest> backgroundRenderRequests;
-	registry.backgroundRenderRequests = backgroundRenderRequests;
+	ctx.registry.backgroundRenderRequests = backgroundRenderRequests;
 
 	ComponentContainer<RenderRequest> foregroundRenderRequests;
-	registry.foregroundRenderRequests = foregroundRenderRequests;
+	ctx.registry.foregroundRenderRequests = foregroundRenderRequests;
 
 	ComponentContainer<RenderRequest> overlayRenderRequests;
-	registry.overlayRenderRequests = overlayRenderRequests;
+	ctx.registry.overlayRenderRequests = overlayRenderRequests;
 
 	ComponentContainer<TextRenderRequest> textRenderRequests;
-	registry.textRenderRequests = textRenderRequests;
+	ctx.registry.textRenderRequests = textRenderRequests;
 
-	//overworldRegistry.screenStates = registry.screenStates;
+	//overworldRegistry.screenStates = ctx.registry.screenStates;
 	//ComponentContainer<ScreenState> screenStates;
 	//registry.screenStates = screenStates;
 
 	ComponentContainer<Consumable> consumables;
-	registry.consumables = consumables;
+	ctx.registry.consumables = consumables;
 
 	ComponentContainer<Deadly> deadlys;
-	registry.deadlys = deadlys;
+	ctx.registry.deadlys = deadlys;
 
 	ComponentContainer<DebugComponent> debugComponents;
-	registry.debugComponents = debugComponents;
+	ctx.registry.debugComponents = debugComponents;
 
 	ComponentContainer<vec3> colors;
-	registry.colors = colors;
+	ctx.registry.colors = colors;
 
 	ComponentContainer<GameNode> nodes;
-	registry.gameNodes = nodes;
+	ctx.registry.gameNodes = nodes;
 
 	ComponentContainer<Collidable> collidables;
-	registry.collidables = collidables;
+	ctx.registry.collidables = collidables;
 
 	ComponentContainer<Arrow> arrows;
-	registry.arrows = arrows;
+	ctx.registry.arrows = arrows;
 
 	ComponentContainer<Background> background;
-	registry.background = background;
+	ctx.registry.background = background;
 
 	ComponentContainer<Wall> walls;
-	registry.walls = walls;
+	ctx.registry.walls = walls;
 
 	ComponentContainer<Animation> animation;
-	registry.animation = animation;
+	ctx.registry.animation = animation;
 
 	//ComponentContainer<Text> texts;
 	//registry.texts = texts;
 
 	ComponentContainer<WhackAMole> whackAMole;
-	registry.whackAMole = whackAMole;
+	ctx.registry.whackAMole = whackAMole;
 
 	ComponentContainer<Title> titleChoice;
-	registry.title = titleChoice;
+	ctx.registry.title = titleChoice;
 
 	ComponentContainer<InstanceRenderRequest> instanceRenderRequest;
-	registry.instanceRenderRequests = instanceRenderRequest;
+	ctx.registry.instanceRenderRequests = instanceRenderRequest;
 
 	ComponentContainer<SavedGameTimer> savedGameTimer;
-	registry.savedGameTimer = savedGameTimer;
+	ctx.registry.savedGameTimer = savedGameTimer;
 
 	ComponentContainer<Platform> platform;
-	registry.platform = platform;
+	ctx.registry.platform = platform;
 	
 	ComponentContainer<Jump> jump;
-	registry.jump = jump;
+	ctx.registry.jump = jump;
 
 	ComponentContainer<Ball> balls;
-	registry.balls = balls;
+	ctx.registry.balls = balls;
 
 	ComponentContainer<Brick> bricks;
-	registry.bricks = bricks;
+	ctx.registry.bricks = bricks;
 
 	ComponentContainer<BezierCurve> beziers;
-	registry.beziers = beziers;
+	ctx.registry.beziers = beziers;
 
 	ComponentContainer<Particle> particles;
-	registry.particles = particles;
+	ctx.registry.particles = particles;
 
 	ComponentContainer<FinishLine> finishLine;
-	registry.finishLine = finishLine;
+	ctx.registry.finishLine = finishLine;
 	ComponentContainer<Paddle> paddles;
-	registry.paddles = paddles;
+	ctx.registry.paddles = paddles;
 
 	ComponentContainer<PowerUp> powerUps;
-	registry.powerUps = powerUps;
+	ctx.registry.powerUps = powerUps;
 
 }
 
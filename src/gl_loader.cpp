@@ -0,0 +1,3 @@
+// gl3w is header only, its loader is compiled once here for everything that links the engine
+#define GL3W_IMPLEMENTATION
+#include <gl3w.h>
@@ -0,0 +1,110 @@
+// internal
+#include "gl_state.hpp"
+
+GlStateCache gl_state;
+
+bool GlStateCache::changes(GLuint& cached, GLuint value)
+{
+	if (cached == value) {
+		elided++;
+		return false;
+	}
+	cached = value;
+	issued++;
+	return true;
+}
+
+void GlStateCache::useProgram(GLuint new_program)
+{
+	if (changes(program, new_program))
+		glUseProgram(new_program);
+}
+
+void GlStateCache::bindBuffer(GLenum target, GLuint buffer)
+{
+	if (target == GL_ARRAY_BUFFER) {
+		if (changes(array_buffer, buffer))
+			glBindBuffer(target, buffer);
+	}
+	else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		if (changes(element_buffer, buffer))
+			glBindBuffer(target, buffer);
+	}
+	else {
+		issued++;
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GlStateCache::activeTexture(GLenum unit)
+{
+	if (changes(active_unit, unit))
+		glActiveTexture(unit);
+}
+
+void GlStateCache::bindTexture(GLenum target, GLuint texture)
+{
+	GLuint unit = active_unit == UNKNOWN ? UNKNOWN : active_unit - GL_TEXTURE0;
+	if (target == GL_TEXTURE_2D && unit < MAX_TEXTURE_UNITS) {
+		if (changes(textures_2d[unit], texture))
+			glBindTexture(target, texture);
+	}
+	else {
+		issued++;
+		glBindTexture(target, texture);
+	}
+}
+
+void GlStateCache::bindVertexArray(GLuint vao)
+{
+	if (changes(vertex_array, vao)) {
+		glBindVertexArray(vao);
+		forgetVertexArrayState();
+	}
+}
+
+void GlStateCache::enableVertexAttribArray(GLuint index)
+{
+	if (index >= MAX_VERTEX_ATTRIBS) {
+		issued++;
+		glEnableVertexAttribArray(index);
+	}
+	else if (changes(attribs[index], 1))
+		glEnableVertexAttribArray(index);
+}
+
+void GlStateCache::disableVertexAttribArray(GLuint index)
+{
+	if (index >= MAX_VERTEX_ATTRIBS) {
+		issued++;
+		glDisableVertexAttribArray(index);
+	}
+	else if (changes(attribs[index], 0))
+		glDisableVertexAttribArray(index);
+}
+
+void GlStateCache::forgetVertexArrayState()
+{
+	element_buffer = UNKNOWN;
+	for (GLuint& attrib : attribs)
+		attrib = UNKNOWN;
+}
+
+void GlStateCache::invalidate()
+{
+	program = UNKNOWN;
+	array_buffer = UNKNOWN;
+	vertex_array = UNKNOWN;
+	active_unit = UNKNOWN;
+	for (GLuint& texture : textures_2d)
+		texture = UNKNOWN;
+	forgetVertexArrayState();
+}
+
+void GlStateCache::beginFrame()
+{
+	last_issued = issued;
+	last_elided = elided;
+	issued = 0;
+	elided = 0;
+}
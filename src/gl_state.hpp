@@ -0,0 +1,63 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+
+// stlib
+#include <atomic>
+
+// Remembers the GL binds the renderer makes during a frame and skips the ones
+// that would not change anything. Everything that binds programs, buffers or
+// textures, or toggles vertex attributes, while drawing goes through here.
+// Code that talks to GL directly has to call invalidate() afterwards.
+//
+// Vertex attribute enables and the element buffer belong to the bound VAO, so
+// switching VAOs forgets them.
+class GlStateCache
+{
+public:
+	static const unsigned int MAX_TEXTURE_UNITS = 16;
+	static const unsigned int MAX_VERTEX_ATTRIBS = 16;
+
+	GlStateCache() { invalidate(); }
+
+	void useProgram(GLuint program);
+	void bindBuffer(GLenum target, GLuint buffer);
+	void activeTexture(GLenum unit);
+	void bindTexture(GLenum target, GLuint texture);
+	void bindVertexArray(GLuint vao);
+	void enableVertexAttribArray(GLuint index);
+	void disableVertexAttribArray(GLuint index);
+
+	// Forget everything, the next call of each kind reaches GL
+	void invalidate();
+
+	// Starts counting a new frame, the previous frame's counts stay readable
+	void beginFrame();
+	unsigned int issuedLastFrame() const { return last_issued; }
+	unsigned int elidedLastFrame() const { return last_elided; }
+
+private:
+	// true when the call has to go to GL, updates the cached value
+	bool changes(GLuint& cached, GLuint value);
+	void forgetVertexArrayState();
+
+	static const GLuint UNKNOWN = ~0u;
+
+	GLuint program = UNKNOWN;
+	GLuint array_buffer = UNKNOWN;
+	GLuint element_buffer = UNKNOWN;
+	GLuint vertex_array = UNKNOWN;
+	GLuint active_unit = UNKNOWN;
+	GLuint textures_2d[MAX_TEXTURE_UNITS];
+	// UNKNOWN, 0 (disabled) or 1 (enabled)
+	GLuint attribs[MAX_VERTEX_ATTRIBS];
+
+	unsigned int issued = 0;
+	unsigned int elided = 0;
+	// read by the simulation thread while the render thread draws
+	std::atomic<unsigned int> last_issued { 0 };
+	std::atomic<unsigned int> last_elided { 0 };
+};
+
+extern GlStateCache gl_state;
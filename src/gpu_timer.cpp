@@ -0,0 +1,170 @@
+// internal
+#include "gpu_timer.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+	const char* PASS_NAMES[GpuTimer::PASS_COUNT] = {
+		"GPU background", "GPU foreground", "GPU particles", "GPU overlay", "GPU text", "GPU drawToScreen"
+	};
+}
+
+void GpuTimer::init()
+{
+	const char* env = getenv("GEN_GPU_TIMERS");
+	if (env != nullptr && strcmp(env, "0") == 0)
+		return;
+
+	// core since 3.3, but a driver may still report a counter without bits
+	GLint bits = 0;
+	glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+	if (gl_has_errors() || bits == 0) {
+		printf("GPU timers: not supported, GPU passes won't be timed\n");
+		return;
+	}
+
+	glGenQueries(LATENCY * PASS_COUNT, &queries[0][0]);
+	gl_has_errors();
+
+	if (track == nullptr)
+		track = &profiler.createTrack("GPU");
+	initialized = true;
+}
+
+void GpuTimer::release()
+{
+	if (!initialized)
+		return;
+	if (active_pass >= 0)
+		end();
+	glDeleteQueries(LATENCY * PASS_COUNT, &queries[0][0]);
+	initialized = false;
+}
+
+void GpuTimer::beginFrame()
+{
+	if (!initialized)
+		return;
+	if (active_pass >= 0)
+		end();
+
+	// offscreen contexts never swap, so nothing else makes sure last frame's queries reach the GPU
+	glFlush();
+
+	unsigned int slot = frame_count % LATENCY;
+	if (frames[slot].pending && !resolve(slot, false)) {
+		// reusing the queries throws the late results away
+		frames[slot].pending = false;
+		dropped++;
+	}
+
+	Frame& frame = frames[slot];
+	frame.number = frame_count++;
+	frame.pending = true;
+	std::fill(std::begin(frame.used), std::end(frame.used), false);
+}
+
+void GpuTimer::begin(PASS pass)
+{
+	if (!initialized || frame_count == 0)
+		return;
+	if (active_pass >= 0)
+		end();
+
+	unsigned int slot = (frame_count - 1) % LATENCY;
+	frames[slot].used[pass] = true;
+	frames[slot].submitted_ns[pass] = profiler.now();
+	glBeginQuery(GL_TIME_ELAPSED, queries[slot][pass]);
+	active_pass = pass;
+}
+
+void GpuTimer::end()
+{
+	if (!initialized || active_pass < 0)
+		return;
+	glEndQuery(GL_TIME_ELAPSED);
+	active_pass = -1;
+}
+
+bool GpuTimer::resolve(unsigned int slot, bool wait)
+{
+	Frame& frame = frames[slot];
+
+	if (!wait) {
+		for (unsigned int pass = 0; pass < PASS_COUNT; pass++) {
+			GLuint available = GL_TRUE;
+			if (frame.used[pass])
+				glGetQueryObjectuiv(queries[slot][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				return false;
+		}
+	}
+
+	GLuint64 elapsed_ns[PASS_COUNT] = {};
+	for (unsigned int pass = 0; pass < PASS_COUNT; pass++) {
+		if (frame.used[pass])
+			glGetQueryObjectui64v(queries[slot][pass], GL_QUERY_RESULT, &elapsed_ns[pass]);
+		// llvmpipe answers its very first query with the time since boot
+		if (elapsed_ns[pass] > MAX_PASS_NS) {
+			frame.pending = false;
+			dropped++;
+			return true;
+		}
+	}
+
+	float total_ms = 0.f;
+	bool any = false;
+	uint64_t frame_start = 0;
+	for (unsigned int pass = 0; pass < PASS_COUNT; pass++) {
+		if (!frame.used[pass])
+			continue;
+		total_ms += (float)elapsed_ns[pass] / 1000000.f;
+
+		uint64_t start = std::max(frame.submitted_ns[pass], track_end_ns);
+		if (!any)
+			frame_start = start;
+		any = true;
+		track_end_ns = start + elapsed_ns[pass];
+		profiler.record(*track, PASS_NAMES[pass], start, track_end_ns);
+	}
+	if (any)
+		profiler.record(*track, "GPU frame", frame_start, track_end_ns);
+
+	frame.pending = false;
+	resolved.push_back(std::make_pair(frame.number, total_ms));
+	// nobody takes them in a windowed run
+	if (resolved.size() > MAX_RESOLVED)
+		resolved.pop_front();
+	return true;
+}
+
+void GpuTimer::flush()
+{
+	if (!initialized)
+		return;
+	if (active_pass >= 0)
+		end();
+
+	// oldest first so the track stays in order
+	for (unsigned int i = 0; i < LATENCY; i++) {
+		unsigned int slot = (frame_count + i) % LATENCY;
+		if (frames[slot].pending)
+			resolve(slot, true);
+	}
+	if (dropped > 0)
+		printf("GPU timers: %u frames dropped, results were late or implausible\n", dropped);
+}
+
+bool GpuTimer::takeFrame(unsigned int& frame, float& gpu_ms)
+{
+	if (resolved.empty())
+		return false;
+	frame = resolved.front().first;
+	gpu_ms = resolved.front().second;
+	resolved.pop_front();
+	return true;
+}
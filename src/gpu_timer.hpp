@@ -0,0 +1,72 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <deque>
+#include <utility>
+
+// GL_TIME_ELAPSED queries around each render pass. Results are read LATENCY
+// frames after they were issued so asking for them never waits on the GPU.
+// Every pass lands in the profiler on a "GPU" track next to the CPU zones,
+// placed at the time it was submitted since elapsed queries have no timestamp.
+//
+//     gpu_timer.beginFrame();
+//     gpu_timer.begin(GpuTimer::BACKGROUND);
+//     ... draw ...
+//     gpu_timer.end();
+class GpuTimer
+{
+public:
+	enum PASS { BACKGROUND = 0, FOREGROUND, PARTICLES, OVERLAY, TEXT, SCREEN, PASS_COUNT };
+	// frames between issuing a frame's queries and reading them back
+	static const unsigned int LATENCY = 4;
+	// resolved frame totals kept for takeFrame()
+	static const unsigned int MAX_RESOLVED = 256;
+	// a pass longer than this is a driver bug, not a measurement
+	static const uint64_t MAX_PASS_NS = 1000000000ull;
+
+	// Needs a current context. Does nothing when the driver has no timer bits or GEN_GPU_TIMERS=0.
+	void init();
+	void release();
+	bool enabled() const { return initialized; }
+
+	// Reads back the frame issued LATENCY frames ago and starts the next one
+	void beginFrame();
+	// Only one pass can be timed at a time
+	void begin(PASS pass);
+	void end();
+
+	// Waits for every query still in flight, for the end of a run
+	void flush();
+
+	// Total GPU time of the oldest resolved frame not taken yet, frames count from 0
+	bool takeFrame(unsigned int& frame, float& gpu_ms);
+
+private:
+	struct Frame {
+		unsigned int number = 0;
+		bool pending = false;
+		bool used[PASS_COUNT] = {};
+		uint64_t submitted_ns[PASS_COUNT] = {};
+	};
+
+	// Returns false when wait is off and the results aren't there yet, true once the frame is done with
+	bool resolve(unsigned int slot, bool wait);
+
+	bool initialized = false;
+	GLuint queries[LATENCY][PASS_COUNT];
+	Frame frames[LATENCY];
+	unsigned int frame_count = 0;
+	int active_pass = -1;
+	// frames whose queries weren't done after LATENCY frames (dropped instead of
+	// stalling) or came back with nonsense
+	unsigned int dropped = 0;
+
+	Profiler::Track* track = nullptr;
+	// the GPU runs passes one after the other, the next one can't start before this
+	uint64_t track_end_ns = 0;
+	std::deque<std::pair<unsigned int, float>> resolved;
+};
@@ -0,0 +1,593 @@
+// internal
+#include "grid_search.hpp"
+#include "nav_table.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdlib>
+
+// Step of every Direction: UP, RIGHT, DOWN, LEFT
+static const int DX[4] = { 0, 1, 0, -1 };
+static const int DY[4] = { -1, 0, 1, 0 };
+
+static Direction opposite(Direction dir)
+{
+	return (Direction)((dir + 2) % 4);
+}
+
+static int manhattan(int a_column, int a_row, int b_column, int b_row)
+{
+	return abs(a_column - b_column) + abs(a_row - b_row);
+}
+
+static Search noPath()
+{
+	return Search(-1, -1, SearchPosition(0, 0));
+}
+
+void AStarPool::reset(size_t nodes)
+{
+	if (cost.size() < nodes) {
+		cost.resize(nodes);
+		fvalue.resize(nodes);
+		parent.resize(nodes);
+		arrived_by.resize(nodes);
+		stamp.resize(nodes, 0);
+		heap_index.resize(nodes);
+	}
+	heap.clear();
+	// wrapping around would make stale stamps look current
+	if (++search == 0) {
+		std::fill(stamp.begin(), stamp.end(), 0);
+		search = 1;
+	}
+}
+
+void AStarPool::open(int node, int node_cost, int node_fvalue, int from, Direction dir)
+{
+	bool was_seen = seen(node);
+	stamp[node] = search;
+	cost[node] = node_cost;
+	fvalue[node] = node_fvalue;
+	parent[node] = from;
+	arrived_by[node] = dir;
+	if (was_seen) {
+		siftUp(heap_index[node]);
+		return;
+	}
+	heap.push_back(node);
+	heap_index[node] = (int)heap.size() - 1;
+	siftUp((int)heap.size() - 1);
+}
+
+int AStarPool::pop()
+{
+	int top = heap[0];
+	int last = heap.back();
+	heap.pop_back();
+	if (!heap.empty()) {
+		place(0, last);
+		siftDown(0);
+	}
+	heap_index[top] = -1;
+	return top;
+}
+
+// Lower f first, on ties the node further along the path
+bool AStarPool::before(int a, int b) const
+{
+	return fvalue[a] < fvalue[b] || (fvalue[a] == fvalue[b] && cost[a] > cost[b]);
+}
+
+void AStarPool::place(int pos, int node)
+{
+	heap[pos] = node;
+	heap_index[node] = pos;
+}
+
+void AStarPool::siftUp(int pos)
+{
+	int node = heap[pos];
+	while (pos > 0) {
+		int up = (pos - 1) / 2;
+		if (!before(node, heap[up]))
+			break;
+		place(pos, heap[up]);
+		pos = up;
+	}
+	place(pos, node);
+}
+
+void AStarPool::siftDown(int pos)
+{
+	int node = heap[pos];
+	int size = (int)heap.size();
+	while (true) {
+		int child = pos * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && before(heap[child + 1], heap[child]))
+			child++;
+		if (!before(heap[child], node))
+			break;
+		place(pos, heap[child]);
+		pos = child;
+	}
+	place(pos, node);
+}
+
+GridMap::GridMap(int columns_arg, int rows_arg, uint8_t fill)
+	: columns(columns_arg), rows(rows_arg), walls((size_t)columns_arg * rows_arg, fill)
+{
+}
+
+GridMap GridMap::fromCells(const int* cells, int columns, int rows)
+{
+	GridMap map(columns, rows);
+	for (size_t i = 0; i < map.cells(); i++)
+		map.walls[i] = cells[i] != 0;
+	return map;
+}
+
+// Walks the parents back from goal. Every hop is a straight line in the direction it arrived by.
+static Search pathFromPool(const GridMap& map, const AStarPool& pool, int start, int goal)
+{
+	Search path = Search(pool.cost[goal], pool.cost[goal], SearchPosition(goal % map.columns, goal / map.columns));
+	for (int at = goal; at != start; at = pool.parent[at]) {
+		int from = pool.parent[at];
+		int length = manhattan(at % map.columns, at / map.columns, from % map.columns, from / map.columns);
+		path.dir.insert(path.dir.end(), length, pool.arrived_by[at]);
+	}
+	std::reverse(path.dir.begin(), path.dir.end());
+	return path;
+}
+
+Search gridAStar(const GridMap& map, SearchPosition start, SearchPosition goal, AStarPool& pool, const NavTable* nav)
+{
+	if (!map.open(start.x, start.y) || !map.open(goal.x, goal.y))
+		return noPath();
+
+	int start_cell = map.index(start.x, start.y);
+	int goal_cell = map.index(goal.x, goal.y);
+	if (nav && (nav->columns != map.columns || nav->rows != map.rows))
+		nav = nullptr;
+	// -1 from the table: that cell can't reach the goal at all
+	auto heuristic = [&](int column, int row) {
+		return nav ? nav->distance(map.index(column, row), goal_cell) : manhattan(column, row, goal.x, goal.y);
+	};
+	int start_h = heuristic(start.x, start.y);
+	if (start_h < 0)
+		return noPath();
+
+	pool.reset(map.cells());
+	pool.open(start_cell, 0, start_h, start_cell, UP);
+	while (!pool.empty()) {
+		int cell = pool.pop();
+		if (cell == goal_cell)
+			return pathFromPool(map, pool, start_cell, goal_cell);
+
+		int column = cell % map.columns;
+		int row = cell / map.columns;
+		for (int d = 0; d < 4; d++) {
+			int next_column = column + DX[d];
+			int next_row = row + DY[d];
+			if (!map.open(next_column, next_row))
+				continue;
+			int next = map.index(next_column, next_row);
+			int cost = pool.cost[cell] + 1;
+			if (pool.closed(next) || (pool.seen(next) && pool.cost[next] <= cost))
+				continue;
+			int h = heuristic(next_column, next_row);
+			if (h < 0)
+				continue;
+			pool.open(next, cost, cost + h, cell, (Direction)d);
+		}
+	}
+	return noPath();
+}
+
+Search latticeAStar(const GridMap& map, int cell_px, int xStart, int yStart, int xTarget, int yTarget, int stepSize, int tolerance, AStarPool& pool)
+{
+	int width_px = map.columns * cell_px;
+	int height_px = map.rows * cell_px;
+	if (xStart < 0 || yStart < 0 || xStart >= width_px || yStart >= height_px)
+		return noPath();
+
+	// The lattice: every point a whole number of steps from the start that is still inside the maze
+	int left = xStart / stepSize;
+	int up = yStart / stepSize;
+	int columns = left + (width_px - 1 - xStart) / stepSize + 1;
+	int rows = up + (height_px - 1 - yStart) / stepSize + 1;
+	auto xOf = [=](int node) { return xStart + (node % columns - left) * stepSize; };
+	auto yOf = [=](int node) { return yStart + (node / columns - up) * stepSize; };
+
+	pool.reset((size_t)columns * rows);
+	int start = up * columns + left;
+	pool.open(start, 0, manhattan(xStart, yStart, xTarget, yTarget), start, UP);
+
+	// left, right, up, down, the order the old search tried them in
+	const Direction moves[4] = { LEFT, RIGHT, UP, DOWN };
+	const int dx[4] = { -1, 1, 0, 0 };
+	const int dy[4] = { 0, 0, -1, 1 };
+
+	while (!pool.empty()) {
+		int node = pool.pop();
+		int currX = xOf(node);
+		int currY = yOf(node);
+
+		// Checks if you're near the target
+		if (abs(currX - xTarget) < tolerance && abs(currY - yTarget) < tolerance) {
+			Search path = Search(pool.fvalue[node], pool.cost[node], SearchPosition(currX, currY));
+			for (int at = node; at != start; at = pool.parent[at])
+				path.dir.push_back(pool.arrived_by[at]);
+			std::reverse(path.dir.begin(), path.dir.end());
+			return path;
+		}
+
+		int column = node % columns;
+		int row = node / columns;
+		for (int i = 0; i < 4; i++) {
+			int nextColumn = column + dx[i];
+			int nextRow = row + dy[i];
+			if (nextColumn < 0 || nextRow < 0 || nextColumn >= columns || nextRow >= rows)
+				continue;
+			int next = nextRow * columns + nextColumn;
+			if (pool.closed(next))
+				continue;
+			int nextX = currX + dx[i] * stepSize;
+			int nextY = currY + dy[i] * stepSize;
+			if (map.walls[map.index(nextX / cell_px, nextY / cell_px)])
+				continue;
+			int nextCost = pool.cost[node] + stepSize;
+			if (pool.seen(next) && pool.cost[next] <= nextCost)
+				continue;
+			pool.open(next, nextCost, nextCost + manhattan(nextX, nextY, xTarget, yTarget), node, moves[i]);
+		}
+	}
+	return noPath();
+}
+
+// A horizontal run only has to stop where a side opens up that was walled one
+// cell back, a shortest path could only get there by turning here
+static bool forcedTurn(const GridMap& map, int column, int row, int dx)
+{
+	return (map.open(column, row - 1) && !map.open(column - dx, row - 1)) ||
+		(map.open(column, row + 1) && !map.open(column - dx, row + 1));
+}
+
+// Where a run from (column, row) along dir stops: the goal or a cell a shortest
+// path might turn at. -1 if it runs into a wall first. Vertical runs look
+// sideways from every cell, a horizontal run finding something makes the cell a turn.
+static int jump(const GridMap& map, int column, int row, Direction dir, int goal)
+{
+	int dx = DX[dir];
+	int dy = DY[dir];
+	while (true) {
+		column += dx;
+		row += dy;
+		if (!map.open(column, row))
+			return -1;
+		int cell = map.index(column, row);
+		if (cell == goal)
+			return cell;
+		if (dx != 0) {
+			if (forcedTurn(map, column, row, dx))
+				return cell;
+		}
+		else if (jump(map, column, row, LEFT, goal) >= 0 || jump(map, column, row, RIGHT, goal) >= 0) {
+			return cell;
+		}
+	}
+}
+
+Search jumpPointSearch(const GridMap& map, SearchPosition start, SearchPosition goal, AStarPool& pool)
+{
+	if (!map.open(start.x, start.y) || !map.open(goal.x, goal.y))
+		return noPath();
+
+	pool.reset(map.cells());
+	int start_cell = map.index(start.x, start.y);
+	int goal_cell = map.index(goal.x, goal.y);
+	pool.open(start_cell, 0, manhattan(start.x, start.y, goal.x, goal.y), start_cell, UP);
+	while (!pool.empty()) {
+		int cell = pool.pop();
+		if (cell == goal_cell)
+			return pathFromPool(map, pool, start_cell, goal_cell);
+
+		int column = cell % map.columns;
+		int row = cell / map.columns;
+
+		// Pruned directions: all four from the start, straight on and the forced
+		// turns after a horizontal run, straight on and both sides after a vertical one
+		Direction dirs[4];
+		int count = 0;
+		if (cell == start_cell) {
+			for (int d = 0; d < 4; d++)
+				dirs[count++] = (Direction)d;
+		}
+		else {
+			Direction came = pool.arrived_by[cell];
+			dirs[count++] = came;
+			if (came == LEFT || came == RIGHT) {
+				int dx = DX[came];
+				if (map.open(column, row - 1) && !map.open(column - dx, row - 1))
+					dirs[count++] = UP;
+				if (map.open(column, row + 1) && !map.open(column - dx, row + 1))
+					dirs[count++] = DOWN;
+			}
+			else {
+				dirs[count++] = LEFT;
+				dirs[count++] = RIGHT;
+			}
+		}
+
+		for (int i = 0; i < count; i++) {
+			int next = jump(map, column, row, dirs[i], goal_cell);
+			if (next < 0 || pool.closed(next))
+				continue;
+			int next_column = next % map.columns;
+			int next_row = next / map.columns;
+			int cost = pool.cost[cell] + manhattan(column, row, next_column, next_row);
+			if (pool.seen(next) && pool.cost[next] <= cost)
+				continue;
+			pool.open(next, cost, cost + manhattan(next_column, next_row, goal.x, goal.y), cell, dirs[i]);
+		}
+	}
+	return noPath();
+}
+
+void ClusterGraph::build(const GridMap& map_arg, int cluster_size_arg)
+{
+	map = map_arg;
+	cluster_size = std::max(2, cluster_size_arg);
+	clusters_x = (map.columns + cluster_size - 1) / cluster_size;
+	clusters_y = (map.rows + cluster_size - 1) / cluster_size;
+	nodes.clear();
+	edges.clear();
+	steps.clear();
+	cluster_nodes.assign((size_t)clusters_x * clusters_y, std::vector<int>());
+	node_of_cell.assign(map.cells(), -1);
+	bfs_distance.resize(map.cells());
+	bfs_from.resize(map.cells());
+	bfs_stamp.assign(map.cells(), 0);
+	bfs_search = 0;
+	bfs_queue.resize(map.cells());
+
+	// entrances across every border between clusters side by side, then every one between clusters above each other
+	for (int cy = 0; cy < clusters_y; cy++) {
+		for (int cx = 0; cx + 1 < clusters_x; cx++) {
+			int y0 = cy * cluster_size;
+			addEntrances((cx + 1) * cluster_size - 1, y0, 0, 1, std::min(cluster_size, map.rows - y0));
+		}
+	}
+	for (int cy = 0; cy + 1 < clusters_y; cy++) {
+		for (int cx = 0; cx < clusters_x; cx++) {
+			int x0 = cx * cluster_size;
+			addEntrances(x0, (cy + 1) * cluster_size - 1, 1, 0, std::min(cluster_size, map.columns - x0));
+		}
+	}
+
+	// the paths between every two nodes of a cluster that can reach each other inside it
+	for (const std::vector<int>& members : cluster_nodes) {
+		for (int from : members) {
+			searchCluster(nodes[from].cell);
+			for (int to : members) {
+				if (to != from && bfs_stamp[nodes[to].cell] == bfs_search)
+					addEdge(from, to, nodes[to].cell, false);
+			}
+		}
+	}
+}
+
+size_t ClusterGraph::edgeCount() const
+{
+	size_t count = 0;
+	for (const std::vector<Edge>& list : edges)
+		count += list.size();
+	return count;
+}
+
+int ClusterGraph::clusterOf(int cell) const
+{
+	int column = cell % map.columns;
+	int row = cell / map.columns;
+	return (row / cluster_size) * clusters_x + column / cluster_size;
+}
+
+int ClusterGraph::addNode(int cell)
+{
+	if (node_of_cell[cell] >= 0)
+		return node_of_cell[cell];
+	int node = (int)nodes.size();
+	nodes.push_back({ cell, clusterOf(cell) });
+	edges.emplace_back();
+	cluster_nodes[nodes.back().cluster].push_back(node);
+	node_of_cell[cell] = node;
+	return node;
+}
+
+// Walks the length cells of a border from (x0, y0) along (dx, dy). The other
+// side of the border is one cell across, right of a vertical border or below a
+// horizontal one. Every run of cells open on both sides is an entrance.
+void ClusterGraph::addEntrances(int x0, int y0, int dx, int dy, int length)
+{
+	Direction across = dx == 0 ? RIGHT : DOWN;
+	auto cross = [&](int i) {
+		int column = x0 + i * dx;
+		int row = y0 + i * dy;
+		int a = addNode(map.index(column, row));
+		int b = addNode(map.index(column + dy, row + dx));
+		edges[a].push_back({ b, 1, steps.size() });
+		steps.push_back(across);
+		edges[b].push_back({ a, 1, steps.size() });
+		steps.push_back(opposite(across));
+	};
+
+	int run_start = -1;
+	for (int i = 0; i <= length; i++) {
+		int column = x0 + i * dx;
+		int row = y0 + i * dy;
+		bool open = i < length && map.open(column, row) && map.open(column + dy, row + dx);
+		if (open && run_start < 0)
+			run_start = i;
+		if (!open && run_start >= 0) {
+			// wide entrances get a crossing at each end, narrow ones one in the middle
+			if (i - run_start >= 6) {
+				cross(run_start);
+				cross(i - 1);
+			}
+			else {
+				cross(run_start + (i - run_start) / 2);
+			}
+			run_start = -1;
+		}
+	}
+}
+
+void ClusterGraph::searchCluster(int cell)
+{
+	if (++bfs_search == 0) {
+		std::fill(bfs_stamp.begin(), bfs_stamp.end(), 0);
+		bfs_search = 1;
+	}
+	int cluster = clusterOf(cell);
+	int min_x = (cluster % clusters_x) * cluster_size;
+	int min_y = (cluster / clusters_x) * cluster_size;
+	int max_x = std::min(min_x + cluster_size, map.columns);
+	int max_y = std::min(min_y + cluster_size, map.rows);
+
+	size_t head = 0, tail = 0;
+	bfs_stamp[cell] = bfs_search;
+	bfs_distance[cell] = 0;
+	bfs_queue[tail++] = cell;
+	while (head < tail) {
+		int at = bfs_queue[head++];
+		int column = at % map.columns;
+		int row = at / map.columns;
+		for (int d = 0; d < 4; d++) {
+			int next_column = column + DX[d];
+			int next_row = row + DY[d];
+			if (next_column < min_x || next_row < min_y || next_column >= max_x || next_row >= max_y)
+				continue;
+			int next = map.index(next_column, next_row);
+			if (map.walls[next] || bfs_stamp[next] == bfs_search)
+				continue;
+			bfs_stamp[next] = bfs_search;
+			bfs_distance[next] = bfs_distance[at] + 1;
+			bfs_from[next] = (Direction)d;
+			bfs_queue[tail++] = next;
+		}
+	}
+}
+
+void ClusterGraph::appendClusterPath(int target_cell, bool reversed)
+{
+	size_t path_start = steps.size();
+	for (int at = target_cell; bfs_distance[at] > 0;) {
+		Direction dir = bfs_from[at];
+		steps.push_back(reversed ? opposite(dir) : dir);
+		at = map.index(at % map.columns - DX[dir], at / map.columns - DY[dir]);
+	}
+	// walking back gives the directions last to first, which is already the way back
+	if (!reversed)
+		std::reverse(steps.begin() + path_start, steps.end());
+}
+
+void ClusterGraph::addEdge(int from, int to, int target_cell, bool reversed)
+{
+	size_t path_start = steps.size();
+	appendClusterPath(target_cell, reversed);
+	edges[from].push_back({ to, bfs_distance[target_cell], path_start });
+}
+
+Search ClusterGraph::findPath(SearchPosition start, SearchPosition goal)
+{
+	if (!map.open(start.x, start.y) || !map.open(goal.x, goal.y))
+		return noPath();
+	int start_cell = map.index(start.x, start.y);
+	int goal_cell = map.index(goal.x, goal.y);
+	int goal_cluster = clusterOf(goal_cell);
+
+	// both ends in one cluster: a path that stays inside it is nearly always the one
+	if (clusterOf(start_cell) == goal_cluster) {
+		searchCluster(start_cell);
+		if (bfs_stamp[goal_cell] == bfs_search) {
+			Search path = Search(bfs_distance[goal_cell], bfs_distance[goal_cell], goal);
+			size_t base_steps = steps.size();
+			appendClusterPath(goal_cell, false);
+			path.dir.assign(steps.begin() + base_steps, steps.end());
+			steps.resize(base_steps);
+			return path;
+		}
+	}
+
+	// ends that aren't graph nodes already join it for this query only
+	size_t base_nodes = nodes.size();
+	size_t base_steps = steps.size();
+	std::vector<int> linked;
+	int start_node = node_of_cell[start_cell];
+	if (start_node < 0) {
+		start_node = (int)nodes.size();
+		nodes.push_back({ start_cell, clusterOf(start_cell) });
+		edges.emplace_back();
+		searchCluster(start_cell);
+		for (int node : cluster_nodes[nodes[start_node].cluster]) {
+			if (bfs_stamp[nodes[node].cell] == bfs_search)
+				addEdge(start_node, node, nodes[node].cell, false);
+		}
+	}
+	int goal_node = node_of_cell[goal_cell];
+	if (goal_node < 0) {
+		goal_node = (int)nodes.size();
+		nodes.push_back({ goal_cell, goal_cluster });
+		edges.emplace_back();
+		searchCluster(goal_cell);
+		for (int node : cluster_nodes[goal_cluster]) {
+			if (bfs_stamp[nodes[node].cell] == bfs_search) {
+				addEdge(node, goal_node, nodes[node].cell, true);
+				linked.push_back(node);
+			}
+		}
+	}
+
+	pool.reset(nodes.size());
+	via_edge.resize(nodes.size());
+	auto heuristic = [&](int node) {
+		int cell = nodes[node].cell;
+		return manhattan(cell % map.columns, cell / map.columns, goal.x, goal.y);
+	};
+	pool.open(start_node, 0, heuristic(start_node), start_node, UP);
+	bool found = false;
+	while (!pool.empty()) {
+		int node = pool.pop();
+		if (node == goal_node) {
+			found = true;
+			break;
+		}
+		for (size_t i = 0; i < edges[node].size(); i++) {
+			const Edge& edge = edges[node][i];
+			int cost = pool.cost[node] + edge.cost;
+			if (pool.closed(edge.to) || (pool.seen(edge.to) && pool.cost[edge.to] <= cost))
+				continue;
+			pool.open(edge.to, cost, cost + heuristic(edge.to), node, UP);
+			via_edge[edge.to] = (int)i;
+		}
+	}
+
+	Search path = noPath();
+	if (found) {
+		path = Search(pool.cost[goal_node], pool.cost[goal_node], goal);
+		std::vector<const Edge*> route;
+		for (int at = goal_node; at != start_node; at = pool.parent[at])
+			route.push_back(&edges[pool.parent[at]][via_edge[at]]);
+		for (auto it = route.rbegin(); it != route.rend(); ++it)
+			path.dir.insert(path.dir.end(), steps.begin() + (*it)->path_start, steps.begin() + (*it)->path_start + (*it)->cost);
+	}
+
+	for (int node : linked)
+		edges[node].pop_back();
+	nodes.resize(base_nodes);
+	edges.resize(base_nodes);
+	steps.resize(base_steps);
+	return path;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+
+// stlib
+#include <cstdint>
+#include <vector>
+
+struct SearchPosition
+{
+	int x, y;
+	SearchPosition(int initX, int initY) : x(initX), y(initY) {}
+
+	bool operator==(const SearchPosition& other) const {
+		return x == other.x && y == other.y;
+	}
+};
+
+struct Search {
+	int fvalue;
+	int cost;
+	SearchPosition lastNode;
+	std::vector<Direction> dir;
+	Search(int val, int costs, SearchPosition newNode) : fvalue(val), cost(costs), lastNode(newNode) {}
+
+	bool operator<(const Search& other) const {
+		return fvalue > other.fvalue;
+	}
+};
+
+// Scratch space for the A* searches, one slot per node and kept between
+// searches so planning doesn't allocate. A node whose stamp isn't the current
+// search hasn't been seen yet, so nothing needs clearing.
+struct AStarPool {
+	std::vector<int> cost;
+	std::vector<int> fvalue;
+	std::vector<int> parent;
+	std::vector<Direction> arrived_by;
+	std::vector<unsigned int> stamp;
+	// where the node sits in the heap, -1 once it's been expanded
+	std::vector<int> heap_index;
+	// binary min heap of node indices on fvalue
+	std::vector<int> heap;
+	unsigned int search = 0;
+
+	void reset(size_t nodes);
+	bool seen(int node) const { return stamp[node] == search; }
+	bool closed(int node) const { return seen(node) && heap_index[node] < 0; }
+	// Adds the node or lowers its fvalue if it's already open
+	void open(int node, int node_cost, int node_fvalue, int from, Direction dir);
+	int pop();
+	bool empty() const { return heap.empty(); }
+
+private:
+	bool before(int a, int b) const;
+	void place(int pos, int node);
+	void siftUp(int pos);
+	void siftDown(int pos);
+};
+
+// Walls of a maze of any size, one byte per cell, row major. Non zero is a wall.
+struct GridMap {
+	int columns = 0;
+	int rows = 0;
+	std::vector<uint8_t> walls;
+
+	GridMap() {}
+	GridMap(int columns, int rows, uint8_t fill = 0);
+	// From an int maze laid out like SimContext::maze
+	static GridMap fromCells(const int* cells, int columns, int rows);
+
+	size_t cells() const { return walls.size(); }
+	int index(int column, int row) const { return row * columns + column; }
+	bool contains(int column, int row) const { return column >= 0 && row >= 0 && column < columns && row < rows; }
+	bool open(int column, int row) const { return contains(column, row) && !walls[index(column, row)]; }
+};
+
+// The grid searches take cells for positions and hand back one Direction per
+// cell stepped, lastNode is the goal and cost the number of steps. No path
+// leaves dir empty with a cost of -1.
+
+// A* in pixels over the points stepSize apart from the start, on a map of
+// cell_px square cells. Done once within tolerance of the target, lastNode is
+// where it stopped and every Direction in dir is one stepSize step.
+Search latticeAStar(const GridMap& map, int cell_px, int xStart, int yStart, int xTarget, int yTarget, int stepSize, int tolerance, AStarPool& pool);
+
+class NavTable;
+
+// Plain A* over the cells, mostly there to compare the others against. With a
+// NavTable built for the same map its distances are the heuristic, and being
+// exact they lead it straight down a shortest path.
+Search gridAStar(const GridMap& map, SearchPosition start, SearchPosition goal, AStarPool& pool, const NavTable* nav = nullptr);
+
+// Jump point search for 4 connected grids where every step costs the same.
+// Straight runs are skipped over and only the cells a shortest path may turn
+// at go on the open list, so open areas and long corridors cost little.
+Search jumpPointSearch(const GridMap& map, SearchPosition start, SearchPosition goal, AStarPool& pool);
+
+// HPA*: the grid cut into square clusters, with graph nodes on both sides of
+// every entrance between neighbouring clusters and the paths between the nodes
+// of each cluster found ahead of time. A query searches inside the start and
+// goal clusters and over the small graph, so it barely depends on the grid's
+// size. Paths are close to, but not always, the shortest. Build it once the
+// maze is carved.
+//
+//     ClusterGraph graph;
+//     graph.build(map, 16);
+//     Search path = graph.findPath(SearchPosition(0, 0), SearchPosition(511, 511));
+class ClusterGraph
+{
+public:
+	void build(const GridMap& map, int cluster_size = 16);
+	Search findPath(SearchPosition start, SearchPosition goal);
+
+	size_t nodeCount() const { return nodes.size(); }
+	size_t edgeCount() const;
+
+private:
+	struct Node {
+		int cell;
+		int cluster;
+	};
+	struct Edge {
+		int to;
+		int cost;
+		// directions of the path in steps
+		size_t path_start;
+	};
+
+	int clusterOf(int cell) const;
+	int addNode(int cell);
+	void addEntrances(int x0, int y0, int dx, int dy, int length);
+	// Breadth first inside one cluster, fills bfs_distance and bfs_from
+	void searchCluster(int cell);
+	// Appends the path searchCluster found to target_cell to steps, or the way back from it when reversed
+	void appendClusterPath(int target_cell, bool reversed);
+	void addEdge(int from, int to, int target_cell, bool reversed);
+
+	GridMap map;
+	int cluster_size = 16;
+	int clusters_x = 0;
+	int clusters_y = 0;
+	std::vector<Node> nodes;
+	std::vector<std::vector<Edge>> edges;
+	std::vector<std::vector<int>> cluster_nodes;
+	std::vector<int> node_of_cell;
+	std::vector<Direction> steps;
+
+	// scratch for the searches
+	std::vector<int> bfs_distance;
+	std::vector<Direction> bfs_from;
+	std::vector<unsigned int> bfs_stamp;
+	unsigned int bfs_search = 0;
+	std::vector<int> bfs_queue;
+	std::vector<int> via_edge;
+	AStarPool pool;
+};
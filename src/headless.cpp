@@ -0,0 +1,340 @@
+// internal
+#include "headless.hpp"
+#include "common.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// EGL is only wired up on Linux, the CI and benchmark boxes
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GEN_HAS_EGL 1
+#endif
+
+HeadlessOptions parseHeadlessOptions(int argc, char* argv[])
+{
+	HeadlessOptions options;
+
+	const char* env = getenv("GEN_HEADLESS");
+	if (env != nullptr && strcmp(env, "0") != 0)
+		options.enabled = true;
+
+	const char* trace_env = getenv("GEN_TRACE");
+	if (trace_env != nullptr)
+		options.trace_path = trace_env;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--headless") {
+			options.enabled = true;
+		}
+		else if (arg == "--frames" && has_value) {
+			options.frames = atoi(argv[++i]);
+		}
+		else if (arg == "--state" && has_value) {
+			options.start_state = atoi(argv[++i]);
+		}
+		else if (arg == "--dump-frames" && has_value) {
+			options.dump_dir = argv[++i];
+		}
+		else if (arg == "--dump-every" && has_value) {
+			options.dump_every = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--timings" && has_value) {
+			options.timings_path = argv[++i];
+		}
+		else if (arg == "--simulate" && has_value) {
+			// the renderer still needs a context to load its assets
+			options.enabled = true;
+			options.simulate_ticks = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--trace" && has_value) {
+			options.trace_path = argv[++i];
+		}
+		else if (arg == "--record" && has_value) {
+			options.record_path = argv[++i];
+		}
+		else if (arg == "--replay" && has_value) {
+			options.enabled = true;
+			options.replay_path = argv[++i];
+		}
+		else if (arg == "--batch" && has_value) {
+			options.batch_runs = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--batch-out" && has_value) {
+			options.batch_out = argv[++i];
+		}
+		else if (arg == "--batch-runs" && has_value) {
+			options.batch_runs_path = argv[++i];
+		}
+		else if (arg == "--batch-seed" && has_value) {
+			options.batch_seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--batch-ticks" && has_value) {
+			options.batch_ticks = (uint32_t)std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--batch-threads" && has_value) {
+			options.batch_threads = (unsigned int)std::max(0, atoi(argv[++i]));
+		}
+		else if (arg == "--batch-script" && has_value) {
+			options.batch_script = argv[++i];
+		}
+		else if (arg == "--sweep" && has_value) {
+			options.sweeps.push_back(argv[++i]);
+		}
+	}
+
+	return options;
+}
+
+#ifdef GEN_HAS_EGL
+bool HeadlessContext::init(int width, int height)
+{
+	EGLDisplay egl_display = EGL_NO_DISPLAY;
+
+	// Prefer the surfaceless platform so no X server or DRM node is needed
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+	PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (get_platform_display != nullptr)
+		egl_display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+	if (egl_display == EGL_NO_DISPLAY)
+		egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, &major, &minor)) {
+		fprintf(stderr, "Failed to initialize EGL\n");
+		return false;
+	}
+	display = egl_display;
+
+	const EGLint config_attribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint num_configs = 0;
+	if (!eglChooseConfig(egl_display, config_attribs, &config, 1, &num_configs) || num_configs == 0) {
+		fprintf(stderr, "No EGL config with pbuffer and desktop GL support\n");
+		return false;
+	}
+
+	const EGLint pbuffer_attribs[] = {
+		EGL_WIDTH, width,
+		EGL_HEIGHT, height,
+		EGL_NONE
+	};
+	surface = eglCreatePbufferSurface(egl_display, config, pbuffer_attribs);
+	if (surface == EGL_NO_SURFACE) {
+		fprintf(stderr, "Failed to create EGL pbuffer\n");
+		return false;
+	}
+
+	// Same context version as the GLFW window
+	eglBindAPI(EGL_OPENGL_API);
+	const EGLint context_attribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, context_attribs);
+	if (context == EGL_NO_CONTEXT) {
+		fprintf(stderr, "Failed to create an OpenGL 3.3 core EGL context\n");
+		return false;
+	}
+
+	if (!eglMakeCurrent(egl_display, surface, surface, context)) {
+		fprintf(stderr, "Failed to make the EGL context current\n");
+		return false;
+	}
+
+	printf("Headless EGL %d.%d context ready (%dx%d)\n", major, minor, width, height);
+	return true;
+}
+
+void HeadlessContext::release()
+{
+	if (display == nullptr)
+		return;
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (context != nullptr)
+		eglDestroyContext(display, context);
+	if (surface != nullptr)
+		eglDestroySurface(display, surface);
+	eglTerminate(display);
+	display = nullptr;
+	surface = nullptr;
+	context = nullptr;
+}
+#else
+bool HeadlessContext::init(int width, int height)
+{
+	fprintf(stderr, "Headless mode needs EGL, which is only set up on Linux\n");
+	return false;
+}
+
+void HeadlessContext::release()
+{
+}
+#endif
+
+namespace {
+	uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0)
+	{
+		static uint32_t table[256];
+		static bool table_ready = false;
+		if (!table_ready) {
+			for (uint32_t n = 0; n < 256; n++) {
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				table[n] = c;
+			}
+			table_ready = true;
+		}
+		crc = ~crc;
+		for (size_t i = 0; i < length; i++)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	void putU32(std::vector<uint8_t>& out, uint32_t v)
+	{
+		out.push_back((uint8_t)(v >> 24));
+		out.push_back((uint8_t)(v >> 16));
+		out.push_back((uint8_t)(v >> 8));
+		out.push_back((uint8_t)v);
+	}
+
+	void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> chunk;
+		putU32(chunk, (uint32_t)data.size());
+		chunk.insert(chunk.end(), type, type + 4);
+		chunk.insert(chunk.end(), data.begin(), data.end());
+		std::vector<uint8_t> crc;
+		putU32(crc, crc32(chunk.data() + 4, chunk.size() - 4));
+		chunk.insert(chunk.end(), crc.begin(), crc.end());
+		file.write((const char*)chunk.data(), chunk.size());
+	}
+}
+
+// Uncompressed (stored deflate blocks) png, the frames are for diffing not for sharing
+bool saveFramebufferPNG(const std::string& path, int width, int height)
+{
+	std::vector<uint8_t> pixels((size_t)width * height * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	gl_has_errors();
+
+	// GL rows go bottom to top, png rows top to bottom, each prefixed by filter type 0
+	const size_t row_bytes = (size_t)width * 4;
+	std::vector<uint8_t> raw;
+	raw.reserve((row_bytes + 1) * height);
+	for (int y = height - 1; y >= 0; y--) {
+		raw.push_back(0);
+		raw.insert(raw.end(), pixels.begin() + y * row_bytes, pixels.begin() + (y + 1) * row_bytes);
+	}
+
+	std::vector<uint8_t> zlib = { 0x78, 0x01 };
+	const size_t max_block = 65535;
+	for (size_t offset = 0; offset < raw.size() || offset == 0; offset += max_block) {
+		size_t len = std::min(max_block, raw.size() - offset);
+		bool last = offset + len >= raw.size();
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back((uint8_t)(len & 0xFF));
+		zlib.push_back((uint8_t)(len >> 8));
+		zlib.push_back((uint8_t)(~len & 0xFF));
+		zlib.push_back((uint8_t)((~len >> 8) & 0xFF));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + len);
+		if (last)
+			break;
+	}
+	uint32_t a = 1, b = 0;
+	for (uint8_t byte : raw) {
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	putU32(zlib, (b << 16) | a);
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+
+	const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	file.write((const char*)signature, 8);
+
+	std::vector<uint8_t> header;
+	putU32(header, (uint32_t)width);
+	putU32(header, (uint32_t)height);
+	header.push_back(8); // bit depth
+	header.push_back(6); // RGBA
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	writeChunk(file, "IHDR", header);
+	writeChunk(file, "IDAT", zlib);
+	writeChunk(file, "IEND", {});
+
+	return file.good();
+}
+
+void FrameTimings::add(float cpu_ms, float gpu_ms)
+{
+	cpu.push_back(cpu_ms);
+	gpu.push_back(gpu_ms);
+}
+
+void FrameTimings::setGpu(unsigned int frame, float gpu_ms)
+{
+	if (frame < gpu.size())
+		gpu[frame] = gpu_ms;
+}
+
+void FrameTimings::printSummary() const
+{
+	if (cpu.empty())
+		return;
+
+	auto report = [](const char* name, std::vector<float> times) {
+		std::sort(times.begin(), times.end());
+		float total = 0.f;
+		for (float t : times)
+			total += t;
+		printf("%s ms: avg %.3f  p50 %.3f  p99 %.3f  max %.3f\n", name,
+			total / times.size(), times[times.size() / 2],
+			times[std::min(times.size() - 1, times.size() * 99 / 100)], times.back());
+	};
+
+	printf("Headless run: %d frames\n", (int)cpu.size());
+	report("CPU", cpu);
+	report("GPU", gpu);
+}
+
+bool FrameTimings::writeCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+	file << "frame,cpu_ms,gpu_ms\n";
+	for (size_t i = 0; i < cpu.size(); i++)
+		file << i << "," << cpu[i] << "," << gpu[i] << "\n";
+	return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Options for running without a display, from the command line or GEN_HEADLESS
+//   --headless             render into an offscreen EGL pbuffer (llvmpipe works)
+//   --frames N             number of frames to run before exiting
+//   --state N              jump straight to a GAME_STATES value
+//   --dump-frames DIR      write every dump_every'th frame to DIR/frame_XXXXX.png
+//   --dump-every N
+//   --timings FILE         per frame CPU and GPU times as CSV
+//   --simulate N           run N fixed steps without drawing and report ticks per second
+//   --trace FILE           write the profiler zones as a Chrome trace on exit, windowed runs too (or GEN_TRACE)
+//   --record FILE          windowed runs save their seed and input to FILE on exit
+//   --replay FILE          play a recording back without drawing, report the time per tick and a state checksum
+//   --batch N              play N games of the --state minigame per tuning set on every core, no GL or audio
+//   --batch-out FILE       win rate, time to finish and items per tuning set as CSV (default batch.csv)
+//   --batch-runs FILE      one CSV row per game as well
+//   --batch-seed N         game i plays seed N + i
+//   --batch-ticks N        steps before a game counts as a timeout
+//   --batch-threads N      default one per core
+//   --batch-script FILE    play a recording in every game instead of the bot
+//   --sweep NAME=A,B,...   try every value of a SimTuning field, repeat for a grid
+struct HeadlessOptions {
+	bool enabled = false;
+	int frames = 600;
+	int simulate_ticks = 0;
+	int start_state = -1;
+	std::string dump_dir;
+	int dump_every = 60;
+	std::string timings_path;
+	std::string trace_path;
+	std::string record_path;
+	std::string replay_path;
+	int batch_runs = 0;
+	std::string batch_out = "batch.csv";
+	std::string batch_runs_path;
+	uint32_t batch_seed = 1;
+	uint32_t batch_ticks = 10800;
+	unsigned int batch_threads = 0;
+	std::string batch_script;
+	std::vector<std::string> sweeps;
+};
+
+HeadlessOptions parseHeadlessOptions(int argc, char* argv[]);
+
+// Offscreen OpenGL 3.3 core context through EGL. The pbuffer surface backs the
+// default framebuffer so the render system can draw exactly as it does on screen.
+class HeadlessContext
+{
+public:
+	bool init(int width, int height);
+	void release();
+	~HeadlessContext() { release(); }
+
+private:
+	void* display = nullptr;
+	void* surface = nullptr;
+	void* context = nullptr;
+};
+
+// Reads back the bound read framebuffer and writes it as an RGBA png
+bool saveFramebufferPNG(const std::string& path, int width, int height);
+
+// Per frame timings collected by the headless loop
+class FrameTimings
+{
+public:
+	void add(float cpu_ms, float gpu_ms);
+	// GPU timer results arrive a few frames after the frame was added
+	void setGpu(unsigned int frame, float gpu_ms);
+	void printSummary() const;
+	bool writeCSV(const std::string& path) const;
+
+private:
+	std::vector<float> cpu;
+	std::vector<float> gpu;
+};
@@ -0,0 +1,185 @@
+// internal
+#include "input_recording.hpp"
+
+// stlib
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// File layout, little endian:
+//   "GENR", u8 version, u32 seed, u8 start state, u32 ticks, u32 event count
+//   per event: varint ticks since the previous event, u8 type, then
+//     key:         i16 key, u8 action, u8 mods
+//     mouse click: u8 button, u8 action, u8 mods, i16 x, i16 y
+// Version 1 clicks have no position, they load as (0, 0).
+static const char MAGIC[4] = { 'G', 'E', 'N', 'R' };
+static const uint8_t VERSION = 2;
+
+namespace {
+	class Writer
+	{
+	public:
+		std::vector<uint8_t> bytes;
+
+		void u8(uint8_t value) { bytes.push_back(value); }
+		void u16(uint16_t value) { u8(value & 0xff); u8(value >> 8); }
+		void u32(uint32_t value) { u16(value & 0xffff); u16(value >> 16); }
+		void varint(uint32_t value)
+		{
+			while (value >= 0x80) {
+				u8((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+			u8((uint8_t)value);
+		}
+	};
+
+	// Every read fails once the data runs out, ok() tells at the end
+	class Reader
+	{
+	public:
+		Reader(const std::vector<uint8_t>& bytes) : bytes(bytes) {}
+
+		bool ok() const { return !overrun; }
+		uint8_t u8()
+		{
+			if (offset >= bytes.size()) {
+				overrun = true;
+				return 0;
+			}
+			return bytes[offset++];
+		}
+		uint16_t u16() { uint16_t low = u8(); return (uint16_t)(low | (u8() << 8)); }
+		uint32_t u32() { uint32_t low = u16(); return low | ((uint32_t)u16() << 16); }
+		uint32_t varint()
+		{
+			uint32_t value = 0;
+			for (int shift = 0; shift < 35; shift += 7) {
+				uint8_t byte = u8();
+				value |= (uint32_t)(byte & 0x7f) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+			overrun = true;
+			return 0;
+		}
+
+	private:
+		const std::vector<uint8_t>& bytes;
+		size_t offset = 0;
+		bool overrun = false;
+	};
+}
+
+void InputRecording::add(const InputEvent& event)
+{
+	assert((events.empty() || events.back().tick <= event.tick) && "Input events out of tick order");
+	events.push_back(event);
+}
+
+bool InputRecording::save(const std::string& path) const
+{
+	Writer out;
+	out.bytes.insert(out.bytes.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	out.u8(VERSION);
+	out.u32(seed);
+	out.u8((uint8_t)start_state);
+	out.u32(ticks);
+	out.u32((uint32_t)events.size());
+
+	uint32_t previous_tick = 0;
+	for (const InputEvent& event : events) {
+		out.varint(event.tick - previous_tick);
+		previous_tick = event.tick;
+		out.u8((uint8_t)event.type);
+		switch (event.type) {
+		case INPUT_EVENT_TYPE::KEY:
+			out.u16((uint16_t)(int16_t)event.code);
+			out.u8((uint8_t)event.action);
+			out.u8((uint8_t)event.mods);
+			break;
+		case INPUT_EVENT_TYPE::MOUSE_CLICK:
+			out.u8((uint8_t)event.code);
+			out.u8((uint8_t)event.action);
+			out.u8((uint8_t)event.mods);
+			out.u16((uint16_t)(int16_t)event.x);
+			out.u16((uint16_t)(int16_t)event.y);
+			break;
+		}
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+	file.write((const char*)out.bytes.data(), out.bytes.size());
+	printf("Recorded %u ticks, %d input events to %s (%d bytes)\n", ticks, (int)events.size(), path.c_str(), (int)out.bytes.size());
+	return true;
+}
+
+bool InputRecording::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open recording %s\n", path.c_str());
+		return false;
+	}
+	std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (bytes.size() < sizeof(MAGIC) || memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+		fprintf(stderr, "%s is not an input recording\n", path.c_str());
+		return false;
+	}
+	Reader in(bytes);
+	for (size_t i = 0; i < sizeof(MAGIC); i++)
+		in.u8();
+	uint8_t version = in.u8();
+	if (version != VERSION && version != 1) {
+		fprintf(stderr, "%s is recording version %d, expected %d\n", path.c_str(), version, VERSION);
+		return false;
+	}
+
+	seed = in.u32();
+	start_state = in.u8();
+	ticks = in.u32();
+	uint32_t count = in.u32();
+
+	events.clear();
+	uint32_t tick = 0;
+	for (uint32_t i = 0; i < count && in.ok(); i++) {
+		InputEvent event;
+		tick += in.varint();
+		event.tick = tick;
+		event.type = (INPUT_EVENT_TYPE)in.u8();
+		switch (event.type) {
+		case INPUT_EVENT_TYPE::KEY:
+			event.code = (int16_t)in.u16();
+			event.action = in.u8();
+			event.mods = in.u8();
+			break;
+		case INPUT_EVENT_TYPE::MOUSE_CLICK:
+			event.code = in.u8();
+			event.action = in.u8();
+			event.mods = in.u8();
+			if (version >= 2) {
+				event.x = (int16_t)in.u16();
+				event.y = (int16_t)in.u16();
+			}
+			break;
+		default:
+			fprintf(stderr, "%s has an unknown event type %d\n", path.c_str(), (int)event.type);
+			return false;
+		}
+		events.push_back(event);
+	}
+
+	if (!in.ok()) {
+		fprintf(stderr, "%s is truncated\n", path.c_str());
+		events.clear();
+		return false;
+	}
+	return true;
+}
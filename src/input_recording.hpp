@@ -0,0 +1,44 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class INPUT_EVENT_TYPE {
+	KEY = 0,
+	MOUSE_CLICK = 1
+};
+
+// One window callback, tagged with the fixed step it happened before
+struct InputEvent {
+	uint32_t tick = 0;
+	INPUT_EVENT_TYPE type = INPUT_EVENT_TYPE::KEY;
+	// GLFW key or mouse button
+	int code = 0;
+	int action = 0;
+	int mods = 0;
+	// cursor in window pixels, mouse clicks only
+	int x = 0;
+	int y = 0;
+};
+
+// Everything needed to play a session back tick for tick: the seed, the state
+// it started in and every input event. Stored as a small binary file, events
+// only take the bytes their type needs.
+class InputRecording
+{
+public:
+	uint32_t seed = 0;
+	// GAME_STATES the recording starts in
+	int start_state = 0;
+	// fixed steps the session ran for
+	uint32_t ticks = 0;
+	std::vector<InputEvent> events;
+
+	// Events have to come in tick order
+	void add(const InputEvent& event);
+
+	bool save(const std::string& path) const;
+	bool load(const std::string& path);
+};
@@ -0,0 +1,218 @@
+// internal
+#include "job_system.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+JobSystem job_system;
+
+// Queue of the current thread, -1 on threads that aren't workers
+static thread_local int current_queue = -1;
+
+void JobSystem::init(unsigned int worker_count)
+{
+	shutdown();
+
+	const char* env = getenv("GEN_JOB_THREADS");
+	if (env != nullptr)
+		worker_count = (unsigned int)std::max(0, atoi(env));
+
+	for (unsigned int i = 0; i < worker_count + 1; i++)
+		queues.push_back(std::unique_ptr<Queue>(new Queue()));
+
+	running = true;
+	for (unsigned int i = 0; i < worker_count; i++)
+		threads.emplace_back(&JobSystem::workerLoop, this, i);
+
+	printf("Job system: %u worker threads\n", worker_count);
+}
+
+void JobSystem::shutdown()
+{
+	if (queues.empty())
+		return;
+
+	running = false;
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	wake.notify_all();
+	for (std::thread& thread : threads)
+		thread.join();
+
+	threads.clear();
+	queues.clear();
+	queued = 0;
+}
+
+unsigned int JobSystem::queueIndex() const
+{
+	return current_queue >= 0 ? (unsigned int)current_queue : (unsigned int)queues.size() - 1;
+}
+
+void JobSystem::submit(Job job)
+{
+	// no workers, or not initialized: run it right here. Queued, it would sit
+	// in the queue every other thread shares until any one of them waits,
+	// and with several batch games that can be another game's thread.
+	if (threads.empty()) {
+		job();
+		return;
+	}
+
+	Queue& queue = *queues[queueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+	queued++;
+
+	// taking the lock orders this wake-up after a sleeping worker's last check
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	wake.notify_one();
+}
+
+bool JobSystem::runOne(unsigned int index)
+{
+	Job job;
+
+	// own work first, newest job first
+	{
+		Queue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = std::move(own.jobs.back());
+			own.jobs.pop_back();
+		}
+	}
+
+	// then steal the oldest job from someone else
+	for (size_t i = 1; !job && i < queues.size(); i++) {
+		Queue& victim = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+		}
+	}
+
+	if (!job)
+		return false;
+
+	queued--;
+	job();
+	return true;
+}
+
+void JobSystem::workerLoop(unsigned int index)
+{
+	current_queue = (int)index;
+	profiler.setThreadName("job worker");
+	while (running) {
+		if (runOne(index))
+			continue;
+
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [this] { return !running || queued > 0; });
+	}
+}
+
+void JobSystem::wait(const std::function<bool()>& done)
+{
+	while (!done()) {
+		if (queues.empty() || !runOne(queueIndex()))
+			std::this_thread::yield();
+	}
+}
+
+TaskGraph::Task& TaskGraph::Task::reads(const ContainerInterface& container)
+{
+	read_set.push_back(&container);
+	return *this;
+}
+
+TaskGraph::Task& TaskGraph::Task::writes(const ContainerInterface& container)
+{
+	write_set.push_back(&container);
+	return *this;
+}
+
+TaskGraph::Task& TaskGraph::Task::writesAll()
+{
+	exclusive = true;
+	return *this;
+}
+
+bool TaskGraph::Task::conflictsWith(const Task& other) const
+{
+	if (exclusive || other.exclusive)
+		return true;
+
+	auto overlaps = [](const std::vector<const ContainerInterface*>& a, const std::vector<const ContainerInterface*>& b) {
+		for (const ContainerInterface* container : a) {
+			if (std::find(b.begin(), b.end(), container) != b.end())
+				return true;
+		}
+		return false;
+	};
+	return overlaps(write_set, other.read_set) || overlaps(write_set, other.write_set) || overlaps(read_set, other.write_set);
+}
+
+TaskGraph::Task& TaskGraph::add(const char* name, std::function<void()> work)
+{
+	tasks.push_back(std::unique_ptr<Task>(new Task()));
+	Task& task = *tasks.back();
+	task.name = name;
+	task.work = std::move(work);
+	return task;
+}
+
+void TaskGraph::run(JobSystem& jobs)
+{
+	// every task waits for the earlier tasks it conflicts with, so the
+	// result is the same as running them one after the other in add order
+	for (size_t i = 0; i < tasks.size(); i++) {
+		for (size_t j = 0; j < i; j++) {
+			if (tasks[i]->conflictsWith(*tasks[j])) {
+				tasks[j]->dependents.push_back(tasks[i].get());
+				tasks[i]->pending++;
+			}
+		}
+	}
+
+	// collect the roots first, running one inline can already release others
+	std::vector<Task*> ready;
+	for (std::unique_ptr<Task>& task : tasks) {
+		if (task->pending == 0)
+			ready.push_back(task.get());
+	}
+
+	context = SimContext::bound();
+	remaining = (int)tasks.size();
+	for (Task* task : ready)
+		schedule(jobs, task);
+
+	jobs.wait([this] { return remaining == 0; });
+}
+
+void TaskGraph::schedule(JobSystem& jobs, Task* task)
+{
+	jobs.submit([this, &jobs, task] {
+		{
+			SimContext::Bind bind(context);
+			ProfileZone zone(task->name);
+			task->work();
+		}
+		for (Task* dependent : task->dependents) {
+			if (--dependent->pending == 0)
+				schedule(jobs, dependent);
+		}
+		// last, the graph may be gone as soon as this reaches zero
+		remaining--;
+	});
+}
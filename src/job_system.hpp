@@ -0,0 +1,106 @@
+#pragma once
+
+// internal
+#include "tiny_ecs.hpp"
+#include "sim_context.hpp"
+
+// stlib
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker, and the thread that calls wait(),
+// owns a deque: jobs submitted from a thread go to the back of its own deque,
+// the owner pops from the back (newest first, still warm in cache) and idle
+// threads steal from the front of someone else's.
+//
+// With no workers every job runs inline on the thread that submits it.
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	// 0 worker threads runs everything inline. GEN_JOB_THREADS overrides the count.
+	void init(unsigned int worker_count);
+	void shutdown();
+	~JobSystem() { shutdown(); }
+
+	void submit(Job job);
+	// Runs and steals jobs on the calling thread until done() holds
+	void wait(const std::function<bool()>& done);
+
+	unsigned int workerCount() const { return (unsigned int)threads.size(); }
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void workerLoop(unsigned int index);
+	bool runOne(unsigned int index);
+	unsigned int queueIndex() const;
+
+	// one queue per worker plus a last one shared by all other threads
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+
+	std::atomic<bool> running { false };
+	std::atomic<int> queued { 0 };
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+};
+
+extern JobSystem job_system;
+
+// A batch of tasks that declare which component containers they read and
+// write. A task runs after every earlier task it conflicts with (one writes
+// what the other touches) and in parallel with everything else.
+//
+//     TaskGraph graph;
+//     graph.add("animation", [&] { ... }).reads(ctx.registry.deadlys).writes(ctx.registry.animation);
+//     graph.run(job_system);
+class TaskGraph
+{
+public:
+	class Task
+	{
+	public:
+		Task& reads(const ContainerInterface& container);
+		Task& writes(const ContainerInterface& container);
+		// For work that can add or remove entities, conflicts with every other task
+		Task& writesAll();
+
+	private:
+		friend class TaskGraph;
+		bool conflictsWith(const Task& other) const;
+
+		const char* name = "";
+		std::function<void()> work;
+		std::vector<const ContainerInterface*> read_set;
+		std::vector<const ContainerInterface*> write_set;
+		bool exclusive = false;
+
+		std::vector<Task*> dependents;
+		std::atomic<int> pending { 0 };
+	};
+
+	Task& add(const char* name, std::function<void()> work);
+	// Runs every task and returns once all of them finished. Tasks see the
+	// SimContext bound to the calling thread, whichever worker they land on.
+	void run(JobSystem& jobs);
+
+	size_t size() const { return tasks.size(); }
+
+private:
+	void schedule(JobSystem& jobs, Task* task);
+
+	std::vector<std::unique_ptr<Task>> tasks;
+	std::atomic<int> remaining { 0 };
+	SimContext* context = nullptr;
+};
@@ -1,26 +1,214 @@
 
-#define GL3W_IMPLEMENTATION
-#include <gl3w.h>
-
 // stlib
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 // internal
 #include "physics_system.hpp"
 #include "render_system.hpp"
 #include "world_system.hpp"
 #include "ai_system.hpp"
+#include "batch_runner.hpp"
+#include "headless.hpp"
+#include "render_pipeline.hpp"
+#include "profiler.hpp"
+#include "sim_context.hpp"
+#include "simulation.hpp"
 
 using Clock = std::chrono::high_resolution_clock;
 
+// Catch up steps allowed per rendered frame, past that the backlog is dropped
+// so one slow frame can't make every following frame slower
+const int MAX_SUBSTEPS = 5;
+
+// Runs the step pipeline as fast as it goes, nothing is drawn
+static void run_simulation(int ticks, SimContext& context, WorldSystem& world, PhysicsSystem& physics, AISystem& ai)
+{
+	auto start = Clock::now();
+	int tick = 0;
+	for (; tick < ticks && !world.is_over(); tick++) {
+		step_simulation(context, world, physics, ai);
+	}
+	float seconds = (float)(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start)).count() / 1000000;
+
+	printf("Simulated %d ticks (%.1f s of game time) in %.3f s: %.0f ticks/s\n",
+		tick, tick * FRAME_TIME / 1000, seconds, seconds > 0 ? tick / seconds : 0.f);
+}
+
+// Plays a recording back without drawing, as fast as it goes, and reports the
+// time per tick. The checksum at the end matches between runs of the same build.
+static int run_replay(const std::string& path, SimContext& sim, WorldSystem& world, RenderSystem& renderer, PhysicsSystem& physics, AISystem& ai)
+{
+	InputRecording recording;
+	if (!recording.load(path)) {
+		return EXIT_FAILURE;
+	}
+
+	ReplayDriver replay(recording, sim, world, physics, ai);
+	replay.restart(&renderer);
+
+	std::vector<float> tick_ms;
+	tick_ms.reserve(recording.ticks);
+	auto start = Clock::now();
+	auto tick_start = start;
+	while (replay.step()) {
+		auto now = Clock::now();
+		tick_ms.push_back((float)(std::chrono::duration_cast<std::chrono::microseconds>(now - tick_start)).count() / 1000);
+		tick_start = now;
+	}
+	float seconds = (float)(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start)).count() / 1000000;
+
+	printf("Replayed %d ticks (%.1f s of game time) in %.3f s: %.0f ticks/s\n",
+		(int)tick_ms.size(), tick_ms.size() * FRAME_TIME / 1000, seconds, seconds > 0 ? tick_ms.size() / seconds : 0.f);
+	if (!tick_ms.empty()) {
+		std::sort(tick_ms.begin(), tick_ms.end());
+		printf("Tick ms: p50 %.3f  p99 %.3f  max %.3f\n", tick_ms[tick_ms.size() / 2],
+			tick_ms[std::min(tick_ms.size() - 1, tick_ms.size() * 99 / 100)], tick_ms.back());
+	}
+	printf("Replay checksum %016llx\n", (unsigned long long)replay.checksum());
+	return EXIT_SUCCESS;
+}
+
+// Plays the --state minigame over and over with every --sweep tuning, whole
+// games side by side on all cores, and writes the outcomes as CSV
+static int run_batch(const HeadlessOptions& options)
+{
+	BatchOptions batch;
+	batch.minigame = options.start_state >= 0 && options.start_state < game_states_count ? (GAME_STATES)options.start_state : GAME_STATES::MINIGAME_4;
+	batch.runs = options.batch_runs;
+	batch.seed = options.batch_seed;
+	batch.max_ticks = options.batch_ticks;
+	batch.threads = options.batch_threads;
+	batch.script_path = options.batch_script;
+	for (const std::string& sweep : options.sweeps) {
+		if (!addSweep(batch.sets, sweep))
+			return EXIT_FAILURE;
+	}
+
+	BatchRunner runner(batch);
+	auto start = Clock::now();
+	if (!runner.run())
+		return EXIT_FAILURE;
+	float seconds = (float)(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start)).count() / 1000;
+
+	runner.printSummary();
+	printf("Batch took %.1f s\n", seconds);
+	if (!runner.writeCSV(options.batch_out))
+		return EXIT_FAILURE;
+	if (!options.batch_runs_path.empty() && !runner.writeRunsCSV(options.batch_runs_path))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
+
+// Runs a fixed number of frames into an offscreen context, one simulation
+// step per frame, and reports how long the CPU and GPU took for each.
+static int run_headless(const HeadlessOptions& options, HeadlessContext& context, SimContext& sim, WorldSystem& world, RenderSystem& renderer, PhysicsSystem& physics, AISystem& ai)
+{
+	if (!context.init(window_width_px, window_height_px) || !world.create_headless()) {
+		return EXIT_FAILURE;
+	}
+
+	world.seed((uint32_t)time(NULL));
+	renderer.init(nullptr);
+	if (!options.replay_path.empty()) {
+		return run_replay(options.replay_path, sim, world, renderer, physics, ai);
+	}
+
+	world.init(&renderer);
+	if (options.start_state >= 0 && options.start_state < game_states_count) {
+		world.change_game_states((GAME_STATES)options.start_state);
+	}
+
+	if (options.simulate_ticks > 0) {
+		run_simulation(options.simulate_ticks, sim, world, physics, ai);
+		return EXIT_SUCCESS;
+	}
+
+	FrameTimings timings;
+	auto collect_gpu_times = [&renderer, &timings] {
+		unsigned int frame;
+		float gpu_ms;
+		while (renderer.gpu_timer.takeFrame(frame, gpu_ms))
+			timings.setGpu(frame, gpu_ms);
+	};
+
+	for (int frame = 0; frame < options.frames && !world.is_over(); frame++) {
+		auto start = Clock::now();
+
+		step_simulation(sim, world, physics, ai);
+		renderer.draw();
+		auto submitted = Clock::now();
+
+		float cpu_ms = (float)(std::chrono::duration_cast<std::chrono::microseconds>(submitted - start)).count() / 1000;
+		float gpu_ms = 0.f;
+		if (!renderer.gpu_timer.enabled()) {
+			// no timer queries, time spent waiting for the GPU to drain the frame is the next best thing
+			glFinish();
+			gpu_ms = (float)(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - submitted)).count() / 1000;
+		}
+		timings.add(cpu_ms, gpu_ms);
+		collect_gpu_times();
+
+		if (!options.dump_dir.empty() && frame % options.dump_every == 0) {
+			char name[32];
+			snprintf(name, sizeof(name), "/frame_%05d.png", frame);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+			saveFramebufferPNG(options.dump_dir + name, window_width_px, window_height_px);
+		}
+	}
+
+	renderer.gpu_timer.flush();
+	collect_gpu_times();
+
+	timings.printSummary();
+	if (!options.timings_path.empty()) {
+		timings.writeCSV(options.timings_path);
+	}
+
+	return EXIT_SUCCESS;
+}
+
 // Entry point 
 int main(int argc, char* argv[])
 {
+	// Declared first so the offscreen context outlives the render system
+	HeadlessContext headless_context;
+	profiler.setThreadName("main");
+
+	// The one simulation of the game, everything on this thread works on it
+	SimContext sim;
+	SimContext::Bind bind(sim);
+
 	// Global systems
-	WorldSystem world;
+	WorldSystem world(sim);
 	RenderSystem renderer;
-	PhysicsSystem physics;
-	AISystem ai;
+	PhysicsSystem physics(sim);
+	AISystem ai(sim);
+
+	HeadlessOptions headless = parseHeadlessOptions(argc, argv);
+	if (headless.batch_runs > 0) {
+		// every core already plays a game of its own, the steps' tasks run inline
+		job_system.init(0);
+		int result = run_batch(headless);
+		if (!headless.trace_path.empty()) {
+			profiler.writeTrace(headless.trace_path);
+		}
+		return result;
+	}
+
+	// leave a core for the main thread
+	job_system.init(std::max(1u, std::thread::hardware_concurrency()) - 1);
+
+	if (headless.enabled) {
+		int result = run_headless(headless, headless_context, sim, world, renderer, physics, ai);
+		if (!headless.trace_path.empty()) {
+			profiler.writeTrace(headless.trace_path);
+		}
+		return result;
+	}
 
 	// Initializing window
 	GLFWwindow* window = world.create_window();
@@ -32,14 +220,30 @@ int main(int argc, char* argv[])
 	}
 
 	// initialize the main systems
-	srand((unsigned)time(NULL));
+	uint32_t seed = (uint32_t)time(NULL);
+	world.seed(seed);
 	renderer.init(window);
 	world.init(&renderer);
 
-	// variable timestep loop
+	// every key and click from here on, for a headless --replay later
+	InputRecording recording;
+	if (!headless.record_path.empty()) {
+		recording.seed = seed;
+		recording.start_state = (int)sim.game_state;
+		world.recording = &recording;
+	}
+
+	// Draw on a separate thread unless GEN_RENDER_THREAD=0
+	const char* render_thread_env = getenv("GEN_RENDER_THREAD");
+	bool threaded = render_thread_env == nullptr || strcmp(render_thread_env, "0") != 0;
+	RenderPipeline pipeline;
+	if (threaded) {
+		pipeline.start(&renderer, window);
+	}
+
+	// fixed timestep loop
 	auto t = Clock::now();
-	const float FRAME_CAP = 60.0f;
-	const float FRAME_TIME = 1000.0f / FRAME_CAP;
+	auto last_stats = t;
 	float accumulator = 0.0f;
 
 	while (!world.is_over()) {
@@ -54,18 +258,50 @@ int main(int argc, char* argv[])
 
 		accumulator += elapsed_ms;
 
-		// do one step of the world, ai ,and physics once accumulator > 16.67ms. 
-		// step each with constant 16.67 ms since last update.
-		while (accumulator >= FRAME_TIME) {
-			world.step(elapsed_ms); // Step the whole world (so like game environment and screen)
-			ai.step(elapsed_ms);
-			physics.step(elapsed_ms); // Step the physics system (so move characters given inputs)
-			world.handle_collisions(); // After moving, check for collisions and process those
+		// Can't write into the snapshot the render thread is still drawing
+		RenderSnapshot* snapshot = threaded ? &pipeline.acquire() : nullptr;
+		pipeline.beginSimulation();
 
-			accumulator -= elapsed_ms;
+		// step the world, ai and physics by 16.67ms for every 16.67ms that passed
+		int substeps = 0;
+		while (accumulator >= FRAME_TIME && substeps < MAX_SUBSTEPS) {
+			step_simulation(sim, world, physics, ai);
+			accumulator -= FRAME_TIME;
+			substeps++;
 		}
+		if (accumulator >= FRAME_TIME) {
+			accumulator = fmod(accumulator, FRAME_TIME);
+		}
+
+		// Finally, draw new updated state to the screen, blended by the leftover time
+		if (threaded) {
+			renderer.extract(*snapshot, accumulator / FRAME_TIME);
+			pipeline.endSimulation();
+			pipeline.submit();
+		}
+		else {
+			pipeline.endSimulation();
+			renderer.draw(accumulator / FRAME_TIME);
+		}
+
+		if (threaded && now - last_stats > std::chrono::seconds(1)) {
+			renderer.frame_overlap = pipeline.takeStats().overlapShare();
+			last_stats = now;
+		}
+	}
+
+	if (threaded) {
+		pipeline.stop();
+		pipeline.printSummary();
+	}
+
+	if (world.recording) {
+		recording.ticks = (uint32_t)sim.clock.tick;
+		recording.save(headless.record_path);
+	}
 
-		renderer.draw(); // Finally, draw new updated state to the screen
+	if (!headless.trace_path.empty()) {
+		profiler.writeTrace(headless.trace_path);
 	}
 
 	return EXIT_SUCCESS;
@@ -0,0 +1,267 @@
+// internal
+#include "maze_gen.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <cassert>
+
+// Directions between rooms in the order the old recursive carve listed them
+enum MAZE_STEP { STEP_UP = 0, STEP_DOWN = 1, STEP_LEFT = 2, STEP_RIGHT = 3 };
+static const int STEP_DX[4] = { 0, 0, -1, 1 };
+static const int STEP_DY[4] = { -1, 1, 0, 0 };
+
+// One bit per room
+class RoomBits
+{
+public:
+	explicit RoomBits(size_t count) : words((count + 63) / 64, 0) {}
+	bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+	void set(size_t i) { words[i >> 6] |= 1ull << (i & 63); }
+
+private:
+	std::vector<uint64_t> words;
+};
+
+struct RoomGrid {
+	int columns;
+	int rows;
+
+	explicit RoomGrid(const GridMap& map) : columns((map.columns + 1) / 2), rows((map.rows + 1) / 2) {}
+	size_t count() const { return (size_t)columns * rows; }
+
+	// Bit per MAZE_STEP that stays inside the grid
+	uint8_t steps(int room) const
+	{
+		int x = room % columns;
+		int y = room / columns;
+		return (y > 0 ? 1 : 0) | (y + 1 < rows ? 2 : 0) | (x > 0 ? 4 : 0) | (x + 1 < columns ? 8 : 0);
+	}
+	int neighbour(int room, int step) const
+	{
+		return room + STEP_DY[step] * columns + STEP_DX[step];
+	}
+};
+
+static int bitCount(uint8_t bits)
+{
+	int count = 0;
+	for (; bits; bits &= bits - 1)
+		count++;
+	return count;
+}
+
+// A random one of the set bits, picked the way the old carve picked from its list
+static int pickStep(uint8_t bits, Rng& rng)
+{
+	uint32_t n = rng.below((uint32_t)bitCount(bits));
+	for (int step = 0; step < 4; step++) {
+		if ((bits >> step) & 1) {
+			if (n == 0)
+				return step;
+			n--;
+		}
+	}
+	assert(false);
+	return 0;
+}
+
+static void openRoom(GridMap& map, const RoomGrid& grid, int room)
+{
+	map.walls[map.index(room % grid.columns * 2, room / grid.columns * 2)] = 0;
+}
+
+// Opens the cell between a room and its neighbour one step away
+static void openBetween(GridMap& map, const RoomGrid& grid, int room, int step)
+{
+	int x = room % grid.columns * 2 + STEP_DX[step];
+	int y = room / grid.columns * 2 + STEP_DY[step];
+	map.walls[map.index(x, y)] = 0;
+}
+
+// Draws the same random numbers in the same order as the recursive version did,
+// one per direction tried, so a seed still carves the maze it always has
+static void carveBacktracker(GridMap& map, Rng& rng, int start_column, int start_row)
+{
+	RoomGrid grid(map);
+	RoomBits visited(grid.count());
+	struct Frame {
+		int room;
+		// directions not tried yet
+		uint8_t left;
+	};
+	std::vector<Frame> stack;
+
+	auto enter = [&](int room) {
+		visited.set(room);
+		openRoom(map, grid, room);
+		stack.push_back({ room, grid.steps(room) });
+	};
+	enter(start_row / 2 * grid.columns + start_column / 2);
+
+	while (!stack.empty()) {
+		Frame& frame = stack.back();
+		if (frame.left == 0) {
+			stack.pop_back();
+			continue;
+		}
+		int step = pickStep(frame.left, rng);
+		frame.left &= ~(1 << step);
+		int room = frame.room;
+		int next = grid.neighbour(room, step);
+		if (visited.test(next))
+			continue;
+		openBetween(map, grid, room, step);
+		enter(next);
+	}
+}
+
+static void carveWilson(GridMap& map, Rng& rng)
+{
+	RoomGrid grid(map);
+	RoomBits in_maze(grid.count());
+	// the last way out of every room on the current walk, overwriting it erases loops
+	std::vector<uint8_t> exits(grid.count());
+
+	int first = (int)rng.below((uint32_t)grid.count());
+	in_maze.set(first);
+	openRoom(map, grid, first);
+
+	for (int room = 0; room < (int)grid.count(); room++) {
+		if (in_maze.test(room))
+			continue;
+		// wander until the walk hits the maze
+		for (int at = room; !in_maze.test(at);) {
+			int step = pickStep(grid.steps(at), rng);
+			exits[at] = (uint8_t)step;
+			at = grid.neighbour(at, step);
+		}
+		// then follow the remembered exits, which skip every loop, and carve
+		for (int at = room; !in_maze.test(at); at = grid.neighbour(at, exits[at])) {
+			in_maze.set(at);
+			openRoom(map, grid, at);
+			openBetween(map, grid, at, exits[at]);
+		}
+	}
+}
+
+static void mergeRow(GridMap& map, int row, const std::vector<uint8_t>& cells)
+{
+	uint8_t* walls = &map.walls[map.index(0, row)];
+	for (int x = 0; x < map.columns; x++)
+		walls[x] = walls[x] && cells[x];
+}
+
+static void carveEller(GridMap& map, Rng& rng)
+{
+	EllerMaze eller(map.columns, rng.split());
+	std::vector<uint8_t> room_row(map.columns), wall_row(map.columns);
+	int room_rows = (map.rows + 1) / 2;
+	for (int r = 0; r < room_rows; r++) {
+		if (r + 1 == room_rows) {
+			eller.lastRow(room_row.data());
+			mergeRow(map, r * 2, room_row);
+			break;
+		}
+		eller.nextRows(room_row.data(), wall_row.data());
+		mergeRow(map, r * 2, room_row);
+		mergeRow(map, r * 2 + 1, wall_row);
+	}
+}
+
+void carveMaze(GridMap& map, Rng& rng, MAZE_ALGORITHM algorithm, int start_column, int start_row)
+{
+	PROFILE_ZONE("carveMaze");
+	if (map.columns <= 0 || map.rows <= 0)
+		return;
+	switch (algorithm) {
+	case MAZE_ALGORITHM::BACKTRACKER:
+		carveBacktracker(map, rng, start_column, start_row);
+		break;
+	case MAZE_ALGORITHM::WILSON:
+		carveWilson(map, rng);
+		break;
+	case MAZE_ALGORITHM::ELLER:
+		carveEller(map, rng);
+		break;
+	}
+}
+
+EllerMaze::EllerMaze(int columns_arg, Rng rng_arg)
+	: columns(columns_arg), rooms((columns_arg + 1) / 2), rng(rng_arg),
+	parent(rooms), roots(rooms), down(rooms), members(rooms), chosen(rooms), below(rooms)
+{
+	// every room of the first row starts in a set of its own
+	for (int i = 0; i < rooms; i++)
+		parent[i] = i;
+}
+
+int EllerMaze::find(int room)
+{
+	while (parent[room] != room) {
+		parent[room] = parent[parent[room]];
+		room = parent[room];
+	}
+	return room;
+}
+
+// Rooms open, walls everywhere else, then neighbours in different sets joined at random (all of them on the last row)
+void EllerMaze::joinRooms(uint8_t* room_row, bool last)
+{
+	for (int x = 0; x < columns; x++)
+		room_row[x] = x % 2;
+	for (int i = 0; i + 1 < rooms; i++) {
+		int a = find(i);
+		int b = find(i + 1);
+		if (a == b || (!last && rng.below(2) == 0))
+			continue;
+		parent[a] = b;
+		room_row[i * 2 + 1] = 0;
+	}
+}
+
+void EllerMaze::nextRows(uint8_t* room_row, uint8_t* wall_row)
+{
+	joinRooms(room_row, false);
+
+	for (int i = 0; i < rooms; i++) {
+		roots[i] = find(i);
+		members[roots[i]] = 0;
+		below[roots[i]] = -1;
+	}
+	// every set needs a way down or it's cut off: random ones, plus one picked
+	// evenly from each set (reservoir sampling) in case none of them came up
+	for (int i = 0; i < rooms; i++) {
+		int root = roots[i];
+		down[i] = rng.below(2) == 0;
+		if (rng.below(++members[root]) == 0)
+			chosen[root] = i;
+		if (down[i])
+			below[root] = i;
+	}
+	for (int i = 0; i < rooms; i++) {
+		if (below[roots[i]] < 0)
+			down[chosen[roots[i]]] = 1;
+	}
+
+	// the next row: rooms below a way down stay in their set, the others start a new one
+	for (int x = 0; x < columns; x++)
+		wall_row[x] = 1;
+	for (int i = 0; i < rooms; i++)
+		below[roots[i]] = -1;
+	for (int i = 0; i < rooms; i++) {
+		parent[i] = i;
+		if (!down[i])
+			continue;
+		wall_row[i * 2] = 0;
+		int root = roots[i];
+		if (below[root] < 0)
+			below[root] = i;
+		else
+			parent[i] = below[root];
+	}
+}
+
+void EllerMaze::lastRow(uint8_t* room_row)
+{
+	joinRooms(room_row, true);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// internal
+#include "grid_search.hpp"
+#include "random.hpp"
+
+// stlib
+#include <cstdint>
+#include <vector>
+
+enum class MAZE_ALGORITHM {
+	// depth first with an explicit stack, long winding corridors
+	BACKTRACKER = 0,
+	// loop erased random walks, every maze is equally likely
+	WILSON = 1,
+	// one row at a time, see EllerMaze
+	ELLER = 2
+};
+
+// Carves a perfect maze into map. Rooms are the cells whose column and row are
+// both even, carving opens them and the cell between every two joined rooms.
+// Nothing gets closed, cells open beforehand stay open. The same rng state
+// always carves the same maze. Time and memory grow linearly with the map,
+// WILSON's first walks take a log factor longer on big ones.
+//
+//     GridMap map(4096, 4096, 1);
+//     carveMaze(map, ctx.rng, MAZE_ALGORITHM::WILSON);
+void carveMaze(GridMap& map, Rng& rng, MAZE_ALGORITHM algorithm = MAZE_ALGORITHM::BACKTRACKER, int start_column = 0, int start_row = 0);
+
+// Eller's algorithm: a maze one row at a time with only the current row in
+// memory, so a level can scroll on for as long as it likes. Rows come out
+// with the same layout carveMaze uses, non zero is a wall.
+//
+//     EllerMaze maze(columns, rng.split());
+//     while (scrolling) maze.nextRows(rooms, walls);
+//     maze.lastRow(rooms);
+class EllerMaze
+{
+public:
+	EllerMaze(int columns, Rng rng);
+
+	// The next two grid rows, columns bytes each: the rooms and the joins
+	// between them, then the row below with the ways down into the next rooms
+	void nextRows(uint8_t* room_row, uint8_t* wall_row);
+	// A row of rooms that joins everything still apart, it ends the maze
+	void lastRow(uint8_t* room_row);
+
+private:
+	// union find over the current row's rooms
+	int find(int room);
+	void joinRooms(uint8_t* room_row, bool last);
+
+	int columns;
+	int rooms;
+	Rng rng;
+	std::vector<int> parent;
+	std::vector<int> roots;
+	std::vector<uint8_t> down;
+	// per set: members seen so far, the one picked to go down and where it went
+	std::vector<int> members;
+	std::vector<int> chosen;
+	std::vector<int> below;
+};
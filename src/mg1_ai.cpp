@@ -1,223 +1,330 @@
 // internal
 #include "mg1_ai.hpp"
-#include <queue>
-#include <unordered_set>
+#include "profiler.hpp"
+#include <algorithm>
 #include <SDL.h>
 #include <array>
 #include <iostream>
 
-// Forces the AI to recompute path once it has finished its current path
-bool FORCE_COMPUTE = true;
-bool AI_STALLED = false;
-
-// How "far" ahead the AI looks. Accounts for up, down, left, right
-int STEP_SIZE = 100;
-
-// The error tolerance for what the algo considers "found". Accounts for the fact the sprites aren't just one point
-int TOLERANCE = 80;
-
-// DISTANCE_LEFT_TO_TRAVEL keeps the AI moving in 100 step intervals so it's more on rails.
-float DISTANCE_LEFT_TO_TRAVEL = 0;
-int DIRECTION_INDEX = 0;
-int AI_SPEED = 4;
-
 void MiniGame1AI::step(float elapsed_ms)
 {
  	float step_seconds = elapsed_ms / 1000.f;
 
-	if (game_state != (unsigned int)GAME_STATES::MINIGAME_1 || pause_game_state == true) return;
-	auto& motion_deadly = registry.deadlys;
+	if (ctx.game_state != (unsigned int)GAME_STATES::MINIGAME_1 || ctx.pause_game_state == true) return;
+	auto& motion_deadly = ctx.registry.deadlys;
 	if (motion_deadly.entities.size() <= 0) return;
-	// Recalculate path every COMPUTE_CYCLE tick or if FORCE_COMPUTE is true
-	if (TICK % COMPUTE_CYCLE == 0 || FORCE_COMPUTE) {
- 		if (DISTANCE_LEFT_TO_TRAVEL != 0) {
-			// If there's still distance until the AI has moved 100 steps, don't recalculate yet. But indicate it will right after reaching 100 steps.
-			AI_STALLED = true;
-			FORCE_COMPUTE = false;
-		}
-		else {
-			STEP_SIZE = 100;
-			TOLERANCE = 80;
-			Entity& player = registry.players.entities[0];
-			int xTarget = registry.foregroundMotions.get(player).position.x;
-			int yTarget = registry.foregroundMotions.get(player).position.y;
-
-			// Currently hardcoded for only 1 deadly entity
-			foregroundMotion& rbc_motion = registry.foregroundMotions.get(motion_deadly.entities[0]);
-			int xStart = rbc_motion.position.x;
-			int yStart = rbc_motion.position.y;
-			motion_deadly.components[0].chase = generatePath(xStart, yStart, xTarget, yTarget).dir;
-			if (motion_deadly.components[0].chase.size() == 0) {
-				STEP_SIZE = 50;
-				TOLERANCE = 45;
-				motion_deadly.components[0].chase = generatePath(xStart, yStart, xTarget, yTarget).dir;
-			}
-			DISTANCE_LEFT_TO_TRAVEL = (float)STEP_SIZE;
-			DIRECTION_INDEX = 0;
-			FORCE_COMPUTE = false;
-			AI_STALLED = false;
+	if (usesFlowField()) {
+		followFlowField(step_seconds);
+		TICK++;
+		return;
+	}
+
+	chasers.sync(motion_deadly.entities);
+	size_t count = chasers.size();
+	for (size_t i = 0; i < count; i++) {
+		chasers.motions[i] = &ctx.registry.foregroundMotions.get(chasers.entities[i]);
+		// A new maze (the minigame restarted) makes the old path meaningless
+		if (chasers.maze_version[i] != ctx.maze_version) {
+			motion_deadly.components[i].chase.clear();
+			chasers.direction_index[i] = 0;
+			chasers.distance_left[i] = 0;
+			chasers.maze_version[i] = ctx.maze_version;
+			chasers.goal_cell[i] = -1;
+			chasers.force_compute[i] = true;
+			// nothing cached for the old maze gets found again
+			path_cache.clear();
 		}
 	}
-	else {
-		// follow step plan
-		foregroundMotion& rbc_motion = registry.foregroundMotions.get(motion_deadly.entities[0]);
-		if (motion_deadly.components[0].chase.size() > DIRECTION_INDEX) {
-			Direction dir = motion_deadly.components[0].chase[DIRECTION_INDEX];
-			float scaleX = abs(rbc_motion.scale.x) / 2.0f;
-			float scaleY = abs(rbc_motion.scale.y) / 2.0f;
-
-			float distanceTraveled = AI_SPEED * step_seconds * 50.f;
-			bool done_after_this_step = DISTANCE_LEFT_TO_TRAVEL - distanceTraveled <= 0;
-
-			// bound the amount you increment to keep you on on the center.
-			float bounded_distance = done_after_this_step ? DISTANCE_LEFT_TO_TRAVEL : distanceTraveled;
-
-			switch (dir) {
-				case UP:
-					rbc_motion.position.y -= bounded_distance;
-					DISTANCE_LEFT_TO_TRAVEL = max(0.f, DISTANCE_LEFT_TO_TRAVEL - distanceTraveled);
-					if (done_after_this_step) {
-						DIRECTION_INDEX++;
-						if (AI_STALLED) {
-							FORCE_COMPUTE = true;
-							AI_STALLED = false;
-						}
-						else {
-							DISTANCE_LEFT_TO_TRAVEL = (float)STEP_SIZE;
-						}
-					}
-					break;
-				case DOWN:
-					rbc_motion.position.y += bounded_distance;
-					DISTANCE_LEFT_TO_TRAVEL = max(0.f, DISTANCE_LEFT_TO_TRAVEL - distanceTraveled);
-					if (done_after_this_step) {
-						DIRECTION_INDEX++;
-						if (AI_STALLED) {
-							FORCE_COMPUTE = true;
-							AI_STALLED = false;
-						}
-						else {
-							DISTANCE_LEFT_TO_TRAVEL = (float)STEP_SIZE;
-						}
-					}
-					break;
-				case RIGHT:
-					rbc_motion.position.x += bounded_distance;
-					DISTANCE_LEFT_TO_TRAVEL = max(0.f, DISTANCE_LEFT_TO_TRAVEL - distanceTraveled);
-					if (done_after_this_step) {
-						DIRECTION_INDEX++;
-						if (AI_STALLED) {
-							FORCE_COMPUTE = true;
-							AI_STALLED = false;
-						}
-						else {
-							DISTANCE_LEFT_TO_TRAVEL = (float)STEP_SIZE;
-						}
-					}
-					break;
-				case LEFT:
-					rbc_motion.position.x -= bounded_distance;
-					DISTANCE_LEFT_TO_TRAVEL = max(0.f, DISTANCE_LEFT_TO_TRAVEL - distanceTraveled);
-					if (done_after_this_step) {
-						DIRECTION_INDEX++;
-						if (AI_STALLED) {
-							FORCE_COMPUTE = true;
-							AI_STALLED = false;
-						}
-						else {
-							DISTANCE_LEFT_TO_TRAVEL = (float)STEP_SIZE;
-						}
-					}
-					break;
-			}
-			changeRotationAndDirection(rbc_motion, dir);
-			// Bound the enemy ai to the game window
-			rbc_motion.position.x = max(50.f, min((float)window_width_px - 50, rbc_motion.position.x));
-			rbc_motion.position.y = max(50.f, min((float)window_height_px - 50, rbc_motion.position.y));
+
+	// Every chaser asks for a new path once per COMPUTE_CYCLE, staggered so they
+	// don't all ask on the same tick, or straight away when it's stalled. The old
+	// path is followed until the new one is in. One still heading for the
+	// player's cell is good as it is, the chaser keeps following it.
+	int player_cell = playerCell();
+	scheduler.roundRobin(count, [&](size_t i) {
+		bool due = (TICK + i) % COMPUTE_CYCLE == 0 || chasers.force_compute[i];
+		if (!due || chasers.paths[i]->pending())
+			return false;
+		bool on_path = chasers.direction_index[i] < (int)motion_deadly.components[i].chase.size();
+		if (!chasers.force_compute[i] && on_path && chasers.goal_cell[i] == player_cell) {
+			profiler.count("path_cache/kept");
+			return false;
 		}
-		else {
-			FORCE_COMPUTE = true;
-			DISTANCE_LEFT_TO_TRAVEL = 0;
+		requestPath(i, motion_deadly.components[i]);
+		chasers.force_compute[i] = false;
+		return true;
+	});
+
+	// A new path can only take over between two steps, at the point it was asked for
+	for (size_t i = 0; i < count; i++) {
+		if (chasers.distance_left[i] != 0)
+			continue;
+		Deadly& deadly = motion_deadly.components[i];
+		bool path_done = chasers.direction_index[i] >= (int)deadly.chase.size();
+		if (chasers.paths[i]->pending() && (path_done || atRequestedStart(i)))
+			adoptPath(i, deadly);
+		// stalled ones stay put with distance_left at 0
+		if (chasers.direction_index[i] >= (int)deadly.chase.size()) {
+			chasers.force_compute[i] = true;
+			continue;
 		}
+		chasers.distance_left[i] = (float)chasers.step_size[i];
 	}
+
+	// follow step plans, every chaser only moves itself
+	scheduler.forEachBatch(count, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			moveChaser(i, motion_deadly.components[i], step_seconds);
+	});
 	TICK++;
 }
 
-// Runs A* pathfinding using the "Manhattan Distance" between start and target as heuristic
-Search MiniGame1AI::generatePath(int xStart, int yStart, int xTarget, int yTarget) {
-	// Initialize a minimum priority queue based on f-values (current path costs + calculated heuristic). Uses struct "Search".
-	std::priority_queue<Search> pq;
-	// Initialize visited nodes list
-	std::unordered_set<SearchPosition, searchPositionHash> visited;
-	// Initialize initial cost of 0 and corresponding Search Struct
-	Search initial = Search(generateHeuristic(xStart, yStart, xTarget, yTarget), 0, SearchPosition(xStart, yStart));
-	pq.push(initial);
-
-	while (!pq.empty()) {
-		// Dequeues the best f-value path from the pq
-		Search const& path = pq.top();
-		std::vector<Direction> currentDirection = path.dir;
-		SearchPosition currentNode = path.lastNode;
-		int pathCost = path.cost;
-		int currX = path.lastNode.x;
-		int currY = path.lastNode.y;
-
-
-		// Checks if you're near the target
-		if (abs(currX - xTarget) < TOLERANCE && abs(currY - yTarget) < TOLERANCE) {
-			return path;
+void MiniGame1AI::moveChaser(size_t chaser, const Deadly& deadly, float step_seconds)
+{
+	float& distance_left = chasers.distance_left[chaser];
+	if (distance_left <= 0)
+		return;
+	foregroundMotion& rbc_motion = *chasers.motions[chaser];
+	Direction dir = deadly.chase[chasers.direction_index[chaser]];
+	float distanceTraveled = AI_SPEED * step_seconds * 50.f;
+	// bound the amount you increment to keep you on on the center.
+	float bounded_distance = min(distanceTraveled, distance_left);
+	rbc_motion.position += bounded_distance * directionVector(dir);
+	distance_left -= bounded_distance;
+	if (distance_left <= 0) {
+		distance_left = 0;
+		chasers.direction_index[chaser]++;
+	}
+	changeRotationAndDirection(rbc_motion, dir);
+	// Bound the enemy ai to the game window
+	rbc_motion.position.x = max(50.f, min((float)window_width_px - 50, rbc_motion.position.x));
+	rbc_motion.position.y = max(50.f, min((float)window_height_px - 50, rbc_motion.position.y));
+}
+
+void ChaserAgents::sync(const std::vector<Entity>& deadlys)
+{
+	if (entities.size() == deadlys.size() && std::equal(entities.begin(), entities.end(), deadlys.begin(),
+		[](Entity a, Entity b) { return (unsigned int)a == (unsigned int)b; }))
+		return;
+
+	ChaserAgents synced;
+	for (Entity deadly : deadlys) {
+		size_t old = 0;
+		while (old < entities.size() && (unsigned int)entities[old] != (unsigned int)deadly)
+			old++;
+		synced.entities.push_back(deadly);
+		synced.motions.push_back(nullptr);
+		if (old < entities.size()) {
+			synced.direction_index.push_back(direction_index[old]);
+			synced.distance_left.push_back(distance_left[old]);
+			synced.step_size.push_back(step_size[old]);
+			synced.force_compute.push_back(force_compute[old]);
+			synced.maze_version.push_back(maze_version[old]);
+			synced.goal_cell.push_back(goal_cell[old]);
+			synced.request_goal.push_back(request_goal[old]);
+			synced.requested_start.push_back(requested_start[old]);
+			synced.paths.push_back(std::move(paths[old]));
 		}
+		else {
+			synced.direction_index.push_back(0);
+			synced.distance_left.push_back(0.f);
+			synced.step_size.push_back(100);
+			synced.force_compute.push_back(true);
+			synced.maze_version.push_back(0);
+			synced.goal_cell.push_back(-1);
+			synced.request_goal.push_back(-1);
+			synced.requested_start.push_back({ 0.f, 0.f });
+			synced.paths.emplace_back(new PathService());
+		}
+	}
+	*this = std::move(synced);
+}
 
-		pq.pop();
+vec2 MiniGame1AI::directionVector(Direction dir)
+{
+	switch (dir) {
+	case UP: return { 0.f, -1.f };
+	case RIGHT: return { 1.f, 0.f };
+	case DOWN: return { 0.f, 1.f };
+	default: return { -1.f, 0.f };
+	}
+}
 
-		// If you visited already, ignore
-		if (visited.count(currentNode)) continue;
-		visited.insert(currentNode);
+bool MiniGame1AI::usesFlowField()
+{
+	return flow_field_mode || ctx.registry.deadlys.entities.size() > MAX_PATH_CHASERS;
+}
 
+void MiniGame1AI::planPath()
+{
+	if (ctx.game_state != (unsigned int)GAME_STATES::MINIGAME_1 || ctx.pause_game_state == true) return;
+	if (usesFlowField()) {
+		// usually the only rebuild of the tick, step() then finds it up to date
+		updateFlowField();
+	}
+}
 
-		// Below generates a new Search Struct for left, right, up, down and adds it to the PQ.
-		// left
-		if (currX >= STEP_SIZE && !collidesWithWallX({ currX - STEP_SIZE, currY }, 0)) {
-			SearchPosition newNode = SearchPosition(currX - STEP_SIZE, currY);
-			Search left = Search(generateHeuristic(currX - STEP_SIZE, currY, xTarget, yTarget) + pathCost, pathCost + STEP_SIZE, newNode);
-			left.dir = currentDirection;
-			left.dir.emplace_back(LEFT);
-			pq.push(left);
-		}
+void MiniGame1AI::requestPath(size_t chaser, const Deadly& deadly)
+{
+	if (ctx.registry.players.entities.size() <= 0) return;
+	vec2 player = ctx.registry.foregroundMotions.get(ctx.registry.players.entities[0]).position;
 
-		// right
-		if (currX + STEP_SIZE <= window_width_px && !collidesWithWallX({ currX + STEP_SIZE, currY }, 0)) {
-			SearchPosition newNode = SearchPosition(currX + STEP_SIZE, currY);
-			Search right = Search(generateHeuristic(currX + STEP_SIZE, currY, xTarget, yTarget) + pathCost, pathCost + STEP_SIZE, newNode);
-			right.dir = currentDirection;
-			right.dir.emplace_back(RIGHT);
-			pq.push(right);
-		}
+	// the new path starts where the step the chaser is on, or is about to take, ends
+	vec2 start = chasers.motions[chaser]->position;
+	int direction_index = chasers.direction_index[chaser];
+	if (direction_index < (int)deadly.chase.size()) {
+		float distance_left = chasers.distance_left[chaser];
+		float remaining = distance_left > 0 ? distance_left : (float)chasers.step_size[chaser];
+		start += remaining * directionVector(deadly.chase[direction_index]);
+	}
+
+	chasers.requested_start[chaser] = start;
+	int goal = playerCell();
+	chasers.request_goal[chaser] = goal;
+	PathResult cached;
+	if (path_cache.find((int)start.x, (int)start.y, goal, ctx.maze_version, cached)) {
+		chasers.paths[chaser]->fulfil(std::move(cached));
+		return;
+	}
+
+	PathRequest request;
+	request.map = GridMap::fromCells(&ctx.maze[0][0], MAZE_COLUMNS, MAZE_ROWS);
+	request.cell_px = MAZE_CELL_PX;
+	request.maze_version = ctx.maze_version;
+	request.x_start = (int)start.x;
+	request.y_start = (int)start.y;
+	request.x_target = (int)player.x;
+	request.y_target = (int)player.y;
+	// The error tolerance for what the algo considers "found" accounts for the sprites not being points,
+	// retry on a finer grid when the coarse one can't get close enough
+	request.lattices = { { 100, 80 }, { 50, 45 } };
+	chasers.paths[chaser]->request(std::move(request));
+}
+
+bool MiniGame1AI::atRequestedStart(size_t chaser)
+{
+	vec2 position = chasers.motions[chaser]->position;
+	vec2 requested = chasers.requested_start[chaser];
+	return abs(position.x - requested.x) < 0.5f && abs(position.y - requested.y) < 0.5f;
+}
+
+void MiniGame1AI::adoptPath(size_t chaser, Deadly& deadly)
+{
+	PathResult result = chasers.paths[chaser]->collect();
+	// a path through an older maze would be handed out again as if it were current
+	if (result.maze_version == ctx.maze_version)
+		path_cache.insert(chasers.request_goal[chaser], result);
+	// stale: the maze changed since, or the chaser isn't where the path starts
+	if (result.maze_version != ctx.maze_version || !atRequestedStart(chaser)) {
+		chasers.force_compute[chaser] = true;
+		return;
+	}
+	deadly.chase = std::move(result.path);
+	if (result.step_size > 0)
+		chasers.step_size[chaser] = result.step_size;
+	chasers.direction_index[chaser] = 0;
+	chasers.goal_cell[chaser] = chasers.request_goal[chaser];
+}
+
+int MiniGame1AI::playerCell()
+{
+	if (ctx.registry.players.entities.size() <= 0) return -1;
+	vec2 player = ctx.registry.foregroundMotions.get(ctx.registry.players.entities[0]).position;
+	int column = max(0, min(MAZE_COLUMNS - 1, (int)player.x / MAZE_CELL_PX));
+	int row = max(0, min(MAZE_ROWS - 1, (int)player.y / MAZE_CELL_PX));
+	return row * MAZE_COLUMNS + column;
+}
+
+// Runs A* pathfinding using the "Manhattan Distance" between start and target as heuristic
+Search MiniGame1AI::generatePath(int xStart, int yStart, int xTarget, int yTarget, int stepSize, int tolerance) {
+	GridMap map = GridMap::fromCells(&ctx.maze[0][0], MAZE_COLUMNS, MAZE_ROWS);
+	return latticeAStar(map, MAZE_CELL_PX, xStart, yStart, xTarget, yTarget, stepSize, tolerance, search_pool);
+}
 
-		// up
-		if (currY >= STEP_SIZE && !collidesWithWallY({ currX, currY - STEP_SIZE }, 0)) {
-			SearchPosition newNode = SearchPosition(currX, currY - STEP_SIZE);
-			Search up = Search(generateHeuristic(currX, currY - STEP_SIZE, xTarget, yTarget) + pathCost, pathCost + STEP_SIZE, newNode);
-			up.dir = currentDirection;
-			up.dir.emplace_back(UP);
-			pq.push(up);
+void MiniGame1AI::updateFlowField()
+{
+	if (ctx.registry.players.entities.size() <= 0) return;
+	// the maze's nav table already has the field for every cell
+	if (ctx.maze_nav.built(ctx.maze_version)) return;
+	vec2 player = ctx.registry.foregroundMotions.get(ctx.registry.players.entities[0]).position;
+	int column = max(0, min(MAZE_COLUMNS - 1, (int)player.x / MAZE_CELL_PX));
+	int row = max(0, min(MAZE_ROWS - 1, (int)player.y / MAZE_CELL_PX));
+	flow_field.update(&ctx.maze[0][0], MAZE_COLUMNS, MAZE_ROWS, column, row);
+}
+
+// Every chaser walks the centre line of the maze's corridors: back onto it first
+// if it's off, then one cell along the field. Cost per chaser doesn't depend on the maze.
+void MiniGame1AI::followFlowField(float step_seconds)
+{
+	if (ctx.registry.players.entities.size() <= 0) return;
+	updateFlowField();
+	vec2 player = ctx.registry.foregroundMotions.get(ctx.registry.players.entities[0]).position;
+	float speed = AI_SPEED * step_seconds * 50.f;
+
+	field_motions.clear();
+	for (Entity deadly : ctx.registry.deadlys.entities)
+		field_motions.push_back(&ctx.registry.foregroundMotions.get(deadly));
+	int player_cell = playerCell();
+	scheduler.forEachBatch(field_motions.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			stepAlongField(*field_motions[i], player, player_cell, speed);
+	});
+}
+
+void MiniGame1AI::stepAlongField(foregroundMotion& motion, vec2 player, int player_cell, float speed)
+{
+	int column = max(0, min(MAZE_COLUMNS - 1, (int)motion.position.x / MAZE_CELL_PX));
+	int row = max(0, min(MAZE_ROWS - 1, (int)motion.position.y / MAZE_CELL_PX));
+	vec2 center = { (column + 0.5f) * MAZE_CELL_PX, (row + 0.5f) * MAZE_CELL_PX };
+
+	// the nav table when the maze has one, it's the same field looked up instead of searched
+	int cell = row * MAZE_COLUMNS + column;
+	bool nav = ctx.maze_nav.built(ctx.maze_version);
+	vec2 target;
+	Direction dir;
+	bool has_direction = nav ? ctx.maze_nav.direction(cell, player_cell, dir) : flow_field.direction(column, row, dir);
+	int distance_to_player = nav ? ctx.maze_nav.distance(cell, player_cell) : flow_field.distance(column, row);
+	if (has_direction) {
+		bool horizontal = dir == LEFT || dir == RIGHT;
+		bool on_line = horizontal ? abs(motion.position.y - center.y) < 0.5f : abs(motion.position.x - center.x) < 0.5f;
+		if (on_line) {
+			target = center;
+			if (horizontal)
+				target.x += dir == LEFT ? -MAZE_CELL_PX : MAZE_CELL_PX;
+			else
+				target.y += dir == UP ? -MAZE_CELL_PX : MAZE_CELL_PX;
 		}
-		// down
-		if (currY + STEP_SIZE <= window_height_px && !collidesWithWallY({ currX, currY + STEP_SIZE }, 0)) {
-			SearchPosition newNode = SearchPosition(currX, currY + STEP_SIZE);
-			Search down = Search(generateHeuristic(currX, currY + STEP_SIZE, xTarget, yTarget) + pathCost, pathCost + STEP_SIZE, newNode);
-			down.dir = currentDirection;
-			down.dir.emplace_back(DOWN);
-			pq.push(down);
+		else {
+			target = center;
 		}
 	}
-	// If you get here, there's no path found which theoretically couldn't happen.
-	return Search(-1, -1, SearchPosition(0, 0));
-}
+	else if (distance_to_player == 0) {
+		// same cell as the player, go straight for them
+		target = player;
+	}
+	else {
+		// walled off from the player
+		return;
+	}
 
-int MiniGame1AI::generateHeuristic(int xStart, int yStart, int xTarget, int yTarget) {
-	// Assuming only up and down for now. Uses Manhattan distance.
-	return abs(xTarget - xStart) + abs(yTarget - yStart);
+	// one axis at a time keeps it on rails
+	vec2 delta = target - motion.position;
+	bool along_x = abs(delta.x) >= abs(delta.y);
+	float distance = min(speed, along_x ? abs(delta.x) : abs(delta.y));
+	if (distance <= 0.f)
+		return;
+	Direction facing;
+	if (along_x) {
+		facing = delta.x < 0 ? LEFT : RIGHT;
+		motion.position.x += delta.x < 0 ? -distance : distance;
+	}
+	else {
+		facing = delta.y < 0 ? UP : DOWN;
+		motion.position.y += delta.y < 0 ? -distance : distance;
+	}
+	changeRotationAndDirection(motion, facing);
+	motion.position.x = max(50.f, min((float)window_width_px - 50, motion.position.x));
+	motion.position.y = max(50.f, min((float)window_height_px - 50, motion.position.y));
 }
 
 void MiniGame1AI::changeRotationAndDirection(foregroundMotion& motion, Direction& direction)
@@ -1,49 +1,85 @@
 #pragma once
 
+#include "ai_scheduler.hpp"
 #include "common_ai.hpp"
+#include "flow_field.hpp"
+#include "grid_search.hpp"
+#include "path_cache.hpp"
+#include "path_service.hpp"
 #include "tiny_ecs_registry.hpp"
 
+#include <memory>
 #include <vector>
 
-struct SearchPosition
-{
-	int x, y;
-	SearchPosition(int initX, int initY) : x(initX), y(initY) {}
+// The A* chasers' state, one slot per Deadly in registry order
+struct ChaserAgents {
+	std::vector<Entity> entities;
+	// step of Deadly::chase being walked and how far it still goes, keeps them on rails
+	std::vector<int> direction_index;
+	std::vector<float> distance_left;
+	// how "far" one step of the path goes, 50 when the target needed the finer grid
+	std::vector<int> step_size;
+	// stalled, asks for a path straight away instead of at its next COMPUTE_CYCLE
+	std::vector<uint8_t> force_compute;
+	// maze the path was planned on
+	std::vector<uint32_t> maze_version;
+	// player's cell the path heads for, and the one the pending request does, -1 for none
+	std::vector<int> goal_cell;
+	std::vector<int> request_goal;
+	std::vector<vec2> requested_start;
+	std::vector<std::unique_ptr<PathService>> paths;
+	// resolved before the batches run, they only touch their own
+	std::vector<foregroundMotion*> motions;
 
-	bool operator==(const SearchPosition& other) const {
-		return x == other.x && y == other.y;
-	}
+	size_t size() const { return entities.size(); }
+	// Lines the slots up with the registry's chasers, keeping the state of the ones still there
+	void sync(const std::vector<Entity>& deadlys);
 };
 
-struct searchPositionHash {
+class MiniGame1AI : public CommonAI {
 public:
-	size_t operator()(const SearchPosition p) const
-	{
-		return std::hash<int>()(p.x) ^ std::hash<int>()(p.y);
-	}
-};
-
-struct Search {
-	int fvalue;
-	int cost;
-	SearchPosition lastNode;
-	std::vector<Direction> dir;
-	Search(int val, int costs, SearchPosition newNode) : fvalue(val), cost(costs), lastNode(newNode) {}
+	void step(float elapsed_ms);
+	// Rebuilds the flow field if the player changed cell, A* paths are searched by
+	// the path service across ticks instead. Only reads the registry so it can
+	// run as a task next to the rest of the tick.
+	void planPath();
+	MiniGame1AI(SimContext& ctx) : CommonAI(ctx) {}
 
-	bool operator<(const Search& other) const {
-		return fvalue > other.fvalue;
-	}
-};
+	// Steer every Deadly down a flow field towards the player instead of planning
+	// A* paths. Always on with more than MAX_PATH_CHASERS, they all share the field.
+	bool flow_field_mode = false;
+	static const size_t MAX_PATH_CHASERS = 16;
 
+	// Batches the chasers over the job system and caps the path requests per tick
+	AIScheduler scheduler;
 
-
-class MiniGame1AI : public CommonAI {
-public:
-	void step(float elapsed_ms);
-	MiniGame1AI() {}
+	// A* over the points stepSize apart from the start, done within tolerance of the target.
+	// Leaves dir empty when the target can't be reached.
+	Search generatePath(int xStart, int yStart, int xTarget, int yTarget, int stepSize, int tolerance);
 
 private:
-	Search generatePath(int xStart, int yStart, int xTarget, int yTarget);
-	int generateHeuristic(int xStart, int yStart, int xTarget, int yTarget);
+	bool usesFlowField();
+	// Rebuilds the field when the player moved to another cell, not needed when the maze has a nav table
+	void updateFlowField();
+	void followFlowField(float step_seconds);
+	void stepAlongField(foregroundMotion& motion, vec2 player, int player_cell, float speed);
+	// Sends off the search for a path that takes over where the chaser's current step ends
+	void requestPath(size_t chaser, const Deadly& deadly);
+	bool atRequestedStart(size_t chaser);
+	// Swaps the pending path in, unless the maze or the chaser moved on since it was asked for
+	void adoptPath(size_t chaser, Deadly& deadly);
+	void moveChaser(size_t chaser, const Deadly& deadly, float step_seconds);
+	// Maze cell the player stands in, -1 without a player
+	int playerCell();
+	static vec2 directionVector(Direction dir);
 	void changeRotationAndDirection(foregroundMotion& motion, Direction& direction);
+
+	int AI_SPEED = 4;
+
+	ChaserAgents chasers;
+	// shared by all the chasers, only touched between the batches
+	PathCache path_cache;
+	AStarPool search_pool;
+	FlowField flow_field;
+	std::vector<foregroundMotion*> field_motions;
 };
\ No newline at end of file
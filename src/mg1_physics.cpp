@@ -1,15 +1,17 @@
 #include "mg1_physics.hpp"
+#include "profiler.hpp"
 
 void MiniGame1Physics::step(float elapsed_ms) {
-	Entity& player = registry.players.entities[0];
-	Entity& enemy = registry.deadlys.entities[0];
-	foregroundMotion& player_motion = registry.foregroundMotions.get(player);
-	foregroundMotion& enemy_motion = registry.foregroundMotions.get(enemy);
+	PROFILE_ZONE("MiniGame1Physics::step");
+	Entity& player = ctx.registry.players.entities[0];
+	Entity& enemy = ctx.registry.deadlys.entities[0];
+	foregroundMotion& player_motion = ctx.registry.foregroundMotions.get(player);
+	foregroundMotion& enemy_motion = ctx.registry.foregroundMotions.get(enemy);
 
 	// check for collision between Gen and evil virus
 	if (checkCircleCollision(player, enemy)) {
-		registry.collisions.emplace_with_duplicates(player, enemy);
-		registry.collisions.emplace_with_duplicates(enemy, player);
+		ctx.registry.collisions.emplace_with_duplicates(player, enemy);
+		ctx.registry.collisions.emplace_with_duplicates(enemy, player);
 	}
 
 	//key handling for player
@@ -22,11 +24,11 @@ void MiniGame1Physics::step(float elapsed_ms) {
 }
 
 void MiniGame1Physics::consumableMovementHandler(float elapsed_ms) {
-	ComponentContainer<Consumable>& consumableContainer = registry.consumables;
+	ComponentContainer<Consumable>& consumableContainer = ctx.registry.consumables;
 
 	for (int i = 0; i < consumableContainer.components.size(); i++) {
 		Entity& entity = consumableContainer.entities[i];
-		foregroundMotion& motion = registry.foregroundMotions.get(entity);
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(entity);
 
 		// Allows for scale variation and back and forth motion using linear interpolation. 
 		// Allows for hard-coded rotation of the ATPs
@@ -88,9 +90,9 @@ void MiniGame1Physics::handleATPCollisions() {
 	// Check for collisions between all moving entities and moving entities with staticObjects
 	// For each entity in `collidables`, check against all other collidables
 	// If there is a collision, add to the collisions container
-    ComponentContainer<foregroundMotion> &motion_container = registry.foregroundMotions;
-	ComponentContainer<Collidable>& collidableContainer = registry.collidables;
-	ComponentContainer<backgroundMotions>& staticObjectContainer = registry.backgroundMotions;
+    ComponentContainer<foregroundMotion> &motion_container = ctx.registry.foregroundMotions;
+	ComponentContainer<Collidable>& collidableContainer = ctx.registry.collidables;
+	ComponentContainer<backgroundMotions>& staticObjectContainer = ctx.registry.backgroundMotions;
 
 	for (uint i = 0; i < collidableContainer.components.size(); i++)
 	{
@@ -104,13 +106,13 @@ void MiniGame1Physics::handleATPCollisions() {
 			Entity& entity_j = collidableContainer.entities[j];
 
 			// in Mini Game
-			bool oneIsPlayer = entity_i == registry.players.entities[0] || entity_j == registry.players.entities[0];
-			bool oneIsConsumable = registry.consumables.has(entity_i) || registry.consumables.has(entity_j);
+			bool oneIsPlayer = entity_i == ctx.registry.players.entities[0] || entity_j == ctx.registry.players.entities[0];
+			bool oneIsConsumable = ctx.registry.consumables.has(entity_i) || ctx.registry.consumables.has(entity_j);
 
 			// check that one is the player and one is a consumable and that they are colliding
 			if (oneIsPlayer && oneIsConsumable && checkCircleCollision(entity_i, entity_j)) {
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 		}
 	}
@@ -120,8 +122,8 @@ void MiniGame1Physics::playerMovementHandlerMG1(foregroundMotion& player_motion,
 	float step_seconds = elapsed_ms / 1000.f;
 	float new_pos = 0;
 	int sprite_offset = 35;
-	for (int i = 0; i < sizeof(keymap) / sizeof(keymap[0]); i++) {
-		if (keymap[i]) {
+	for (int i = 0; i < sizeof(ctx.input.keys) / sizeof(ctx.input.keys[0]); i++) {
+		if (ctx.input.keys[i]) {
 			switch (i) {
 			case GLFW_KEY_W:
 				new_pos = player_motion.position.y - (275 * step_seconds);
@@ -13,7 +13,7 @@ class MiniGame1Physics : public CommonPhysics {
 public:
 
 	void step(float elapsed_ms);
-	MiniGame1Physics() {}
+	MiniGame1Physics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void consumableMovementHandler(float elapsed_ms);
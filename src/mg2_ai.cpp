@@ -1,83 +1,96 @@
 // internal
 #include "mg2_ai.hpp"
+#include "behavior_tree.hpp"
 #include "world_init.hpp"
-#include "random"
+#include "sim_context.hpp"
 
-float TOTAL_TIME = 0.0f;
-float tickTimer = 0.f;
+// The obstacle spawner. Every 4166 ms: hard mode's three obstacles once enough
+// time has gone by, otherwise a worm at whichever half of the screen Gen is in.
+static const char* MG2_TREE = R"({
+	"root": { "type": "cooldown", "ms": 4166, "child":
+		{ "type": "selector", "children": [
+			{ "type": "sequence", "children": [
+				{ "type": "condition", "name": "hard_mode" },
+				{ "type": "action", "name": "spawn_hard" } ] },
+			{ "type": "sequence", "children": [
+				{ "type": "condition", "name": "player_in_bottom_half" },
+				{ "type": "action", "name": "spawn_bottom" } ] },
+			{ "type": "action", "name": "spawn_top" } ] } }
+})";
 
-// C++ random number generator
-std::default_random_engine rng;
-std::uniform_real_distribution<float> uniform_dist; // number between 0..1
+static bool hardMode(BehaviorCall& call)
+{
+	return call.ctx.minigames.mg2_total_ms >= call.ctx.tuning.hard_mode_time;
+}
 
-// Once this amount of timee has passed, activate hard mode
-float HARD_MODE_TIME = 5000.0f;
+static bool playerInBottomHalf(BehaviorCall& call)
+{
+	ECSRegistry& registry = call.ctx.registry;
+	Entity& player = registry.players.entities[0];
+	foregroundMotion& player_motion = registry.foregroundMotions.get(player);
+	return player_motion.position.y >= window_height_px / 2.0f;
+}
 
-AITreeNode root;
-AITreeNode one;
-AITreeNode two;
-AITreeNode three;
-AITreeNode four;
-AITreeNode five;
+static BT_STATUS spawnHard(BehaviorCall& call)
+{
+	RenderSystem* render = call.ctx.minigames.mg2_renderer;
+	Rng& rng = call.ctx.rng;
+	createMG2MeshObject(render, { (window_width_px + 100), (window_height_px - 100) }, { 75,75 }, 0, rng.uniform());
+	createMG2MeshObject(render, { (window_width_px + 400), 100 }, { 150,-150 }, 1, rng.uniform());
+	createMG2MeshObject(render, { (window_width_px + 100) + 2 * window_width_px, window_height_px / 1.5 }, { 75,75 }, 2, rng.uniform());
+	return BT_STATUS::SUCCESS;
+}
+
+static BT_STATUS spawnBottom(BehaviorCall& call)
+{
+	createMG2MeshObject(call.ctx.minigames.mg2_renderer, { (window_width_px + 100), (window_height_px - 100) }, { 75,75 }, 0, 0);
+	return BT_STATUS::SUCCESS;
+}
+
+static BT_STATUS spawnTop(BehaviorCall& call)
+{
+	createMG2MeshObject(call.ctx.minigames.mg2_renderer, { (window_width_px + 100), 100 }, { 150,-150 }, 1, 0);
+	return BT_STATUS::SUCCESS;
+}
 
-RenderSystem* render;
+// Compiled once and shared by every simulation, the state is in the spawner's blackboard
+static const BehaviorTree& mg2Tree()
+{
+	static const BehaviorTree tree = []() {
+		BehaviorLibrary library;
+		library.addCondition("hard_mode", hardMode);
+		library.addCondition("player_in_bottom_half", playerInBottomHalf);
+		library.addAction("spawn_hard", spawnHard);
+		library.addAction("spawn_bottom", spawnBottom);
+		library.addAction("spawn_top", spawnTop);
+		BehaviorTree compiled;
+		bool ok = compiled.compile(nlohmann::json::parse(MG2_TREE), library);
+		assert(ok);
+		(void)ok;
+		return compiled;
+	}();
+	return tree;
+}
 
 void MiniGame2AI::step(float elapsed_ms)
 {
-	if (pause_game_state == true) return;
-	TOTAL_TIME += elapsed_ms;
-	tickTimer += elapsed_ms;
-	
-	if (tickTimer > 4166.f) {
-		processNode(&root);
-		tickTimer = 0;
-	}
+	if (ctx.pause_game_state == true) return;
+	ctx.minigames.mg2_total_ms += elapsed_ms;
+	mg2Tree().tickAll(ctx, elapsed_ms);
 	TICK++;
 }
 
-// Initializes behavior tree for MG2. Only three nodes right now, (root + left + right) but open to extension.
 void initializeMG2Tree(RenderSystem* renderer) {
-	TOTAL_TIME = 0.0f;
-	render = renderer;
-
-	three.isEnd = true;
-	// leaf node, generate worm on top of the screen if Gen y position is less than half the screen
-	three.Action = []() {
-		createMG2MeshObject(render, { (window_width_px + 100), 100 }, { 150,-150 }, 1, 0);
-		};
-
-	two.isEnd = true;
-	// leaf node, generate worm on bottom of the screen if Gen y position is more or equal to half the screen
-	two.Action = []() {
-		createMG2MeshObject(render, { (window_width_px + 100), (window_height_px - 100) }, { 75,75 }, 0, 0);
-		};
+	SimContext& ctx = SimContext::current();
+	ctx.minigames.mg2_total_ms = 0.0f;
+	ctx.minigames.mg2_renderer = renderer;
 
-	one.isEnd = false;
-	// parent node, generate worms either on top or bottom of screen based on Gen's positions
-	one.left = &two;
-	one.right = &three;
-	one.Decision = []() -> bool {
-		Entity& player = registry.players.entities[0];
-		foregroundMotion& player_motion = registry.foregroundMotions.get(player);
-		return player_motion.position.y >= window_height_px / 2.0f;
-		};
-	
-	four.isEnd = true;
-	// leaf node, HARD MODE
-	four.Action = []() {
-		createMG2MeshObject(render, { (window_width_px + 100), (window_height_px - 100) }, { 75,75 }, 0, uniform_dist(rng));
-		createMG2MeshObject(render, { (window_width_px + 400), 100 }, { 150,-150 }, 1, uniform_dist(rng));
-		createMG2MeshObject(render, { (window_width_px + 100) + 2 * window_width_px, window_height_px / 1.5 }, { 75,75 }, 2, uniform_dist(rng));
-		};
-
-	five.isEnd = false;
-	five.left = &four;
-	five.right = &one;
-	// If enough time has passed, activate hard mode.
-	five.Decision = []() -> bool {
-		return TOTAL_TIME >= HARD_MODE_TIME;
-		};
-
-	root = five;
-
-}
\ No newline at end of file
+	// one spawner per run, the last one's blackboard goes with it
+	ECSRegistry& registry = ctx.registry;
+	for (size_t i = registry.blackboards.components.size(); i-- > 0;) {
+		if (registry.blackboards.components[i].tree == &mg2Tree())
+			registry.remove_all_components_of(registry.blackboards.entities[i]);
+	}
+	Entity spawner;
+	registry.blackboards.insert(spawner, mg2Tree().blackboard());
+}
@@ -7,8 +7,9 @@
 class MiniGame2AI : public CommonAI {
 public:
 	void step(float elapsed_ms);
-	MiniGame2AI() {}
+	MiniGame2AI(SimContext& ctx) : CommonAI(ctx) {}
 
 };
 
+// Restarts the hard mode clock, the obstacles are built from renderer's meshes
 void initializeMG2Tree(RenderSystem* renderer);
\ No newline at end of file
@@ -1,34 +1,36 @@
 #include "mg2_physics.hpp"
+#include "profiler.hpp"
 
 const int BACKGROUND_SPEED = 200;
-float countup_timer = 0;
 
 void MiniGame2Physics::step(float elapsed_ms) {
+	PROFILE_ZONE("MiniGame2Physics::step");
 	float step_seconds = elapsed_ms / 1000.f;
+	float& countup_timer = ctx.minigames.mg2_seconds;
 	countup_timer += step_seconds;
-	Entity& player = registry.players.entities[0];
-	foregroundMotion& player_motion = registry.foregroundMotions.get(player);
+	Entity& player = ctx.registry.players.entities[0];
+	foregroundMotion& player_motion = ctx.registry.foregroundMotions.get(player);
 
 	CommonPhysics::playerMovementHandler(player_motion, elapsed_ms);
 	
-	for (int i = 0; i < registry.deadlys.entities.size(); i++) {
-		Entity& deadlyMesh = registry.deadlys.entities[i];
+	for (int i = 0; i < ctx.registry.deadlys.entities.size(); i++) {
+		Entity& deadlyMesh = ctx.registry.deadlys.entities[i];
 
-		foregroundMotion& mesh_motion = registry.foregroundMotions.get(deadlyMesh);
+		foregroundMotion& mesh_motion = ctx.registry.foregroundMotions.get(deadlyMesh);
 		mesh_motion.position -= vec2{ BACKGROUND_SPEED * step_seconds, sin(countup_timer) * step_seconds * 50.f};
 		fancyMeshMotion(deadlyMesh, step_seconds);
 
 		if (isColliding(deadlyMesh, player)) {
-			registry.collisions.emplace_with_duplicates(player, deadlyMesh);
-			registry.collisions.emplace_with_duplicates(deadlyMesh, player);
+			ctx.registry.collisions.emplace_with_duplicates(player, deadlyMesh);
+			ctx.registry.collisions.emplace_with_duplicates(deadlyMesh, player);
 		}
 
 		// Delete entities that fall outside of screen
-		if (mesh_motion.position.x <= -100.0f) registry.remove_all_components_of(deadlyMesh);
+		if (mesh_motion.position.x <= -100.0f) ctx.registry.remove_all_components_of(deadlyMesh);
 	}
 
-	for (auto lipid : registry.consumables.entities) {
-		foregroundMotion& lipid_motion = registry.foregroundMotions.get(lipid);
+	for (auto lipid : ctx.registry.consumables.entities) {
+		foregroundMotion& lipid_motion = ctx.registry.foregroundMotions.get(lipid);
 		lipid_motion.position.x -= BACKGROUND_SPEED * step_seconds + sin(countup_timer*5)/5;
 	}
 
@@ -39,13 +41,14 @@ void MiniGame2Physics::step(float elapsed_ms) {
 }
 
 void initMG2Physics() {
-	countup_timer = 0;
+	SimContext::current().minigames.mg2_seconds = 0;
 }
 
 void MiniGame2Physics::fancyMeshMotion(Entity& meshEntity, float step_seconds) {
-	foregroundMotion& mesh_motion = registry.foregroundMotions.get(meshEntity);
-	Random& r = registry.random.get(meshEntity);
-	int meshIndex = registry.meshPtrs.get(meshEntity)->index;
+	foregroundMotion& mesh_motion = ctx.registry.foregroundMotions.get(meshEntity);
+	Random& r = ctx.registry.random.get(meshEntity);
+	int meshIndex = ctx.registry.meshPtrs.get(meshEntity)->index;
+	float countup_timer = ctx.minigames.mg2_seconds;
 
 	switch (meshIndex) {
 	case 0:
@@ -67,13 +70,13 @@ void MiniGame2Physics::fancyMeshMotion(Entity& meshEntity, float step_seconds) {
 }
 
 void MiniGame2Physics::moveBackground(float step_seconds) {
-	registry.backgroundMotions.get(registry.background.entities[0]).position.x -= BACKGROUND_SPEED * step_seconds;
-	registry.backgroundMotions.get(registry.background.entities[1]).position.x -= BACKGROUND_SPEED * step_seconds;
-	if (registry.backgroundMotions.get(registry.background.entities[0]).position.x <= -window_width_px/2) {
-		registry.backgroundMotions.get(registry.background.entities[0]).position.x = window_width_px + window_width_px / 2;
+	ctx.registry.backgroundMotions.get(ctx.registry.background.entities[0]).position.x -= BACKGROUND_SPEED * step_seconds;
+	ctx.registry.backgroundMotions.get(ctx.registry.background.entities[1]).position.x -= BACKGROUND_SPEED * step_seconds;
+	if (ctx.registry.backgroundMotions.get(ctx.registry.background.entities[0]).position.x <= -window_width_px/2) {
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[0]).position.x = window_width_px + window_width_px / 2;
 	}
-	if (registry.backgroundMotions.get(registry.background.entities[1]).position.x <= -window_width_px / 2) {
-		registry.backgroundMotions.get(registry.background.entities[1]).position.x = window_width_px + window_width_px / 2;
+	if (ctx.registry.backgroundMotions.get(ctx.registry.background.entities[1]).position.x <= -window_width_px / 2) {
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[1]).position.x = window_width_px + window_width_px / 2;
 	}
 }
 
@@ -82,9 +85,9 @@ void MiniGame2Physics::handleLipidCollisions() {
 	// Check for collisions between all moving entities and moving entities with staticObjects
 	// For each entity in `collidables`, check against all other collidables
 	// If there is a collision, add to the collisions container
-	ComponentContainer<foregroundMotion>& motion_container = registry.foregroundMotions;
-	ComponentContainer<Collidable>& collidableContainer = registry.collidables;
-	ComponentContainer<backgroundMotions>& staticObjectContainer = registry.backgroundMotions;
+	ComponentContainer<foregroundMotion>& motion_container = ctx.registry.foregroundMotions;
+	ComponentContainer<Collidable>& collidableContainer = ctx.registry.collidables;
+	ComponentContainer<backgroundMotions>& staticObjectContainer = ctx.registry.backgroundMotions;
 
 	for (uint i = 0; i < collidableContainer.components.size(); i++)
 	{
@@ -98,13 +101,13 @@ void MiniGame2Physics::handleLipidCollisions() {
 			Entity& entity_j = collidableContainer.entities[j];
 
 			// in Mini Game
-			bool oneIsPlayer = entity_i == registry.players.entities[0] || entity_j == registry.players.entities[0];
-			bool oneIsConsumable = registry.consumables.has(entity_i) || registry.consumables.has(entity_j);
+			bool oneIsPlayer = entity_i == ctx.registry.players.entities[0] || entity_j == ctx.registry.players.entities[0];
+			bool oneIsConsumable = ctx.registry.consumables.has(entity_i) || ctx.registry.consumables.has(entity_j);
 
 			// check that one is the player and one is a consumable and that they are colliding
 			if (oneIsPlayer && oneIsConsumable && checkCircleCollision(entity_i, entity_j)) {
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 		}
 	}
@@ -7,7 +7,7 @@ class MiniGame2Physics : public CommonPhysics {
 	
 public:
 	void step(float elapsed_ms);
-	MiniGame2Physics() {}
+	MiniGame2Physics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void moveBackground(float step_seconds);
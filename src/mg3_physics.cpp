@@ -1,34 +1,34 @@
 #include "mg3_physics.hpp"
+#include "profiler.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <components.hpp>
 #include <SDL_mixer.h>
 #include "world_init.hpp"
 
-bool on_platform = false;
 float gravity_factor = 82.f;
-int jump_count = 0;
 bool is_in_acid(Entity& entity);
 
 void MiniGame3Physics::step(float elapsed_ms) 
 {
+	PROFILE_ZONE("MiniGame3Physics::step");
 	float step = elapsed_ms / 1000.0f;
 
-	auto& foregroundMotions_registry = registry.foregroundMotions;
-	for (Entity platform_entity : registry.platform.entities)
+	auto& foregroundMotions_registry = ctx.registry.foregroundMotions;
+	for (Entity platform_entity : ctx.registry.platform.entities)
 	{
 		foregroundMotion& motion = foregroundMotions_registry.get(platform_entity);
 		motion.position += motion.velocity * step;
 	}
 
-	for (Entity finish_line : registry.finishLine.entities)
+	for (Entity finish_line : ctx.registry.finishLine.entities)
 	{
 		foregroundMotion& motion = foregroundMotions_registry.get(finish_line);
 		motion.position += motion.velocity * step;
 	}
 
-	Entity& player = registry.players.entities[0];
-	foregroundMotion& player_motion = registry.foregroundMotions.get(player);
+	Entity& player = ctx.registry.players.entities[0];
+	foregroundMotion& player_motion = ctx.registry.foregroundMotions.get(player);
 
 	glucose_movement(elapsed_ms);
 	handlePlayerMovement(elapsed_ms, player, player_motion);
@@ -45,8 +45,8 @@ void MiniGame3Physics::handlePlayerMovement(float elapsed_ms, Entity entity, for
 
 	player_motion.velocity.x = 0;
 	// Free Left / Right movement 
-	for (int i = 0; i < sizeof(keymap) / sizeof(keymap[0]); i++) {
-		if (keymap[i]) {
+	for (int i = 0; i < sizeof(ctx.input.keys) / sizeof(ctx.input.keys[0]); i++) {
+		if (ctx.input.keys[i]) {
 			switch (i) {
 			case GLFW_KEY_A:
 				if (!disable_a)
@@ -62,21 +62,21 @@ void MiniGame3Physics::handlePlayerMovement(float elapsed_ms, Entity entity, for
 
 	player_motion.position.x += player_motion.velocity.x * step;
 	// Player jumping movement
-	if (registry.jump.has(entity))
+	if (ctx.registry.jump.has(entity))
 	{
 		player_motion.velocity.y += (gravity_factor * step * 6);
 
 		if (player_motion.velocity.y >= gravity_factor)
 		{
 			player_motion.velocity.y = gravity_factor * 3;
-			registry.jump.remove(entity);
+			ctx.registry.jump.remove(entity);
 		}
 
 		player_motion.position.y += player_motion.velocity.y * step * 2;
 	}
 	else
 	{
-		if (on_platform)
+		if (ctx.minigames.on_platform)
 			player_motion.velocity.y = gravity_factor;
 		else
 			player_motion.velocity.y = gravity_factor * 3;
@@ -93,10 +93,10 @@ void MiniGame3Physics::glucose_movement(float elapsed_ms)
 {
 	float step = elapsed_ms / 1000.f;
 
-	auto& consumable_registry = registry.consumables;
+	auto& consumable_registry = ctx.registry.consumables;
 	for (Entity entity : consumable_registry.entities)
 	{
-		foregroundMotion& g_motion = registry.foregroundMotions.get(entity);
+		foregroundMotion& g_motion = ctx.registry.foregroundMotions.get(entity);
 
 		if (g_motion.velocity.y < gravity_factor * 3)
 		{
@@ -135,7 +135,7 @@ void MiniGame3Physics::glucose_movement(float elapsed_ms)
 
 void MiniGame3Physics::checkOffPlatform(Entity& entity, foregroundMotion& player_motion)
 {
-	if (on_platform)
+	if (ctx.minigames.on_platform)
 	{
 		vec2 player_bb = get_bounding_box(entity);
 		vec4 player_bbox_corners = get_bbox_corners(player_bb, player_motion.position);
@@ -143,9 +143,9 @@ void MiniGame3Physics::checkOffPlatform(Entity& entity, foregroundMotion& player
 		float x1_min = player_bbox_corners[0];
 		float x1_max = player_bbox_corners[1];
 
-		if (registry.foregroundMotions.has(player_on_platform))
+		if (ctx.registry.foregroundMotions.has(player_on_platform))
 		{
-			foregroundMotion& platform_motion = registry.foregroundMotions.get(player_on_platform);
+			foregroundMotion& platform_motion = ctx.registry.foregroundMotions.get(player_on_platform);
 			vec2 platform_bb = get_bounding_box(player_on_platform);
 			vec4 platform_bbox_corners = get_bbox_corners(platform_bb, platform_motion.position);
 
@@ -154,22 +154,22 @@ void MiniGame3Physics::checkOffPlatform(Entity& entity, foregroundMotion& player
 
 			if (x1_min > x2_min && x1_min > (x2_max - 5))
 			{
-				Platform& platform = registry.platform.get(player_on_platform);
+				Platform& platform = ctx.registry.platform.get(player_on_platform);
 				platform.below = false;
-				on_platform = false;
+				ctx.minigames.on_platform = false;
 				player_motion.position.x = x2_max + (player_bb.x / 2);
 			}
 			else if (x1_max < (x2_min + 5) && x1_max < x2_max)
 			{
-				Platform& platform = registry.platform.get(player_on_platform);
+				Platform& platform = ctx.registry.platform.get(player_on_platform);
 				platform.below = false;
-				on_platform = false;
+				ctx.minigames.on_platform = false;
 				player_motion.position.x = x2_min - (player_bb.x / 2);
 			}
 		}
 		else
 		{
-			on_platform = false;
+			ctx.minigames.on_platform = false;
 		}
 	}
 }
@@ -186,9 +186,9 @@ void MiniGame3Physics::handlePlatformCollisions(Entity& player, foregroundMotion
 	float y1_max = player_bbox_corners[3];
 
 	// Platform & Player Collisions
-	for (Entity platform_entity : registry.platform.entities)
+	for (Entity platform_entity : ctx.registry.platform.entities)
 	{ 
-		foregroundMotion& platform_motion = registry.foregroundMotions.get(platform_entity);
+		foregroundMotion& platform_motion = ctx.registry.foregroundMotions.get(platform_entity);
 		vec2 platform_position = platform_motion.position;
 		vec2 platform_bb = get_bounding_box(platform_entity);
 		vec4 platform_bbox_corners = get_bbox_corners(platform_bb, platform_position);
@@ -199,20 +199,20 @@ void MiniGame3Physics::handlePlatformCollisions(Entity& player, foregroundMotion
 		float y2_max = platform_bbox_corners[3];
 
 		// only check for platform landings after jumping
-		if (!on_platform)
+		if (!ctx.minigames.on_platform)
 		{
 			// Only land on platforms that are below the player
-			Platform& platform = registry.platform.get(platform_entity);
+			Platform& platform = ctx.registry.platform.get(platform_entity);
 			if (platform.below)
 			{
 				if ((y1_max >= y2_min && y1_min < y2_min) && ((x1_min > x2_min && (x1_min < (x2_max - 20))) || ((x1_max > (x2_min + 20)) && x1_max < x2_max)))
 				{
-					on_platform = true;
+					ctx.minigames.on_platform = true;
 					player_on_platform = platform_entity;
-					jump_count = 0;
+					ctx.minigames.jump_count = 0;
 				}
 				else
-					on_platform = false;
+					ctx.minigames.on_platform = false;
 			}
 
 			// update if platforms are lower than player
@@ -223,10 +223,10 @@ void MiniGame3Physics::handlePlatformCollisions(Entity& player, foregroundMotion
 
 		}
 
-		auto& consumable_registry = registry.consumables;
+		auto& consumable_registry = ctx.registry.consumables;
 		for (Entity consumable : consumable_registry.entities)
 		{
-			foregroundMotion& c_motion = registry.foregroundMotions.get(consumable);
+			foregroundMotion& c_motion = ctx.registry.foregroundMotions.get(consumable);
 			vec2 glucose_position = c_motion.position;
 			vec2 glucose_bb = get_bounding_box(consumable);
 			vec4 glucose_bbox_corners = get_bbox_corners(glucose_bb, glucose_position);
@@ -254,7 +254,7 @@ void MiniGame3Physics::handlePlatformCollisions(Entity& player, foregroundMotion
 void MiniGame3Physics::collisionDetection()
 {
 	// Acid Collisions
-	ComponentContainer<Collidable>& collidableContainer = registry.collidables;
+	ComponentContainer<Collidable>& collidableContainer = ctx.registry.collidables;
 	for (uint i = 0; i < collidableContainer.entities.size(); i++)
 	{
 		Entity& entity_i = collidableContainer.entities[i];
@@ -263,36 +263,36 @@ void MiniGame3Physics::collisionDetection()
 		{
 			Entity& entity_j = collidableContainer.entities[j];
 
-			bool oneIsAcid = registry.deadlys.has(entity_i) || registry.deadlys.has(entity_j);
-			bool oneIsPlayer = registry.players.has(entity_i) || registry.players.has(entity_j);
-			bool oneIsPlatform = registry.platform.has(entity_i) || registry.platform.has(entity_j);
-			bool oneIsGlucose = registry.consumables.has(entity_i) || registry.consumables.has(entity_j);
-			bool oneIsFinishLine = registry.finishLine.has(entity_i) || registry.finishLine.has(entity_j);
+			bool oneIsAcid = ctx.registry.deadlys.has(entity_i) || ctx.registry.deadlys.has(entity_j);
+			bool oneIsPlayer = ctx.registry.players.has(entity_i) || ctx.registry.players.has(entity_j);
+			bool oneIsPlatform = ctx.registry.platform.has(entity_i) || ctx.registry.platform.has(entity_j);
+			bool oneIsGlucose = ctx.registry.consumables.has(entity_i) || ctx.registry.consumables.has(entity_j);
+			bool oneIsFinishLine = ctx.registry.finishLine.has(entity_i) || ctx.registry.finishLine.has(entity_j);
 
 			if (oneIsAcid && oneIsPlatform && (is_in_acid(entity_i) && is_in_acid(entity_j)))
 			{
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 			else if (oneIsAcid && oneIsPlayer && (is_in_acid(entity_i) && is_in_acid(entity_j)))
 			{
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 			else if (oneIsAcid && oneIsGlucose && (is_in_acid(entity_i) && is_in_acid(entity_j)))
 			{
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 			else if (oneIsPlayer && oneIsGlucose && checkBoxCollision(entity_i, entity_j))
 			{
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 			else if (oneIsPlayer && oneIsFinishLine && playerFinish(entity_i, entity_j))
 			{
-				registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+				ctx.registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+				ctx.registry.collisions.emplace_with_duplicates(entity_j, entity_i);
 			}
 		}
 	}
@@ -310,9 +310,9 @@ void MiniGame3Physics::handleOffPlatformSideCollisions(Entity& player, foregroun
 	float y1_max = player_bbox_corners[3];
 
 	// Platform & Player Collisions
-	for (Entity platform_entity : registry.platform.entities)
+	for (Entity platform_entity : ctx.registry.platform.entities)
 	{
-		foregroundMotion& platform_motion = registry.foregroundMotions.get(platform_entity);
+		foregroundMotion& platform_motion = ctx.registry.foregroundMotions.get(platform_entity);
 		vec2 platform_position = platform_motion.position;
 		vec2 platform_bb = get_bounding_box(platform_entity);
 		vec4 platform_bbox_corners = get_bbox_corners(platform_bb, platform_position);
@@ -323,7 +323,7 @@ void MiniGame3Physics::handleOffPlatformSideCollisions(Entity& player, foregroun
 		float y2_max = platform_bbox_corners[3];
 
 		// check for off-platform collisions with other platforms
-		if (!on_platform)
+		if (!ctx.minigames.on_platform)
 		{
 			// check for player right side collisions to left side of platform
 			if (checkBoxCollision(player, platform_entity))
@@ -361,10 +361,10 @@ void MiniGame3Physics::handleOffPlatformSideCollisions(Entity& player, foregroun
 
 bool MiniGame3Physics::playerFinish(Entity& entity_i, Entity& entity_j)
 {
-	if (registry.players.has(entity_i) && registry.finishLine.has(entity_j))
+	if (ctx.registry.players.has(entity_i) && ctx.registry.finishLine.has(entity_j))
 	{
-		foregroundMotion& player_motion = registry.foregroundMotions.get(entity_i);
-		foregroundMotion& finish_line_motion = registry.foregroundMotions.get(entity_j);
+		foregroundMotion& player_motion = ctx.registry.foregroundMotions.get(entity_i);
+		foregroundMotion& finish_line_motion = ctx.registry.foregroundMotions.get(entity_j);
 
 		float player_y = player_motion.position.y;
 		float finish_line_y = finish_line_motion.position.y;
@@ -378,9 +378,10 @@ bool MiniGame3Physics::playerFinish(Entity& entity_i, Entity& entity_j)
 
 bool is_in_acid(Entity& entity)
 {
-	Entity& acid = registry.deadlys.entities[0];
-	foregroundMotion& acid_motion = registry.foregroundMotions.get(acid);
-	foregroundMotion& motion = registry.foregroundMotions.get(entity);
+	SimContext& ctx = SimContext::current();
+	Entity& acid = ctx.registry.deadlys.entities[0];
+	foregroundMotion& acid_motion = ctx.registry.foregroundMotions.get(acid);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.get(entity);
 	
 	return acid_motion.position.y <= motion.position.y;
 }
@@ -3,15 +3,13 @@
 #include "common_physics.hpp"
 #include "tiny_ecs_registry.hpp"
 
-extern bool on_platform;
 extern float gravity_factor;
-extern int jump_count;
 
 class MiniGame3Physics : public CommonPhysics {
 
 public:
 	void step(float elapsed_ms);
-	MiniGame3Physics() {}
+	MiniGame3Physics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	
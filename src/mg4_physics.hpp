@@ -9,11 +9,13 @@ class MiniGame4Physics : public CommonPhysics {
 
 public:
 	void step(float elapsed_ms);
-	MiniGame4Physics() {}
+	MiniGame4Physics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void activateAMole();
 	void moveMole();
 	void handleVirusCollision();
 	void handleIronMotion(Entity& ironEntity, float step_seconds);
+
+	unsigned int spawningCounter = 1;
 };
\ No newline at end of file
@@ -1,42 +1,44 @@
 #include "mg5_physics.hpp"
+#include "profiler.hpp"
 #include "particle_system.hpp"
 
 void MiniGame5Physics::step(float elapsed_ms) {
+	PROFILE_ZONE("MiniGame5Physics::step");
 
 	float step_seconds = elapsed_ms / 1000.f;
 	
-	Entity& paddle = registry.paddles.entities[0];
-	foregroundMotion& paddleMotion = registry.foregroundMotions.get(paddle);
+	Entity& paddle = ctx.registry.paddles.entities[0];
+	foregroundMotion& paddleMotion = ctx.registry.foregroundMotions.get(paddle);
 	paddleMovementHandler(paddleMotion, step_seconds);
 	
 	// consumable movement
-	for (Entity& consumableEntity: registry.consumables.entities) {
+	for (Entity& consumableEntity: ctx.registry.consumables.entities) {
 
-		if (registry.powerUps.has(consumableEntity)) {
+		if (ctx.registry.powerUps.has(consumableEntity)) {
 			
-			foregroundMotion& motion = registry.foregroundMotions.get(consumableEntity);
+			foregroundMotion& motion = ctx.registry.foregroundMotions.get(consumableEntity);
 			motion.position += motion.velocity * step_seconds;
-			if (checkBoxCollision(consumableEntity, paddle)) registry.collisions.emplace(consumableEntity, paddle);
+			if (checkBoxCollision(consumableEntity, paddle)) ctx.registry.collisions.emplace(consumableEntity, paddle);
 
 		} else {
 
 			handleOxygenMotion(consumableEntity, step_seconds);
-			if (checkBoxCollision(consumableEntity, paddle)) registry.collisions.emplace(consumableEntity, paddle);
+			if (checkBoxCollision(consumableEntity, paddle)) ctx.registry.collisions.emplace(consumableEntity, paddle);
 		}
 	}
 
 	// move the ball
-	for (Entity& ballEntity : registry.balls.entities) {
-		foregroundMotion& motion = registry.foregroundMotions.get(ballEntity);
+	for (Entity& ballEntity : ctx.registry.balls.entities) {
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(ballEntity);
 		motion.position += motion.velocity * step_seconds;
 		checkForBounce(ballEntity);
 	}
 
-	stepParticles(elapsed_ms);
+	// particles are integrated in PhysicsSystem::scheduleTasks
 }
 
 void MiniGame5Physics::checkForBounce(Entity& ballEntity) {
-	foregroundMotion& ballMotion = registry.foregroundMotions.get(ballEntity);
+	foregroundMotion& ballMotion = ctx.registry.foregroundMotions.get(ballEntity);
 	BBox ballBBox = getBBoxBounds(ballEntity);
 
 	checkForCollisions(ballEntity);
@@ -52,23 +54,23 @@ void MiniGame5Physics::checkForBounce(Entity& ballEntity) {
 		ballMotion.position.y = (-ballMotion.scale.y) / 2;
 		ballMotion.velocity.y *= -1;
 	} else if (ballBBox.top > window_height_px) { // if ball passed the bottom of the screen
-		registry.remove_all_components_of(ballEntity);
+		ctx.registry.remove_all_components_of(ballEntity);
 	}
 
 }
 
 void MiniGame5Physics::checkForCollisions(Entity& ballEntity) {
-	Entity& paddle = registry.paddles.entities[0];
+	Entity& paddle = ctx.registry.paddles.entities[0];
 
 	// check for paddle collisions
 	if (checkBoxCollision(paddle, ballEntity)) {
 		handlePaddleCollision(paddle, ballEntity);
 	}
 
-	for (Entity& brickEntity : registry.bricks.entities) {
+	for (Entity& brickEntity : ctx.registry.bricks.entities) {
 		if (checkBoxCollision(brickEntity, ballEntity)) {
 			handleBrickCollision(brickEntity, ballEntity);
-			registry.collisions.emplace_with_duplicates(brickEntity, ballEntity);
+			ctx.registry.collisions.emplace_with_duplicates(brickEntity, ballEntity);
 		}
 	}
 
@@ -101,7 +103,7 @@ void handlePaddleTopReflection(foregroundMotion& ball, BBox& paddleBBox) {
 }
 
 void MiniGame5Physics::handlePaddleCollision(Entity& paddleEntity, Entity& ballEntity) {
-	foregroundMotion& ball = registry.foregroundMotions.get(ballEntity);
+	foregroundMotion& ball = ctx.registry.foregroundMotions.get(ballEntity);
 	BBox paddleBBox = CommonPhysics::getBBoxBounds(paddleEntity);
 
 	if (ball.position.y < paddleBBox.top) {
@@ -117,7 +119,7 @@ void MiniGame5Physics::handlePaddleCollision(Entity& paddleEntity, Entity& ballE
 }
 
 void MiniGame5Physics::handleBrickCollision(Entity& brickEntity, Entity& ballEntity) {
-	foregroundMotion& ball = registry.foregroundMotions.get(ballEntity);
+	foregroundMotion& ball = ctx.registry.foregroundMotions.get(ballEntity);
 	BBox brickBBox = CommonPhysics::getBBoxBounds(brickEntity);
 
 	if (ball.position.y < brickBBox.top) {
@@ -136,8 +138,8 @@ void MiniGame5Physics::handleBrickCollision(Entity& brickEntity, Entity& ballEnt
 }
 
 void MiniGame5Physics::handleOxygenMotion(Entity& oxygenEntity, float step_seconds) {
-	foregroundMotion& motion = registry.foregroundMotions.get(oxygenEntity);
-	BezierCurve& bezier = registry.beziers.get(oxygenEntity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.get(oxygenEntity);
+	BezierCurve& bezier = ctx.registry.beziers.get(oxygenEntity);
 	bezier.t = fmin(bezier.t + step_seconds / 2.f, 1.0f);
 
 	motion.position = getBezierPosition(bezier);
@@ -146,15 +148,15 @@ void MiniGame5Physics::handleOxygenMotion(Entity& oxygenEntity, float step_secon
 }
 
 void MiniGame5Physics::removeOffScreen(Entity& entity) {
-	foregroundMotion& motion = registry.foregroundMotions.get(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.get(entity);
 	if (motion.position.y - abs(motion.scale.y) > window_height_px) {
-		registry.remove_all_components_of(entity);
+		ctx.registry.remove_all_components_of(entity);
 	}
 }
 
 void MiniGame5Physics::paddleMovementHandler(foregroundMotion& paddleMotion, float step_seconds) {
-	for (int i = 0; i < sizeof(keymap) / sizeof(keymap[0]); i++) {
-		if (keymap[i]) {
+	for (int i = 0; i < sizeof(ctx.input.keys) / sizeof(ctx.input.keys[0]); i++) {
+		if (ctx.input.keys[i]) {
 			switch (i) {
 			case GLFW_KEY_A:
 				paddleMotion.position.x += -PADDLE_STEP * step_seconds * 40.f;
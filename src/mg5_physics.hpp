@@ -10,7 +10,7 @@ class MiniGame5Physics : public CommonPhysics {
 	
 public:
 	void step(float elapsed_ms);
-	MiniGame5Physics() {}
+	MiniGame5Physics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void checkForBounce(Entity& ballEntity);
@@ -0,0 +1,191 @@
+// internal
+#include "minigame_bots.hpp"
+
+// stlib
+#include <cmath>
+
+void MinigameBot::think(std::vector<InputEvent>& out)
+{
+	events = &out;
+	// the tutorial is the only pause a running minigame has, space closes it
+	if (ctx.pause_game_state)
+		tap(GLFW_KEY_SPACE);
+	else
+		play();
+	events = nullptr;
+}
+
+void MinigameBot::hold(int key, bool down)
+{
+	if (ctx.input.keys[key] == down)
+		return;
+	InputEvent event;
+	event.tick = (uint32_t)ctx.clock.tick;
+	event.type = INPUT_EVENT_TYPE::KEY;
+	event.code = key;
+	event.action = down ? GLFW_PRESS : GLFW_RELEASE;
+	events->push_back(event);
+}
+
+void MinigameBot::tap(int key)
+{
+	InputEvent event;
+	event.tick = (uint32_t)ctx.clock.tick;
+	event.type = INPUT_EVENT_TYPE::KEY;
+	event.code = key;
+	event.action = GLFW_PRESS;
+	events->push_back(event);
+	event.action = GLFW_RELEASE;
+	events->push_back(event);
+}
+
+void MinigameBot::steer(float from, float to, int less_key, int more_key, float dead_zone)
+{
+	hold(less_key, to < from - dead_zone);
+	hold(more_key, to > from + dead_zone);
+}
+
+namespace {
+	// Blood vessel: lines up with the next lipid and swaps to the other half
+	// of the vessel when an obstacle is coming up on that line
+	class MiniGame2Bot : public MinigameBot
+	{
+	public:
+		MiniGame2Bot(SimContext& ctx) : MinigameBot(ctx) {}
+
+	protected:
+		void play()
+		{
+			if (ctx.registry.players.entities.empty())
+				return;
+			vec2 player = ctx.registry.foregroundMotions.get(ctx.registry.players.entities[0]).position;
+
+			float target_y = window_height_px / 2.f;
+			float nearest_x = INFINITY;
+			for (Entity lipid : ctx.registry.consumables.entities) {
+				vec2 pos = ctx.registry.foregroundMotions.get(lipid).position;
+				if (pos.x > player.x - 20.f && pos.x < nearest_x) {
+					nearest_x = pos.x;
+					target_y = pos.y;
+				}
+			}
+
+			for (Entity deadly : ctx.registry.deadlys.entities) {
+				const foregroundMotion& motion = ctx.registry.foregroundMotions.get(deadly);
+				vec2 half = abs(motion.scale) / 2.f;
+				bool ahead = motion.position.x - half.x < player.x + 300.f && motion.position.x + half.x > player.x - 50.f;
+				if (ahead && std::abs(target_y - motion.position.y) < half.y + 60.f)
+					target_y = motion.position.y > window_height_px / 2.f ? 200.f : window_height_px - 150.f;
+			}
+
+			steer(player.y, target_y, GLFW_KEY_W, GLFW_KEY_S, 10.f);
+			steer(player.x, 300.f, GLFW_KEY_A, GLFW_KEY_D, 20.f);
+		}
+	};
+
+	// Whack a mole: walks to the angriest mole and whacks it, picks up iron in between
+	class MiniGame4Bot : public MinigameBot
+	{
+	public:
+		MiniGame4Bot(SimContext& ctx) : MinigameBot(ctx) {}
+
+	protected:
+		void play()
+		{
+			if (ctx.registry.players.entities.empty())
+				return;
+			Entity player = ctx.registry.players.entities[0];
+			vec2 player_pos = ctx.registry.foregroundMotions.get(player).position;
+
+			// standing on an active mole, the world whacks it on the space release
+			for (unsigned int i = 0; i < ctx.registry.collisions.size(); i++) {
+				Entity other = ctx.registry.collisions.components[i].other;
+				if (ctx.registry.collisions.entities[i] == player && isTarget(other)) {
+					tap(GLFW_KEY_SPACE);
+					return;
+				}
+			}
+
+			bool found = false;
+			float anger = -1.f;
+			vec2 target = { window_width_px / 2.f, window_height_px / 2.f };
+			for (unsigned int i = 0; i < ctx.registry.whackAMole.size(); i++) {
+				Entity mole = ctx.registry.whackAMole.entities[i];
+				const WhackAMole& state = ctx.registry.whackAMole.components[i];
+				if (isTarget(mole) && state.angerLevel > anger) {
+					anger = state.angerLevel;
+					target = ctx.registry.foregroundMotions.get(mole).position;
+					found = true;
+				}
+			}
+			if (!found) {
+				float nearest = INFINITY;
+				for (Entity iron : ctx.registry.consumables.entities) {
+					vec2 pos = ctx.registry.foregroundMotions.get(iron).position;
+					float distance = length(pos - player_pos);
+					if (distance < nearest) {
+						nearest = distance;
+						target = pos;
+					}
+				}
+			}
+
+			steer(player_pos.x, target.x, GLFW_KEY_A, GLFW_KEY_D, 15.f);
+			steer(player_pos.y, target.y, GLFW_KEY_W, GLFW_KEY_S, 15.f);
+		}
+
+	private:
+		bool isTarget(Entity mole)
+		{
+			if (!ctx.registry.whackAMole.has(mole))
+				return false;
+			const WhackAMole& state = ctx.registry.whackAMole.get(mole);
+			return state.active && !state.whacked && !state.exploded;
+		}
+	};
+
+	// Brick breaker: keeps the paddle under the lowest ball that is falling
+	class MiniGame5Bot : public MinigameBot
+	{
+	public:
+		MiniGame5Bot(SimContext& ctx) : MinigameBot(ctx) {}
+
+	protected:
+		void play()
+		{
+			if (ctx.registry.paddles.entities.empty() || ctx.registry.balls.entities.empty())
+				return;
+			float paddle_x = ctx.registry.foregroundMotions.get(ctx.registry.paddles.entities[0]).position.x;
+
+			// balls going up can wait, the lowest one going down can't
+			float target_x = paddle_x;
+			float lowest = -INFINITY;
+			bool falling = false;
+			for (Entity ball : ctx.registry.balls.entities) {
+				const foregroundMotion& motion = ctx.registry.foregroundMotions.get(ball);
+				bool ball_falling = motion.velocity.y > 0.f;
+				if ((ball_falling && !falling) || (ball_falling == falling && motion.position.y > lowest)) {
+					falling = ball_falling;
+					lowest = motion.position.y;
+					target_x = motion.position.x;
+				}
+			}
+
+			steer(paddle_x, target_x, GLFW_KEY_A, GLFW_KEY_D, 15.f);
+		}
+	};
+}
+
+std::unique_ptr<MinigameBot> createMinigameBot(GAME_STATES minigame, SimContext& ctx)
+{
+	switch (minigame) {
+	case GAME_STATES::MINIGAME_2:
+		return std::unique_ptr<MinigameBot>(new MiniGame2Bot(ctx));
+	case GAME_STATES::MINIGAME_4:
+		return std::unique_ptr<MinigameBot>(new MiniGame4Bot(ctx));
+	case GAME_STATES::MINIGAME_5:
+		return std::unique_ptr<MinigameBot>(new MiniGame5Bot(ctx));
+	default:
+		return nullptr;
+	}
+}
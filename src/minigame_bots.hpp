@@ -0,0 +1,46 @@
+#pragma once
+
+// internal
+#include "components.hpp"
+#include "input_recording.hpp"
+#include "sim_context.hpp"
+
+// stlib
+#include <memory>
+#include <vector>
+
+// Plays a minigame by sending the same key events a player would, so every
+// rule the world applies to input applies to the bot too. Looks at the
+// registry before each step and only ever presses what a person could.
+//
+//     std::unique_ptr<MinigameBot> bot = createMinigameBot(GAME_STATES::MINIGAME_4, ctx);
+//     std::vector<InputEvent> events;
+//     bot->think(events);
+//     for (const InputEvent& event : events) world.applyInput(event);
+class MinigameBot
+{
+public:
+	MinigameBot(SimContext& ctx) : ctx(ctx) {}
+	virtual ~MinigameBot() {}
+
+	// Appends the input for the coming step. Tutorials are dismissed first.
+	void think(std::vector<InputEvent>& events);
+
+protected:
+	virtual void play() = 0;
+
+	// Presses or releases a movement key (WASD) if it isn't already
+	void hold(int key, bool down);
+	// Press and release in the same step
+	void tap(int key);
+	// Holds the keys that move from `from` towards `to` along one axis, dead_zone px either side
+	void steer(float from, float to, int less_key, int more_key, float dead_zone);
+
+	SimContext& ctx;
+
+private:
+	std::vector<InputEvent>* events = nullptr;
+};
+
+// Null for minigames without a bot (1 and 3, their runs need a recording)
+std::unique_ptr<MinigameBot> createMinigameBot(GAME_STATES minigame, SimContext& ctx);
@@ -0,0 +1,96 @@
+// internal
+#include "nav_table.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <cstdio>
+
+static const uint16_t UNREACHABLE = UINT16_MAX;
+
+bool NavTable::build(const GridMap& map, uint32_t version)
+{
+	PROFILE_ZONE("NavTable::build");
+	valid = false;
+	distances.clear();
+	directions.clear();
+	if (map.cells() > (size_t)MAX_CELLS) {
+		fprintf(stderr, "NavTable: %dx%d is too big for a table, %d cells at most\n", map.columns, map.rows, MAX_CELLS);
+		return false;
+	}
+
+	columns = map.columns;
+	rows = map.rows;
+	cells = (int)map.cells();
+	distances.assign((size_t)cells * cells, UNREACHABLE);
+	directions.assign((size_t)cells * cells, 0);
+
+	// a breadth first search out from every target, in the same order as FlowField
+	// so both pick the same way when two are equally short
+	const int dx[4] = { 0, 1, 0, -1 };
+	const int dy[4] = { -1, 0, 1, 0 };
+	const Direction back[4] = { DOWN, LEFT, UP, RIGHT };
+	std::vector<int> queue(cells);
+	for (int target = 0; target < cells; target++) {
+		if (map.walls[target])
+			continue;
+		uint16_t* distance = &distances[entry(0, target)];
+		uint8_t* direction = &directions[entry(0, target)];
+		size_t head = 0, tail = 0;
+		distance[target] = 0;
+		queue[tail++] = target;
+		while (head < tail) {
+			int cell = queue[head++];
+			int column = cell % columns;
+			int row = cell / columns;
+			for (int i = 0; i < 4; i++) {
+				int next_column = column + dx[i];
+				int next_row = row + dy[i];
+				if (!map.open(next_column, next_row))
+					continue;
+				int next = map.index(next_column, next_row);
+				if (distance[next] != UNREACHABLE)
+					continue;
+				distance[next] = distance[cell] + 1;
+				direction[next] = (uint8_t)back[i];
+				queue[tail++] = next;
+			}
+		}
+	}
+
+	built_version = version;
+	valid = true;
+	return true;
+}
+
+int NavTable::distance(int from, int to) const
+{
+	if (!valid || from < 0 || to < 0 || from >= cells || to >= cells)
+		return -1;
+	uint16_t steps = distances[entry(from, to)];
+	return steps == UNREACHABLE ? -1 : steps;
+}
+
+bool NavTable::direction(int from, int to, Direction& dir) const
+{
+	if (distance(from, to) <= 0)
+		return false;
+	dir = (Direction)directions[entry(from, to)];
+	return true;
+}
+
+std::vector<Direction> NavTable::path(int from, int to) const
+{
+	std::vector<Direction> steps;
+	int length = distance(from, to);
+	if (length <= 0)
+		return steps;
+	steps.reserve(length);
+	const int dx[4] = { 0, 1, 0, -1 };
+	const int dy[4] = { -1, 0, 1, 0 };
+	for (int cell = from; cell != to;) {
+		Direction dir = (Direction)directions[entry(cell, to)];
+		steps.push_back(dir);
+		cell += dy[dir] * columns + dx[dir];
+	}
+	return steps;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// internal
+#include "grid_search.hpp"
+
+// stlib
+#include <cstdint>
+#include <vector>
+
+// Exact distances and first steps between every pair of cells of a small
+// grid, found by a breadth first search from each cell once per maze. It
+// takes cells² entries, about 20k for the minigame 1 maze, so it's only built
+// for grids up to MAX_CELLS. Lookups are O(1), and the distances are a
+// perfect heuristic for A* on the same grid (see gridAStar).
+//
+//     ctx.maze_nav.build(map, ctx.maze_version);
+//     if (ctx.maze_nav.built(ctx.maze_version) && ctx.maze_nav.direction(from, to, dir)) ...
+class NavTable
+{
+public:
+	static const int MAX_CELLS = 4096;
+
+	// False, and the table left empty, when the grid has more than MAX_CELLS cells
+	bool build(const GridMap& map, uint32_t version);
+	// Built for that maze version
+	bool built(uint32_t version) const { return valid && built_version == version; }
+
+	// Steps between two cells (row * columns + column), -1 if either is a wall or there's no way through
+	int distance(int from, int to) const;
+	// First step from one cell on a shortest path to the other, false if there isn't one or they're the same cell
+	bool direction(int from, int to, Direction& dir) const;
+	// Every step of a shortest path, empty if there isn't one
+	std::vector<Direction> path(int from, int to) const;
+
+	int columns = 0;
+	int rows = 0;
+
+private:
+	size_t entry(int from, int to) const { return (size_t)to * cells + from; }
+
+	int cells = 0;
+	bool valid = false;
+	uint32_t built_version = 0;
+	// per target cell, per cell: steps to the target and the way to go, UINT16_MAX when there's none
+	std::vector<uint16_t> distances;
+	std::vector<uint8_t> directions;
+};
@@ -0,0 +1,371 @@
+// internal
+#include "organ_navmesh.hpp"
+#include "components.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+
+int (*organBoundary(unsigned int game_state))[ORGAN_BOUNDARY_COLUMNS]
+{
+	switch (game_state) {
+	case (int)GAME_STATES::ORGAN_1:
+		return ORGAN_1_BOUNDARY;
+	case (int)GAME_STATES::ORGAN_2:
+		return ORGAN_2_BOUNDARY;
+	case (int)GAME_STATES::ORGAN_3:
+		return ORGAN_3_BOUNDARY;
+	case (int)GAME_STATES::ORGAN_4:
+		return ORGAN_4_BOUNDARY;
+	case (int)GAME_STATES::ORGAN_5:
+		return ORGAN_5_BOUNDARY;
+	case (int)GAME_STATES::BRAIN_LOCKED:
+		return BRAIN_LOCKED_BOUNDARY;
+	case (int)GAME_STATES::BRAIN_UNLOCKED:
+		return BRAIN_UNLOCKED_BOUNDARY;
+	}
+	return nullptr;
+}
+
+// Positive when b is to the left of a
+static float cross(vec2 a, vec2 b)
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+// Every cell edge of the map and the lines clearance either side of it, kept
+// on the map so no step of the mesh's grid is narrower than it needs to be
+static std::vector<float> gridLines(int cells, float cell_px, float clearance)
+{
+	float size = cells * cell_px;
+	std::vector<float> lines;
+	for (int k = 0; k <= cells; k++) {
+		for (float line : { k * cell_px - clearance, k * cell_px, k * cell_px + clearance })
+			lines.push_back(std::max(0.f, std::min(size, line)));
+	}
+	std::sort(lines.begin(), lines.end());
+	lines.erase(std::unique(lines.begin(), lines.end(), [](float a, float b) { return b - a < 1e-3f; }), lines.end());
+	return lines;
+}
+
+// Whether the square reaching clearance either side of a point misses every
+// wall cell, off the map counts as wall. Only asked about the middles of the
+// mesh's cells, which are never on a line where that changes.
+static bool clear(const GridMap& map, float cell_px, float clearance, vec2 point)
+{
+	int first_column = (int)floorf((point.x - clearance) / cell_px);
+	int last_column = (int)floorf((point.x + clearance) / cell_px);
+	int first_row = (int)floorf((point.y - clearance) / cell_px);
+	int last_row = (int)floorf((point.y + clearance) / cell_px);
+	for (int row = first_row; row <= last_row; row++) {
+		for (int column = first_column; column <= last_column; column++) {
+			if (!map.open(column, row))
+				return false;
+		}
+	}
+	return true;
+}
+
+void NavMesh::build(const GridMap& map, float cell_px, float clearance)
+{
+	PROFILE_ZONE("NavMesh::build");
+	grown_by = clearance;
+	xs = gridLines(map.columns, cell_px, clearance);
+	ys = gridLines(map.rows, cell_px, clearance);
+	columns = (int)xs.size() - 1;
+	rows = (int)ys.size() - 1;
+	regions.clear();
+	portals.clear();
+
+	// the grown walls only start and stop on the grid's lines, so each of its
+	// cells is either clear all over or not at all
+	std::vector<bool> open((size_t)columns * rows);
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			vec2 middle((xs[column] + xs[column + 1]) * 0.5f, (ys[row] + ys[row + 1]) * 0.5f);
+			open[row * columns + column] = clear(map, cell_px, clearance, middle);
+		}
+	}
+	cell_region.assign(open.size(), -1);
+	auto free = [&](int column, int row) {
+		return column < columns && row < rows && open[row * columns + column] && cell_region[row * columns + column] < 0;
+	};
+
+	// greedy: the first free cell in reading order grows right as far as it
+	// can, then down while every cell under the row is free too
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			if (!free(column, row))
+				continue;
+			Region region = { column, row, 1, 1 };
+			while (free(column + region.columns, row))
+				region.columns++;
+			for (bool grows = true; grows;) {
+				int next_row = row + region.rows;
+				for (int c = column; grows && c < column + region.columns; c++)
+					grows = free(c, next_row);
+				if (grows)
+					region.rows++;
+			}
+			int id = (int)regions.size();
+			for (int r = row; r < row + region.rows; r++)
+				for (int c = column; c < column + region.columns; c++)
+					cell_region[r * columns + c] = id;
+			regions.push_back(region);
+		}
+	}
+
+	for (int region = 0; region < (int)regions.size(); region++)
+		addPortals(region);
+
+	// both ends of every portal link to each other
+	first_link.assign(regions.size() + 1, 0);
+	for (const Portal& portal : portals) {
+		first_link[portal.a + 1]++;
+		first_link[portal.b + 1]++;
+	}
+	for (size_t region = 0; region < regions.size(); region++)
+		first_link[region + 1] += first_link[region];
+	links.resize(portals.size() * 2);
+	std::vector<int> next = first_link;
+	for (int portal = 0; portal < (int)portals.size(); portal++) {
+		links[next[portals[portal].a]++] = { portals[portal].b, portal };
+		links[next[portals[portal].b]++] = { portals[portal].a, portal };
+	}
+}
+
+// Only the right and bottom edges are walked, the others are some other region's right or bottom
+void NavMesh::addPortals(int region)
+{
+	const Region& r = regions[region];
+	int right = r.column + r.columns;
+	int bottom = r.row + r.rows;
+
+	int run_start = 0, run_region = -1;
+	for (int row = r.row; row <= bottom; row++) {
+		int other = row < bottom && right < columns ? cell_region[row * columns + right] : -1;
+		if (other == run_region)
+			continue;
+		if (run_region >= 0)
+			portals.push_back({ region, run_region, vec2(xs[right], ys[run_start]), vec2(xs[right], ys[row]) });
+		run_start = row;
+		run_region = other;
+	}
+
+	run_region = -1;
+	for (int column = r.column; column <= right; column++) {
+		int other = column < right && bottom < rows ? cell_region[bottom * columns + column] : -1;
+		if (other == run_region)
+			continue;
+		if (run_region >= 0)
+			portals.push_back({ region, run_region, vec2(xs[run_start], ys[bottom]), vec2(xs[column], ys[bottom]) });
+		run_start = column;
+		run_region = other;
+	}
+}
+
+vec2 NavMesh::centre(int region) const
+{
+	const Region& r = regions[region];
+	return vec2(xs[r.column] + xs[r.column + r.columns], ys[r.row] + ys[r.row + r.rows]) * 0.5f;
+}
+
+// The cells a coordinate is in, two when it's on a line between them
+static int lineCells(const std::vector<float>& lines, float at, int cells[2])
+{
+	if (lines.empty() || at < lines.front() || at > lines.back())
+		return 0;
+	int cell = (int)(std::upper_bound(lines.begin(), lines.end(), at) - lines.begin()) - 1;
+	int count = 0;
+	if (cell < (int)lines.size() - 1)
+		cells[count++] = cell;
+	if (cell > 0 && lines[cell] == at)
+		cells[count++] = cell - 1;
+	return count;
+}
+
+int NavMesh::regionAt(vec2 point) const
+{
+	int cell_columns[2], cell_rows[2];
+	int column_count = lineCells(xs, point.x, cell_columns);
+	int row_count = lineCells(ys, point.y, cell_rows);
+	for (int r = 0; r < row_count; r++) {
+		for (int c = 0; c < column_count; c++) {
+			int region = cell_region[cell_rows[r] * columns + cell_columns[c]];
+			if (region >= 0)
+				return region;
+		}
+	}
+	return -1;
+}
+
+bool NavMesh::findPath(vec2 from, vec2 to, std::vector<vec2>& points) const
+{
+	PROFILE_ZONE("NavMesh::findPath");
+	points.clear();
+	int start = regionAt(from);
+	int goal = regionAt(to);
+	if (start < 0 || goal < 0)
+		return false;
+
+	std::vector<int> crossed;
+	if (!searchRegions(start, goal, from, to, crossed))
+		return false;
+	pullString(from, to, start, crossed, points);
+	return true;
+}
+
+// A* over the regions, each entered at the middle of the portal it was reached through
+bool NavMesh::searchRegions(int start, int goal, vec2 from, vec2 to, std::vector<int>& crossed) const
+{
+	crossed.clear();
+	if (start == goal)
+		return true;
+
+	std::vector<float> cost(regions.size(), FLT_MAX);
+	std::vector<vec2> entry(regions.size());
+	std::vector<int> arrived_by(regions.size(), -1);
+	std::vector<bool> closed(regions.size(), false);
+	typedef std::pair<float, int> Open;
+	std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+
+	cost[start] = 0.f;
+	entry[start] = from;
+	open.push({ length(to - from), start });
+	while (!open.empty()) {
+		int region = open.top().second;
+		open.pop();
+		if (closed[region])
+			continue;
+		closed[region] = true;
+		if (region == goal)
+			break;
+
+		for (int link = first_link[region]; link < first_link[region + 1]; link++) {
+			const Link& next = links[link];
+			const Portal& portal = portals[next.portal];
+			if (closed[next.region])
+				continue;
+			vec2 middle = (portal.start + portal.end) * 0.5f;
+			float next_cost = cost[region] + length(middle - entry[region]);
+			if (next_cost >= cost[next.region])
+				continue;
+			cost[next.region] = next_cost;
+			entry[next.region] = middle;
+			arrived_by[next.region] = next.portal;
+			open.push({ next_cost + length(to - middle), next.region });
+		}
+	}
+	if (!closed[goal])
+		return false;
+
+	for (int region = goal; region != start;) {
+		const Portal& portal = portals[arrived_by[region]];
+		crossed.push_back(arrived_by[region]);
+		region = portal.a == region ? portal.b : portal.a;
+	}
+	std::reverse(crossed.begin(), crossed.end());
+	return true;
+}
+
+void NavMesh::pullString(vec2 from, vec2 to, int start, const std::vector<int>& crossed, std::vector<vec2>& points) const
+{
+	// every portal's ends as seen walking through it, with the start and the
+	// goal as portals of no width at either end
+	size_t count = crossed.size() + 2;
+	std::vector<vec2> left(count), right(count);
+	left[0] = right[0] = from;
+	left[count - 1] = right[count - 1] = to;
+	int region = start;
+	for (size_t i = 0; i < crossed.size(); i++) {
+		const Portal& portal = portals[crossed[i]];
+		int next = portal.a == region ? portal.b : portal.a;
+		vec2 through = centre(next) - centre(region);
+		// the portals are axis aligned, only the part of the way across them counts
+		if (portal.start.x == portal.end.x)
+			through = vec2(through.x, 0.f);
+		else
+			through = vec2(0.f, through.y);
+		bool start_on_left = cross(through, portal.start - portal.end) > 0.f;
+		left[i + 1] = start_on_left ? portal.start : portal.end;
+		right[i + 1] = start_on_left ? portal.end : portal.start;
+		region = next;
+	}
+
+	// the funnel: its sides narrow portal by portal, and when one side would
+	// cross the other the corner it crosses is on the path and the funnel
+	// starts again from there
+	points.push_back(from);
+	vec2 apex = from, funnel_left = from, funnel_right = from;
+	size_t apex_index = 0, left_index = 0, right_index = 0;
+	for (size_t i = 1; i < count; i++) {
+		if (cross(funnel_right - apex, right[i] - apex) >= 0.f) {
+			if (apex == funnel_right || cross(funnel_left - apex, right[i] - apex) < 0.f) {
+				funnel_right = right[i];
+				right_index = i;
+			}
+			else {
+				apex = funnel_left;
+				apex_index = left_index;
+				if (points.back() != apex)
+					points.push_back(apex);
+				funnel_left = funnel_right = apex;
+				left_index = right_index = i = apex_index;
+				continue;
+			}
+		}
+		if (cross(funnel_left - apex, left[i] - apex) <= 0.f) {
+			if (apex == funnel_left || cross(funnel_right - apex, left[i] - apex) > 0.f) {
+				funnel_left = left[i];
+				left_index = i;
+			}
+			else {
+				apex = funnel_right;
+				apex_index = right_index;
+				if (points.back() != apex)
+					points.push_back(apex);
+				funnel_left = funnel_right = apex;
+				left_index = right_index = i = apex_index;
+				continue;
+			}
+		}
+	}
+	if (points.back() != to)
+		points.push_back(to);
+}
+
+// One mesh per organ and clearance, with the walls it was built from
+struct CachedNavMesh {
+	GridMap map;
+	std::shared_ptr<const NavMesh> mesh;
+};
+
+static std::mutex nav_cache_mutex;
+static std::map<std::pair<unsigned int, float>, CachedNavMesh> nav_cache;
+
+std::shared_ptr<const NavMesh> organNavMesh(unsigned int game_state, float clearance)
+{
+	int(*boundary)[ORGAN_BOUNDARY_COLUMNS] = organBoundary(game_state);
+	if (boundary == nullptr)
+		return nullptr;
+	GridMap map = GridMap::fromCells(&boundary[0][0], ORGAN_BOUNDARY_COLUMNS, ORGAN_BOUNDARY_ROWS);
+
+	std::lock_guard<std::mutex> lock(nav_cache_mutex);
+	CachedNavMesh& cached = nav_cache[std::make_pair(game_state, clearance)];
+	if (cached.mesh && cached.map.walls == map.walls) {
+		profiler.count("organ_nav/hits");
+		return cached.mesh;
+	}
+	std::shared_ptr<NavMesh> mesh = std::make_shared<NavMesh>();
+	mesh->build(map, (float)ORGAN_CELL_PX, clearance);
+	cached.map = std::move(map);
+	cached.mesh = mesh;
+	profiler.count("organ_nav/builds");
+	return mesh;
+}
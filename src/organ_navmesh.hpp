@@ -0,0 +1,96 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+#include "grid_search.hpp"
+
+// stlib
+#include <memory>
+#include <vector>
+
+// Organ screens are ORGAN_BOUNDARY_ROWS by ORGAN_BOUNDARY_COLUMNS cells of
+// ORGAN_CELL_PX, covering the whole window
+const int ORGAN_BOUNDARY_ROWS = 36;
+const int ORGAN_BOUNDARY_COLUMNS = 64;
+const int ORGAN_CELL_PX = 25;
+
+// Boundary grid of an organ screen, 1 is a wall, null for the screens that aren't organs
+int (*organBoundary(unsigned int game_state))[ORGAN_BOUNDARY_COLUMNS];
+
+// The open cells of a grid cut into rectangles, with a portal wherever two
+// rectangles touch. Under a hundred rectangles stand in for the two thousand
+// or so open cells of an organ, so a query searches the rectangles and then
+// pulls the path tight through the portals it crosses, giving straight lines
+// between wall corners rather than cell steps.
+//
+// Built with a clearance the walls are grown by that much first, the edges of
+// the grid counting as walls, so every point on a path is at least that far
+// from a wall on both axes. The grid the rectangles are cut from then has lines
+// at clearance either side of every cell edge as well as on it.
+//
+//     std::shared_ptr<const NavMesh> mesh = organNavMesh(ctx.game_state);
+//     std::vector<vec2> points;
+//     if (mesh && mesh->findPath(from, to, points)) ... walk from point to point ...
+class NavMesh
+{
+public:
+	// An axis aligned block of open cells, in cells of the mesh's own grid
+	struct Region {
+		int column, row;
+		int columns, rows;
+	};
+	// The stretch of edge two regions share, in pixels
+	struct Portal {
+		int a, b;
+		vec2 start, end;
+	};
+
+	void build(const GridMap& map, float cell_px, float clearance = 0.f);
+
+	// Region a point in pixels is in, -1 in a wall or off the grid
+	int regionAt(vec2 point) const;
+	// Corners of the shortest way through the regions from one point to the
+	// other, both included. False, with points empty, if either point is
+	// closer to a wall than the clearance or there's no way.
+	bool findPath(vec2 from, vec2 to, std::vector<vec2>& points) const;
+
+	float clearance() const { return grown_by; }
+
+	size_t regionCount() const { return regions.size(); }
+	size_t portalCount() const { return portals.size(); }
+	const std::vector<Region>& allRegions() const { return regions; }
+	const std::vector<Portal>& allPortals() const { return portals; }
+
+private:
+	struct Link {
+		int region;
+		int portal;
+	};
+
+	void addPortals(int region);
+	vec2 centre(int region) const;
+	// Region path from the start region to the goal one, empty if there's none
+	bool searchRegions(int start, int goal, vec2 from, vec2 to, std::vector<int>& crossed) const;
+	// The funnel algorithm over the portals crossed
+	void pullString(vec2 from, vec2 to, int start, const std::vector<int>& crossed, std::vector<vec2>& points) const;
+
+	// the mesh's grid, column c spans xs[c] to xs[c + 1] pixels and row r ys[r] to ys[r + 1]
+	int columns = 0;
+	int rows = 0;
+	std::vector<float> xs;
+	std::vector<float> ys;
+	float grown_by = 0.f;
+	std::vector<Region> regions;
+	std::vector<Portal> portals;
+	// region of every cell, -1 for walls
+	std::vector<int> cell_region;
+	// links of region r are links[first_link[r]] up to links[first_link[r + 1]]
+	std::vector<int> first_link;
+	std::vector<Link> links;
+};
+
+// The mesh of an organ screen's boundary, null for the screens that aren't
+// organs. Built the first time an organ is loaded with that clearance and kept,
+// going back to an organ only compares its boundary with the one the mesh was
+// built from. Safe to call from several simulations at once.
+std::shared_ptr<const NavMesh> organNavMesh(unsigned int game_state, float clearance = 0.f);
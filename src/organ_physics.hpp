@@ -8,7 +8,7 @@ class OrganPhysics : public CommonPhysics {
 public:
 
 	void step(float elapsed_ms);
-	OrganPhysics() {}
+	OrganPhysics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	void arrowMovementHandler(float elapsed_ms);
@@ -0,0 +1,382 @@
+// internal
+#include "particle_pool.hpp"
+#include "gl_state.hpp"
+#include "random.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLE_POOL_SSE 1
+#endif
+
+// std::min takes these by reference, so they need a definition
+const unsigned int ParticlePool::MAX_PARTICLES;
+const unsigned int ParticlePool::STRESS_PARTICLES;
+
+// Same constants as the ECS particles in particle_system.cpp
+const vec2 pool_gravity = { 0.0f, -9.81f };
+const float pool_drag = 5.0f;
+// Particles fade out over their last fade_time seconds
+const float pool_fade_time = 0.5f;
+const float pool_particle_size = 5.0f;
+
+// defined in render_system_init.cpp
+bool gl_compile_shader(GLuint shader);
+
+// Compiles the vertex only update program and captures its outputs with transform feedback
+static bool loadUpdateProgram(GLuint& out_program)
+{
+	std::ifstream vs_is(shader_path("particle_update.vs.glsl"));
+	if (!vs_is.good()) {
+		fprintf(stderr, "Failed to load particle update shader\n");
+		return false;
+	}
+	std::stringstream vs_ss;
+	vs_ss << vs_is.rdbuf();
+	std::string vs_str = vs_ss.str();
+	const char* vs_src = vs_str.c_str();
+	GLsizei vs_len = (GLsizei)vs_str.size();
+
+	GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertex, 1, &vs_src, &vs_len);
+	if (!gl_compile_shader(vertex)) {
+		fprintf(stderr, "Particle update shader compilation failed\n");
+		return false;
+	}
+
+	out_program = glCreateProgram();
+	glAttachShader(out_program, vertex);
+	const char* varyings[] = { "out_position", "out_velocity", "out_color", "out_life" };
+	glTransformFeedbackVaryings(out_program, 4, varyings, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(out_program);
+	glDetachShader(out_program, vertex);
+	glDeleteShader(vertex);
+
+	GLint is_linked = GL_FALSE;
+	glGetProgramiv(out_program, GL_LINK_STATUS, &is_linked);
+	if (is_linked == GL_FALSE) {
+		GLint log_len;
+		glGetProgramiv(out_program, GL_INFO_LOG_LENGTH, &log_len);
+		std::vector<char> log(log_len + 1);
+		glGetProgramInfoLog(out_program, log_len, &log_len, log.data());
+		fprintf(stderr, "Particle update link error: %s\n", log.data());
+		glDeleteProgram(out_program);
+		out_program = 0;
+		return false;
+	}
+
+	// clear out any error left behind by a failed attempt
+	while (glGetError() != GL_NO_ERROR) {}
+	return true;
+}
+
+bool ParticlePool::init(GLuint sprite_vbo_arg, GLuint sprite_ibo_arg, GLuint texture_arg, GLuint draw_program_arg)
+{
+	sprite_vbo = sprite_vbo_arg;
+	sprite_ibo = sprite_ibo_arg;
+	texture = texture_arg;
+	draw_program = draw_program_arg;
+
+	glGenBuffers(2, particle_vbos);
+	for (GLuint vbo : particle_vbos) {
+		gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GpuParticle) * MAX_PARTICLES, nullptr, GL_DYNAMIC_COPY);
+	}
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, 0);
+	gl_has_errors();
+
+	// GEN_CPU_PARTICLES forces the fallback path, handy for comparing the two
+	gpu_simulation = getenv("GEN_CPU_PARTICLES") == nullptr && loadUpdateProgram(update_program);
+	if (gpu_simulation) {
+		glGenTransformFeedbacks(1, &transform_feedback);
+		gl_has_errors();
+	}
+	else {
+		printf("Particles: transform feedback unavailable, simulating on the CPU\n");
+		pos_x.resize(MAX_PARTICLES);
+		pos_y.resize(MAX_PARTICLES);
+		vel_x.resize(MAX_PARTICLES);
+		vel_y.resize(MAX_PARTICLES);
+		life_left.resize(MAX_PARTICLES);
+		colors.resize(MAX_PARTICLES);
+		upload.resize(MAX_PARTICLES);
+	}
+
+	initialized = true;
+	return true;
+}
+
+void ParticlePool::release()
+{
+	if (!initialized)
+		return;
+	glDeleteBuffers(2, particle_vbos);
+	if (gpu_simulation) {
+		glDeleteTransformFeedbacks(1, &transform_feedback);
+		glDeleteProgram(update_program);
+	}
+	initialized = false;
+}
+
+void ParticlePool::emit(vec2 position, vec3 color, unsigned int count, float spread, float life)
+{
+	std::lock_guard<std::mutex> lock(pending_mutex);
+	pending_emits.push_back({ position, color, count, spread, life });
+}
+
+void ParticlePool::step(float elapsed_ms)
+{
+	std::lock_guard<std::mutex> lock(pending_mutex);
+	pending_ms += elapsed_ms;
+}
+
+void ParticlePool::clear()
+{
+	std::lock_guard<std::mutex> lock(pending_mutex);
+	pending_emits.clear();
+	pending_ms = 0.f;
+	stress_mode = false;
+	clear_requested = true;
+}
+
+void ParticlePool::toggleStress()
+{
+	if (stress_mode) {
+		clear();
+		return;
+	}
+	clear();
+	stress_mode = true;
+	// long lived so the whole million stays in the simulation
+	emit({ window_width_px / 2.f, window_height_px / 2.f }, { 0.6549f, 0.9490f, 0.f }, STRESS_PARTICLES, (float)window_width_px, 1e9f);
+}
+
+// Copies count particles into the ring starting at first, splitting the write at the wrap point
+void ParticlePool::writeRange(unsigned int first, const GpuParticle* data, unsigned int count)
+{
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, particle_vbos[current]);
+	unsigned int tail = std::min(count, MAX_PARTICLES - first);
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(GpuParticle) * first, sizeof(GpuParticle) * tail, data);
+	if (tail < count)
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GpuParticle) * (count - tail), data + tail);
+	gl_has_errors();
+}
+
+void ParticlePool::flushEmits(const std::vector<PendingEmit>& emits)
+{
+	std::vector<GpuParticle> spawned;
+	// four numbers a particle, drawn up front in one go
+	std::vector<float> unit;
+
+	for (const PendingEmit& e : emits) {
+		unsigned int count = std::min(e.count, MAX_PARTICLES);
+		spawned.resize(count);
+		unit.resize(count * 4);
+		threadRng().fill(unit.data(), unit.size(), 0.f, 1.f);
+		for (unsigned int i = 0; i < count; i++) {
+			const float* u = &unit[i * 4];
+			// uniform in the circle, sqrt for an even spread
+			float angle = u[0] * 2.0f * M_PI;
+			float r = sqrt(u[1]) * e.spread;
+			GpuParticle& p = spawned[i];
+			p.position = e.position + vec2(r * cos(angle), r * sin(angle));
+			p.velocity = vec2((u[2] - 0.5f) * 100.f, 100.f * u[3]);
+			p.color = e.color;
+			p.life = e.life;
+		}
+
+		if (gpu_simulation) {
+			writeRange(head, spawned.data(), count);
+		}
+		else {
+			for (unsigned int i = 0; i < count; i++) {
+				unsigned int slot = (head + i) % MAX_PARTICLES;
+				pos_x[slot] = spawned[i].position.x;
+				pos_y[slot] = spawned[i].position.y;
+				vel_x[slot] = spawned[i].velocity.x;
+				vel_y[slot] = spawned[i].velocity.y;
+				colors[slot] = spawned[i].color;
+				life_left[slot] = spawned[i].life;
+			}
+		}
+
+		head = (head + count) % MAX_PARTICLES;
+		live = std::min(live + count, MAX_PARTICLES);
+		time_to_expire = std::max(time_to_expire, e.life);
+	}
+}
+
+void ParticlePool::simulateGpu(float step_seconds)
+{
+	gl_state.useProgram(update_program);
+	glUniform1f(glGetUniformLocation(update_program, "step_seconds"), step_seconds);
+	glUniform2f(glGetUniformLocation(update_program, "gravity"), pool_gravity.x, pool_gravity.y);
+	glUniform1f(glGetUniformLocation(update_program, "drag"), pool_drag);
+	gl_has_errors();
+
+	const GLsizei stride = sizeof(GpuParticle);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, particle_vbos[current]);
+	gl_state.enableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, position));
+	gl_state.enableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, velocity));
+	gl_state.enableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, color));
+	gl_state.enableVertexAttribArray(3);
+	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, life));
+	gl_has_errors();
+
+	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, transform_feedback);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particle_vbos[1 - current]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, live);
+	glEndTransformFeedback();
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+
+	for (GLuint i = 0; i < 4; i++)
+		gl_state.disableVertexAttribArray(i);
+	gl_has_errors();
+
+	current = 1 - current;
+}
+
+void ParticlePool::simulateCpu(float step_seconds)
+{
+	const float damping = 1.f - pool_drag * step_seconds;
+	const float gravity_x = pool_gravity.x * step_seconds;
+	const float gravity_y = pool_gravity.y * step_seconds;
+	float* px = pos_x.data();
+	float* py = pos_y.data();
+	float* vx = vel_x.data();
+	float* vy = vel_y.data();
+	float* life = life_left.data();
+
+	unsigned int i = 0;
+#ifdef PARTICLE_POOL_SSE
+	const __m128 dt4 = _mm_set1_ps(step_seconds);
+	const __m128 damping4 = _mm_set1_ps(damping);
+	const __m128 gx4 = _mm_set1_ps(gravity_x);
+	const __m128 gy4 = _mm_set1_ps(gravity_y);
+	for (; i + 4 <= live; i += 4) {
+		__m128 vx4 = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), gx4), damping4);
+		__m128 vy4 = _mm_add_ps(_mm_loadu_ps(vy + i), gy4);
+		_mm_storeu_ps(vx + i, vx4);
+		_mm_storeu_ps(vy + i, vy4);
+		_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(vx4, dt4)));
+		_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(vy4, dt4)));
+		_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt4));
+	}
+#endif
+	// remainder (or everything when SSE isn't available), same maths as the shader
+	for (; i < live; i++) {
+		vx[i] = (vx[i] + gravity_x) * damping;
+		vy[i] += gravity_y;
+		px[i] += vx[i] * step_seconds;
+		py[i] += vy[i] * step_seconds;
+		life[i] -= step_seconds;
+	}
+}
+
+void ParticlePool::draw(const mat3& projection)
+{
+	if (!initialized)
+		return;
+
+	// take everything queued since the last draw in one go
+	bool clearing;
+	float step_seconds;
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex);
+		clearing = clear_requested;
+		clear_requested = false;
+		step_seconds = pending_ms / 1000.f;
+		pending_ms = 0.f;
+		flushing_emits.swap(pending_emits);
+	}
+
+	if (clearing) {
+		head = 0;
+		live = 0;
+		time_to_expire = 0.f;
+	}
+
+	flushEmits(flushing_emits);
+	flushing_emits.clear();
+
+	// every particle has run out, drop them all instead of simulating corpses
+	time_to_expire -= step_seconds;
+	if (time_to_expire <= 0.f) {
+		head = 0;
+		live = 0;
+		time_to_expire = 0.f;
+	}
+	live_count = live;
+	if (live == 0)
+		return;
+
+	if (step_seconds > 0.f) {
+		if (gpu_simulation) {
+			simulateGpu(step_seconds);
+		}
+		else {
+			simulateCpu(step_seconds);
+			for (unsigned int i = 0; i < live; i++) {
+				upload[i] = { { pos_x[i], pos_y[i] }, { vel_x[i], vel_y[i] }, colors[i], life_left[i] };
+			}
+			gl_state.bindBuffer(GL_ARRAY_BUFFER, particle_vbos[current]);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GpuParticle) * live, upload.data());
+			gl_has_errors();
+		}
+	}
+
+	gl_state.useProgram(draw_program);
+	GLuint projection_loc = glGetUniformLocation(draw_program, "projection");
+	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&projection);
+	glUniform1f(glGetUniformLocation(draw_program, "particle_size"), pool_particle_size);
+	glUniform1f(glGetUniformLocation(draw_program, "fade_time"), pool_fade_time);
+	gl_has_errors();
+
+	// per vertex: the sprite quad
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, sprite_vbo);
+	gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprite_ibo);
+	gl_state.enableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+	gl_state.enableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+
+	// per instance: the particle state
+	const GLsizei stride = sizeof(GpuParticle);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, particle_vbos[current]);
+	gl_state.enableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, position));
+	glVertexAttribDivisor(2, 1);
+	gl_state.enableVertexAttribArray(3);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, color));
+	glVertexAttribDivisor(3, 1);
+	gl_state.enableVertexAttribArray(4);
+	glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuParticle, life));
+	glVertexAttribDivisor(4, 1);
+	gl_has_errors();
+
+	gl_state.activeTexture(GL_TEXTURE0);
+	gl_state.bindTexture(GL_TEXTURE_2D, texture);
+
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, live);
+	gl_has_errors();
+
+	// leave the shared vao the way the other draws expect it
+	for (GLuint i = 2; i <= 4; i++) {
+		glVertexAttribDivisor(i, 0);
+		gl_state.disableVertexAttribArray(i);
+	}
+	gl_has_errors();
+}
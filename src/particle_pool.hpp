@@ -0,0 +1,104 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+#include "components.hpp"
+
+// stlib
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// One particle as it lives in the GPU buffers. The layout is shared by the
+// transform feedback outputs and the per-instance attributes of the draw.
+struct GpuParticle {
+	vec2 position;
+	vec2 velocity;
+	vec3 color;
+	float life;
+};
+
+// Fixed capacity pool of short lived sprites (brick debris, stress test, ...).
+//
+// Simulation runs on the GPU with transform feedback, ping-ponging between two
+// VBOs, and everything is drawn with a single instanced draw of the sprite quad.
+// If transform feedback can't be set up the same integration runs on the CPU
+// over structure-of-arrays storage and the result is uploaded for the draw.
+//
+// step() and emit() only queue work, the GL calls all happen in draw() so the
+// pool can be stepped from the simulation without touching the context, also
+// while draw() runs on the render thread.
+class ParticlePool
+{
+public:
+	static const unsigned int MAX_PARTICLES = 1 << 20;
+	static const unsigned int STRESS_PARTICLES = 1000000;
+
+	bool init(GLuint sprite_vbo, GLuint sprite_ibo, GLuint texture, GLuint draw_program);
+	void release();
+
+	// Spawns count particles in a circle of radius spread around position
+	void emit(vec2 position, vec3 color, unsigned int count, float spread = 20.f, float life = 0.5f);
+	// Advances every live particle by elapsed_ms the next time the pool is drawn
+	void step(float elapsed_ms);
+	void clear();
+
+	void draw(const mat3& projection);
+
+	// Fills the pool for the 1M particle stress mode
+	void toggleStress();
+	bool inStressMode() const { return stress_mode; }
+
+	unsigned int size() const { return live_count; }
+	bool usingGpu() const { return gpu_simulation; }
+
+private:
+	struct PendingEmit {
+		vec2 position;
+		vec3 color;
+		unsigned int count;
+		float spread;
+		float life;
+	};
+
+	void flushEmits(const std::vector<PendingEmit>& emits);
+	void simulateGpu(float step_seconds);
+	void simulateCpu(float step_seconds);
+	void writeRange(unsigned int first, const GpuParticle* data, unsigned int count);
+
+	bool initialized = false;
+	bool gpu_simulation = false;
+	bool stress_mode = false;
+	bool clear_requested = false;
+
+	// queued by the simulation, taken by draw()
+	std::mutex pending_mutex;
+	float pending_ms = 0.f;
+	std::vector<PendingEmit> pending_emits;
+	std::vector<PendingEmit> flushing_emits;
+
+	// live as of the last draw, for size()
+	std::atomic<unsigned int> live_count { 0 };
+
+	// ring buffer bookkeeping, new particles overwrite the oldest ones
+	unsigned int head = 0;
+	unsigned int live = 0;
+	// seconds until the longest lived particle dies
+	float time_to_expire = 0.f;
+
+	// ping-pong buffers, particle_vbos[current] holds the latest state
+	GLuint particle_vbos[2] = { 0, 0 };
+	unsigned int current = 0;
+	GLuint update_program = 0;
+	GLuint transform_feedback = 0;
+
+	GLuint draw_program = 0;
+	GLuint sprite_vbo = 0;
+	GLuint sprite_ibo = 0;
+	GLuint texture = 0;
+
+	// CPU fallback state, one array per field so the integration vectorizes
+	std::vector<float> pos_x, pos_y, vel_x, vel_y, life_left;
+	std::vector<vec3> colors;
+	std::vector<GpuParticle> upload;
+};
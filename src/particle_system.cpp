@@ -1,15 +1,14 @@
 #include "particle_system.hpp"
 #include "world_init.hpp"
+#include "sim_context.hpp"
 #include <cmath>
 
 const vec2 gravity = { 0.0f, -9.81f };
 const float dragCoefficient = 5.0f;
 
-// Helper: generates random float in the range [min, max]
+// Helper: generates random float in the range [min, max)
 float randomFloat(float min, float max) {
-    std::default_random_engine rng(std::random_device{}());
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+    return SimContext::current().particle_rng.uniform(min, max);
 }
 
 // Helper: generates a random position within a circle around a position
@@ -27,11 +26,12 @@ vec2 randomize_init_position(vec2 position, float radius) {
 
 // Updates all particles currently in the particles registry
 void stepParticles(float elapsed_ms) {
+	SimContext& ctx = SimContext::current();
     float step_time = elapsed_ms / 1000.f;
-	ComponentContainer<Particle>& particlesRegistry = registry.particles;
-	for (uint i = 0; i < particlesRegistry.components.size(); i++) {
+	ComponentContainer<Particle>& particlesRegistry = ctx.registry.particles;
+	for (int i = (int)particlesRegistry.components.size() - 1; i >= 0; i--) {
 		Entity p_entity = particlesRegistry.entities[i];
-		foregroundMotion& motion = registry.foregroundMotions.get(p_entity);
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(p_entity);
 		
         // move particles
 		// calculate velocity after gravity and drag applied
@@ -41,35 +41,41 @@ void stepParticles(float elapsed_ms) {
 		
 		motion.position += motion.velocity * step_time;
 
-        // update translation offsets for instanced particles
-		for (Entity particle : registry.particles.entities)
+        // update translation offsets of this particle's instances only
+		if (ctx.registry.instanceRenderRequests.has(p_entity))
 		{
-		    InstanceRenderRequest& irr = registry.instanceRenderRequests.get(particle);
-		    for (uint i = 1; i < irr.instances; i++) {
-                float angle = step_time * 2.0f * M_PI; 
-                float deltaX = 0.0005f * std::cos(angle);
+		    InstanceRenderRequest& irr = ctx.registry.instanceRenderRequests.get(p_entity);
+            float angle = step_time * 2.0f * M_PI;
+            float deltaX = 0.0005f * std::cos(angle);
+		    for (uint j = 1; j < irr.instances; j++) {
                 if (randomFloat(0.0f, 10.0f) > 5) { 
-                    irr.translations[i][0] += deltaX;
+                    irr.translations[j][0] += deltaX;
                 } else {
-                    irr.translations[i][0] -= deltaX;
+                    irr.translations[j][0] -= deltaX;
                 }
-				irr.translations[i][1] += motion.velocity[0] * step_time / 10000.f;
+				irr.translations[j][1] += motion.velocity[0] * step_time / 10000.f;
 			}
 		}
 
-		Particle& curr_particle = registry.particles.get(p_entity);
+		Particle& curr_particle = ctx.registry.particles.get(p_entity);
         curr_particle.life -= step_time;    // reduce particle life
         if (curr_particle.life > 0.0f)      // particle is alive, thus update
         {	
             curr_particle.opacity -= step_time;
         } 
-		else // kill particle
-		{
-			registry.remove_all_components_of(p_entity);
-		}
 	} 
 }
 
+// Dead particles are removed separately, removing entities touches every container
+void removeDeadParticles() {
+	SimContext& ctx = SimContext::current();
+	ComponentContainer<Particle>& particlesRegistry = ctx.registry.particles;
+	for (int i = (int)particlesRegistry.components.size() - 1; i >= 0; i--) {
+		if (particlesRegistry.components[i].life <= 0.0f)
+			ctx.registry.remove_all_components_of(particlesRegistry.entities[i]);
+	}
+}
+
 // returns translations vector to pass into instance rendering
 std::vector<vec2> generateParticles(vec2 emitter_position, vec3 color)
 {
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "game_state.hpp"
-#include <random>
 
 void stepParticles(float elapsed_ms);
+void removeDeadParticles();
 
 std::vector<vec2> generateParticles(vec2 emitter_position, vec3 color);
\ No newline at end of file
@@ -0,0 +1,75 @@
+// internal
+#include "path_cache.hpp"
+#include "profiler.hpp"
+
+bool PathCache::find(int x_start, int y_start, int goal_cell, uint32_t maze_version, PathResult& result)
+{
+	auto exact = index.find({ x_start, y_start, goal_cell, maze_version });
+	if (exact != index.end()) {
+		touch(exact->second);
+		result = exact->second->result;
+		profiler.count("path_cache/hits");
+		return true;
+	}
+
+	// a chaser part way along a path another search already found
+	for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+		if (entry->key.goal_cell != goal_cell || entry->key.maze_version != maze_version)
+			continue;
+		const PathResult& cached = entry->result;
+		int x = cached.x_start;
+		int y = cached.y_start;
+		for (size_t step = 0; step < cached.path.size(); step++) {
+			if (x == x_start && y == y_start) {
+				result.maze_version = maze_version;
+				result.x_start = x_start;
+				result.y_start = y_start;
+				result.step_size = cached.step_size;
+				result.path.assign(cached.path.begin() + step, cached.path.end());
+				touch(entry);
+				profiler.count("path_cache/suffix_hits");
+				return true;
+			}
+			switch (cached.path[step]) {
+			case UP: y -= cached.step_size; break;
+			case RIGHT: x += cached.step_size; break;
+			case DOWN: y += cached.step_size; break;
+			case LEFT: x -= cached.step_size; break;
+			}
+		}
+	}
+
+	profiler.count("path_cache/misses");
+	return false;
+}
+
+void PathCache::insert(int goal_cell, const PathResult& result)
+{
+	if (result.path.empty() || capacity == 0)
+		return;
+	Key key = { result.x_start, result.y_start, goal_cell, result.maze_version };
+	auto existing = index.find(key);
+	if (existing != index.end()) {
+		existing->second->result = result;
+		touch(existing->second);
+		return;
+	}
+
+	if (entries.size() >= capacity) {
+		index.erase(entries.back().key);
+		entries.pop_back();
+	}
+	entries.push_front({ key, result });
+	index[key] = entries.begin();
+}
+
+void PathCache::clear()
+{
+	entries.clear();
+	index.clear();
+}
+
+void PathCache::touch(std::list<Entry>::iterator entry)
+{
+	entries.splice(entries.begin(), entries, entry);
+}
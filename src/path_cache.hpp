@@ -0,0 +1,65 @@
+#pragma once
+
+// internal
+#include "path_service.hpp"
+
+// stlib
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+// Recently found chase paths, least recently used thrown out first. Keyed by
+// where the path starts, the cell it heads for and the maze it was found on:
+// the player often stands in one cell for many ticks and the chasers start
+// their paths on the same lattice points, so the same searches come round again.
+//
+//     if (!cache.find(x, y, goal_cell, ctx.maze_version, result)) ... search ...
+//     cache.insert(goal_cell, result);
+//
+// Hits, suffix hits and misses are counted in the profiler under path_cache/.
+class PathCache
+{
+public:
+	explicit PathCache(size_t capacity = 64) : capacity(capacity) {}
+
+	// A path from exactly (x_start, y_start), or the rest of one that passes
+	// through it at a step boundary, towards goal_cell on maze_version
+	bool find(int x_start, int y_start, int goal_cell, uint32_t maze_version, PathResult& result);
+	// Keeps a found path, empty ones aren't worth keeping
+	void insert(int goal_cell, const PathResult& result);
+	void clear();
+	size_t size() const { return entries.size(); }
+
+private:
+	struct Key {
+		int x_start;
+		int y_start;
+		int goal_cell;
+		uint32_t maze_version;
+		bool operator==(const Key& other) const
+		{
+			return x_start == other.x_start && y_start == other.y_start && goal_cell == other.goal_cell && maze_version == other.maze_version;
+		}
+	};
+	struct KeyHash {
+		size_t operator()(const Key& key) const
+		{
+			size_t hash = std::hash<int>()(key.x_start);
+			hash = hash * 31 + std::hash<int>()(key.y_start);
+			hash = hash * 31 + std::hash<int>()(key.goal_cell);
+			return hash * 31 + std::hash<uint32_t>()(key.maze_version);
+		}
+	};
+	struct Entry {
+		Key key;
+		PathResult result;
+	};
+
+	// Moves an entry to the front, it's the most recently used now
+	void touch(std::list<Entry>::iterator entry);
+
+	size_t capacity;
+	// most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+};
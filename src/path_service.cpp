@@ -0,0 +1,61 @@
+// internal
+#include "path_service.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <cassert>
+
+PathService::~PathService()
+{
+	job_system.wait([this] { return done.load(); });
+}
+
+bool PathService::request(PathRequest request_arg)
+{
+	if (in_flight)
+		return false;
+	current = std::move(request_arg);
+	in_flight = true;
+	done = false;
+	job_system.submit([this] { search(); });
+	return true;
+}
+
+bool PathService::fulfil(PathResult result_arg)
+{
+	if (in_flight)
+		return false;
+	result = std::move(result_arg);
+	in_flight = true;
+	done = true;
+	return true;
+}
+
+PathResult PathService::collect()
+{
+	assert(in_flight);
+	job_system.wait([this] { return done.load(); });
+	in_flight = false;
+	return std::move(result);
+}
+
+// Runs on whichever thread takes the job, only touches current, result and pool
+void PathService::search()
+{
+	PROFILE_ZONE("PathService::search");
+	result = PathResult();
+	result.maze_version = current.maze_version;
+	result.x_start = current.x_start;
+	result.y_start = current.y_start;
+	for (const PathLattice& lattice : current.lattices) {
+		Search path = latticeAStar(current.map, current.cell_px, current.x_start, current.y_start,
+			current.x_target, current.y_target, lattice.step_size, lattice.tolerance, pool);
+		if (path.dir.size() > 0) {
+			result.step_size = lattice.step_size;
+			result.path = std::move(path.dir);
+			break;
+		}
+	}
+	done = true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// internal
+#include "grid_search.hpp"
+
+// stlib
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// One lattice a PathRequest tries, see latticeAStar
+struct PathLattice {
+	int step_size;
+	int tolerance;
+};
+
+// A chase path to work out away from the step. Carries its own copy of the
+// maze so the search never reads the live one while the world changes it.
+struct PathRequest {
+	GridMap map;
+	int cell_px = 100;
+	// SimContext::maze_version the map was copied from
+	uint32_t maze_version = 0;
+	int x_start = 0;
+	int y_start = 0;
+	int x_target = 0;
+	int y_target = 0;
+	// tried in order, the first one that reaches the target is the result
+	std::vector<PathLattice> lattices;
+};
+
+struct PathResult {
+	uint32_t maze_version = 0;
+	int x_start = 0;
+	int y_start = 0;
+	// lattice the path was found on, every Direction is one step this long
+	int step_size = 0;
+	// empty when no lattice reached the target
+	std::vector<Direction> path;
+};
+
+// Runs one path search at a time on the job system. The simulation keeps going
+// while it runs and picks the result up at a point of its choosing, so the
+// result always lands on the same tick and replays stay deterministic. Only
+// waits when the search is still going at that point.
+//
+//     if (!paths.pending()) paths.request(request);
+//     ... later ticks ...
+//     PathResult result = paths.collect();
+//     if (result.maze_version != ctx.maze_version) ... stale, ask again ...
+class PathService
+{
+public:
+	// Waits for a search that's still running, it writes into this service
+	~PathService();
+
+	// False if the last request hasn't been collected yet
+	bool request(PathRequest request);
+	// Like request, for a result found without a search (a PathCache hit).
+	// It goes through the same pending and collect as a searched one.
+	bool fulfil(PathResult result);
+	// A request went out and hasn't been collected
+	bool pending() const { return in_flight; }
+	// The pending search is done, collect won't wait
+	bool ready() const { return done; }
+	// Hands over the pending result, helping the job system until it's done
+	PathResult collect();
+
+private:
+	void search();
+
+	PathRequest current;
+	PathResult result;
+	AStarPool pool;
+	bool in_flight = false;
+	std::atomic<bool> done { true };
+};
@@ -1,17 +1,39 @@
 // internal
 #include "physics_system.hpp"
+#include "profiler.hpp"
+#include "particle_system.hpp"
 
 void PhysicsSystem::step(float elapsed_ms){
+	PROFILE_ZONE("PhysicsSystem::step");
 	CommonPhysics* physics = getPhysics();
 
 	// if we are in tutorial state we want all physics to pause
-	if (pause_game_state) return;
+	if (ctx.pause_game_state) return;
 
 	physics->step(elapsed_ms);
 }
 
+void PhysicsSystem::storePreviousPositions() {
+	for (foregroundMotion& motion : ctx.registry.foregroundMotions.components) {
+		motion.previous_position = motion.position;
+		motion.has_previous = true;
+	}
+}
+
+void PhysicsSystem::scheduleTasks(TaskGraph& graph, float elapsed_ms) {
+	// only minigame 5 spawns them
+	if (ctx.game_state != (unsigned int)GAME_STATES::MINIGAME_5 || ctx.pause_game_state || ctx.registry.particles.size() == 0) return;
+
+	graph.add("particles", [elapsed_ms] { stepParticles(elapsed_ms); })
+		.writes(ctx.registry.particles)
+		.writes(ctx.registry.foregroundMotions)
+		.writes(ctx.registry.instanceRenderRequests);
+	graph.add("particle cleanup", [] { removeDeadParticles(); })
+		.writesAll();
+}
+
 CommonPhysics* PhysicsSystem::getPhysics() {
-	switch (game_state) {
+	switch (ctx.game_state) {
 		case (unsigned int) GAME_STATES::TITLE: {
 			return titlePhysics;
 		}
@@ -9,21 +9,26 @@
 #include "mg4_physics.hpp"
 #include "mg5_physics.hpp"
 #include "credits_physics.hpp"
+#include "job_system.hpp"
 
 class PhysicsSystem {
 
 public:
 
 	void step(float elapsed_ms);
-	PhysicsSystem() {
-		titlePhysics = new TitlePhysics();
-		organPhysics = new OrganPhysics();
-		mg1Physics = new MiniGame1Physics();
-		mg2Physics = new MiniGame2Physics();
-		mg3Physics = new MiniGame3Physics();
-		mg4Physics = new MiniGame4Physics();
-		mg5Physics = new MiniGame5Physics();
-		creditsPhysics = new CreditsPhysics();
+	// Remembers every foreground position before a fixed step for render interpolation
+	void storePreviousPositions();
+	// Adds the physics work that can run alongside the other systems (particle integration)
+	void scheduleTasks(TaskGraph& graph, float elapsed_ms);
+	PhysicsSystem(SimContext& ctx) : ctx(ctx) {
+		titlePhysics = new TitlePhysics(ctx);
+		organPhysics = new OrganPhysics(ctx);
+		mg1Physics = new MiniGame1Physics(ctx);
+		mg2Physics = new MiniGame2Physics(ctx);
+		mg3Physics = new MiniGame3Physics(ctx);
+		mg4Physics = new MiniGame4Physics(ctx);
+		mg5Physics = new MiniGame5Physics(ctx);
+		creditsPhysics = new CreditsPhysics(ctx);
 	}
 
 	~PhysicsSystem() {
@@ -39,6 +44,7 @@ public:
 
 private:
 
+	SimContext& ctx;
 	CommonPhysics* getPhysics();
 	TitlePhysics* titlePhysics;
 	OrganPhysics* organPhysics;
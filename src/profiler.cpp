@@ -0,0 +1,211 @@
+// internal
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+Profiler profiler;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point epoch = Clock::now();
+
+	// Escapes what can show up in a zone or thread name
+	std::string jsonString(const char* str)
+	{
+		std::string out = "\"";
+		for (const char* c = str; *c != '\0'; c++) {
+			if (*c == '"' || *c == '\\')
+				out += '\\';
+			out += *c;
+		}
+		return out + "\"";
+	}
+}
+
+uint64_t Profiler::now() const
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+Profiler::Track& Profiler::createTrack(const char* name)
+{
+	std::lock_guard<std::mutex> lock(tracks_mutex);
+	tracks.push_back(std::unique_ptr<Track>(new Track()));
+	Track& track = *tracks.back();
+	track.id = (unsigned int)tracks.size();
+	track.name.store(name, std::memory_order_relaxed);
+	return track;
+}
+
+Profiler::Track& Profiler::threadTrack()
+{
+	// registered once per thread, never freed so late zones on exiting threads stay valid
+	static thread_local Track* track = nullptr;
+	if (track == nullptr)
+		track = &createTrack(nullptr);
+	return *track;
+}
+
+void Profiler::record(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+	record(threadTrack(), name, start_ns, end_ns);
+}
+
+void Profiler::record(Track& track, const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+	uint64_t index = track.written.load(std::memory_order_relaxed);
+
+	Event& event = track.events[index % RING_SIZE];
+	event.name.store(name, std::memory_order_relaxed);
+	event.start_ns.store(start_ns, std::memory_order_relaxed);
+	event.end_ns.store(end_ns, std::memory_order_relaxed);
+
+	// publishes the slot to readers
+	track.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+	threadTrack().name.store(name, std::memory_order_relaxed);
+}
+
+void Profiler::copyEvents(const Track& track, uint64_t since_ns, std::vector<Copy>& out)
+{
+	uint64_t written = track.written.load(std::memory_order_acquire);
+	uint64_t first = written > RING_SIZE ? written - RING_SIZE : 0;
+
+	// zones are recorded as they end, so walking back from the newest can stop at the first older one
+	std::vector<Copy> copies;
+	uint64_t i = written;
+	for (; i > first; i--) {
+		const Event& event = track.events[(i - 1) % RING_SIZE];
+		Copy copy = { event.name.load(std::memory_order_relaxed),
+			event.start_ns.load(std::memory_order_relaxed),
+			event.end_ns.load(std::memory_order_relaxed) };
+		if (copy.end_ns < since_ns)
+			break;
+		copies.push_back(copy);
+	}
+
+	// the owner may have lapped the oldest slots while they were copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t written_after = track.written.load(std::memory_order_relaxed);
+	uint64_t overwritten = written_after > RING_SIZE ? written_after - RING_SIZE : 0;
+	size_t valid = (size_t)(written - std::min(std::max(overwritten, i), written));
+
+	// oldest first, the way they were recorded
+	for (size_t j = std::min(valid, copies.size()); j > 0; j--)
+		out.push_back(copies[j - 1]);
+}
+
+void Profiler::count(const char* name, int64_t amount)
+{
+	std::lock_guard<std::mutex> lock(counters_mutex);
+	for (auto& total : totals) {
+		if (total.first == name) {
+			total.second += amount;
+			return;
+		}
+	}
+	totals.push_back({ name, amount });
+}
+
+std::vector<Profiler::Counter> Profiler::counters() const
+{
+	std::vector<Counter> out;
+	{
+		std::lock_guard<std::mutex> lock(counters_mutex);
+		for (const auto& total : totals)
+			out.push_back({ total.first, total.second });
+	}
+	std::sort(out.begin(), out.end(), [](const Counter& a, const Counter& b) { return a.name < b.name; });
+	return out;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::summarize(float window_ms) const
+{
+	uint64_t window_ns = (uint64_t)(window_ms * 1000000.f);
+	uint64_t current = now();
+	uint64_t since = current > window_ns ? current - window_ns : 0;
+
+	std::vector<Copy> events;
+	{
+		std::lock_guard<std::mutex> lock(tracks_mutex);
+		for (const std::unique_ptr<Track>& track : tracks)
+			copyEvents(*track, since, events);
+	}
+
+	std::map<std::string, std::vector<float>> durations;
+	for (const Copy& event : events)
+		durations[event.name].push_back((float)(event.end_ns - event.start_ns) / 1000000.f);
+
+	std::vector<ZoneStats> stats;
+	for (auto& zone : durations) {
+		std::vector<float>& times = zone.second;
+		std::sort(times.begin(), times.end());
+
+		ZoneStats entry;
+		entry.name = zone.first;
+		entry.count = (unsigned int)times.size();
+		entry.p50_ms = times[times.size() / 2];
+		entry.p99_ms = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+		stats.push_back(entry);
+	}
+
+	std::sort(stats.begin(), stats.end(), [](const ZoneStats& a, const ZoneStats& b) { return a.p99_ms > b.p99_ms; });
+	return stats;
+}
+
+bool Profiler::writeTrace(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.good()) {
+		fprintf(stderr, "Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(tracks_mutex);
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+	size_t count = 0;
+	char line[64];
+
+	for (const std::unique_ptr<Track>& track : tracks) {
+		const char* thread_name = track->name.load(std::memory_order_relaxed);
+		if (thread_name != nullptr) {
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->id
+				<< ",\"args\":{\"name\":" << jsonString(thread_name) << "}}";
+			first = false;
+		}
+
+		std::vector<Copy> events;
+		copyEvents(*track, 0, events);
+		for (const Copy& event : events) {
+			// microseconds, with the nanoseconds kept as decimals
+			snprintf(line, sizeof(line), ",\"ts\":%.3f,\"dur\":%.3f", event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0);
+			file << (first ? "" : ",\n") << "{\"name\":" << jsonString(event.name) << ",\"ph\":\"X\"" << line
+				<< ",\"pid\":1,\"tid\":" << track->id << "}";
+			first = false;
+		}
+		count += events.size();
+	}
+
+	// the counters' totals as of now, one counter track
+	std::vector<Counter> totals_now = counters();
+	if (!totals_now.empty()) {
+		snprintf(line, sizeof(line), ",\"ts\":%.3f", now() / 1000.0);
+		file << (first ? "" : ",\n") << "{\"name\":\"counters\",\"ph\":\"C\"" << line << ",\"pid\":1,\"args\":{";
+		for (size_t i = 0; i < totals_now.size(); i++)
+			file << (i ? "," : "") << jsonString(totals_now[i].name.c_str()) << ":" << totals_now[i].value;
+		file << "}}";
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	printf("Wrote %u profiler zones to %s\n", (unsigned int)count, path.c_str());
+	return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped CPU timing zones. Every thread records into its own ring buffer, so
+// recording never takes a lock; readers (the overlay and the trace export) can
+// run on any thread while the owners keep writing.
+//
+//     void PhysicsSystem::step(float elapsed_ms) {
+//         PROFILE_ZONE("PhysicsSystem::step");
+//         ...
+//     }
+//
+// Zone names must be string literals, only the pointer is stored.
+class Profiler
+{
+public:
+	// Events kept per thread, the oldest are overwritten first
+	static const uint32_t RING_SIZE = 1 << 16;
+
+	struct ZoneStats {
+		std::string name;
+		unsigned int count = 0;
+		float p50_ms = 0.f;
+		float p99_ms = 0.f;
+	};
+
+	struct Counter {
+		std::string name;
+		int64_t value = 0;
+	};
+
+	struct Event {
+		std::atomic<const char*> name { nullptr };
+		std::atomic<uint64_t> start_ns { 0 };
+		std::atomic<uint64_t> end_ns { 0 };
+	};
+
+	// One timeline in the trace, a thread or something that isn't one like the GPU
+	struct Track {
+		unsigned int id = 0;
+		std::atomic<const char*> name { nullptr };
+		// total events ever recorded, only the owner writes it
+		std::atomic<uint64_t> written { 0 };
+		Event events[RING_SIZE];
+	};
+
+	// Nanoseconds since the profiler started
+	uint64_t now() const;
+
+	// Appends a finished zone to the calling thread's ring
+	void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+	// Shows up as the thread's name in the trace viewer
+	void setThreadName(const char* name);
+
+	// A track that isn't tied to the calling thread. Only one thread at a time may record into it.
+	Track& createTrack(const char* name);
+	void record(Track& track, const char* name, uint64_t start_ns, uint64_t end_ns);
+
+	// Adds to a running total, like cache hits. Unlike zones this takes a lock,
+	// keep it to a handful of calls a tick. Names must be string literals.
+	void count(const char* name, int64_t amount = 1);
+	// Every total so far, by name
+	std::vector<Counter> counters() const;
+
+	// Percentiles per zone name over the zones that ended in the last window_ms, slowest p99 first
+	std::vector<ZoneStats> summarize(float window_ms) const;
+	// Everything still in the rings in Chrome's trace_event format, open it in chrome://tracing or Perfetto
+	bool writeTrace(const std::string& path) const;
+
+private:
+	struct Copy {
+		const char* name;
+		uint64_t start_ns;
+		uint64_t end_ns;
+	};
+
+	Track& threadTrack();
+	// Consistent copy of the events of one ring that ended at or after since_ns
+	static void copyEvents(const Track& track, uint64_t since_ns, std::vector<Copy>& out);
+
+	mutable std::mutex tracks_mutex;
+	std::vector<std::unique_ptr<Track>> tracks;
+	mutable std::mutex counters_mutex;
+	std::vector<std::pair<const char*, int64_t>> totals;
+};
+
+extern Profiler profiler;
+
+// Records the time between construction and destruction
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* name) : name(name), start_ns(profiler.now()) {}
+	~ProfileZone() { profiler.record(name, start_ns, profiler.now()); }
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* name;
+	uint64_t start_ns;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
@@ -0,0 +1,143 @@
+// internal
+#include "random.hpp"
+
+// stlib
+#include <atomic>
+#include <cassert>
+
+// generators fill() runs side by side, one vector register of 32 bit lanes on AVX2
+const int FILL_LANES = 8;
+
+static std::atomic<uint64_t> global_seed { 0 };
+// bumped by seedRandom, thread generators compare it to know they're stale
+static std::atomic<uint32_t> seed_generation { 1 };
+static std::atomic<uint64_t> next_thread_stream { 0 };
+
+static uint64_t splitmix64(uint64_t& x)
+{
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static inline uint32_t rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+// top 24 bits, every float in [0, 1) is equally likely
+static inline float toUnit(uint32_t x)
+{
+	return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+Rng::Rng(uint64_t seed)
+{
+	uint64_t a = splitmix64(seed);
+	uint64_t b = splitmix64(seed);
+	s[0] = (uint32_t)a;
+	s[1] = (uint32_t)(a >> 32);
+	s[2] = (uint32_t)b;
+	s[3] = (uint32_t)(b >> 32);
+	// all zero state would only ever return zero
+	if ((s[0] | s[1] | s[2] | s[3]) == 0)
+		s[0] = 1;
+}
+
+Rng Rng::stream(uint64_t seed, uint64_t stream)
+{
+	uint64_t mixed = seed;
+	splitmix64(mixed);
+	return Rng(mixed ^ (stream * 0xd1b54a32d192ed03ull));
+}
+
+uint32_t Rng::next()
+{
+	uint32_t result = s[0] + s[3];
+	uint32_t t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+	return result;
+}
+
+float Rng::uniform()
+{
+	return toUnit(next());
+}
+
+float Rng::uniform(float min, float max)
+{
+	return min + (max - min) * uniform();
+}
+
+uint32_t Rng::below(uint32_t n)
+{
+	assert(n > 0);
+	// multiply and keep the high half, no division and hardly any bias for small n
+	return (uint32_t)(((uint64_t)next() * n) >> 32);
+}
+
+Rng Rng::split()
+{
+	uint64_t seed = ((uint64_t)next() << 32) | next();
+	return Rng(seed);
+}
+
+void Rng::fill(float* out, size_t count, float min, float max)
+{
+	// lanes are laid out so each line of the step is one vector operation
+	uint32_t s0[FILL_LANES], s1[FILL_LANES], s2[FILL_LANES], s3[FILL_LANES];
+	for (int lane = 0; lane < FILL_LANES; lane++) {
+		Rng lane_rng = split();
+		s0[lane] = lane_rng.s[0];
+		s1[lane] = lane_rng.s[1];
+		s2[lane] = lane_rng.s[2];
+		s3[lane] = lane_rng.s[3];
+	}
+
+	float scale = (max - min) * (1.0f / 16777216.0f);
+	size_t i = 0;
+	for (; i + FILL_LANES <= count; i += FILL_LANES) {
+		for (int lane = 0; lane < FILL_LANES; lane++) {
+			uint32_t result = s0[lane] + s3[lane];
+			uint32_t t = s1[lane] << 9;
+			s2[lane] ^= s0[lane];
+			s3[lane] ^= s1[lane];
+			s1[lane] ^= s2[lane];
+			s0[lane] ^= s3[lane];
+			s2[lane] ^= t;
+			s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+			out[i + lane] = min + (float)(result >> 8) * scale;
+		}
+	}
+	for (; i < count; i++)
+		out[i] = uniform(min, max);
+}
+
+void seedRandom(uint64_t seed)
+{
+	global_seed = seed;
+	next_thread_stream = 0;
+	seed_generation++;
+}
+
+uint64_t randomSeed()
+{
+	return global_seed;
+}
+
+Rng& threadRng()
+{
+	static thread_local Rng rng;
+	static thread_local uint32_t generation = 0;
+	if (generation != seed_generation) {
+		generation = seed_generation;
+		rng = Rng::stream(global_seed, next_thread_stream++);
+	}
+	return rng;
+}
@@ -0,0 +1,159 @@
+// internal
+#include "render_pipeline.hpp"
+#include "profiler.hpp"
+
+bool RenderPipeline::start(RenderSystem* renderer_arg, GLFWwindow* window_arg)
+{
+	renderer = renderer_arg;
+	window = window_arg;
+	stopping = false;
+
+	run_start = window_start = Clock::now();
+
+	// a context can only be current on one thread at a time
+	glfwMakeContextCurrent(nullptr);
+	thread = std::thread(&RenderPipeline::renderLoop, this);
+	return true;
+}
+
+void RenderPipeline::stop()
+{
+	if (!thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	changed.notify_all();
+	thread.join();
+
+	glfwMakeContextCurrent(window);
+}
+
+RenderSnapshot& RenderPipeline::acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	changed.wait(lock, [this] { return !in_use[write_index]; });
+	return snapshots[write_index];
+}
+
+void RenderPipeline::submit()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		// at most one frame queued, the simulation never runs more than a frame ahead
+		changed.wait(lock, [this] { return ready_index < 0; });
+		in_use[write_index] = true;
+		ready_index = write_index;
+		write_index = 1 - write_index;
+	}
+	changed.notify_all();
+}
+
+void RenderPipeline::renderLoop()
+{
+	glfwMakeContextCurrent(window);
+	profiler.setThreadName("render");
+
+	while (true) {
+		int index;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this] { return ready_index >= 0 || stopping; });
+			// drain what was submitted before stopping
+			if (ready_index < 0)
+				break;
+			index = ready_index;
+			ready_index = -1;
+		}
+		changed.notify_all();
+
+		markBusy(RENDER, true);
+		renderer->draw(snapshots[index]);
+		markBusy(RENDER, false);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			in_use[index] = false;
+		}
+		changed.notify_all();
+	}
+
+	glfwMakeContextCurrent(nullptr);
+}
+
+void RenderPipeline::beginSimulation()
+{
+	markBusy(SIMULATE, true);
+}
+
+void RenderPipeline::endSimulation()
+{
+	markBusy(SIMULATE, false);
+
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	window_totals.frames++;
+	run_totals.frames++;
+}
+
+void RenderPipeline::markBusy(STAGE stage, bool is_busy)
+{
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	Clock::time_point now = Clock::now();
+	bool other_busy = busy[1 - stage];
+
+	if (is_busy) {
+		busy_since[stage] = now;
+		if (other_busy)
+			overlap_since = now;
+	}
+	else {
+		double busy_ms = std::chrono::duration<double, std::milli>(now - busy_since[stage]).count();
+		window_totals.busy_ms[stage] += busy_ms;
+		run_totals.busy_ms[stage] += busy_ms;
+		if (other_busy) {
+			double overlap_ms = std::chrono::duration<double, std::milli>(now - overlap_since).count();
+			window_totals.overlap_ms += overlap_ms;
+			run_totals.overlap_ms += overlap_ms;
+		}
+	}
+	busy[stage] = is_busy;
+}
+
+namespace {
+	RenderPipeline::Stats averages(unsigned int frames, double busy_simulate, double busy_render, double overlap, double elapsed_ms)
+	{
+		RenderPipeline::Stats stats;
+		stats.frames = frames;
+		if (frames == 0)
+			return stats;
+		stats.frame_ms = (float)(elapsed_ms / frames);
+		stats.simulate_ms = (float)(busy_simulate / frames);
+		stats.render_ms = (float)(busy_render / frames);
+		stats.overlap_ms = (float)(overlap / frames);
+		return stats;
+	}
+}
+
+RenderPipeline::Stats RenderPipeline::takeStats()
+{
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	Clock::time_point now = Clock::now();
+	Stats stats = averages(window_totals.frames, window_totals.busy_ms[SIMULATE], window_totals.busy_ms[RENDER],
+		window_totals.overlap_ms, std::chrono::duration<double, std::milli>(now - window_start).count());
+	window_totals = Totals();
+	window_start = now;
+	return stats;
+}
+
+void RenderPipeline::printSummary() const
+{
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	Stats stats = averages(run_totals.frames, run_totals.busy_ms[SIMULATE], run_totals.busy_ms[RENDER],
+		run_totals.overlap_ms, std::chrono::duration<double, std::milli>(Clock::now() - run_start).count());
+	if (stats.frames == 0)
+		return;
+	printf("Render thread: %u frames, %.2f ms/frame, simulate %.2f ms, render %.2f ms, overlapped %.2f ms (%.0f%%)\n",
+		stats.frames, stats.frame_ms, stats.simulate_ms, stats.render_ms, stats.overlap_ms, stats.overlapShare() * 100.f);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// internal
+#include "render_system.hpp"
+
+// stlib
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Draws on a render thread that owns the GL context while the main thread
+// simulates the next frame. Two snapshots alternate: the main thread extracts
+// frame N+1 into one while the render thread draws frame N from the other.
+//
+//     RenderSnapshot& snapshot = pipeline.acquire();
+//     ... simulate ...
+//     renderer.extract(snapshot, alpha);
+//     pipeline.submit();
+class RenderPipeline
+{
+public:
+	// Moves the window's context to the render thread
+	bool start(RenderSystem* renderer, GLFWwindow* window);
+	// Finishes the submitted frames and gives the context back to the calling thread
+	void stop();
+	~RenderPipeline() { stop(); }
+
+	// The snapshot to extract into next, waits while the render thread still draws it
+	RenderSnapshot& acquire();
+	// Hands the acquired snapshot to the render thread
+	void submit();
+
+	// Brackets the main thread's simulation and extraction, for the overlap numbers
+	void beginSimulation();
+	void endSimulation();
+
+	struct Stats {
+		unsigned int frames = 0;
+		float frame_ms = 0.f;
+		float simulate_ms = 0.f;
+		float render_ms = 0.f;
+		// both stages busy at the same time
+		float overlap_ms = 0.f;
+		float overlapShare() const { return frame_ms > 0.f ? overlap_ms / frame_ms : 0.f; }
+	};
+	// Per frame averages since the last call
+	Stats takeStats();
+	// Per frame averages since start()
+	void printSummary() const;
+
+private:
+	using Clock = std::chrono::high_resolution_clock;
+	enum STAGE { SIMULATE = 0, RENDER = 1 };
+
+	void renderLoop();
+	void markBusy(STAGE stage, bool busy);
+
+	RenderSystem* renderer = nullptr;
+	GLFWwindow* window = nullptr;
+	std::thread thread;
+
+	RenderSnapshot snapshots[2];
+	bool in_use[2] = { false, false };
+	int write_index = 0;
+	// snapshot waiting for the render thread, -1 when none
+	int ready_index = -1;
+	bool stopping = false;
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	// overlap accounting, in milliseconds
+	struct Totals {
+		unsigned int frames = 0;
+		double busy_ms[2] = { 0.0, 0.0 };
+		double overlap_ms = 0.0;
+	};
+	mutable std::mutex stats_mutex;
+	bool busy[2] = { false, false };
+	Clock::time_point busy_since[2];
+	Clock::time_point overlap_since;
+	Totals window_totals;
+	Totals run_totals;
+	Clock::time_point window_start;
+	Clock::time_point run_start;
+};
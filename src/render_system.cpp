@@ -1,15 +1,18 @@
 // internal
 #include "render_system.hpp"
+#include "profiler.hpp"
 #include <SDL.h>
 
 #include "tiny_ecs_registry.hpp"
+#include "sim_context.hpp"
 
 
 GLuint RenderSystem::getForegroundTexture(Entity& entity, RenderRequest& render_request)
 {
+	SimContext& ctx = SimContext::current();
 	if (render_request.used_effect != EFFECT_ASSET_ID::MESH)
 	{
-		return texture_gl_handles[(GLuint)registry.foregroundRenderRequests.get(entity).used_texture];
+		return texture_gl_handles[(GLuint)ctx.registry.foregroundRenderRequests.get(entity).used_texture];
 	}
 	else
 	{
@@ -17,73 +20,113 @@ GLuint RenderSystem::getForegroundTexture(Entity& entity, RenderRequest& render_
 	}
 }
 
-void RenderSystem::drawTexturedMesh(Entity& entity,
-									const mat3 &projection)
+// Copies what drawTexturedMesh needs for one render request out of the ECS
+void RenderSystem::extractDrawItem(Entity entity, float alpha, DrawItem& item)
 {
+	SimContext& ctx = SimContext::current();
 	// Transformation code, see Rendering and Transformation in the template
 	// specification for more info Incrementally updates transformation matrix,
 	// thus ORDER IS IMPORTANT
 	Transform transform;
 	RenderRequest render_request;
-	GLuint texture_id;
 
 	// Transformations
-	if (registry.foregroundMotions.has(entity)) {
-		foregroundMotion& motion = registry.foregroundMotions.get(entity);
-		transform.translate(motion.position);
+	if (ctx.registry.foregroundMotions.has(entity)) {
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(entity);
+		// Blend from the previous fixed step by how far into the next one we are
+		vec2 position = motion.position;
+		if (motion.has_previous)
+			position = motion.previous_position + (motion.position - motion.previous_position) * alpha;
+		transform.translate(position);
 		transform.scale(motion.scale);
 		transform.rotate(motion.angle);
 	}
-	else if (registry.backgroundMotions.has(entity)) {
-		backgroundMotions& backgroundMotions = registry.backgroundMotions.get(entity);
+	else if (ctx.registry.backgroundMotions.has(entity)) {
+		backgroundMotions& backgroundMotions = ctx.registry.backgroundMotions.get(entity);
 		transform.translate(backgroundMotions.position);
 		transform.scale(backgroundMotions.scale);
 		transform.rotate(backgroundMotions.angle);
 	}
-	else if (registry.overlayMotions.has(entity)) {
-		overlayMotions& overlayMotions = registry.overlayMotions.get(entity);
+	else if (ctx.registry.overlayMotions.has(entity)) {
+		overlayMotions& overlayMotions = ctx.registry.overlayMotions.get(entity);
 		transform.translate(overlayMotions.position);
 		transform.scale(overlayMotions.scale);
 		transform.rotate(overlayMotions.angle);
 	}
+	item.transform = transform.mat;
 
 	// Rendering order
-	if (registry.backgroundRenderRequests.has(entity)) {
-		render_request = registry.backgroundRenderRequests.get(entity);
-		texture_id =
-			texture_gl_handles[(GLuint)registry.backgroundRenderRequests.get(entity).used_texture];
+	if (ctx.registry.backgroundRenderRequests.has(entity)) {
+		render_request = ctx.registry.backgroundRenderRequests.get(entity);
+		item.texture =
+			texture_gl_handles[(GLuint)ctx.registry.backgroundRenderRequests.get(entity).used_texture];
 	}
-	else if (registry.foregroundRenderRequests.has(entity)) {
-		render_request = registry.foregroundRenderRequests.get(entity);
-		texture_id = getForegroundTexture(entity, render_request);
+	else if (ctx.registry.foregroundRenderRequests.has(entity)) {
+		render_request = ctx.registry.foregroundRenderRequests.get(entity);
+		item.texture = getForegroundTexture(entity, render_request);
 	}
-	else if (registry.overlayRenderRequests.has(entity)) {
-		render_request = registry.overlayRenderRequests.get(entity);
-		texture_id = texture_gl_handles[(GLuint)registry.overlayRenderRequests.get(entity).used_texture];
+	else if (ctx.registry.overlayRenderRequests.has(entity)) {
+		render_request = ctx.registry.overlayRenderRequests.get(entity);
+		item.texture = texture_gl_handles[(GLuint)ctx.registry.overlayRenderRequests.get(entity).used_texture];
 	}
 	else {
 		assert(false);
 	}
+	item.effect = render_request.used_effect;
+	item.geometry = render_request.used_geometry;
+
+	item.color = ctx.registry.colors.has(entity) ? ctx.registry.colors.get(entity) : vec3(1);
+	item.opacity = ctx.registry.particles.has(entity) ? ctx.registry.particles.get(entity).opacity : 1.0f;
+
+	item.instanced = ctx.registry.instanceRenderRequests.has(entity);
+	if (item.instanced) {
+		InstanceRenderRequest& irr = ctx.registry.instanceRenderRequests.get(entity);
+		item.instances = irr.instances;
+		item.instancing = irr.used_instancing;
+		item.translations = irr.translations;
+	}
+
+	if (item.effect == EFFECT_ASSET_ID::ANIMATION) {
+		Animation& animation = ctx.registry.animation.get(entity);
+		item.frame_x = animation.current_x_frame;
+		item.frame_y = animation.current_y_frame;
+		item.columns = animation.columns;
+		item.rows = animation.rows;
+	}
+
+	item.has_mole = ctx.registry.whackAMole.has(entity);
+	if (item.has_mole) {
+		WhackAMole& mole = ctx.registry.whackAMole.get(entity);
+		item.whacked = mole.whacked;
+		item.anger_level = mole.angerLevel;
+	}
+}
 
-	const GLuint used_effect_enum = (GLuint)render_request.used_effect;
+void RenderSystem::drawTexturedMesh(const DrawItem& item,
+									const mat3 &projection)
+{
+	PROFILE_ZONE("RenderSystem::drawTexturedMesh");
+	const GLuint texture_id = item.texture;
+
+	const GLuint used_effect_enum = (GLuint)item.effect;
 	assert(used_effect_enum != (GLuint)EFFECT_ASSET_ID::EFFECT_COUNT);
 	const GLuint program = (GLuint)effects[used_effect_enum];
 
 	// Setting shaders
-	glUseProgram(program);
+	gl_state.useProgram(program);
 	gl_has_errors();
 
-	assert(render_request.used_geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT);
-	const GLuint vbo = vertex_buffers[(GLuint)render_request.used_geometry];
-	const GLuint ibo = index_buffers[(GLuint)render_request.used_geometry];
+	assert(item.geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT);
+	const GLuint vbo = vertex_buffers[(GLuint)item.geometry];
+	const GLuint ibo = index_buffers[(GLuint)item.geometry];
 
 	// Setting vertex and index buffers
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo);
+	gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
 	gl_has_errors();
 
 	// Input data location as in the vertex buffer
-	if (render_request.used_effect == EFFECT_ASSET_ID::TEXTURED)
+	if (item.effect == EFFECT_ASSET_ID::TEXTURED)
 	{
 		GLint in_position_loc = glGetAttribLocation(program, "in_position");
 		GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
@@ -94,23 +137,21 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		assert(in_position_loc >= 0);
 		assert(is_instanced_loc >= 0);
 
-		if (registry.instanceRenderRequests.has(entity))
+		if (item.instanced)
 		{
 			// set instance rendering to true in vertex shader
 			glUniform1i(is_instanced_loc, 1);
 
-			InstanceRenderRequest& irr = registry.instanceRenderRequests.get(entity);
-
-			GLuint instance_vbo = instancing_buffers[(int)irr.used_instancing];
-			glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * irr.instances, &irr.translations[0], GL_STATIC_DRAW);
+			GLuint instance_vbo = instancing_buffers[(int)item.instancing];
+			gl_state.bindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * item.instances, &item.translations[0], GL_STATIC_DRAW);
 			gl_has_errors();
 
-			glEnableVertexAttribArray(texture_in_offset);
-			glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+			gl_state.enableVertexAttribArray(texture_in_offset);
+			gl_state.bindBuffer(GL_ARRAY_BUFFER, instance_vbo);
 			glVertexAttribPointer(texture_in_offset, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
 			glVertexAttribDivisor(texture_in_offset, 1);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo);
 			gl_has_errors();
 		}
 		else
@@ -120,12 +161,12 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 			gl_has_errors();
 		}
 
-		glEnableVertexAttribArray(in_position_loc);
+		gl_state.enableVertexAttribArray(in_position_loc);
 		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
 							  sizeof(TexturedVertex), (void *)0);
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_texcoord_loc);
+		gl_state.enableVertexAttribArray(in_texcoord_loc);
 		glVertexAttribPointer(
 			in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
 			(void *)sizeof(
@@ -133,14 +174,14 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		gl_has_errors();
 
 		// Enabling and binding texture to slot 0
-		glActiveTexture(GL_TEXTURE0);
+		gl_state.activeTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		glBindTexture(GL_TEXTURE_2D, texture_id);
+		gl_state.bindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
 		
 	}
-	else if (render_request.used_effect == EFFECT_ASSET_ID::MESH)
+	else if (item.effect == EFFECT_ASSET_ID::MESH)
 	{
 		// Code left in for reference to specific effects on things
 
@@ -148,16 +189,16 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		GLint in_color_loc = glGetAttribLocation(program, "in_color");
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_position_loc);
+		gl_state.enableVertexAttribArray(in_position_loc);
 		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
 			sizeof(ColoredVertex), (void*)0);
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_color_loc);
+		gl_state.enableVertexAttribArray(in_color_loc);
 		glVertexAttribPointer(in_color_loc, 3, GL_FLOAT, GL_FALSE,
 			sizeof(ColoredVertex), (void*)sizeof(vec3));
 		gl_has_errors();
-	} else if (render_request.used_effect == EFFECT_ASSET_ID::MOLE)
+	} else if (item.effect == EFFECT_ASSET_ID::MOLE)
 	{
 		GLint in_position_loc = glGetAttribLocation(program, "in_position");
 		GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
@@ -175,37 +216,37 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		gl_has_errors();
 
 
-		if (registry.whackAMole.has(entity)) {
-			glUniform1i(whacked_uloc, registry.whackAMole.get(entity).whacked);
-			if (registry.whackAMole.get(entity).angerLevel < 0.5) { // If anger level passes this value, start shaking
+		if (item.has_mole) {
+			glUniform1i(whacked_uloc, item.whacked);
+			if (item.anger_level < 0.5) { // If anger level passes this value, start shaking
 				glUniform1f(anger_level_uloc, 0);
 			}
 			else {
-				glUniform1f(anger_level_uloc, registry.whackAMole.get(entity).angerLevel-0.5);
+				glUniform1f(anger_level_uloc, item.anger_level-0.5);
 			}
 		}
 
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_position_loc);
+		gl_state.enableVertexAttribArray(in_position_loc);
 		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
 			sizeof(TexturedVertex), (void*)0);
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_texcoord_loc);
+		gl_state.enableVertexAttribArray(in_texcoord_loc);
 		glVertexAttribPointer(
 			in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
 			(void*)sizeof(
 				vec3)); // note the stride to skip the preceeding vertex position
 
 		// Enabling and binding texture to slot 0
-		glActiveTexture(GL_TEXTURE0);
+		gl_state.activeTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		glBindTexture(GL_TEXTURE_2D, texture_id);
+		gl_state.bindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
 	}
-	else if (render_request.used_effect == EFFECT_ASSET_ID::ANIMATION)
+	else if (item.effect == EFFECT_ASSET_ID::ANIMATION)
 	{
 		GLint in_position_loc = glGetAttribLocation(program, "in_position");
 		GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
@@ -223,19 +264,18 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		assert(sheet_height_loc >= 0);
 		
 
-		Animation& animation = registry.animation.get(entity);
-		glUniform1i(frame_index_loc, animation.current_x_frame);
-		glUniform1i(sheet_width_loc, animation.columns);
-		glUniform1i(frame_y_loc, animation.current_y_frame);
-		glUniform1i(sheet_height_loc, animation.rows);
+		glUniform1i(frame_index_loc, item.frame_x);
+		glUniform1i(sheet_width_loc, item.columns);
+		glUniform1i(frame_y_loc, item.frame_y);
+		glUniform1i(sheet_height_loc, item.rows);
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_position_loc);
+		gl_state.enableVertexAttribArray(in_position_loc);
 		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
 			sizeof(TexturedVertex), (void*)0);
 		gl_has_errors();
 
-		glEnableVertexAttribArray(in_texcoord_loc);
+		gl_state.enableVertexAttribArray(in_texcoord_loc);
 		glVertexAttribPointer(
 			in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex),
 			(void*)sizeof(
@@ -243,10 +283,10 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 		gl_has_errors();
 
 		// Enabling and binding texture to slot 0
-		glActiveTexture(GL_TEXTURE0);
+		gl_state.activeTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		glBindTexture(GL_TEXTURE_2D, texture_id);
+		gl_state.bindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
 	}
 	else
@@ -257,36 +297,27 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
-	const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
-	glUniform3fv(color_uloc, 1, (float *)&color);
+	glUniform3fv(color_uloc, 1, (float *)&item.color);
 	gl_has_errors();
 
 	GLint opacity_uloc = glGetUniformLocation(program, "opacity");
-	const float opacity = registry.particles.has(entity) ? registry.particles.get(entity).opacity : 1.0f;
-	glUniform1fv(opacity_uloc, 1, (float*)&opacity);
+	glUniform1fv(opacity_uloc, 1, (float*)&item.opacity);
 
-	// Get number of indices from index buffer, which has elements uint16_t
-	GLint size = 0;
-	glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
-	gl_has_errors();
-
-	GLsizei num_indices = size / sizeof(uint16_t);
+	// Index counts are recorded at upload, asking GL for the buffer size stalls
+	GLsizei num_indices = index_counts[(GLuint)item.geometry];
 	// GLsizei num_triangles = num_indices / 3;
 
-	GLint currProgram;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &currProgram);
 	// Setting uniform values to the currently bound program
-	GLuint transform_loc = glGetUniformLocation(currProgram, "transform");
-	glUniformMatrix3fv(transform_loc, 1, GL_FALSE, (float *)&transform.mat);
-	GLuint projection_loc = glGetUniformLocation(currProgram, "projection");
+	GLuint transform_loc = glGetUniformLocation(program, "transform");
+	glUniformMatrix3fv(transform_loc, 1, GL_FALSE, (float *)&item.transform);
+	GLuint projection_loc = glGetUniformLocation(program, "projection");
 	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float *)&projection);
 	gl_has_errors();
 
 	// instance rendering is only enabled for textures for now
-	if (registry.instanceRenderRequests.has(entity) && render_request.used_effect == EFFECT_ASSET_ID::TEXTURED)
+	if (item.instanced && item.effect == EFFECT_ASSET_ID::TEXTURED)
 	{
-		InstanceRenderRequest& irr = registry.instanceRenderRequests.get(entity);
-		glDrawElementsInstanced(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr, irr.instances);
+		glDrawElementsInstanced(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr, item.instances);
 	}
 	else
 	{
@@ -297,17 +328,77 @@ void RenderSystem::drawTexturedMesh(Entity& entity,
 	gl_has_errors();
 }
 
-// draw the intermediate texture to the screen, with some distortion to simulate
-// wind
-void RenderSystem::drawToScreen()
+// Screen space visibility test done before extracting a render request. Uses
+// the same motion lookup order as extractDrawItem.
+bool RenderSystem::isOnScreen(Entity entity, GEOMETRY_BUFFER_ID geometry)
+{
+	SimContext& ctx = SimContext::current();
+	vec2 position, scale;
+	float angle;
+	if (ctx.registry.foregroundMotions.has(entity)) {
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(entity);
+		position = motion.position;
+		scale = motion.scale;
+		angle = motion.angle;
+	}
+	else if (ctx.registry.backgroundMotions.has(entity)) {
+		backgroundMotions& motion = ctx.registry.backgroundMotions.get(entity);
+		position = motion.position;
+		scale = motion.scale;
+		angle = motion.angle;
+	}
+	else if (ctx.registry.overlayMotions.has(entity)) {
+		overlayMotions& motion = ctx.registry.overlayMotions.get(entity);
+		position = motion.position;
+		scale = motion.scale;
+		angle = motion.angle;
+	}
+	else {
+		// nothing to place it with, let the draw decide
+		return true;
+	}
+
+	// Instance offsets are added after projection, so the motion alone doesn't bound them
+	if (ctx.registry.instanceRenderRequests.has(entity))
+		return true;
+
+	// Sprites and meshes span [-0.5, 0.5], the background quad spans [-1, 1]
+	float extent = geometry == GEOMETRY_BUFFER_ID::BACKGROUND ? 1.f : 0.5f;
+	vec2 half_size = abs(scale) * extent;
+	if (angle != 0.f) {
+		// bounds of the rotated box
+		float c = std::abs(cos(angle));
+		float s = std::abs(sin(angle));
+		half_size = { half_size.x * c + half_size.y * s, half_size.x * s + half_size.y * c };
+	}
+
+	return position.x + half_size.x >= 0.f && position.x - half_size.x <= (float)window_width_px &&
+		position.y + half_size.y >= 0.f && position.y - half_size.y <= (float)window_height_px;
+}
+
+// Works out which post effects this frame needs. Everything that reads the
+// finished frame is folded into the single transition pass.
+RenderSystem::FramePlan RenderSystem::planFrame(const RenderSnapshot& snapshot)
+{
+	FramePlan plan;
+	if (snapshot.darken_screen_factor > 0)
+		plan.post_effects |= POST_FADE;
+	if (snapshot.shake_ms > 0)
+		plan.post_effects |= POST_SHAKE;
+	plan.offscreen = plan.post_effects != 0;
+	return plan;
+}
+
+// draw the intermediate texture to the screen, running every active post
+// effect of the plan in one pass
+void RenderSystem::drawToScreen(const FramePlan& plan, const RenderSnapshot& snapshot)
 {
 	// Setting shaders
-	// get the wind texture, sprite mesh, and program
-	glUseProgram(effects[(GLuint)EFFECT_ASSET_ID::TRANSITION]);
+	gl_state.useProgram(effects[(GLuint)EFFECT_ASSET_ID::TRANSITION]);
 	gl_has_errors();
 	// Clearing backbuffer
 	int w, h;
-	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+	getFramebufferSize(w, h);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glViewport(0, 0, w, h);
 	glDepthRange(0, 10);
@@ -321,33 +412,37 @@ void RenderSystem::drawToScreen()
 	glDisable(GL_DEPTH_TEST);
 
 	// Draw the screen texture on the quad geometry
-	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE]);
-	glBindBuffer(
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE]);
+	gl_state.bindBuffer(
 		GL_ELEMENT_ARRAY_BUFFER,
 		index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE]); // Note, GL_ELEMENT_ARRAY_BUFFER associates
 																	 // indices to the bound GL_ARRAY_BUFFER
 	gl_has_errors();
 
 	const GLuint transition_program = effects[(GLuint)EFFECT_ASSET_ID::TRANSITION];
+
+	GLuint post_effects_uloc = glGetUniformLocation(transition_program, "post_effects");
+	glUniform1i(post_effects_uloc, (GLint)plan.post_effects);
+
 	// Set clock
 	GLuint darken_timer_uloc = glGetUniformLocation(transition_program, "darken_screen_factor");
+	glUniform1f(darken_timer_uloc, snapshot.darken_screen_factor);
 
-	float& darken_screen_factor = registry.screenStates.get(screen_state_entity).darken_screen_factor;
-
-	glUniform1f(darken_timer_uloc, darken_screen_factor);
+	GLuint shake_offset_uloc = glGetUniformLocation(transition_program, "shake_offset");
+	glUniform2f(shake_offset_uloc, snapshot.shake_offset.x, snapshot.shake_offset.y);
 	gl_has_errors();
 	
 	// Set the vertex position and vertex texture coordinates (both stored in the
 	// same VBO)
 	GLint in_position_loc = glGetAttribLocation(transition_program, "in_position");
-	glEnableVertexAttribArray(in_position_loc);
+	gl_state.enableVertexAttribArray(in_position_loc);
 	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void *)0);
 	gl_has_errors();
 
 	// Bind our texture in Texture Unit 0
-	glActiveTexture(GL_TEXTURE0);
+	gl_state.activeTexture(GL_TEXTURE0);
 
-	glBindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
+	gl_state.bindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
 	gl_has_errors();
 	// Draw
 	glDrawElements(
@@ -357,16 +452,73 @@ void RenderSystem::drawToScreen()
 	gl_has_errors();
 }
 
+// Culls and copies one layer of render requests, reusing the layer's items
+void RenderSystem::extractLayer(ComponentContainer<RenderRequest>& requests, float alpha, std::vector<DrawItem>& layer, RenderSnapshot& snapshot)
+{
+	size_t count = 0;
+	for (uint i = 0; i < requests.size(); i++) {
+		Entity entity = requests.entities[i];
+		if (!isOnScreen(entity, requests.components[i].used_geometry)) {
+			snapshot.culled_count++;
+			continue;
+		}
+		if (count == layer.size())
+			layer.emplace_back();
+		extractDrawItem(entity, alpha, layer[count++]);
+	}
+	layer.resize(count);
+	snapshot.drawn_count += (unsigned int)count;
+}
+
+void RenderSystem::extract(RenderSnapshot& snapshot, float alpha)
+{
+	SimContext& ctx = SimContext::current();
+	PROFILE_ZONE("RenderSystem::extract");
+	snapshot.drawn_count = 0;
+	snapshot.culled_count = 0;
+
+	extractLayer(ctx.registry.backgroundRenderRequests, alpha, snapshot.background, snapshot);
+	extractLayer(ctx.registry.foregroundRenderRequests, alpha, snapshot.foreground, snapshot);
+	extractLayer(ctx.registry.overlayRenderRequests, alpha, snapshot.overlay, snapshot);
+
+	snapshot.texts.clear();
+	for (Entity entity: ctx.registry.textRenderRequests.entities) {
+		Text& text = ctx.registry.texts.get(entity);
+		if (text.str != "")
+			snapshot.texts.push_back(text);
+	}
+
+	ScreenState& screen = ctx.registry.screenStates.get(screen_state_entity);
+	snapshot.darken_screen_factor = screen.darken_screen_factor;
+	snapshot.shake_ms = screen.shake_ms;
+	snapshot.shake_offset = screen.shake_offset;
+
+	drawn_count = snapshot.drawn_count;
+	culled_count = snapshot.culled_count;
+}
+
+void RenderSystem::draw(float alpha)
+{
+	extract(local_snapshot, alpha);
+	draw(local_snapshot);
+}
+
 // Render our game world
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
-void RenderSystem::draw()
+void RenderSystem::draw(const RenderSnapshot& snapshot)
 {
+	PROFILE_ZONE("RenderSystem::draw");
+	gl_state.beginFrame();
+	gpu_timer.beginFrame();
+
 	// Getting size of window
 	int w, h;
-	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+	getFramebufferSize(w, h);
 
-	// First render to the custom framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+	// Only go through the intermediate texture when a post effect has to read it,
+	// otherwise the scene goes straight to the default framebuffer
+	FramePlan plan = planFrame(snapshot);
+	glBindFramebuffer(GL_FRAMEBUFFER, plan.offscreen ? frame_buffer : 0);
 	gl_has_errors();
 	// Clearing backbuffer
 	glViewport(0, 0, w, h);
@@ -383,35 +535,39 @@ void RenderSystem::draw()
 	mat3 projection_2D = createProjectionMatrix();
 
 	// Draw background images first
-	for (Entity entity : registry.backgroundRenderRequests.entities) {
-		drawTexturedMesh(entity, projection_2D);
-	}
+	gpu_timer.begin(GpuTimer::BACKGROUND);
+	for (const DrawItem& item : snapshot.background)
+		drawTexturedMesh(item, projection_2D);
 
 	// Draw foreground objects after
-	for (Entity entity : registry.foregroundRenderRequests.entities)
-	{
-		drawTexturedMesh(entity, projection_2D);
-	}
+	gpu_timer.begin(GpuTimer::FOREGROUND);
+	for (const DrawItem& item : snapshot.foreground)
+		drawTexturedMesh(item, projection_2D);
+
+	// Particles sit on top of the foreground
+	gpu_timer.begin(GpuTimer::PARTICLES);
+	particle_pool.draw(projection_2D);
 
 	// Draw overlay objects after
-	for (Entity entity : registry.overlayRenderRequests.entities)
-	{
-		drawTexturedMesh(entity, projection_2D);
-	}
+	gpu_timer.begin(GpuTimer::OVERLAY);
+	for (const DrawItem& item : snapshot.overlay)
+		drawTexturedMesh(item, projection_2D);
 
 	// Draw text objects after
-	for (Entity entity: registry.textRenderRequests.entities) {
-		Text& text = registry.texts.get(entity);
-		if (text.str != "") {
-			renderText(text.str, text.pos.x, text.pos.y, text.scale, text.color, text.trans);
-		}
-	}
+	gpu_timer.begin(GpuTimer::TEXT);
+	for (const Text& text : snapshot.texts)
+		renderText(text.str, text.pos.x, text.pos.y, text.scale, text.color, text.trans);
 
 	// Truely render to the screen
-	drawToScreen();
+	if (plan.offscreen) {
+		gpu_timer.begin(GpuTimer::SCREEN);
+		drawToScreen(plan, snapshot);
+	}
+	gpu_timer.end();
 
-	// flicker-free display with a double buffer
-	glfwSwapBuffers(window);
+	// flicker-free display with a double buffer, nothing to present when headless
+	if (window != nullptr)
+		glfwSwapBuffers(window);
 	gl_has_errors();
 }
 
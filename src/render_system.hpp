@@ -6,6 +6,9 @@
 #include "common.hpp"
 #include "components.hpp"
 #include "tiny_ecs.hpp"
+#include "particle_pool.hpp"
+#include "gl_state.hpp"
+#include "gpu_timer.hpp"
 
 // fonts
 // NEED FOR FONTS
@@ -22,6 +25,47 @@ struct Character {
 	char character;
 };
 
+// One render request as the draw needs it, copied out of the ECS
+struct DrawItem {
+	mat3 transform;
+	EFFECT_ASSET_ID effect = EFFECT_ASSET_ID::EFFECT_COUNT;
+	GEOMETRY_BUFFER_ID geometry = GEOMETRY_BUFFER_ID::GEOMETRY_COUNT;
+	GLuint texture = 0;
+	vec3 color = vec3(1);
+	float opacity = 1.f;
+	// ANIMATION sprite sheet frame
+	int frame_x = 0;
+	int frame_y = 0;
+	int columns = 1;
+	int rows = 1;
+	// MOLE
+	bool has_mole = false;
+	bool whacked = false;
+	float anger_level = 0.f;
+	// instanced TEXTURED draws
+	bool instanced = false;
+	unsigned int instances = 0;
+	INSTANCING_BUFFER_ID instancing = INSTANCING_BUFFER_ID::INSTANCING_COUNT;
+	std::vector<vec2> translations;
+};
+
+// Everything a frame draws, so drawing never reads the live ECS containers and
+// can run on another thread while the next frame is simulated
+struct RenderSnapshot {
+	std::vector<DrawItem> background;
+	std::vector<DrawItem> foreground;
+	std::vector<DrawItem> overlay;
+	std::vector<Text> texts;
+
+	// from the ScreenState
+	float darken_screen_factor = 0.f;
+	float shake_ms = 0.f;
+	vec2 shake_offset = { 0.f, 0.f };
+
+	unsigned int drawn_count = 0;
+	unsigned int culled_count = 0;
+};
+
 // System responsible for setting up OpenGL and for rendering all the
 // visual entities in the game
 class RenderSystem {
@@ -148,18 +192,23 @@ class RenderSystem {
 		shader_path("mesh"),
 		shader_path("font"),
 		shader_path("mole"),
-		shader_path("animation")
+		shader_path("animation"),
+		shader_path("particle")
 	};
 
 	std::array<GLuint, geometry_count> vertex_buffers;
 	std::array<GLuint, geometry_count> index_buffers;
+	std::array<GLsizei, geometry_count> index_counts = {};
 	std::array<Mesh, geometry_count> meshes;
 	std::array<GLuint, instancing_count> instancing_buffers;
 
 public:
-	// Initialize the window
+	// Initialize the window, pass nullptr when rendering into a headless context
 	bool init(GLFWwindow* window);
 
+	// Size of the default framebuffer, the window's or the headless pbuffer's
+	void getFramebufferSize(int& width, int& height);
+
 	template <class T>
 	void bindVBOandIBO(GEOMETRY_BUFFER_ID gid, std::vector<T> vertices, std::vector<uint16_t> indices);
 
@@ -168,6 +217,9 @@ public:
 	void initializeGlEffects();
 
 	void initializeGlMeshes();
+	// Reads the .obj files into meshes, no GL involved. Simulations without a
+	// context (batch runs) call it for the collision meshes, init() does it too.
+	bool loadMeshes();
 	Mesh& getMesh(GEOMETRY_BUFFER_ID id) { return meshes[(int)id]; };
 
 	void initializeGlGeometryBuffers();
@@ -179,8 +231,13 @@ public:
 	// Destroy resources associated to one or all entities created by the system
 	~RenderSystem();
 
-	// Draw all entities
-	void draw();
+	// Copies what the next frame draws out of the ECS, alpha is how far we are
+	// between the last two fixed steps. Doesn't touch GL.
+	void extract(RenderSnapshot& snapshot, float alpha = 1.f);
+	// Draws a snapshot, only needs the GL context
+	void draw(const RenderSnapshot& snapshot);
+	// Extract and draw on the calling thread
+	void draw(float alpha = 1.f);
 
 	mat3 createProjectionMatrix();
 
@@ -191,16 +248,51 @@ public:
 
 	Entity screen_state_entity;
 
+	// GPU simulated particles, drawn between the foreground and the overlay
+	ParticlePool particle_pool;
+
+	// GPU time of each pass in draw(), read back a few frames late
+	GpuTimer gpu_timer;
+
+	// Render requests submitted and skipped by the screen culling in the last extract
+	unsigned int drawn_count = 0;
+	unsigned int culled_count = 0;
+
+	// Share of the frame time the simulation and the render thread ran at the
+	// same time, set by the main loop, 0 when drawing on the main thread
+	float frame_overlap = 0.f;
+
 private:
 	// Internal drawing functions for each entity type
-	void drawTexturedMesh(Entity& entity, const mat3& projection);
-	void drawToScreen();
+	void extractLayer(ComponentContainer<RenderRequest>& requests, float alpha, std::vector<DrawItem>& layer, RenderSnapshot& snapshot);
+	void extractDrawItem(Entity entity, float alpha, DrawItem& item);
+	void drawTexturedMesh(const DrawItem& item, const mat3& projection);
+	bool isOnScreen(Entity entity, GEOMETRY_BUFFER_ID geometry);
+	// What the frame needs beyond drawing the scene, built at the start of draw()
+	enum POST_EFFECT {
+		POST_FADE = 1 << 0,
+		POST_SHAKE = 1 << 1
+	};
+	struct FramePlan {
+		bool offscreen = false;
+		unsigned int post_effects = 0;
+	};
+	FramePlan planFrame(const RenderSnapshot& snapshot);
+	void drawToScreen(const FramePlan& plan, const RenderSnapshot& snapshot);
 	GLuint getForegroundTexture(Entity& entity, RenderRequest& render_request);
+	void releaseGl();
 	//GLuint runOverlayAnimation(Entity& entity);
 
 	// Window handle
 	GLFWwindow* window;
 
+	// set once init() has a context, the destructor only frees GL objects then
+	bool gl_ready = false;
+	bool meshes_loaded = false;
+
+	// used by draw(alpha) when there is no render thread
+	RenderSnapshot local_snapshot;
+
 	// Screen texture handles
 	GLuint frame_buffer;
 	GLuint off_screen_render_buffer_color;
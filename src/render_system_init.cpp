@@ -1,5 +1,6 @@
 // internal
 #include "render_system.hpp"
+#include "profiler.hpp"
 
 #include <array>
 #include <fstream>
@@ -8,6 +9,7 @@
 
 // This creates circular header inclusion, that is quite bad.
 #include "tiny_ecs_registry.hpp"
+#include "sim_context.hpp"
 
 // stlib
 #include <iostream>
@@ -21,14 +23,19 @@
 // World initialization
 bool RenderSystem::init(GLFWwindow* window_arg)
 {
+	PROFILE_ZONE("RenderSystem::init");
 	this->window = window_arg;
 
-	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1); // vsync
+	// In headless mode the caller already made an offscreen context current
+	if (window != nullptr) {
+		glfwMakeContextCurrent(window);
+		glfwSwapInterval(1); // vsync
+	}
 
 	// Load OpenGL function pointers
 	const int is_fine = gl3w_init();
 	assert(is_fine == 0);
+	gl_ready = true;
 
 	stbi_set_flip_vertically_on_load(true);
 
@@ -41,7 +48,7 @@ bool RenderSystem::init(GLFWwindow* window_arg)
 	// For some high DPI displays (ex. Retina Display on Macbooks)
 	// https://stackoverflow.com/questions/36672935/why-retina-screen-coordinate-value-is-twice-the-value-of-pixel-value
 	int frame_buffer_width_px, frame_buffer_height_px;
-	glfwGetFramebufferSize(window, &frame_buffer_width_px, &frame_buffer_height_px);  // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+	getFramebufferSize(frame_buffer_width_px, frame_buffer_height_px);
 	if (frame_buffer_width_px != window_width_px)
 	{
 		printf("WARNING: retina display! https://stackoverflow.com/questions/36672935/why-retina-screen-coordinate-value-is-twice-the-value-of-pixel-value\n");
@@ -70,17 +77,40 @@ bool RenderSystem::init(GLFWwindow* window_arg)
 	// Initialize instancing buffers
 	glGenBuffers((GLsizei)instancing_buffers.size(), instancing_buffers.data());
 
+	particle_pool.init(
+		vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE],
+		index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE],
+		texture_gl_handles[(GLuint)TEXTURE_ASSET_ID::PARTICLE],
+		effects[(GLuint)EFFECT_ASSET_ID::PARTICLE]);
+
 	// setup fonts
 	std::string font_filename = font_path("Kenney_Mini.ttf");
 	unsigned int font_default_size = 48;
 	fontInit(window, font_filename, font_default_size);
 
+	gpu_timer.init();
+
+	// init bound things behind the cache's back
+	gl_state.invalidate();
+
 	return true;
 }
 
+void RenderSystem::getFramebufferSize(int& width, int& height)
+{
+	if (window == nullptr) {
+		// the headless pbuffer is created at the logical resolution
+		width = window_width_px;
+		height = window_height_px;
+		return;
+	}
+	glfwGetFramebufferSize(window, &width, &height); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+}
+
 // Loads the textures files onto GL
 void RenderSystem::initializeGlTextures()
 {
+    PROFILE_ZONE("RenderSystem::initializeGlTextures");
     glGenTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
 
     for(uint i = 0; i < texture_paths.size(); i++)
@@ -110,6 +140,7 @@ void RenderSystem::initializeGlTextures()
 
 void RenderSystem::initializeGlEffects()
 {
+	PROFILE_ZONE("RenderSystem::initializeGlEffects");
 	for(uint i = 0; i < effect_paths.size(); i++)
 	{
 		const std::string vertex_shader_name = effect_paths[i] + ".vs.glsl";
@@ -132,21 +163,35 @@ void RenderSystem::bindVBOandIBO(GEOMETRY_BUFFER_ID gid, std::vector<T> vertices
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers[(uint)gid]);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER,
 		sizeof(indices[0]) * indices.size(), indices.data(), GL_STATIC_DRAW);
+	index_counts[(uint)gid] = (GLsizei)indices.size();
 	gl_has_errors();
 }
 
-void RenderSystem::initializeGlMeshes()
+bool RenderSystem::loadMeshes()
 {
+	if (meshes_loaded)
+		return true;
 	for (uint i = 0; i < mesh_paths.size(); i++)
 	{
-		// Initialize meshes
 		GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
 		std::string name = mesh_paths[i].second;
-		Mesh::loadFromOBJFile(name, 
+		if (!Mesh::loadFromOBJFile(name,
 			meshes[(int)geom_index].vertices,
 			meshes[(int)geom_index].vertex_indices,
-			meshes[(int)geom_index].original_size);
+			meshes[(int)geom_index].original_size))
+			return false;
+	}
+	meshes_loaded = true;
+	return true;
+}
 
+void RenderSystem::initializeGlMeshes()
+{
+	PROFILE_ZONE("RenderSystem::initializeGlMeshes");
+	loadMeshes();
+	for (uint i = 0; i < mesh_paths.size(); i++)
+	{
+		GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
 		bindVBOandIBO(geom_index,
 			meshes[(int)geom_index].vertices, 
 			meshes[(int)geom_index].vertex_indices);
@@ -214,9 +259,31 @@ RenderSystem::~RenderSystem()
 {
 	// Don't need to free gl resources since they last for as long as the program,
 	// but it's polite to clean after yourself.
+	if (gl_ready)
+		releaseGl();
+
+	// remove all entities created by the render system, if their simulation is still around
+	SimContext* ctx = SimContext::bound();
+	if (!ctx)
+		return;
+
+	while (ctx->registry.foregroundRenderRequests.entities.size() > 0)
+	    ctx->registry.remove_all_components_of(ctx->registry.foregroundRenderRequests.entities.back());
+
+	while (ctx->registry.backgroundRenderRequests.entities.size() > 0)
+		ctx->registry.remove_all_components_of(ctx->registry.backgroundRenderRequests.entities.back());
+
+	while (ctx->registry.overlayRenderRequests.entities.size() > 0)
+		ctx->registry.remove_all_components_of(ctx->registry.overlayRenderRequests.entities.back());
+}
+
+void RenderSystem::releaseGl()
+{
 	glDeleteBuffers((GLsizei)vertex_buffers.size(), vertex_buffers.data());
 	glDeleteBuffers((GLsizei)index_buffers.size(), index_buffers.data());
 	glDeleteBuffers((GLsizei)instancing_buffers.size(), instancing_buffers.data());
+	particle_pool.release();
+	gpu_timer.release();
 	glDeleteTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
 	glDeleteTextures(1, &off_screen_render_buffer_color);
 	glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
@@ -228,25 +295,16 @@ RenderSystem::~RenderSystem()
 	// delete allocated resources
 	glDeleteFramebuffers(1, &frame_buffer);
 	gl_has_errors();
-
-	// remove all entities created by the render system
-	while (registry.foregroundRenderRequests.entities.size() > 0)
-	    registry.remove_all_components_of(registry.foregroundRenderRequests.entities.back());
-
-	while (registry.backgroundRenderRequests.entities.size() > 0)
-		registry.remove_all_components_of(registry.backgroundRenderRequests.entities.back());
-
-	while (registry.overlayRenderRequests.entities.size() > 0)
-		registry.remove_all_components_of(registry.overlayRenderRequests.entities.back());
 }
 
 // Initialize the screen texture from a standard sprite
 bool RenderSystem::initScreenTexture()
 {
-	registry.screenStates.emplace(screen_state_entity);
+	SimContext& ctx = SimContext::current();
+	ctx.registry.screenStates.emplace(screen_state_entity);
 
 	int framebuffer_width, framebuffer_height;
-	glfwGetFramebufferSize(const_cast<GLFWwindow*>(window), &framebuffer_width, &framebuffer_height);  // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+	getFramebufferSize(framebuffer_width, framebuffer_height);
 
 	glGenTextures(1, &off_screen_render_buffer_color);
 	glBindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
@@ -370,6 +428,7 @@ bool loadEffectFromFile(
 }
 
 bool RenderSystem::fontInit(GLFWwindow* window, const std::string& font_filename, unsigned int font_default_size) {
+	PROFILE_ZONE("RenderSystem::fontInit");
 
 	// font buffer setup
 	glGenVertexArrays(1, &m_font_VAO);
@@ -479,7 +538,7 @@ bool RenderSystem::fontInit(GLFWwindow* window, const std::string& font_filename
 // NEED FOR FONTS
 void RenderSystem::renderText(const std::string& text, float x, float y, float scale, const glm::vec3& color, const glm::mat4 trans) {
 	// activate the shaders
-	glUseProgram(m_font_shaderProgram);
+	gl_state.useProgram(m_font_shaderProgram);
 
 	GLint textColor_location = glGetUniformLocation(m_font_shaderProgram, "textColor");
 	assert(textColor_location > -1);
@@ -491,7 +550,7 @@ void RenderSystem::renderText(const std::string& text, float x, float y, float s
 
 	glUniformMatrix4fv(transform_location, 1, GL_FALSE, glm::value_ptr(trans));
 
-	glBindVertexArray(m_font_VAO);
+	gl_state.bindVertexArray(m_font_VAO);
 
 	// iterate through all characters
 	std::string::const_iterator c;
@@ -513,14 +572,13 @@ void RenderSystem::renderText(const std::string& text, float x, float y, float s
 		};
 
 		// render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
+		gl_state.bindTexture(GL_TEXTURE_2D, ch.TextureID);
 
 		// std::cout << "binding texture: " << ch.character << " = " << ch.TextureID <<std::endl;
 
 		// update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, m_font_VBO);
+		gl_state.bindBuffer(GL_ARRAY_BUFFER, m_font_VBO);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 		// render quad
 		glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -530,8 +588,7 @@ void RenderSystem::renderText(const std::string& text, float x, float y, float s
 	}
 
 	// go back to using dummy_vao
-	glBindVertexArray(dummy_vao);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	gl_state.bindVertexArray(dummy_vao);
 }
 
 
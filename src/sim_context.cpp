@@ -0,0 +1,52 @@
+// internal
+#include "sim_context.hpp"
+
+// stlib
+#include <cassert>
+#include <cstring>
+
+static thread_local SimContext* bound_context = nullptr;
+
+void InputState::clear()
+{
+	memset(keys, 0, sizeof(keys));
+}
+
+void SimClock::advance(float step_ms)
+{
+	tick++;
+	elapsed_ms += step_ms;
+}
+
+void SimContext::seed(uint64_t seed)
+{
+	rng = Rng(seed);
+	particle_rng = rng.split();
+}
+
+SimContext& SimContext::current()
+{
+	assert(bound_context && "No SimContext bound to this thread");
+	return *bound_context;
+}
+
+SimContext* SimContext::bound()
+{
+	return bound_context;
+}
+
+SimContext::Bind::Bind(SimContext& context) : previous(bound_context)
+{
+	bound_context = &context;
+}
+
+SimContext::Bind::Bind(SimContext* context) : previous(bound_context)
+{
+	if (context)
+		bound_context = context;
+}
+
+SimContext::Bind::~Bind()
+{
+	bound_context = previous;
+}
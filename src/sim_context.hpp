@@ -0,0 +1,114 @@
+#pragma once
+
+// internal
+#include "nav_table.hpp"
+#include "organ_navmesh.hpp"
+#include "random.hpp"
+#include "tiny_ecs_registry.hpp"
+
+// stlib
+#include <cstdint>
+#include <memory>
+
+class RenderSystem;
+
+// Minigame 1 maze size in cells, every cell is MAZE_CELL_PX square on screen
+const int MAZE_ROWS = 9;
+const int MAZE_COLUMNS = 16;
+const int MAZE_CELL_PX = 100;
+
+// Keys held down, written by the window's key callback and read by the physics
+struct InputState {
+	bool keys[512] = {};
+
+	void clear();
+};
+
+// Game time of a simulation, advanced once per fixed step
+struct SimClock {
+	uint64_t tick = 0;
+	double elapsed_ms = 0.0;
+
+	void advance(float step_ms);
+};
+
+// Values the balancing sweeps vary, the defaults are what the game ships with
+struct SimTuning {
+	// ms between mole spawns in minigame 4, smaller spawns faster
+	float mole_update_rate = 1000.f;
+	// ms into minigame 2 before the hard mode obstacles start
+	float hard_mode_time = 5000.f;
+	// ms minigame 2 has to be survived for
+	float mg2_duration = 40000.f;
+	// BRICK_MAP_ARRAY index minigame 5 plays, -1 picks one at random
+	int brick_map = -1;
+};
+
+// Minigame progress shared by the world, the physics and the AI
+struct MinigameState {
+	// minigame 2 seconds since it started, drives the obstacles' wobble
+	float mg2_seconds = 0.f;
+	// minigame 2 ms since it started
+	float mg2_total_ms = 0.f;
+	// the minigame 2 obstacles take their collision meshes from it
+	RenderSystem* mg2_renderer = nullptr;
+	// minigame 3
+	bool on_platform = false;
+	int jump_count = 0;
+};
+
+// Everything one simulation reads and writes. The systems are handed theirs
+// when they're built. Free helpers like the entity factories use the context
+// bound to the calling thread, so several simulations can run side by side,
+// one per thread.
+//
+//     SimContext context;
+//     SimContext::Bind bind(context);
+//     WorldSystem world(context);
+struct SimContext {
+	ECSRegistry registry;
+	InputState input;
+	SimClock clock;
+
+	// GAME_STATES of the current screen
+	unsigned int game_state = 0;
+	// true while a tutorial is up, physics stops
+	bool pause_game_state = false;
+	// minigame 1 maze, 1 is a wall
+	int maze[MAZE_ROWS][MAZE_COLUMNS] = {};
+	// bumped whenever the maze is carved, paths planned on an older one are dropped
+	uint32_t maze_version = 0;
+	// every shortest way through the maze, rebuilt with it, optional: check built(maze_version)
+	NavTable maze_nav;
+	// walkable areas of the organ on screen, null on every other screen
+	std::shared_ptr<const NavMesh> organ_nav;
+	MinigameState minigames;
+	SimTuning tuning;
+
+	// Gameplay randomness, only touched by the thread stepping the simulation
+	Rng rng;
+	// Split from rng for the particle task, which can run next to other tasks
+	Rng particle_rng;
+
+	// Restarts both generators from seed, the same seed replays the same game
+	void seed(uint64_t seed);
+
+	// Context bound to this thread, asserts there is one
+	static SimContext& current();
+	static SimContext* bound();
+
+	// Binds a context to the calling thread until it goes out of scope
+	class Bind
+	{
+	public:
+		explicit Bind(SimContext& context);
+		// null binds nothing
+		explicit Bind(SimContext* context);
+		~Bind();
+		Bind(const Bind&) = delete;
+		Bind& operator=(const Bind&) = delete;
+
+	private:
+		SimContext* previous;
+	};
+};
@@ -0,0 +1,82 @@
+// internal
+#include "simulation.hpp"
+#include "profiler.hpp"
+
+void step_simulation(SimContext& ctx, WorldSystem& world, PhysicsSystem& physics, AISystem& ai)
+{
+	PROFILE_ZONE("step_simulation");
+	ctx.clock.advance(FRAME_TIME);
+	// Animations advance ahead of world.step like they did inside it, step reads
+	// the endingSceneFinished they set on the same tick
+	TaskGraph before_world;
+	before_world.add("previous positions", [&physics] { physics.storePreviousPositions(); })
+		.writes(ctx.registry.foregroundMotions);
+	world.scheduleTasks(before_world, FRAME_TIME);
+	before_world.run(job_system);
+	world.step(FRAME_TIME); // Step the whole world (so like game environment and screen)
+
+	// Independent work of every system, only ordered where read/write sets overlap
+	TaskGraph tasks;
+	ai.scheduleTasks(tasks);
+	physics.scheduleTasks(tasks, FRAME_TIME);
+	tasks.run(job_system);
+
+	ai.step(FRAME_TIME);
+	physics.step(FRAME_TIME); // Step the physics system (so move characters given inputs)
+	world.handle_collisions(); // After moving, check for collisions and process those
+}
+
+ReplayDriver::ReplayDriver(const InputRecording& recording, SimContext& ctx, WorldSystem& world, PhysicsSystem& physics, AISystem& ai)
+	: recording(recording), ctx(ctx), world(world), physics(physics), ai(ai)
+{
+}
+
+void ReplayDriver::restart(RenderSystem* renderer)
+{
+	ctx.clock = SimClock();
+	ctx.input.clear();
+	ctx.pause_game_state = false;
+	next_event = 0;
+
+	world.seed(recording.seed);
+	world.init(renderer);
+	if (recording.start_state != (int)ctx.game_state && recording.start_state >= 0 && recording.start_state < game_states_count) {
+		world.change_game_states((GAME_STATES)recording.start_state);
+	}
+}
+
+bool ReplayDriver::step()
+{
+	if (ctx.clock.tick >= recording.ticks)
+		return false;
+
+	// events were recorded between the steps, before the one that saw them
+	const std::vector<InputEvent>& events = recording.events;
+	while (next_event < events.size() && events[next_event].tick <= ctx.clock.tick) {
+		world.applyInput(events[next_event]);
+		next_event++;
+	}
+
+	step_simulation(ctx, world, physics, ai);
+	return true;
+}
+
+uint64_t ReplayDriver::checksum() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size) {
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	mix(&ctx.game_state, sizeof(ctx.game_state));
+	mix(&ctx.clock.tick, sizeof(ctx.clock.tick));
+	for (const foregroundMotion& motion : ctx.registry.foregroundMotions.components) {
+		float values[5] = { motion.position.x, motion.position.y, motion.velocity.x, motion.velocity.y, motion.angle };
+		mix(values, sizeof(values));
+	}
+	return hash;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// internal
+#include "ai_system.hpp"
+#include "input_recording.hpp"
+#include "physics_system.hpp"
+#include "render_system.hpp"
+#include "sim_context.hpp"
+#include "world_system.hpp"
+
+// The simulation always advances in steps of FRAME_TIME ms
+const float FRAME_CAP = 60.0f;
+const float FRAME_TIME = 1000.0f / FRAME_CAP;
+
+// One fixed step of the whole step pipeline
+void step_simulation(SimContext& ctx, WorldSystem& world, PhysicsSystem& physics, AISystem& ai);
+
+// Plays an InputRecording back through the fixed step loop as fast as it goes.
+// The same recording on the same build always ends in the same state, the
+// checksum makes that easy to compare.
+//
+//     ReplayDriver replay(recording, ctx, world, physics, ai);
+//     replay.restart(&renderer);
+//     while (replay.step()) {}
+class ReplayDriver
+{
+public:
+	ReplayDriver(const InputRecording& recording, SimContext& ctx, WorldSystem& world, PhysicsSystem& physics, AISystem& ai);
+
+	// Back to the first tick: reseeds, restarts the world and enters the recorded start state
+	void restart(RenderSystem* renderer);
+	// Feeds the input of the next tick and steps once, false once the recording is over
+	bool step();
+	uint32_t tick() const { return (uint32_t)ctx.clock.tick; }
+
+	// FNV-1a over the game state and every foreground entity's motion
+	uint64_t checksum() const;
+
+private:
+	const InputRecording& recording;
+	SimContext& ctx;
+	WorldSystem& world;
+	PhysicsSystem& physics;
+	AISystem& ai;
+	size_t next_event = 0;
+};
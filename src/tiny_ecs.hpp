@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include <set>
@@ -12,7 +13,7 @@
 class Entity
 {
 	unsigned int id;
-	static unsigned int id_count; // starts from 1, entit 0 is the default initialization
+	static std::atomic<unsigned int> id_count; // starts from 1, entit 0 is the default initialization. Shared by every simulation
 public:
 	Entity()
 	{
@@ -76,7 +77,8 @@ public:
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		// find rather than [] so tasks on other threads can look up components concurrently
+		return components[map_entity_componentID.find(e)->second];
 	}
 
 	// Check if entity has a component of type 'Component'
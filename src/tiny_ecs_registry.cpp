@@ -1,3 +0,0 @@
-#include "tiny_ecs_registry.hpp"
-
-ECSRegistry registry;
\ No newline at end of file
@@ -51,6 +51,7 @@ public:
 	ComponentContainer<BrainEndingChoiceNode> brainEndingChoiceNode;
 	ComponentContainer<PowerUp> powerUps;
 	ComponentContainer<Paddle> paddles;
+	ComponentContainer<Blackboard> blackboards;
 
 	ComponentContainer<FinishLine> finishLine;
 	// IMPORTANT:  When adding new components to the registry, be sure to also change GameState::save_overworld_state
@@ -101,6 +102,7 @@ public:
 		registry_list.push_back(&finishLine);
 		registry_list.push_back(&powerUps);
 		registry_list.push_back(&paddles);
+		registry_list.push_back(&blackboards);
 	}
 
 	void clear_all_components() {
@@ -128,5 +130,3 @@ public:
 	}
 
 };
-
-extern ECSRegistry registry;
@@ -1,4 +1,5 @@
 #include "title_physics.hpp"
+#include "profiler.hpp"
 
 // BACKGROUND ENTITIES
 // 0: background
@@ -17,6 +18,7 @@ const float TITLE_CONTROLS_Y_POS = window_height_px - 60;
 float arrow_pos = TITLE_ARROW_SELECT_START_Y_POS;
 
 void TitlePhysics::step(float elapsed_ms) {
+	PROFILE_ZONE("TitlePhysics::step");
 	float step_seconds = elapsed_ms / 1000.f;
 	if (panUp) {
 		screenMoves_panUpwards(step_seconds);
@@ -26,21 +28,21 @@ void TitlePhysics::step(float elapsed_ms) {
 		screenMoves_panDown(step_seconds);
 	}
 
-	if (registry.title.components[0].titleInPlace) {
+	if (ctx.registry.title.components[0].titleInPlace) {
 		selectionKeyHandler();
-		registry.backgroundMotions.get(registry.background.entities[1]).position.y = SPLASH_ART_Y_POS;
-		registry.backgroundMotions.get(registry.background.entities[2]).position.y = arrow_pos;
-		registry.backgroundMotions.get(registry.background.entities[3]).position.y = TITLE_OPTIONS_Y_POS;
-		registry.backgroundMotions.get(registry.background.entities[4]).position.y = TITLE_CONTROLS_Y_POS;
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[1]).position.y = SPLASH_ART_Y_POS;
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[2]).position.y = arrow_pos;
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[3]).position.y = TITLE_OPTIONS_Y_POS;
+		ctx.registry.backgroundMotions.get(ctx.registry.background.entities[4]).position.y = TITLE_CONTROLS_Y_POS;
 	}
 }
 
 
 void TitlePhysics::screenMoves_panUpwards(float step_seconds) {
-	std::vector<Entity>& backgroundRenderEntities = registry.backgroundRenderRequests.entities;
-	Entity& backgroundEntity = registry.background.entities[0]; // 0th element is big background
-	if (registry.backgroundMotions.get(backgroundEntity).position.y <= window_height_px+1200) {
-		registry.backgroundMotions.get(backgroundEntity).position.y += step_seconds * 75.f;
+	std::vector<Entity>& backgroundRenderEntities = ctx.registry.backgroundRenderRequests.entities;
+	Entity& backgroundEntity = ctx.registry.background.entities[0]; // 0th element is big background
+	if (ctx.registry.backgroundMotions.get(backgroundEntity).position.y <= window_height_px+1200) {
+		ctx.registry.backgroundMotions.get(backgroundEntity).position.y += step_seconds * 75.f;
 	}
 	else {
 		panUp = false;
@@ -48,10 +50,10 @@ void TitlePhysics::screenMoves_panUpwards(float step_seconds) {
 }
 
 void TitlePhysics::screenMoves_panDown(float step_seconds) {
-	std::vector<Entity>& backgroundRenderEntities = registry.backgroundRenderRequests.entities;
-	Entity& backgroundEntity = registry.background.entities[0]; // 0th element is big background
-	if (registry.backgroundMotions.get(backgroundEntity).position.y >= -850) { 
-		registry.backgroundMotions.get(backgroundEntity).position.y -= step_seconds * 75.f;
+	std::vector<Entity>& backgroundRenderEntities = ctx.registry.backgroundRenderRequests.entities;
+	Entity& backgroundEntity = ctx.registry.background.entities[0]; // 0th element is big background
+	if (ctx.registry.backgroundMotions.get(backgroundEntity).position.y >= -850) { 
+		ctx.registry.backgroundMotions.get(backgroundEntity).position.y -= step_seconds * 75.f;
 	}
 	else {
 		panUp = true;
@@ -60,22 +62,22 @@ void TitlePhysics::screenMoves_panDown(float step_seconds) {
 }
 
 void TitlePhysics::title_pans_down(float step_seconds) {
-	std::vector<Entity>& backgroundRenderEntities = registry.backgroundRenderRequests.entities;
-	Entity& titleEntity = registry.background.entities[1]; // one'th element is the title
-	if (registry.backgroundMotions.get(titleEntity).position.y <= SPLASH_ART_Y_POS) {
-		registry.backgroundMotions.get(titleEntity).position.y += step_seconds * 200.f;
+	std::vector<Entity>& backgroundRenderEntities = ctx.registry.backgroundRenderRequests.entities;
+	Entity& titleEntity = ctx.registry.background.entities[1]; // one'th element is the title
+	if (ctx.registry.backgroundMotions.get(titleEntity).position.y <= SPLASH_ART_Y_POS) {
+		ctx.registry.backgroundMotions.get(titleEntity).position.y += step_seconds * 200.f;
 
 	}
 	else {
-		registry.title.components[0].titleInPlace = true;
+		ctx.registry.title.components[0].titleInPlace = true;
 	}
 }
 
 void TitlePhysics::selectionKeyHandler() {
-	if (registry.title.components[0].selectionOption == 0) {
+	if (ctx.registry.title.components[0].selectionOption == 0) {
 		arrow_pos = TITLE_ARROW_SELECT_START_Y_POS;
 	}
-	else if (registry.title.components[0].selectionOption == 1) {
+	else if (ctx.registry.title.components[0].selectionOption == 1) {
 		arrow_pos = TITLE_ARROW_SELECT_LOAD_Y_POS;
 	}
 	else {
@@ -8,7 +8,7 @@ class TitlePhysics : public CommonPhysics {
 public:
 
 	void step(float elapsed_ms);
-	TitlePhysics() {}
+	TitlePhysics(SimContext& ctx) : CommonPhysics(ctx) {}
 
 private:
 	bool panUp = true;
@@ -1,20 +1,22 @@
 #include "world_init.hpp"
 #include "tiny_ecs_registry.hpp"
+#include "sim_context.hpp"
 #include <random>
 
 Entity createBackground(RenderSystem* renderer, enum TEXTURE_ASSET_ID assetID, vec2 pos, vec2 scale)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	// Initialize the motion
-	auto& staticObject = registry.backgroundMotions.emplace(entity);
+	auto& staticObject = ctx.registry.backgroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.scale = scale;
 
-	registry.background.emplace(entity);
+	ctx.registry.background.emplace(entity);
 
 	// Calls render request to be rendered later
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ assetID,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -26,12 +28,13 @@ Entity createBackground(RenderSystem* renderer, enum TEXTURE_ASSET_ID assetID, v
 
 Entity createPlayer(RenderSystem* renderer, vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
 	// Setting initial motion values
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.angle = 0.f;
 	motion.velocity = { 0.f, 0.f };
@@ -39,9 +42,9 @@ Entity createPlayer(RenderSystem* renderer, vec2 pos)
 	motion.scale.y *= -1; // point front to the right
 	motion.accel = { 0, 0 };
 
-	registry.players.emplace(entity);
-	registry.collidables.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.players.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::GEN,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -52,19 +55,20 @@ Entity createPlayer(RenderSystem* renderer, vec2 pos)
 
 Entity createEvilVirus(RenderSystem* renderer, vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
 	// Setting initial motion values
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = mesh.original_size * 100.f;
 	motion.scale.y *= -1; // point front to the right
 	motion.accel = { 0, 0 };
 
-	registry.deadlys.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.deadlys.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::EVIL_VIRUS,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -75,23 +79,24 @@ Entity createEvilVirus(RenderSystem* renderer, vec2 pos)
 
 Entity createRedBloodCell(vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	//Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale *= -12; // point to the left and upright
 	motion.accel = { 0, 0 };
 
-	registry.deadlys.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.deadlys.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::RBC_SHEET,
 			EFFECT_ASSET_ID::ANIMATION,
 			GEOMETRY_BUFFER_ID::SPRITE });
 
-	Animation& animation = registry.animation.emplace(entity);
+	Animation& animation = ctx.registry.animation.emplace(entity);
 	animation.elapsed_ms = 75.f;
 	animation.columns = 7;
 	animation.rows = 1;
@@ -102,18 +107,19 @@ Entity createRedBloodCell(vec2 pos)
 
 Entity createMinigameNode(RenderSystem* renderer, vec2 pos, enum GAME_STATES minigame)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& staticObject = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& staticObject = ctx.registry.backgroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.angle = 0.f;
 	staticObject.scale *= vec2(8, - 7); // point front to the right
 
-	registry.gameNodes.emplace(entity);
-	registry.gameNodes.get(entity).minigame = (unsigned int)minigame;
-	registry.collidables.emplace(entity);
+	ctx.registry.gameNodes.emplace(entity);
+	ctx.registry.gameNodes.get(entity).minigame = (unsigned int)minigame;
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::GAME_NODE,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -124,18 +130,19 @@ Entity createMinigameNode(RenderSystem* renderer, vec2 pos, enum GAME_STATES min
 
 Entity createTransportNode(vec2 pos, enum GAME_STATES nextGameState)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& staticObject = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& staticObject = ctx.registry.backgroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.angle = 0.f;
 	staticObject.scale *= vec2{10, -10}; // point front to the right
 
-	registry.transportNodes.emplace(entity);
-	registry.transportNodes.get(entity).nextOrgan = (unsigned int)nextGameState;
-	registry.collidables.emplace(entity);
+	ctx.registry.transportNodes.emplace(entity);
+	ctx.registry.transportNodes.get(entity).nextOrgan = (unsigned int)nextGameState;
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::TRANSPORT_NODE,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -145,17 +152,18 @@ Entity createTransportNode(vec2 pos, enum GAME_STATES nextGameState)
 }
 
 Entity createBrainItemCheckNode(vec2 pos) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& staticObject = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& staticObject = ctx.registry.backgroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.angle = 0.f;
 	staticObject.scale *= vec2{ 10, -10 }; // point front to the right
 
-	registry.brainItemCheckNode.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.brainItemCheckNode.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::GAME_NODE, // Just for the visuals
 			EFFECT_ASSET_ID::TEXTURED,
@@ -165,17 +173,18 @@ Entity createBrainItemCheckNode(vec2 pos) {
 }
 
 Entity createBrainEndingChoiceNode(vec2 pos) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& staticObject = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& staticObject = ctx.registry.backgroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.angle = 0.f;
 	staticObject.scale *= vec2{ 10, -10 }; // point front to the right
 
-	registry.brainEndingChoiceNode.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.brainEndingChoiceNode.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::GAME_NODE, // Just for the visuals
 			EFFECT_ASSET_ID::TEXTURED,
@@ -186,11 +195,12 @@ Entity createBrainEndingChoiceNode(vec2 pos) {
 
 Entity createGenericSpaceBarTextBox(RenderSystem* renderer, enum TEXTURE_ASSET_ID assetID, vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
-	overlayMotions& overlayMotions = registry.overlayMotions.emplace(entity);
+	overlayMotions& overlayMotions = ctx.registry.overlayMotions.emplace(entity);
 	overlayMotions.position = pos;
 	overlayMotions.angle = 0.f;
 	
@@ -202,36 +212,38 @@ Entity createGenericSpaceBarTextBox(RenderSystem* renderer, enum TEXTURE_ASSET_I
 
 Entity createItem_ATP(RenderSystem* renderer, vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	//motion.velocity = { 100.0f, 0.0f };
 	motion.velocity = { -1.0f, 0.0f };
 	motion.scale = mesh.original_size * 50.f;
 	motion.scale.y *= -1; // point front to the right
 
-	registry.consumables.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.consumables.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
 	return entity;
 }
 
 Entity createItem_Lipid(RenderSystem* renderer, vec2 pos, float x_scale_multiplier) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale *= 5.f;
 	motion.scale.x *= x_scale_multiplier;
 	motion.scale.y *= -1;
 
-	registry.consumables.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.consumables.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::ITEM_LIPID,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -241,20 +253,21 @@ Entity createItem_Lipid(RenderSystem* renderer, vec2 pos, float x_scale_multipli
 }
 
 Entity createArrow(RenderSystem* renderer, vec2 pos, Entity& node) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
 
-	backgroundMotions& motion = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& motion = ctx.registry.backgroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.velocity = { 0.0f, -100.0f };
 	motion.scale = mesh.original_size * 50.f;
 	motion.scale.y *= -1; // point front to the right
 
-	registry.arrows.emplace(entity);
-	registry.arrows.get(entity).associatedNode = node;
+	ctx.registry.arrows.emplace(entity);
+	ctx.registry.arrows.get(entity).associatedNode = node;
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::ARROW,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -266,20 +279,21 @@ Entity createArrow(RenderSystem* renderer, vec2 pos, Entity& node) {
 
 Entity createMG2MeshObject(RenderSystem* renderer, vec2 pos, vec2 scale, int index, float random)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 	int mesh_index = (int)GEOMETRY_BUFFER_ID::MESH1 + index;
 
 	// Store a reference to the potentially re-used mesh object
 	Mesh& mesh = renderer->getMesh((GEOMETRY_BUFFER_ID)mesh_index);
-	registry.meshPtrs.emplace(entity, &mesh);
+	ctx.registry.meshPtrs.emplace(entity, &mesh);
 	mesh.index = index;
 
 	// gives each mesh some random value to carry forward
-	Random& r = registry.random.emplace(entity);
+	Random& r = ctx.registry.random.emplace(entity);
 	r.random = random;
 
 	// Setting initial motion values
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.angle = 0.f;
 	motion.velocity = { 0.f, 0.f };
@@ -287,8 +301,8 @@ Entity createMG2MeshObject(RenderSystem* renderer, vec2 pos, vec2 scale, int ind
 	motion.scale.y = mesh.original_size.y * scale.y;
 	motion.scale.y *= -1; // point front to the right
 
-	registry.deadlys.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.deadlys.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::TEXTURE_COUNT, // TEXTURE_COUNT indicates that no txture is needed
 			EFFECT_ASSET_ID::MESH,
@@ -298,13 +312,14 @@ Entity createMG2MeshObject(RenderSystem* renderer, vec2 pos, vec2 scale, int ind
 }
 
 Entity createMG2ProgressBar(vec2 pos, vec2 scale) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	overlayMotions& motion = registry.overlayMotions.emplace(entity);
+	overlayMotions& motion = ctx.registry.overlayMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = scale;
 
-	registry.overlayRenderRequests.insert(
+	ctx.registry.overlayRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::PROGRESS_BAR,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -313,15 +328,16 @@ Entity createMG2ProgressBar(vec2 pos, vec2 scale) {
 }
 
 Entity createMG2Progress(vec2 pos, vec2 scale) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	overlayMotions& motion = registry.overlayMotions.emplace(entity);
+	overlayMotions& motion = ctx.registry.overlayMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = scale;
 
-	registry.bar.emplace(entity);
+	ctx.registry.bar.emplace(entity);
 
-	registry.overlayRenderRequests.insert(
+	ctx.registry.overlayRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::GREEN_BOX,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -330,15 +346,16 @@ Entity createMG2Progress(vec2 pos, vec2 scale) {
 }
 
 Entity createTutorial(vec2 pos, TEXTURE_ASSET_ID assetId) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	overlayMotions& overlayMotions = registry.overlayMotions.emplace(entity);
+	overlayMotions& overlayMotions = ctx.registry.overlayMotions.emplace(entity);
 	overlayMotions.position = pos;
 	overlayMotions.angle = 0.f;
 	overlayMotions.scale = { 1000, 400 };
 	overlayMotions.scale.y *= -1; // point front to the right
 
-	registry.overlayRenderRequests.insert(
+	ctx.registry.overlayRenderRequests.insert(
 		entity,
 		{
 			assetId,
@@ -353,15 +370,16 @@ Entity createTutorial(vec2 pos, TEXTURE_ASSET_ID assetId) {
 }
 
 Entity createWall(RenderSystem* renderer, vec2 pos, vec2 scale) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& motion = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& motion = ctx.registry.backgroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = scale;
 
-	registry.walls.emplace(entity);
+	ctx.registry.walls.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::WALL,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -371,17 +389,18 @@ Entity createWall(RenderSystem* renderer, vec2 pos, vec2 scale) {
 
 Entity createPlatform(vec2 pos, vec2 scale, float y_velocity)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity_one = Entity();
 
-	foregroundMotion& motion_one = registry.foregroundMotions.emplace(entity_one);
+	foregroundMotion& motion_one = ctx.registry.foregroundMotions.emplace(entity_one);
 	motion_one.position = pos;
 	motion_one.scale = scale;
 	motion_one.velocity.y = y_velocity;
 
-	registry.platform.emplace(entity_one);
-	registry.collidables.emplace(entity_one);
+	ctx.registry.platform.emplace(entity_one);
+	ctx.registry.collidables.emplace(entity_one);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity_one,
 		{ TEXTURE_ASSET_ID::MG3_PLATFORM,
 			EFFECT_ASSET_ID::TEXTURED,
@@ -392,15 +411,16 @@ Entity createPlatform(vec2 pos, vec2 scale, float y_velocity)
 
 Entity createAnimation(vec2 pos, TEXTURE_ASSET_ID sprite_sheet, int total_frames, vec2 scale)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	overlayMotions& overlayMotions = registry.overlayMotions.emplace(entity);
+	overlayMotions& overlayMotions = ctx.registry.overlayMotions.emplace(entity);
 	overlayMotions.position = pos;
 	overlayMotions.angle = 0.f;
 	overlayMotions.scale = scale;
 	overlayMotions.scale.y *= -1; // point front to the right
 
-	registry.overlayRenderRequests.insert(
+	ctx.registry.overlayRenderRequests.insert(
 		entity,
 		{
 			sprite_sheet,
@@ -409,7 +429,7 @@ Entity createAnimation(vec2 pos, TEXTURE_ASSET_ID sprite_sheet, int total_frames
 		}
 	);
 
-	Animation& animation = registry.animation.emplace(entity);
+	Animation& animation = ctx.registry.animation.emplace(entity);
 	animation.total_frames = total_frames;
 	animation.columns = total_frames;
 	animation.rows = 1;
@@ -420,15 +440,16 @@ Entity createAnimation(vec2 pos, TEXTURE_ASSET_ID sprite_sheet, int total_frames
 
 Entity createFinalCutSceneAnimation(TEXTURE_ASSET_ID sprite_sheet, int total_x_frames, int total_y_frames, int total_frames)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	overlayMotions& overlayMotions = registry.overlayMotions.emplace(entity);
+	overlayMotions& overlayMotions = ctx.registry.overlayMotions.emplace(entity);
 	overlayMotions.position = vec2(window_width_px / 2, window_height_px / 2);
 	overlayMotions.angle = 0.f;
 	overlayMotions.scale = { 1600, 900 };
 	overlayMotions.scale.y *= -1; // point front to the right
 
-	registry.overlayRenderRequests.insert(
+	ctx.registry.overlayRenderRequests.insert(
 		entity,
 		{
 			sprite_sheet,
@@ -437,7 +458,7 @@ Entity createFinalCutSceneAnimation(TEXTURE_ASSET_ID sprite_sheet, int total_x_f
 		}
 	);
 
-	Animation& animation = registry.animation.emplace(entity);
+	Animation& animation = ctx.registry.animation.emplace(entity);
 	animation.total_frames = total_frames;
 	animation.columns = total_x_frames;
 	animation.rows = total_y_frames;
@@ -446,31 +467,33 @@ Entity createFinalCutSceneAnimation(TEXTURE_ASSET_ID sprite_sheet, int total_x_f
 }
 
 Entity createText(const std::string& str, const glm::vec2& pos, float scale, const glm::vec3& color) {
+	SimContext& ctx = SimContext::current();
 	Entity entity = Entity();
 
-	Text& text = registry.texts.emplace(entity);
+	Text& text = ctx.registry.texts.emplace(entity);
 	text.str = str;
 	text.pos = pos;
 	text.scale = scale;
 	text.color = color;
 	text.trans = mat4(1.0f);
 
-	registry.textRenderRequests.emplace(entity);
+	ctx.registry.textRenderRequests.emplace(entity);
 
 	return entity;
 }
 
 Entity createFpsText() {
+	SimContext& ctx = SimContext::current();
 	Entity entity = Entity();
 
-	Text& text = registry.texts.emplace(entity);
+	Text& text = ctx.registry.texts.emplace(entity);
 	text.str = "";
 	text.pos = vec2(0.0f, 0.0f);
 	text.scale = 1.0f;
 	text.color = vec3(1.0f, 1.0f, 1.0f);
 	text.trans = mat4(1.0f);
 
-	registry.textRenderRequests.emplace(entity);
+	ctx.registry.textRenderRequests.emplace(entity);
 
 	return entity;
 }
@@ -479,17 +502,18 @@ Entity createFpsText() {
 
 Entity createWhackAMole(RenderSystem* renderer, vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	// Setting initial motion values
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = { 100, -100 }; // point front to the right
 	motion.accel = { 0, 0 };
 
-	registry.whackAMole.emplace(entity);
-	registry.whackAMole.get(entity).origin = pos;
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.whackAMole.emplace(entity);
+	ctx.registry.whackAMole.get(entity).origin = pos;
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::EVIL_VIRUS,
 			EFFECT_ASSET_ID::MOLE,
@@ -500,15 +524,16 @@ Entity createWhackAMole(RenderSystem* renderer, vec2 pos)
 
 Entity createMg4BackgroundOverlay(RenderSystem* renderer, enum TEXTURE_ASSET_ID assetID, vec2 pos, vec2 scale)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
 	// Initialize the motion
-	auto& staticObject = registry.foregroundMotions.emplace(entity);
+	auto& staticObject = ctx.registry.foregroundMotions.emplace(entity);
 	staticObject.position = pos;
 	staticObject.scale = scale;
 
 	// Calls render request to be rendered later
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ assetID,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -518,20 +543,21 @@ Entity createMg4BackgroundOverlay(RenderSystem* renderer, enum TEXTURE_ASSET_ID
 }
 
 void createIron() {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.scale = vec2(50.f, -50.f);
 	
-	BezierCurve& bezier = registry.beziers.insert(
+	BezierCurve& bezier = ctx.registry.beziers.insert(
 		entity,
 		{ 0.0f, {} }
 	);
 
 	randomizeBezierPoints_MG4(bezier, motion);
 
-	registry.consumables.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.consumables.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::IRON,
@@ -543,12 +569,13 @@ void createIron() {
 
 InstanceRenderRequest createInstanceRender(RenderSystem* renderer, TEXTURE_ASSET_ID assetID, EFFECT_ASSET_ID effectID, GEOMETRY_BUFFER_ID geometryID, INSTANCING_BUFFER_ID instancingID, Entity entity, std::vector<vec2> translations)
 {
-	registry.backgroundRenderRequests.insert(
+	SimContext& ctx = SimContext::current();
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ assetID, effectID, geometryID }
 	);
 
-	InstanceRenderRequest& instance = registry.instanceRenderRequests.emplace(entity);
+	InstanceRenderRequest& instance = ctx.registry.instanceRenderRequests.emplace(entity);
 	instance.translations = translations;
 	instance.instances = translations.size();
 	instance.used_instancing = instancingID;
@@ -558,23 +585,24 @@ InstanceRenderRequest createInstanceRender(RenderSystem* renderer, TEXTURE_ASSET
 
 Entity createAcid(vec2 pos)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale.x *= -180;
 	motion.scale.y *= -10;
 	motion.accel = { 0, 0 };
 
-	registry.deadlys.emplace(entity);
-	registry.collidables.emplace(entity);
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.deadlys.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{ TEXTURE_ASSET_ID::MG3_ACID_SHEET,
 			EFFECT_ASSET_ID::ANIMATION,
 			GEOMETRY_BUFFER_ID::SPRITE });
 
-	Animation& animation = registry.animation.emplace(entity);
+	Animation& animation = ctx.registry.animation.emplace(entity);
 	animation.elapsed_ms = 75.0f;
 	animation.total_frames = 4;
 	animation.columns = 4;
@@ -584,18 +612,19 @@ Entity createAcid(vec2 pos)
 }
 
 Entity createBall(vec2 pos, vec2 velocity) {
+	SimContext& ctx = SimContext::current();
 	Entity entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.accel = vec2(0.0f, 0.0f);
 	motion.angle = 0.0f;
 	motion.position = pos;
 	motion.scale = vec2(50.0f, -50.0f);
 	motion.velocity = velocity;
 
-	registry.balls.emplace(entity);
+	ctx.registry.balls.emplace(entity);
 
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::GEN,
@@ -608,18 +637,19 @@ Entity createBall(vec2 pos, vec2 velocity) {
 }
 
 Entity createPaddle() {
+	SimContext& ctx = SimContext::current();
 	Entity entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.accel = vec2(0.0f, 0.0f);
 	motion.angle = 0.0f;
 	motion.position = vec2(window_width_px / 2, window_height_px - 50.0f);
 	motion.scale = vec2(150.0f, -25.0f);
 	motion.velocity = vec2(0.0f, 0.0f);
 
-	registry.paddles.emplace(entity); 
+	ctx.registry.paddles.emplace(entity); 
 
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::PADDLE,
@@ -632,15 +662,16 @@ Entity createPaddle() {
 }
 
 Entity createBrick(vec2 pos, vec2 scale, bool hasOxygen, PowerUpType powerUp) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	backgroundMotions& motion = registry.backgroundMotions.emplace(entity);
+	backgroundMotions& motion = ctx.registry.backgroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = vec2(scale.x, -scale.y);
 
-	registry.bricks.insert(entity, { hasOxygen , (unsigned int)powerUp });
+	ctx.registry.bricks.insert(entity, { hasOxygen , (unsigned int)powerUp });
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{ 
 			TEXTURE_ASSET_ID::BRICK,
@@ -653,25 +684,26 @@ Entity createBrick(vec2 pos, vec2 scale, bool hasOxygen, PowerUpType powerUp) {
 }
 
 Entity createOxygen(vec2 pos) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = vec2(50.f, -50.f);
 
-	registry.consumables.emplace(entity);
+	ctx.registry.consumables.emplace(entity);
 
-	vec2 p1 = vec2(rand() % window_width_px, rand() % (window_height_px / 3) + window_height_px / 2);
+	vec2 p1 = vec2(ctx.rng.below(window_width_px), ctx.rng.below(window_height_px / 3) + window_height_px / 2);
 	vec2 p2 = vec2(pos.x, window_height_px + abs(motion.scale.y));
 
 	std::vector<vec2> points = { pos, p1, p2 };
 	
-	registry.beziers.insert(
+	ctx.registry.beziers.insert(
 		entity,
 		{ 0.0f, points }
 	);
 
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::OXYGEN,
@@ -684,15 +716,16 @@ Entity createOxygen(vec2 pos) {
 }
 
 Entity createPowerUp(vec2 pos, PowerUpType powerUp) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.velocity = vec2(0.0f, 100.f);
 	motion.scale = vec2(50.f, -50.f);
 
-	registry.consumables.emplace(entity);
-	registry.powerUps.insert(entity, { (unsigned int)powerUp });
+	ctx.registry.consumables.emplace(entity);
+	ctx.registry.powerUps.insert(entity, { (unsigned int)powerUp });
 
 	TEXTURE_ASSET_ID texture;
 	if (powerUp == PowerUpType::MULTIPLY) {
@@ -701,7 +734,7 @@ Entity createPowerUp(vec2 pos, PowerUpType powerUp) {
 		texture = TEXTURE_ASSET_ID::LONGPADDLE;
 	}
 
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			texture,
@@ -715,18 +748,19 @@ Entity createPowerUp(vec2 pos, PowerUpType powerUp) {
 
 Entity createGlucose(vec2 pos, float y_velocity)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = vec2(50.f, -50.f);
 	motion.angle = 0;
 	motion.velocity.y = y_velocity;
 
-	registry.consumables.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.consumables.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::MG3_GLUCOSE,
@@ -740,18 +774,19 @@ Entity createGlucose(vec2 pos, float y_velocity)
 
 Entity createFinishLine(vec2 pos, float y_velocity)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = vec2(window_width_px, -75.f);
 	motion.angle = 0;
 	motion.velocity.y = y_velocity;
 
-	registry.finishLine.emplace(entity);
-	registry.collidables.emplace(entity);
+	ctx.registry.finishLine.emplace(entity);
+	ctx.registry.collidables.emplace(entity);
 
-	registry.backgroundRenderRequests.insert(
+	ctx.registry.backgroundRenderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::MG3_FINISH_LINE,
@@ -765,14 +800,15 @@ Entity createFinishLine(vec2 pos, float y_velocity)
 
 // Created for animations on the credit screen that only just need movements
 Entity createGenericTexture(vec2 pos, vec2 scale, enum TEXTURE_ASSET_ID texture) {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.scale = scale;
 
 
-	registry.foregroundRenderRequests.insert(
+	ctx.registry.foregroundRenderRequests.insert(
 		entity,
 		{
 			texture,
@@ -787,16 +823,17 @@ Entity createGenericTexture(vec2 pos, vec2 scale, enum TEXTURE_ASSET_ID texture)
 
 Entity createParticle(vec2 pos, vec3 color)
 {
+	SimContext& ctx = SimContext::current();
 	auto entity = Entity();
 
-	foregroundMotion& motion = registry.foregroundMotions.emplace(entity);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.emplace(entity);
 	motion.position = pos;
 	motion.velocity = { 0.0f, 100.0f }; // particle velocity dependent on minigame situation
 	motion.scale = { 5.0f, 5.0f };
 
-	Particle& particle = registry.particles.emplace(entity);
+	Particle& particle = ctx.registry.particles.emplace(entity);
 	particle.color = color;
-	registry.colors.emplace(entity, color);
+	ctx.registry.colors.emplace(entity, color);
 	particle.opacity = 1.0f;
 	particle.life = 0.5f;
 
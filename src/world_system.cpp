@@ -1,14 +1,17 @@
 // Header
 #include "world_system.hpp"
+#include "profiler.hpp"
 #include "world_init.hpp"
 #include "game_state.hpp"
 
 // stlib
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
 #include "physics_system.hpp"
 #include "mg2_ai.hpp"
+#include "maze_gen.hpp"
 #include "particle_system.hpp"
 
 
@@ -29,9 +32,7 @@ const vec2 NODE_POS_BRAIN_TO_5 = vec2(window_width_px / 2 - 400, window_height_p
 RollingFps fpsWindow(60);
 
 // Create the world
-WorldSystem::WorldSystem(): points(0){
-	// Seeding rng with random device
-	rng = std::default_random_engine(std::random_device()());
+WorldSystem::WorldSystem(SimContext& ctx): ctx(ctx), points(0){
 }
 
 WorldSystem::~WorldSystem() {
@@ -49,10 +50,11 @@ WorldSystem::~WorldSystem() {
 	Mix_CloseAudio();
 
 	// Destroy all created components
-	registry.clear_all_components();
+	ctx.registry.clear_all_components();
 
 	// Close the window
-	glfwDestroyWindow(window);
+	if (window != nullptr)
+		glfwDestroyWindow(window);
 }
 
 // Debugging
@@ -99,20 +101,44 @@ GLFWwindow* WorldSystem::create_window() {
 	glfwSetWindowUserPointer(window, this);
 	auto key_redirect = [](GLFWwindow* wnd, int _0, int _1, int _2, int _3) { ((WorldSystem*)glfwGetWindowUserPointer(wnd))->on_key(_0, _1, _2, _3); };
 	auto cursor_pos_redirect = [](GLFWwindow* wnd, double _0, double _1) { ((WorldSystem*)glfwGetWindowUserPointer(wnd))->on_mouse_move({ _0, _1 }); };
-	auto cursor_click_redirect = [](GLFWwindow* wnd, int _0, int _1, int _2) { ((WorldSystem*)glfwGetWindowUserPointer(wnd))->on_mouse_click(_0, _1, _2); };
+	auto cursor_click_redirect = [](GLFWwindow* wnd, int _0, int _1, int _2) {
+		double xpos, ypos;
+		glfwGetCursorPos(wnd, &xpos, &ypos);
+		((WorldSystem*)glfwGetWindowUserPointer(wnd))->on_mouse_click(_0, _1, _2, vec2(xpos, ypos));
+	};
 	glfwSetKeyCallback(window, key_redirect);
 	glfwSetCursorPosCallback(window, cursor_pos_redirect);
 	glfwSetMouseButtonCallback(window, cursor_click_redirect);
 
+	if (!init_audio())
+		return nullptr;
+
+	return window;
+}
+
+// Headless runs have no window and no input, the render system draws into an
+// offscreen context owned by main. Audio goes to SDL's dummy driver.
+bool WorldSystem::create_headless() {
+	window = nullptr;
+#ifdef _WIN32
+	_putenv_s("SDL_AUDIODRIVER", "dummy");
+#else
+	setenv("SDL_AUDIODRIVER", "dummy", 0);
+#endif
+	return init_audio();
+}
+
+bool WorldSystem::init_audio() {
+	PROFILE_ZONE("WorldSystem::init_audio");
 	//////////////////////////////////////
 	// Loading music and sounds with SDL
 	if (SDL_Init(SDL_INIT_AUDIO) < 0) {
 		fprintf(stderr, "Failed to initialize SDL Audio");
-		return nullptr;
+		return false;
 	}
 	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) == -1) {
 		fprintf(stderr, "Failed to open audio device");
-		return nullptr;
+		return false;
 	}
 
 	title_background_music = Mix_LoadMUS(audio_path("title_background_music.wav").c_str());
@@ -193,10 +219,10 @@ GLFWwindow* WorldSystem::create_window() {
 			audio_path("brain_help_background_music.wav").c_str(),
 			audio_path("brain_background_music.wav").c_str()
 		);
-		return nullptr;
+		return false;
 	}
 
-	return window;
+	return true;
 }
 
 void WorldSystem::init(RenderSystem* renderer_arg) {
@@ -205,65 +231,49 @@ void WorldSystem::init(RenderSystem* renderer_arg) {
 	restart_game();
 }
 
-// Update our game world - Focus on the environment and the game system like the window and screen
-bool WorldSystem::step(float elapsed_ms_since_last_update) {
-	// Updating window title with points
-	std::stringstream title_ss;
-	title_ss << "Path of Gen";
-
-	if (debugging.in_debug_mode) {
-		fpsWindow.update(elapsed_ms_since_last_update);
-		float fps = fpsWindow.calculate_fps();
-		title_ss << "   fps: " << std::round(fps);
-
-		if (counter >= 5) {
-			std::string fpsString = std::to_string((int)fps);
-			Text& text = registry.texts.get(fpsTextEntity);
-			text.str = "FPS: " + fpsString;
-			
-			counter = 0;
-		} else {
-			counter++;
-		}
-	} else {
-		Text& text = registry.texts.get(fpsTextEntity);
-		text.str = "";
-	}
-
-	glfwSetWindowTitle(window, title_ss.str().c_str());
+void WorldSystem::seed(uint32_t seed) {
+	ctx.seed(seed);
+	seedRandom(seed);
+}
 
-	// Remove debug info from the last step
-	while (registry.debugComponents.entities.size() > 0) {
-		registry.remove_all_components_of(registry.debugComponents.entities.back());
+void WorldSystem::applyInput(const InputEvent& event) {
+	switch (event.type) {
+	case INPUT_EVENT_TYPE::KEY:
+		on_key(event.code, 0, event.action, event.mods);
+		break;
+	case INPUT_EVENT_TYPE::MOUSE_CLICK:
+		on_mouse_click(event.code, event.action, event.mods, vec2(event.x, event.y));
+		break;
 	}
+}
 
-	// Processing the screen state
-  	assert(registry.screenStates.components.size() <= 1);
-	ScreenState &screen = registry.screenStates.components[0];
-
-	end_minigame_2(elapsed_ms_since_last_update);
-	minigame3_step(elapsed_ms_since_last_update);
-	minigame4_step(elapsed_ms_since_last_update);
-	end_minigame_4();
-	if (game_state == (unsigned int)GAME_STATES::MINIGAME_5 && pause_game_state == false) minigame5_step(elapsed_ms_since_last_update);
-
-	for (Entity entity : registry.savedGameTimer.entities) {
-		SavedGameTimer& counter = registry.savedGameTimer.get(entity);
-		counter.counter_ms -= elapsed_ms_since_last_update;
-		if (counter.counter_ms < 1) {
-			registry.remove_all_components_of(entity);
-		}
-	}
+// Mouse moves aren't recorded, clicks carry where the cursor was instead
+void WorldSystem::recordInput(INPUT_EVENT_TYPE type, int code, int action, int mods, vec2 cursor) {
+	if (recording == nullptr) return;
+	InputEvent event;
+	// the step that sees this event is the next one
+	event.tick = (uint32_t)ctx.clock.tick;
+	event.type = type;
+	event.code = code;
+	event.action = action;
+	event.mods = mods;
+	event.x = (int)cursor.x;
+	event.y = (int)cursor.y;
+	recording->add(event);
+}
 
-	for (Entity animation_entity: registry.animation.entities)
+// Steps every sprite sheet animation, run as a task ahead of step
+void WorldSystem::advanceAnimations(float elapsed_ms)
+{
+	for (Entity animation_entity: ctx.registry.animation.entities)
 	{
-		if (registry.overlayRenderRequests.has(animation_entity))
+		if (ctx.registry.overlayRenderRequests.has(animation_entity))
 		{
-			Animation& animation = registry.animation.get(animation_entity);
+			Animation& animation = ctx.registry.animation.get(animation_entity);
 
 			if (animation.current_frame < animation.total_frames - 1)
 			{
-				animation.elapsed_ms -= elapsed_ms_since_last_update;
+				animation.elapsed_ms -= elapsed_ms;
 				if (animation.elapsed_ms < 0 && animation.current_x_frame < animation.columns - 1)
 				{
 					animation.current_frame++;
@@ -285,11 +295,11 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 				endingSceneFinished = true;
 			}
 		} 
-		else if (registry.deadlys.has(animation_entity))
+		else if (ctx.registry.deadlys.has(animation_entity))
 		{
-			Animation& animation = registry.animation.get(animation_entity);
+			Animation& animation = ctx.registry.animation.get(animation_entity);
 
-			animation.elapsed_ms -= elapsed_ms_since_last_update;
+			animation.elapsed_ms -= elapsed_ms;
 			if (animation.elapsed_ms < 0 && animation.current_x_frame < animation.columns - 1)
 			{
 				animation.current_x_frame++;
@@ -302,16 +312,133 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 			}
 		}
 	}
+}
+
+void WorldSystem::scheduleTasks(TaskGraph& graph, float elapsed_ms)
+{
+	graph.add("animation", [this, elapsed_ms] { advanceAnimations(elapsed_ms); })
+		.reads(ctx.registry.overlayRenderRequests)
+		.reads(ctx.registry.deadlys)
+		.writes(ctx.registry.animation);
+}
+
+void WorldSystem::updateProfileText(bool visible)
+{
+	for (Entity entity : profileTextEntities) {
+		ctx.registry.remove_all_components_of(entity);
+	}
+	profileTextEntities.clear();
 
-	float &fadeOutTimer = registry.screenStates.get(renderer->screen_state_entity).fadeOutTimer;
+	if (!visible)
+		return;
+
+	const unsigned int MAX_LINES = 6;
+	std::vector<Profiler::ZoneStats> zones = profiler.summarize(1000.f);
+	for (unsigned int i = 0; i < zones.size() && i < MAX_LINES; i++) {
+		char line[128];
+		snprintf(line, sizeof(line), "%s  p50 %.2f ms  p99 %.2f ms  x%u", zones[i].name.c_str(), zones[i].p50_ms, zones[i].p99_ms, zones[i].count);
+		// stacked upwards from just above the FPS text
+		profileTextEntities.push_back(createText(line, vec2(0.f, 50.f + 24.f * i), 0.45f, vec3(1.f, 1.f, 0.6f)));
+	}
+
+	// the counters on one line above the zones
+	std::string counters;
+	for (const Profiler::Counter& counter : profiler.counters())
+		counters += counter.name + " " + std::to_string(counter.value) + "  ";
+	if (!counters.empty()) {
+		float y = 50.f + 24.f * std::min<size_t>(zones.size(), MAX_LINES);
+		profileTextEntities.push_back(createText(counters, vec2(0.f, y), 0.45f, vec3(0.6f, 1.f, 1.f)));
+	}
+}
+
+// Update our game world - Focus on the environment and the game system like the window and screen
+bool WorldSystem::step(float elapsed_ms_since_last_update) {
+	PROFILE_ZONE("WorldSystem::step");
+	// Updating window title with points
+	std::stringstream title_ss;
+	title_ss << "Path of Gen";
+
+	if (debugging.in_debug_mode) {
+		fpsWindow.update(elapsed_ms_since_last_update);
+		float fps = fpsWindow.calculate_fps();
+		title_ss << "   fps: " << std::round(fps);
+
+		if (counter >= 5) {
+			std::string fpsString = std::to_string((int)fps);
+			Text& text = ctx.registry.texts.get(fpsTextEntity);
+			text.str = "FPS: " + fpsString;
+			text.str += "  Drawn: " + std::to_string(renderer->drawn_count) + "  Culled: " + std::to_string(renderer->culled_count);
+			text.str += "  GL: " + std::to_string(gl_state.issuedLastFrame()) + " (" + std::to_string(gl_state.elidedLastFrame()) + " skipped)";
+			if (renderer->frame_overlap > 0.f) {
+				text.str += "  Overlap: " + std::to_string((int)(renderer->frame_overlap * 100)) + "%";
+			}
+			if (renderer->particle_pool.size() > 0) {
+				text.str += "  Particles: " + std::to_string(renderer->particle_pool.size());
+			}
+			
+			counter = 0;
+		} else {
+			counter++;
+		}
+
+		// summing up the zones is slower than the FPS text, twice a second is plenty
+		if (profile_counter >= 30) {
+			updateProfileText(true);
+			profile_counter = 0;
+		} else {
+			profile_counter++;
+		}
+	} else {
+		Text& text = ctx.registry.texts.get(fpsTextEntity);
+		text.str = "";
+		updateProfileText(false);
+	}
+
+	if (window != nullptr)
+		glfwSetWindowTitle(window, title_ss.str().c_str());
+
+	// Particle pool integrates on the next draw
+	renderer->particle_pool.step(elapsed_ms_since_last_update);
+
+	// Remove debug info from the last step
+	while (ctx.registry.debugComponents.entities.size() > 0) {
+		ctx.registry.remove_all_components_of(ctx.registry.debugComponents.entities.back());
+	}
+
+	// Processing the screen state
+  	assert(ctx.registry.screenStates.components.size() <= 1);
+	ScreenState &screen = ctx.registry.screenStates.components[0];
+
+	end_minigame_2(elapsed_ms_since_last_update);
+	minigame3_step(elapsed_ms_since_last_update);
+	minigame4_step(elapsed_ms_since_last_update);
+	end_minigame_4();
+	if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_5 && ctx.pause_game_state == false) minigame5_step(elapsed_ms_since_last_update);
+
+	for (Entity entity : ctx.registry.savedGameTimer.entities) {
+		SavedGameTimer& counter = ctx.registry.savedGameTimer.get(entity);
+		counter.counter_ms -= elapsed_ms_since_last_update;
+		if (counter.counter_ms < 1) {
+			ctx.registry.remove_all_components_of(entity);
+		}
+	}
+
+	// Screen shake wobbles around the centre and dies down over its duration
+	if (screen.shake_ms > 0) {
+		screen.shake_ms = std::max(0.f, screen.shake_ms - elapsed_ms_since_last_update);
+		float strength = SCREEN_SHAKE_STRENGTH * screen.shake_ms / SCREEN_SHAKE_MS;
+		screen.shake_offset = { strength * sin(screen.shake_ms * 0.09f), strength * cos(screen.shake_ms * 0.07f) };
+	}
+
+	float &fadeOutTimer = ctx.registry.screenStates.get(renderer->screen_state_entity).fadeOutTimer;
 
 	if (fadeOut) fadeOutTimer -= elapsed_ms_since_last_update;
 	screen.darken_screen_factor = 1 - fadeOutTimer / 1500;
 
-	if (fadeOut && game_state == (unsigned int)GAME_STATES::TITLE && registry.title.components[0].titleInPlace) {
+	if (fadeOut && ctx.game_state == (unsigned int)GAME_STATES::TITLE && ctx.registry.title.components[0].titleInPlace) {
 		if (fadeOutTimer <= 0) {
-			pause_game_state = false;
-			if (registry.title.components[0].selectionOption == (unsigned int)TITLE_OPTIONS_SELECTION::NEWGAME) {
+			ctx.pause_game_state = false;
+			if (ctx.registry.title.components[0].selectionOption == (unsigned int)TITLE_OPTIONS_SELECTION::NEWGAME) {
 				// New game inits
 				player_saved_pos = vec2(window_width_px - window_width_px / 3, window_height_px - 300);
 				mg1_inv_points = mg2_inv_points = mg3_inv_points = mg4_inv_points = mg5_inv_points = 0;
@@ -321,7 +448,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 				completedOrgan = (unsigned int)GAME_STATES::TITLE;
 				change_game_states(GAME_STATES::ORGAN_1);
 			}
-			else if (registry.title.components[0].selectionOption == (unsigned int)TITLE_OPTIONS_SELECTION::LOAD) {
+			else if (ctx.registry.title.components[0].selectionOption == (unsigned int)TITLE_OPTIONS_SELECTION::LOAD) {
 				load_game_saveFile();
 			}
 			else {
@@ -334,7 +461,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 
 	if (fadeOut && endingSceneFinished) {
 		if (fadeOutTimer <= 0) {
-			pause_game_state = false;
+			ctx.pause_game_state = false;
 			change_game_states(GAME_STATES::CREDITS);
 			inEndingScene = false;
 			endingSceneFinished = false;
@@ -343,13 +470,13 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 		}
 	}
 
-	if (fadeOut && game_state == (unsigned int)GAME_STATES::CREDITS) {
-		if (registry.credits.components[0].creditsFinished) {
+	if (fadeOut && ctx.game_state == (unsigned int)GAME_STATES::CREDITS) {
+		if (ctx.registry.credits.components[0].creditsFinished) {
 			if (fadeOutTimer <= 0) {
-				pause_game_state = false;
+				ctx.pause_game_state = false;
 				change_game_states(GAME_STATES::TITLE);
-				registry.credits.components[0].creditsFinished = false;
-				registry.credits.components[0].creditsStarted = false;
+				ctx.registry.credits.components[0].creditsFinished = false;
+				ctx.registry.credits.components[0].creditsStarted = false;
 				fadeOut = false;
 				fadeOutTimer = 1500;
 			}
@@ -357,56 +484,56 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 	}
 
 	if (fadeOut &&
-		game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		) {
 		if (fadeOutTimer <= 0) {
-			pause_game_state = false;
-			auto& collisionsRegistry = registry.collisions;
+			ctx.pause_game_state = false;
+			auto& collisionsRegistry = ctx.registry.collisions;
 			for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 				// The entity and its collider
 				Entity entity = collisionsRegistry.entities[i];
 				Entity entity_other = collisionsRegistry.components[i].other;
 
-				if (registry.gameNodes.has(entity_other)) {
-					if (registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_1) {
+				if (ctx.registry.gameNodes.has(entity_other)) {
+					if (ctx.registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_1) {
 						// Enters minigame 1
-						player_saved_pos = registry.foregroundMotions.get(player).position;
+						player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 						change_game_states(GAME_STATES::MINIGAME_1);
 					}
-					else if (registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_2) {
+					else if (ctx.registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_2) {
 						// Enters minigame 2
-						player_saved_pos = registry.foregroundMotions.get(player).position;
+						player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 						change_game_states(GAME_STATES::MINIGAME_2);
 					}
-					else if (registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_3) {
+					else if (ctx.registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_3) {
 						// Enters minigame 3
-						player_saved_pos = registry.foregroundMotions.get(player).position;
+						player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 						change_game_states(GAME_STATES::MINIGAME_3);
 					}
-					else if (registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_4)
+					else if (ctx.registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_4)
 					{
-						player_saved_pos = registry.foregroundMotions.get(player).position;
+						player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 						change_game_states(GAME_STATES::MINIGAME_4);
 					}
-					else if (registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_5) {
+					else if (ctx.registry.gameNodes.get(entity_other).minigame == (unsigned int)GAME_STATES::MINIGAME_5) {
 						// Enters minigame 5
-						player_saved_pos = registry.foregroundMotions.get(player).position;
+						player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 						change_game_states(GAME_STATES::MINIGAME_5);
 					}
-				} else if (registry.transportNodes.has(entity_other)) {
-					if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_1) {
+				} else if (ctx.registry.transportNodes.has(entity_other)) {
+					if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_1) {
 						if (currentOrgan == GAME_STATES::ORGAN_2) {
 							player_saved_pos = NODE_POS_1_TO_2;
 						}
 						change_game_states(GAME_STATES::ORGAN_1);
 					}
-					else if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_2) {
+					else if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_2) {
 						if (currentOrgan == GAME_STATES::ORGAN_1) {
 							player_saved_pos = NODE_POS_2_TO_1;
 						}
@@ -415,7 +542,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 						}
 						change_game_states(GAME_STATES::ORGAN_2);
 					}
-					else if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_3) {
+					else if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_3) {
 						if (currentOrgan == GAME_STATES::ORGAN_2) {
 							player_saved_pos = NODE_POS_3_TO_2;
 						}
@@ -424,7 +551,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 						}
 						change_game_states(GAME_STATES::ORGAN_3);
 					}
-					else if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_4) {
+					else if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_4) {
 						if (currentOrgan == GAME_STATES::ORGAN_3) {
 							player_saved_pos = NODE_POS_4_TO_3;
 						}
@@ -433,7 +560,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 						}
 						change_game_states(GAME_STATES::ORGAN_4);
 					}
-					else if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_5) {
+					else if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::ORGAN_5) {
 						if (currentOrgan == GAME_STATES::ORGAN_4) {
 							player_saved_pos = NODE_POS_5_TO_4;
 						}
@@ -442,15 +569,15 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 						}
 						change_game_states(GAME_STATES::ORGAN_5);
 					}
-					else if (registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-						registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::BRAIN_UNLOCKED) {
+					else if (ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+						ctx.registry.transportNodes.get(entity_other).nextOrgan == (unsigned int)GAME_STATES::BRAIN_UNLOCKED) {
 						if (currentOrgan == GAME_STATES::ORGAN_5) {
 							player_saved_pos = NODE_POS_BRAIN_TO_5;
 						}
 						change_game_states(GAME_STATES::BRAIN_LOCKED);
 					}
-				} else if (registry.brainEndingChoiceNode.has(entity_other)) {
-					BrainEndingChoiceNode endingNode = registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) ? registry.brainEndingChoiceNode.get(collisionsRegistry.entities[0]) : registry.brainEndingChoiceNode.get(collisionsRegistry.entities[1]);
+				} else if (ctx.registry.brainEndingChoiceNode.has(entity_other)) {
+					BrainEndingChoiceNode endingNode = ctx.registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) ? ctx.registry.brainEndingChoiceNode.get(collisionsRegistry.entities[0]) : ctx.registry.brainEndingChoiceNode.get(collisionsRegistry.entities[1]);
 					if (endingNode.killEnding) {
 						change_game_states(GAME_STATES::BRAIN_KILL);
 					}
@@ -467,27 +594,34 @@ bool WorldSystem::step(float elapsed_ms_since_last_update) {
 	return true;
 }
 
+// Nothing on a new screen blends in from where it was on the old one
+static void snapMotions(SimContext& ctx) {
+	for (foregroundMotion& motion : ctx.registry.foregroundMotions.components)
+		motion.has_previous = false;
+}
+
 // Reset the world state to its initial state
 void WorldSystem::restart_game() {
 	// Debugging for memory/component leaks
-	registry.list_all_components();
+	ctx.registry.list_all_components();
 	printf("Restarting\n");
 
 	// Reset the current game state
-	game_state = (unsigned int)GAME_STATES::TITLE;
+	ctx.game_state = (unsigned int)GAME_STATES::TITLE;
 	
 	// Remove all entities that we created
 	// All that have a motion
-	while (registry.foregroundMotions.entities.size() > 0) {
-		registry.remove_all_components_of(registry.foregroundMotions.entities.back());
+	while (ctx.registry.foregroundMotions.entities.size() > 0) {
+		ctx.registry.remove_all_components_of(ctx.registry.foregroundMotions.entities.back());
 		
 	}
 
 	// Debugging for memory/component leaks
-	registry.list_all_components();
+	ctx.registry.list_all_components();
 	game_state_system.initStatePersistence();
 	completedOrgan = (unsigned int) GAME_STATES::TITLE;
 	create_title();
+	snapMotions(ctx);
 }
 
 void WorldSystem::create_title() {
@@ -495,9 +629,9 @@ void WorldSystem::create_title() {
 	fpsTextEntity = createFpsText();
 
 	auto entity = Entity();
-	registry.title.emplace(entity);
+	ctx.registry.title.emplace(entity);
 
-	game_state = (unsigned int)GAME_STATES::TITLE;
+	ctx.game_state = (unsigned int)GAME_STATES::TITLE;
 
 	createBackground(renderer, TEXTURE_ASSET_ID::TITLE_BACKGROUND, { window_width_px / 2,  -window_height_px}, { window_width_px/2, -window_height_px*2-300});
 	createBackground(renderer, TEXTURE_ASSET_ID::TITLE_SPLASH, { window_width_px / 2,  -500 }, {300, -300 }); // Not technically a background but a good hack to make it work
@@ -510,8 +644,8 @@ void WorldSystem::create_credits() {
 	fpsTextEntity = createFpsText();
 	Mix_PlayMusic(credits_background_music, 0);
 	auto entity = Entity();
-	registry.credits.emplace(entity);
-	game_state = (unsigned int)GAME_STATES::CREDITS;
+	ctx.registry.credits.emplace(entity);
+	ctx.game_state = (unsigned int)GAME_STATES::CREDITS;
 	createBackground(renderer, TEXTURE_ASSET_ID::CREDITS_BG, { window_width_px / 2,  7500/2 }, { window_width_px/2, -7500/2});
 }
 
@@ -527,7 +661,7 @@ void WorldSystem::create_organ_1(vec2 startingPos) {
 	Mix_PlayMusic(organ1_background_music, -1);
 	fpsTextEntity = createFpsText();
 	currentOrgan = GAME_STATES::ORGAN_1;
-	game_state = (unsigned int)GAME_STATES::ORGAN_1;
+	ctx.game_state = (unsigned int)GAME_STATES::ORGAN_1;
 	createBackground(renderer, TEXTURE_ASSET_ID::ORGAN_1_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px/2 });
 
 	Entity node = createMinigameNode(renderer, vec2(window_width_px / 2, window_height_px / 2), GAME_STATES::MINIGAME_1);
@@ -537,10 +671,10 @@ void WorldSystem::create_organ_1(vec2 startingPos) {
 	if ((unsigned int)completedOrgan >= (unsigned int)currentOrgan) {
 		// Minigame has been beaten here
 		createTransportNode(NODE_POS_1_TO_2, GAME_STATES::ORGAN_2);
-		registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
+		ctx.registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
 	}
 	if (!tutorialChecklist[GAME_STATES::TITLE]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::OVERALL_TUTORIAL);
 		tutorialChecklist[GAME_STATES::TITLE] = true;
 	}
@@ -551,7 +685,7 @@ void WorldSystem::create_organ_2(vec2 startingPos) {
 	Mix_PlayMusic(organ2_background_music, -1);
 	fpsTextEntity = createFpsText();
 	currentOrgan = GAME_STATES::ORGAN_2;
-	game_state = (unsigned int)GAME_STATES::ORGAN_2;
+	ctx.game_state = (unsigned int)GAME_STATES::ORGAN_2;
 	createBackground(renderer, TEXTURE_ASSET_ID::ORGAN_2_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 	Entity node = createMinigameNode(renderer, vec2(window_width_px / 2, window_height_px / 2), GAME_STATES::MINIGAME_2);
 	player = createPlayer(renderer, startingPos);
@@ -561,7 +695,7 @@ void WorldSystem::create_organ_2(vec2 startingPos) {
 	if ((unsigned int)completedOrgan >= (unsigned int)currentOrgan) {
 		// Minigame has been beaten here
 		createTransportNode(NODE_POS_2_TO_3, GAME_STATES::ORGAN_3);
-		registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
+		ctx.registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
 	}
 	display_inventory();
 }
@@ -570,7 +704,7 @@ void WorldSystem::create_organ_3(vec2 startingPos) {
 	Mix_PlayMusic(organ3_background_music, -1);
 	fpsTextEntity = createFpsText();
 	currentOrgan = GAME_STATES::ORGAN_3;
-	game_state = (unsigned int)GAME_STATES::ORGAN_3;
+	ctx.game_state = (unsigned int)GAME_STATES::ORGAN_3;
 	createBackground(renderer, TEXTURE_ASSET_ID::ORGAN_3_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 	Entity node = createMinigameNode(renderer, vec2(window_width_px / 2 + 400, window_height_px / 2), GAME_STATES::MINIGAME_3);
 	player = createPlayer(renderer, startingPos);
@@ -579,7 +713,7 @@ void WorldSystem::create_organ_3(vec2 startingPos) {
 	if ((unsigned int)completedOrgan >= (unsigned int)currentOrgan) {
 		// Minigame has been beaten here
 		createTransportNode(NODE_POS_3_TO_4, GAME_STATES::ORGAN_4);
-		registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
+		ctx.registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
 	}
 	display_inventory();
 }
@@ -588,7 +722,7 @@ void WorldSystem::create_organ_4(vec2 startingPos) {
 	Mix_PlayMusic(organ4_background_music, -1);
 	fpsTextEntity = createFpsText();
 	currentOrgan = GAME_STATES::ORGAN_4;
-	game_state = (unsigned int)GAME_STATES::ORGAN_4;
+	ctx.game_state = (unsigned int)GAME_STATES::ORGAN_4;
 	createBackground(renderer, TEXTURE_ASSET_ID::ORGAN_4_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 	Entity node = createMinigameNode(renderer, vec2(window_width_px / 2 -300, window_height_px / 2 -300), GAME_STATES::MINIGAME_4);
 	player = createPlayer(renderer, startingPos);
@@ -597,7 +731,7 @@ void WorldSystem::create_organ_4(vec2 startingPos) {
 	if ((unsigned int)completedOrgan >= (unsigned int)currentOrgan) {
 		// Minigame has been beaten here
 		createTransportNode(NODE_POS_4_TO_5, GAME_STATES::ORGAN_5);
-		registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
+		ctx.registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
 	}
 	display_inventory();
 }
@@ -606,7 +740,7 @@ void WorldSystem::create_organ_5(vec2 startingPos) {
 	Mix_PlayMusic(organ5_background_music, -1);
 	fpsTextEntity = createFpsText();
 	currentOrgan = GAME_STATES::ORGAN_5;
-	game_state = (unsigned int)GAME_STATES::ORGAN_5;
+	ctx.game_state = (unsigned int)GAME_STATES::ORGAN_5;
 	createBackground(renderer, TEXTURE_ASSET_ID::ORGAN_5_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 	Entity node = createMinigameNode(renderer, vec2(window_width_px / 2 + 150, window_height_px / 2 - 100), GAME_STATES::MINIGAME_5);
 	player = createPlayer(renderer, startingPos);
@@ -615,7 +749,7 @@ void WorldSystem::create_organ_5(vec2 startingPos) {
 	if ((unsigned int)completedOrgan >= (unsigned int)currentOrgan) {
 		// Minigame has been beaten here
 		createTransportNode(NODE_POS_5_TO_BRAIN, GAME_STATES::BRAIN_LOCKED);
-		registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
+		ctx.registry.colors.insert(node, vec3(0.1f, 1.0f, 0.8f));
 	}
 	display_inventory();
 }
@@ -630,19 +764,19 @@ void WorldSystem::create_brain(vec2 startingPos) {
 	enoughItems = check_enough_items();
 	if (!brainGateUnlocked) {
 		currentOrgan = GAME_STATES::BRAIN_LOCKED;
-		game_state = (unsigned int)GAME_STATES::BRAIN_LOCKED;
+		ctx.game_state = (unsigned int)GAME_STATES::BRAIN_LOCKED;
 		createBackground(renderer, TEXTURE_ASSET_ID::BRAIN_LOCKED_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 		brainGateNode = createBrainItemCheckNode(vec2(window_width_px / 2+60, window_height_px / 2 + 160));
 	}
 	else {
 		currentOrgan = GAME_STATES::BRAIN_UNLOCKED;
-		game_state = (unsigned int)GAME_STATES::BRAIN_UNLOCKED;
+		ctx.game_state = (unsigned int)GAME_STATES::BRAIN_UNLOCKED;
 		createBackground(renderer, TEXTURE_ASSET_ID::BRAIN_UNLOCKED_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 	}
 	Entity killEnding = createBrainEndingChoiceNode(vec2(window_width_px / 2 - 130, window_height_px / 2 - 120));
-	registry.brainEndingChoiceNode.get(killEnding).killEnding = 1;
+	ctx.registry.brainEndingChoiceNode.get(killEnding).killEnding = 1;
 	Entity helpEnding = createBrainEndingChoiceNode(vec2(window_width_px / 2 + 220, window_height_px / 2 - 80));
-	registry.brainEndingChoiceNode.get(helpEnding).killEnding = 0;
+	ctx.registry.brainEndingChoiceNode.get(helpEnding).killEnding = 0;
 	createTransportNode(NODE_POS_BRAIN_TO_5, GAME_STATES::ORGAN_5);
 	display_inventory();
 }
@@ -693,29 +827,30 @@ bool WorldSystem::check_enough_items() {
 
 // Compute collisions between entities
 void WorldSystem::handle_collisions() {
+	PROFILE_ZONE("WorldSystem::handle_collisions");
 	// Loop over all collisions detected by the physics system
-	auto& collisionsRegistry = registry.collisions;
-
-	if (game_state == (unsigned int)GAME_STATES::ORGAN_1||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+	auto& collisionsRegistry = ctx.registry.collisions;
+
+	if (ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		)
 	{
 		// this only works because we should only have Gen/node collisons in the overworld FOR NOW
 		if (collisionsRegistry.components.size() == 0) {
 			// Not on any node
-			registry.overlayRenderRequests.remove(genericSpacebarTextBox);
-			registry.remove_all_components_of(genericTextBoxAccompanyingText);
+			ctx.registry.overlayRenderRequests.remove(genericSpacebarTextBox);
+			ctx.registry.remove_all_components_of(genericTextBoxAccompanyingText);
 			genericSpacebarTextBoxActive = false;
 		}
-		else if (registry.transportNodes.has(collisionsRegistry.entities[0]) || registry.transportNodes.has(collisionsRegistry.entities[1])) {
+		else if (ctx.registry.transportNodes.has(collisionsRegistry.entities[0]) || ctx.registry.transportNodes.has(collisionsRegistry.entities[1])) {
 			// On a transport node
 			if (!genericSpacebarTextBoxActive) {
-				registry.overlayRenderRequests.insert(
+				ctx.registry.overlayRenderRequests.insert(
 					genericSpacebarTextBox,
 					{ TEXTURE_ASSET_ID::TEXT_BOX,
 						EFFECT_ASSET_ID::TEXTURED,
@@ -724,11 +859,11 @@ void WorldSystem::handle_collisions() {
 
 				// Get the correct collision entity (the transport node)
 				TransportNode transportNode;
-				if (registry.transportNodes.has(collisionsRegistry.entities[0])) {
-					transportNode = registry.transportNodes.get(collisionsRegistry.entities[0]);
+				if (ctx.registry.transportNodes.has(collisionsRegistry.entities[0])) {
+					transportNode = ctx.registry.transportNodes.get(collisionsRegistry.entities[0]);
 				}
 				else {
-					transportNode = registry.transportNodes.get(collisionsRegistry.entities[1]);
+					transportNode = ctx.registry.transportNodes.get(collisionsRegistry.entities[1]);
 				}
 
 				// Depending on the organ, print the accompanying text
@@ -752,12 +887,12 @@ void WorldSystem::handle_collisions() {
 				}
 			}
 		}
-		else if (registry.brainItemCheckNode.has(collisionsRegistry.entities[0]) || registry.brainItemCheckNode.has(collisionsRegistry.entities[1])) {
+		else if (ctx.registry.brainItemCheckNode.has(collisionsRegistry.entities[0]) || ctx.registry.brainItemCheckNode.has(collisionsRegistry.entities[1])) {
 			// On brain check node
 			// Do check of items
 			if (!brainGateUnlocked) {
 				if (!genericSpacebarTextBoxActive) {
-					registry.overlayRenderRequests.insert(
+					ctx.registry.overlayRenderRequests.insert(
 						genericSpacebarTextBox,
 						{ TEXTURE_ASSET_ID::TEXT_BOX,
 							EFFECT_ASSET_ID::TEXTURED,
@@ -776,12 +911,12 @@ void WorldSystem::handle_collisions() {
 			}
 			// }
 		}
-		else if (registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) || registry.brainEndingChoiceNode.has(collisionsRegistry.entities[1])) {
+		else if (ctx.registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) || ctx.registry.brainEndingChoiceNode.has(collisionsRegistry.entities[1])) {
 			// On brain ending node
 			// Do check of items
-			BrainEndingChoiceNode endingNode = registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) ? registry.brainEndingChoiceNode.get(collisionsRegistry.entities[0]) : registry.brainEndingChoiceNode.get(collisionsRegistry.entities[1]);
+			BrainEndingChoiceNode endingNode = ctx.registry.brainEndingChoiceNode.has(collisionsRegistry.entities[0]) ? ctx.registry.brainEndingChoiceNode.get(collisionsRegistry.entities[0]) : ctx.registry.brainEndingChoiceNode.get(collisionsRegistry.entities[1]);
 			if (!genericSpacebarTextBoxActive) {
-				registry.overlayRenderRequests.insert(
+				ctx.registry.overlayRenderRequests.insert(
 					genericSpacebarTextBox,
 					{ TEXTURE_ASSET_ID::TEXT_BOX,
 						EFFECT_ASSET_ID::TEXTURED,
@@ -798,7 +933,7 @@ void WorldSystem::handle_collisions() {
 		else if (!genericSpacebarTextBoxActive) {
 			// On a minigame node
 			Mix_PlayChannel(-1, overworld_on_node_sound, 0);
-			registry.overlayRenderRequests.insert(
+			ctx.registry.overlayRenderRequests.insert(
 				genericSpacebarTextBox,
 					{ 	TEXTURE_ASSET_ID::TEXT_BOX,
 						EFFECT_ASSET_ID::TEXTURED,
@@ -808,7 +943,7 @@ void WorldSystem::handle_collisions() {
 		}
 
 	} 
-	else if (game_state == (unsigned int)GAME_STATES::MINIGAME_1)
+	else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_1)
 	{
 		for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 			// The entity and its collider
@@ -816,11 +951,11 @@ void WorldSystem::handle_collisions() {
 			Entity& entity_other = collisionsRegistry.components[i].other;
 
 			// Player is collecting items
-			if (entity == player_mg && registry.consumables.has(entity_other)) {
-				foregroundMotion& atp_motion = registry.foregroundMotions.get(entity_other);
+			if (entity == player_mg && ctx.registry.consumables.has(entity_other)) {
+				foregroundMotion& atp_motion = ctx.registry.foregroundMotions.get(entity_other);
 
 				// Get the InstanceRenderRequest for ATP and remove corresponding offset from translation vector 
-				InstanceRenderRequest& irr = registry.instanceRenderRequests.components[0];
+				InstanceRenderRequest& irr = ctx.registry.instanceRenderRequests.components[0];
 				vec2 offset = vec2((atp_motion.position.x - atpStart.x) / (CURRENT_SPRITE_OFFSET * window_width_px / MAP_BLOCK_SIZE), (atp_motion.position.y - atpStart.y) / (CURRENT_SPRITE_OFFSET * window_height_px / MAP_BLOCK_SIZE));
 				auto it = std::find(irr.translations.begin(), irr.translations.end(), offset);
 				if (it != irr.translations.end())
@@ -834,14 +969,14 @@ void WorldSystem::handle_collisions() {
 				}
 
 				// Remove atp from registry
-				if (!registry.instanceRenderRequests.has(entity_other))
-					registry.remove_all_components_of(entity_other);
+				if (!ctx.registry.instanceRenderRequests.has(entity_other))
+					ctx.registry.remove_all_components_of(entity_other);
 				else
-					registry.collidables.remove(entity_other);
+					ctx.registry.collidables.remove(entity_other);
 
 				// add points and play music 
 				++points;
-				Text& scoreText = registry.texts.get(mg1_score);
+				Text& scoreText = ctx.registry.texts.get(mg1_score);
 				scoreText.str = std::to_string(points);
 				if (points == 10) scoreText.pos.x -= 5;
 				Mix_PlayChannel(-1, mg1_pickup_atp_sound, 0);
@@ -850,7 +985,7 @@ void WorldSystem::handle_collisions() {
 				if (points == numberOfConsumables) {
 					mg1_inv_points += points;
 					points = 0;
-					std::vector<Entity> entities_to_remove = { entity, registry.deadlys.entities[0], registry.instanceRenderRequests.entities[0]};
+					std::vector<Entity> entities_to_remove = { entity, ctx.registry.deadlys.entities[0], ctx.registry.instanceRenderRequests.entities[0]};
 					minigame_win_lose_overlay(true, entities_to_remove, TEXTURE_ASSET_ID::MG1_WIN_SHEET, 12);
 					if ((unsigned int)completedOrgan < (unsigned int)GAME_STATES::ORGAN_1) {
 						completedOrgan = (unsigned int) GAME_STATES::ORGAN_1;
@@ -866,10 +1001,10 @@ void WorldSystem::handle_collisions() {
 			}
 
 			// Remove all collisions from this simulation step
-			registry.collisions.clear();
+			ctx.registry.collisions.clear();
 		}
 	}
-	else if (game_state == (unsigned int)GAME_STATES::MINIGAME_2)
+	else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_2)
 	{
 		for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 			// The entity and its collider
@@ -877,51 +1012,51 @@ void WorldSystem::handle_collisions() {
 			Entity& entity_other = collisionsRegistry.components[i].other;
 
 			// TODO: properly handle collisions between Gen and Worms 
-			if (entity == player_mg && registry.deadlys.has(entity_other)) {
+			if (entity == player_mg && ctx.registry.deadlys.has(entity_other)) {
 				points = 0;
-				mg2_duration = 40000.0f;
+				mg2_duration = ctx.tuning.mg2_duration;
 				std::vector<Entity> entities_to_remove = { player };
 				minigame_win_lose_overlay(false, entities_to_remove, TEXTURE_ASSET_ID::MG2_LOSE_SHEET, 12);
 			}
 
 			// Player is collecting items
-			if (entity == player_mg && registry.consumables.has(entity_other)) {
-				registry.remove_all_components_of(entity_other);
+			if (entity == player_mg && ctx.registry.consumables.has(entity_other)) {
+				ctx.registry.remove_all_components_of(entity_other);
 				++points;
 				++mg2_inv_points;
 				Mix_PlayChannel(-1, mg1_pickup_atp_sound, 0);
 			}
 
 			// Remove all collisions from this simulation step
-			registry.collisions.clear();
+			ctx.registry.collisions.clear();
 		}
 	}
-	else if (game_state == (unsigned int)GAME_STATES::MINIGAME_3)
+	else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_3)
 	{
 		for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 			// The entity and its collider
 			Entity& entity = collisionsRegistry.entities[i];
 			Entity& entity_other = collisionsRegistry.components[i].other;
 
-			if (entity == player_mg && registry.deadlys.has(entity_other))
+			if (entity == player_mg && ctx.registry.deadlys.has(entity_other))
 			{
 				points = 0;
 				std::vector<Entity> entities_to_remove = { entity };
 				num_of_glucose = 10;
 				minigame_win_lose_overlay(false, entities_to_remove, TEXTURE_ASSET_ID::MG3_LOSE_SHEET, 28);
 			}
-			else if ((registry.platform.has(entity) || registry.consumables.has(entity)) && registry.deadlys.has(entity_other))
+			else if ((ctx.registry.platform.has(entity) || ctx.registry.consumables.has(entity)) && ctx.registry.deadlys.has(entity_other))
 			{
-				registry.remove_all_components_of(entity);
+				ctx.registry.remove_all_components_of(entity);
 			}
-			else if (entity == player_mg && registry.consumables.has(entity_other))
+			else if (entity == player_mg && ctx.registry.consumables.has(entity_other))
 			{
-				registry.remove_all_components_of(entity_other);
+				ctx.registry.remove_all_components_of(entity_other);
 				points++;
 				mg3_inv_points++;
 				Mix_PlayChannel(-1, mg1_pickup_atp_sound, 0);
 			}
-			else if (entity == player_mg && registry.finishLine.has(entity_other))
+			else if (entity == player_mg && ctx.registry.finishLine.has(entity_other))
 			{
 				points = 0;
 				num_of_glucose = 10;
@@ -933,25 +1068,25 @@ void WorldSystem::handle_collisions() {
 			}
 
 			// Remove all collisions from this simulation step
-			registry.collisions.clear();
+			ctx.registry.collisions.clear();
 		}
 	}
-	else if (game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
-		for (Entity& collisionEntity : registry.collisions.entities) {
-			if (registry.consumables.has(collisionEntity) && registry.foregroundRenderRequests.has(collisionEntity)) {
-				registry.foregroundRenderRequests.remove(collisionEntity);
-				registry.collisions.remove(collisionEntity);
+	else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
+		for (Entity& collisionEntity : ctx.registry.collisions.entities) {
+			if (ctx.registry.consumables.has(collisionEntity) && ctx.registry.foregroundRenderRequests.has(collisionEntity)) {
+				ctx.registry.foregroundRenderRequests.remove(collisionEntity);
+				ctx.registry.collisions.remove(collisionEntity);
 				mg4_inv_points++;
 				Mix_PlayChannel(-1, mg1_pickup_atp_sound, 0);
 			}
 		}
 	}
-	else if (game_state == (unsigned int)GAME_STATES::MINIGAME_5) {
-		for (Entity& collisionEntity : registry.collisions.entities) {
+	else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_5) {
+		for (Entity& collisionEntity : ctx.registry.collisions.entities) {
 
-			if (registry.bricks.has(collisionEntity)) {
-				Brick& brick = registry.bricks.get(collisionEntity);
-				backgroundMotions& motion = registry.backgroundMotions.get(collisionEntity);
+			if (ctx.registry.bricks.has(collisionEntity)) {
+				Brick& brick = ctx.registry.bricks.get(collisionEntity);
+				backgroundMotions& motion = ctx.registry.backgroundMotions.get(collisionEntity);
 				if (brick.hasOxygen) {
 					createOxygen(motion.position);
 				}
@@ -961,25 +1096,23 @@ void WorldSystem::handle_collisions() {
 				numBricks--;
 
 				// Generate particles upon brick destruction
-				Entity first_particle = createParticle(motion.position, vec3(0.6549, 0.9490, 0.0000));
-				std::vector<vec2> particle_translations = generateParticles(motion.position, vec3(0.6549, 0.9490, 0.0000));
-				createInstanceRender(renderer, TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::TEXTURED, GEOMETRY_BUFFER_ID::SPRITE, INSTANCING_BUFFER_ID::PARTICLE, first_particle, particle_translations); 
+				renderer->particle_pool.emit(motion.position, vec3(0.6549, 0.9490, 0.0000), 64);
 		
-				Text& text = registry.texts.get(remainingBricksText);
+				Text& text = ctx.registry.texts.get(remainingBricksText);
 				std::string str = "Remaining Phlegm: " + std::to_string(numBricks);
 				text.str = str;
-				registry.remove_all_components_of(collisionEntity);
+				ctx.registry.remove_all_components_of(collisionEntity);
 			}
 
-			if (registry.consumables.has(collisionEntity)) {
-				if (registry.powerUps.has(collisionEntity)) {
+			if (ctx.registry.consumables.has(collisionEntity)) {
+				if (ctx.registry.powerUps.has(collisionEntity)) {
 
-					PowerUp& powerUp = registry.powerUps.get(collisionEntity);
+					PowerUp& powerUp = ctx.registry.powerUps.get(collisionEntity);
 					
 					if (powerUp.type == (unsigned int)PowerUpType::MULTIPLY) {
-						std::vector<Entity> ballEntities = registry.balls.entities;
+						std::vector<Entity> ballEntities = ctx.registry.balls.entities;
 						for (Entity& ballEntity : ballEntities) {
-							foregroundMotion& motion = registry.foregroundMotions.get(ballEntity);
+							foregroundMotion& motion = ctx.registry.foregroundMotions.get(ballEntity);
 							vec2 pos = motion.position;
 
 							float velY = (motion.velocity.y > 0) ? 200.f : -200.f;
@@ -989,11 +1122,11 @@ void WorldSystem::handle_collisions() {
 							Mix_PlayChannel(-1, mg5_x3_multiplier_sound, 0);
 						}
 					} else if (powerUp.type == (unsigned int)PowerUpType::LONGPADDLE) {
-						Paddle& paddle = registry.paddles.components[0];
+						Paddle& paddle = ctx.registry.paddles.components[0];
 
 						if (paddle.longPaddle_ms <= 0.f) {
-							Entity& paddleEntity = registry.paddles.entities[0];
-							foregroundMotion& motion = registry.foregroundMotions.get(paddleEntity);
+							Entity& paddleEntity = ctx.registry.paddles.entities[0];
+							foregroundMotion& motion = ctx.registry.foregroundMotions.get(paddleEntity);
 							motion.scale.x = 200.f;
 
 							paddle.longPaddle_ms = 6000.f;
@@ -1001,10 +1134,10 @@ void WorldSystem::handle_collisions() {
 						}
 					}
 
-					registry.remove_all_components_of(collisionEntity);
+					ctx.registry.remove_all_components_of(collisionEntity);
 
 				} else { // must be an oxygen
-					registry.remove_all_components_of(collisionEntity);
+					ctx.registry.remove_all_components_of(collisionEntity);
 					mg5_inv_points++;
 					Mix_PlayChannel(-1, mg1_pickup_atp_sound, 0);
 				}
@@ -1014,29 +1147,31 @@ void WorldSystem::handle_collisions() {
 		if (!mg5_gameFinished) {
 			if (numBricks == 0) {
 				std::vector<Entity> entities_to_remove = { player };
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.bricks.entities), std::end(registry.bricks.entities));
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.consumables.entities), std::end(registry.consumables.entities));
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.balls.entities), std::end(registry.balls.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.bricks.entities), std::end(ctx.registry.bricks.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.consumables.entities), std::end(ctx.registry.consumables.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.balls.entities), std::end(ctx.registry.balls.entities));
 				minigame_win_lose_overlay(true, entities_to_remove, TEXTURE_ASSET_ID::MG5_WIN_SHEET, 12);
 				if ((unsigned int)completedOrgan < (unsigned int)GAME_STATES::ORGAN_5) {
 					completedOrgan = (unsigned int)GAME_STATES::ORGAN_5;
 				}
 				mg5_gameFinished = true;
-			} else if (registry.balls.components.empty()) {
+			} else if (ctx.registry.balls.components.empty()) {
 				std::vector<Entity> entities_to_remove = { player };
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.bricks.entities), std::end(registry.bricks.entities));
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.consumables.entities), std::end(registry.consumables.entities));
-				entities_to_remove.insert(std::end(entities_to_remove), std::begin(registry.balls.entities), std::end(registry.balls.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.bricks.entities), std::end(ctx.registry.bricks.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.consumables.entities), std::end(ctx.registry.consumables.entities));
+				entities_to_remove.insert(std::end(entities_to_remove), std::begin(ctx.registry.balls.entities), std::end(ctx.registry.balls.entities));
 				minigame_win_lose_overlay(false, entities_to_remove, TEXTURE_ASSET_ID::MG5_LOSE_SHEET, 20);
 				mg5_gameFinished = true;
 			}
 		}
-		registry.collisions.clear();
+		ctx.registry.collisions.clear();
 	}
 }
 
 void WorldSystem::change_game_states(enum GAME_STATES game) {
+	last_minigame = MinigameResult();
 	game_state_system.newGameStateContainers();
+	renderer->particle_pool.clear();
 
 	// Jumps to the different minigames
 	switch (game) {
@@ -1087,13 +1222,16 @@ void WorldSystem::change_game_states(enum GAME_STATES game) {
 			create_credits();
 			break;
 	}
+	snapMotions(ctx);
+	// built the first time each organ loads, after that it's the cached one
+	ctx.organ_nav = organNavMesh(ctx.game_state);
 }
 
 // Pacman
 void WorldSystem::create_minigame_1() {
 	fpsTextEntity = createFpsText();
 	Mix_PlayMusic(mg1_background_music, -1);
-	game_state = (unsigned int)GAME_STATES::MINIGAME_1;
+	ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_1;
 	createText("ATPS:", {window_width_px - 105, window_height_px - 45}, 0.75, {0,0,0});
 	mg1_score = createText(std::to_string(points), {window_width_px-73, window_height_px - 85}, 0.75, {0,0,0});
 	minigame1_maze_gen();
@@ -1101,25 +1239,25 @@ void WorldSystem::create_minigame_1() {
 	vec2 playerStart = { CURRENT_SPRITE_OFFSET , CURRENT_SPRITE_OFFSET };
 	vec2 enemyStart = { window_width_px - CURRENT_SPRITE_OFFSET, window_height_px - CURRENT_SPRITE_OFFSET };
 	Entity backgroundEntity = createBackground(renderer, TEXTURE_ASSET_ID::MINIGAME_1, { window_width_px / 2, window_height_px / 2 }, { window_width_px/2, -window_height_px/2});
-	if (registry.players.entities.size() <= 1) {
+	if (ctx.registry.players.entities.size() <= 1) {
 		player_mg = createPlayer(renderer, playerStart);
-		registry.foregroundMotions.get(player_mg).scale = { 80,-80 };
+		ctx.registry.foregroundMotions.get(player_mg).scale = { 80,-80 };
 	}
 	else {
-		registry.foregroundMotions.get(player_mg).position = playerStart;
-		registry.foregroundRenderRequests.insert(
+		ctx.registry.foregroundMotions.get(player_mg).teleport(playerStart);
+		ctx.registry.foregroundRenderRequests.insert(
 			player_mg,
 			{ TEXTURE_ASSET_ID::GEN,
 				EFFECT_ASSET_ID::TEXTURED,
 				GEOMETRY_BUFFER_ID::SPRITE });
 	}
 
-	if (registry.deadlys.entities.size() < 1) {
+	if (ctx.registry.deadlys.entities.size() < 1) {
 		enemy_rbc = createRedBloodCell(enemyStart);
 	}
 	else {
-		registry.foregroundMotions.get(enemy_rbc).position = enemyStart;
-		registry.foregroundRenderRequests.insert(
+		ctx.registry.foregroundMotions.get(enemy_rbc).teleport(enemyStart);
+		ctx.registry.foregroundRenderRequests.insert(
 			enemy_rbc,
 			{ TEXTURE_ASSET_ID::RBC_SHEET,
 				EFFECT_ASSET_ID::ANIMATION,
@@ -1134,10 +1272,10 @@ void WorldSystem::create_minigame_1() {
 		float xPos = CURRENT_SPRITE_OFFSET;
 		for (int x = 0; x < 16; x++) {
 
-			if (GAME_MAZE[y][x] && !(xPos == counterPosition.x + 10 && yPos == counterPosition.y)) {
+			if (ctx.maze[y][x] && !(xPos == counterPosition.x + 10 && yPos == counterPosition.y)) {
 				createWall(renderer, vec2(xPos, yPos), {100,-100});
 			}
-			else if (!GAME_MAZE[y][x] && !((xPos == playerStart.x && yPos == playerStart.y) || (xPos == enemyStart.x && yPos == enemyStart.y)))
+			else if (!ctx.maze[y][x] && !((xPos == playerStart.x && yPos == playerStart.y) || (xPos == enemyStart.x && yPos == enemyStart.y)))
 			{
 				createItem_ATP(renderer, vec2(xPos, yPos));
 				vec2 offset = vec2((xPos - atpStart.x) / (CURRENT_SPRITE_OFFSET * window_width_px / MAP_BLOCK_SIZE), (yPos - atpStart.y) / (CURRENT_SPRITE_OFFSET * window_height_px / MAP_BLOCK_SIZE));
@@ -1149,11 +1287,11 @@ void WorldSystem::create_minigame_1() {
 		yPos += MAP_BLOCK_SIZE;
 	}
 
-	createInstanceRender(renderer, TEXTURE_ASSET_ID::ITEM_ATP, EFFECT_ASSET_ID::TEXTURED, GEOMETRY_BUFFER_ID::SPRITE, INSTANCING_BUFFER_ID::ATP, registry.consumables.entities[0], translations); 
+	createInstanceRender(renderer, TEXTURE_ASSET_ID::ITEM_ATP, EFFECT_ASSET_ID::TEXTURED, GEOMETRY_BUFFER_ID::SPRITE, INSTANCING_BUFFER_ID::ATP, ctx.registry.consumables.entities[0], translations); 
 	
 	// tutorial stuff
 	if (!tutorialChecklist[GAME_STATES::MINIGAME_1]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MG1_TUTORIAL);
 		tutorialChecklist[GAME_STATES::MINIGAME_1] = true;
 	}
@@ -1161,63 +1299,21 @@ void WorldSystem::create_minigame_1() {
 }
 
 void WorldSystem::minigame1_maze_gen() {
-	// Reset game maze to initial seed
-	for (int j = 0; j < 9; j++) {
-		for (int i = 0; i < 16; i++) {
-			GAME_MAZE[j][i] = GAME_MAZE_SEED[j][i];
+	// Carve into the initial seed
+	GridMap map = GridMap::fromCells(&GAME_MAZE_SEED[0][0], MAZE_COLUMNS, MAZE_ROWS);
+	// rooms sit on even cells, rows only go up to 8
+	int start_column = ctx.rng.below(8) * 2;
+	int start_row = ctx.rng.below(5) * 2;
+	carveMaze(map, ctx.rng, MAZE_ALGORITHM::BACKTRACKER, start_column, start_row);
+	for (int j = 0; j < MAZE_ROWS; j++) {
+		for (int i = 0; i < MAZE_COLUMNS; i++) {
+			ctx.maze[j][i] = map.walls[map.index(i, j)];
 		}
 	}
-	std::vector<vec2> visited = {};
-	vec2 pos = { (rand() % 8) * 2, (rand() % 8) * 2 };
-	minigame1_carve_maze(pos, visited);
-	GAME_MAZE[0][0] = 0; GAME_MAZE[8][15] = 0;
-}
-
-void WorldSystem::minigame1_carve_maze(vec2 pos, std::vector<vec2>& visited) {
-	// DFS Recursive search until all nodes are visited
-	if ((count(visited.begin(), visited.end(), pos) != 0)) return;
-	visited.push_back(pos);
-	GAME_MAZE[(int)pos.y][(int)pos.x] = 0;
-	std::vector<Direction> possibleDirections = { };
-	if (pos.y - 2 >= 0) possibleDirections.push_back(UP);
-	if (pos.y + 2 <= 8) possibleDirections.push_back(DOWN);
-	if (pos.x - 2 >= 0) possibleDirections.push_back(LEFT);
-	if (pos.x + 2 <= 15) possibleDirections.push_back(RIGHT);
-	while (possibleDirections.size() > 0) {
-		int randomIndex = rand() % possibleDirections.size();
-		vec2 newPos = { 0,0 };
-		switch (possibleDirections[randomIndex]) {
-		case UP:
-			newPos = { pos.x, pos.y-2 };
-			if (count(visited.begin(), visited.end(), newPos) == 0) {
-				GAME_MAZE[(int)pos.y - 1][(int)pos.x] = 0;
-				minigame1_carve_maze({ pos.x, pos.y - 2 }, visited);
-			}
-			break;
-		case RIGHT:
-			newPos = { pos.x + 2, pos.y };
-			if (count(visited.begin(), visited.end(), newPos) == 0) {
-				GAME_MAZE[(int)pos.y][(int)pos.x + 1] = 0;
-				minigame1_carve_maze({ pos.x + 2, pos.y }, visited);
-			}
-			break;
-		case DOWN:
-			newPos = { pos.x, pos.y + 2 };
-			if (count(visited.begin(), visited.end(), newPos) == 0) {
-				GAME_MAZE[(int)pos.y + 1][(int)pos.x] = 0;
-				minigame1_carve_maze({ pos.x, pos.y + 2 }, visited);
-			}
-			break;
-		case LEFT:
-			newPos = { pos.x - 2, pos.y };
-			if (count(visited.begin(), visited.end(), newPos) == 0) {
-				GAME_MAZE[(int)pos.y][(int)pos.x - 1] = 0;
-				minigame1_carve_maze({ pos.x - 2, pos.y }, visited);
-			}
-			break;
-		}
-		possibleDirections.erase(possibleDirections.begin() + randomIndex);
-	}
+	ctx.maze[0][0] = 0; ctx.maze[8][15] = 0;
+	ctx.maze_version++;
+	// small enough to know every shortest way through up front, the chasers look them up
+	ctx.maze_nav.build(GridMap::fromCells(&ctx.maze[0][0], MAZE_COLUMNS, MAZE_ROWS), ctx.maze_version);
 }
 
 // Falling / Moving through blood vessel
@@ -1227,6 +1323,7 @@ void WorldSystem::create_minigame_2() {
 	Entity backgroundEntity_1 = createBackground(renderer, TEXTURE_ASSET_ID::MINIGAME_2, { 0, window_height_px / 2 }, { window_width_px / 2 + 10 , -window_height_px / 2 });
 	Entity backgroundEntity_2 = createBackground(renderer, TEXTURE_ASSET_ID::MINIGAME_2, { window_width_px, window_height_px / 2 }, { window_width_px / 2 + 10 , -window_height_px / 2 });
 	numberOfConsumables = 15;
+	mg2_duration = ctx.tuning.mg2_duration;
 	float x_pos = window_width_px;
 
 	player_mg = createPlayer(renderer, { 100, window_height_px/2 });
@@ -1235,35 +1332,35 @@ void WorldSystem::create_minigame_2() {
 	createMG2Progress({ 410, 39 }, { 32,30 });
 	
 	for (int i = 0; i < numberOfConsumables; i++) {
-		float rand = uniform_dist(rng);
+		float rand = ctx.rng.uniform();
 		x_pos += rand*window_width_px + 150;
 		float y_pos = rand > 0.5f ? 170.f : 750.f;
 		createItem_Lipid(renderer, { x_pos, y_pos }, 2.5f-rand);
 	}
 	initMG2Physics();
 	initializeMG2Tree(renderer);
-	game_state = (unsigned int)GAME_STATES::MINIGAME_2;
+	ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_2;
 	
 	// tutorial stuff
 	if (!tutorialChecklist[GAME_STATES::MINIGAME_2]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MG2_TUTORIAL);
 		tutorialChecklist[GAME_STATES::MINIGAME_2] = true;
 	}
 }
 
 void WorldSystem::end_minigame_2(float elapsed_ms_since_last_update) {
-	if (game_state == (unsigned int)GAME_STATES::MINIGAME_2) {
-		Entity bar = registry.bar.entities.back();
-		overlayMotions& bar_motion = registry.overlayMotions.get(bar);
+	if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_2) {
+		Entity bar = ctx.registry.bar.entities.back();
+		overlayMotions& bar_motion = ctx.registry.overlayMotions.get(bar);
 
-		if (!pause_game_state) {
+		if (!ctx.pause_game_state) {
 			mg2_duration -= elapsed_ms_since_last_update;
-			bar_motion.scale.x += (1075.f / 40000.f) * elapsed_ms_since_last_update; // 1075 is the width of the progress bar
-			bar_motion.position.x += (1075.f / 40000.f) * elapsed_ms_since_last_update / 2;
+			bar_motion.scale.x += (1075.f / ctx.tuning.mg2_duration) * elapsed_ms_since_last_update; // 1075 is the width of the progress bar
+			bar_motion.position.x += (1075.f / ctx.tuning.mg2_duration) * elapsed_ms_since_last_update / 2;
 		}
-		if (mg2_duration <= 0 && !pause_game_state) {
-			mg2_duration = 40000.0f;
+		if (mg2_duration <= 0 && !ctx.pause_game_state) {
+			mg2_duration = ctx.tuning.mg2_duration;
 			points = 0;
 			std::vector<Entity> entities_to_remove = { player };
 			minigame_win_lose_overlay(true, entities_to_remove, TEXTURE_ASSET_ID::MG2_WIN_SHEET, 12);
@@ -1277,16 +1374,16 @@ void WorldSystem::end_minigame_2(float elapsed_ms_since_last_update) {
 // Acid jump
 void WorldSystem::create_minigame_3()
 {
-	jump_count = 0;
+	ctx.minigames.jump_count = 0;
 	fpsTextEntity = createFpsText();
 	Mix_PlayMusic(mg3_background_music, -1);
 	Entity backgroundEntity_1 = createBackground(renderer, TEXTURE_ASSET_ID::MG3_BACKGROUND, { window_width_px / 2, window_height_px / 2 }, { window_width_px / 2 , -window_height_px / 2 });
 
 	player_mg = createPlayer(renderer, { 75, window_height_px / 4 });
-	foregroundMotion& motion = registry.foregroundMotions.get(player_mg);
+	foregroundMotion& motion = ctx.registry.foregroundMotions.get(player_mg);
 	vec2 starting_pos = motion.position - vec2(0, (motion.scale.y / 2) - 50);
 	Entity platform_entity = createPlatform(starting_pos, vec2(150, -50), gravity_factor);
-	Platform& platform = registry.platform.get(platform_entity);
+	Platform& platform = ctx.registry.platform.get(platform_entity);
 	platform.below = true;
 
 	platform_pos.push_back(starting_pos);
@@ -1337,25 +1434,25 @@ void WorldSystem::create_minigame_3()
 	Entity finish_line = createFinishLine(vec2(window_width_px / 2, last_platform_pos.y - 100), gravity_factor);
 
 	if (!tutorialChecklist[GAME_STATES::MINIGAME_3]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MG3_TUTORIAL);
 		tutorialChecklist[GAME_STATES::MINIGAME_3] = true;
 	}
 
 	Entity acid_entity = createAcid(vec2(window_width_px / 2, window_height_px - 50));
-	game_state = (unsigned int)GAME_STATES::MINIGAME_3;
+	ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_3;
 }
 
 void WorldSystem::minigame3_step(float elapsed_ms_since_last_update)
 {
-	if (game_state == (unsigned int)GAME_STATES::MINIGAME_3 && !pause_game_state)
+	if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_3 && !ctx.pause_game_state)
 	{
 		if (num_of_glucose > 0)
 		{
 			glucose_counter -= elapsed_ms_since_last_update;
 			if (glucose_counter < 0)
 			{
-				float index = rand() % platform_pos.size();
+				int index = ctx.rng.below((uint32_t)platform_pos.size());
 				Entity glucose = createGlucose(vec2(platform_pos[index].x, -50), gravity_factor * 3);
 				num_of_glucose--;
 				glucose_counter = 2000.f;
@@ -1382,13 +1479,13 @@ void WorldSystem::create_minigame_4() {
 
 	player_mg = createPlayer(renderer, { 100, window_height_px / 2 });
 
-	game_state = (unsigned int)GAME_STATES::MINIGAME_4;
+	ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_4;
 
 	for (int i = 0; i < NUM_IRON; i++) createIron();
 
 	// tutorial stuff
 	if (!tutorialChecklist[GAME_STATES::MINIGAME_4]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MG4_TUTORIAL);
 		tutorialChecklist[GAME_STATES::MINIGAME_4] = true;
 	}
@@ -1397,10 +1494,10 @@ void WorldSystem::create_minigame_4() {
 }
 
 void WorldSystem::minigame4_step(float elapsed_ms_since_last_update) {
-	if (game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
-		std::vector<Entity>& whackAMoleEntities = registry.whackAMole.entities;
+	if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
+		std::vector<Entity>& whackAMoleEntities = ctx.registry.whackAMole.entities;
 		for (unsigned int i = 0; i < whackAMoleEntities.size(); i++) {
-			WhackAMole& whackAMoleComponent = registry.whackAMole.get(whackAMoleEntities[i]);
+			WhackAMole& whackAMoleComponent = ctx.registry.whackAMole.get(whackAMoleEntities[i]);
 			if (whackAMoleComponent.active && !whackAMoleComponent.whacked && !whackAMoleComponent.exploded) {
 				if (whackAMoleComponent.angerLevel < ALLOWED_TIME_TO_BE_ALIVE) {
 					whackAMoleComponent.angerLevel += elapsed_ms_since_last_update / 7500;
@@ -1408,13 +1505,14 @@ void WorldSystem::minigame4_step(float elapsed_ms_since_last_update) {
 				else {
 					Mix_PlayChannel(-1, mg3_explosion_sound, 0);
 					explosionCount++;
+					ctx.registry.screenStates.get(renderer->screen_state_entity).shake_ms = SCREEN_SHAKE_MS;
 					whackAMoleComponent.exploded = 1;
 					whackAMoleComponent.whacked = 0;
 					whackAMoleComponent.angerLevel = 0;
-					if (registry.collidables.has(whackAMoleEntities[i])) {
-						registry.collidables.remove(whackAMoleEntities[i]);
+					if (ctx.registry.collidables.has(whackAMoleEntities[i])) {
+						ctx.registry.collidables.remove(whackAMoleEntities[i]);
 					}
-					registry.foregroundRenderRequests.get(whackAMoleEntities[i]).used_texture = TEXTURE_ASSET_ID::MG4_EXPLOSION;
+					ctx.registry.foregroundRenderRequests.get(whackAMoleEntities[i]).used_texture = TEXTURE_ASSET_ID::MG4_EXPLOSION;
 				}
 			}
 		}
@@ -1422,13 +1520,13 @@ void WorldSystem::minigame4_step(float elapsed_ms_since_last_update) {
 }
 
 void WorldSystem::end_minigame_4() {
-	if (game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
-		if (explosionCount >= 3 && !pause_game_state) {
+	if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
+		if (explosionCount >= 3 && !ctx.pause_game_state) {
 			std::vector<Entity> toRemove = { player_mg};
-			toRemove.insert(std::end(toRemove), std::begin(registry.whackAMole.entities), std::end(registry.whackAMole.entities));
-			toRemove.insert(std::end(toRemove), std::begin(registry.consumables.entities), std::end(registry.consumables.entities));
+			toRemove.insert(std::end(toRemove), std::begin(ctx.registry.whackAMole.entities), std::end(ctx.registry.whackAMole.entities));
+			toRemove.insert(std::end(toRemove), std::begin(ctx.registry.consumables.entities), std::end(ctx.registry.consumables.entities));
 			minigame_win_lose_overlay(false, toRemove, TEXTURE_ASSET_ID::MG4_LOSE_SHEET, 11);
-			registry.remove_all_components_of(remainingText); //Cleanup
+			ctx.registry.remove_all_components_of(remainingText); //Cleanup
 		}
 	}
 }
@@ -1446,16 +1544,16 @@ void WorldSystem::create_minigame_5() {
 	float yPos = BRICK_HEIGHT;
 	numBricks = 0;
 	const int numMaps = sizeof(BRICK_MAP_ARRAY) / sizeof(BRICK_MAP_ARRAY[0]);
-	const int randomSelection = rand() % numMaps;
+	const int randomSelection = ctx.tuning.brick_map >= 0 ? std::min(ctx.tuning.brick_map, numMaps - 1) : (int)ctx.rng.below(numMaps);
 	const auto brickMap = BRICK_MAP_ARRAY[randomSelection];
 	for (int y = 0; y < 18; y++) {
 		float xPos = BRICK_WIDTH / 2;
 		for (int x = 0; x < 16; x++) {
 			
 			if (brickMap[y][x]) {
-				bool hasOxygen = rand() % 10 == 0;
+				bool hasOxygen = ctx.rng.below(10) == 0;
 				PowerUpType powerUp;
-				int random = rand();
+				uint32_t random = ctx.rng.next();
 				if (random % 20 == 0) powerUp = PowerUpType::MULTIPLY;
 				else if (random % 15 == 0) powerUp = PowerUpType::LONGPADDLE;
 				else powerUp = PowerUpType::NONE;
@@ -1471,24 +1569,24 @@ void WorldSystem::create_minigame_5() {
 	std::string numBricksStr = "Remaining Phlegm: " + std::to_string(numBricks);
 	remainingBricksText = createText(numBricksStr, vec2(window_width_px - 400, 10.0f), 0.75f, vec3(1.0f, 1.0f, 1.0f));
 
-	game_state = (unsigned int)GAME_STATES::MINIGAME_5;
+	ctx.game_state = (unsigned int)GAME_STATES::MINIGAME_5;
 
 	// tutorial stuff
 	if (!tutorialChecklist[GAME_STATES::MINIGAME_5]) {
-		pause_game_state = true;
+		ctx.pause_game_state = true;
 		tutorial = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MG5_TUTORIAL);
 		tutorialChecklist[GAME_STATES::MINIGAME_5] = true;
 	}
 }
 
 void WorldSystem::minigame5_step(float elapsed_ms_since_last_update) {
-	Paddle& paddle = registry.paddles.components[0];
+	Paddle& paddle = ctx.registry.paddles.components[0];
 
 	if (paddle.longPaddle_ms > 0.f) {
 		paddle.longPaddle_ms -= elapsed_ms_since_last_update;
 	} else {
-		Entity& paddleEntity = registry.paddles.entities[0];
-		foregroundMotion& motion = registry.foregroundMotions.get(paddleEntity);
+		Entity& paddleEntity = ctx.registry.paddles.entities[0];
+		foregroundMotion& motion = ctx.registry.foregroundMotions.get(paddleEntity);
 
 		motion.scale.x = 150.f;
 	}
@@ -1509,7 +1607,7 @@ void WorldSystem::display_inventory() {
 	Entity atp_icon = createBackground(renderer, TEXTURE_ASSET_ID::ITEM_ATP, { 25 + spacingX, iconStartingY }, defaultScale);
 	if (!mg1_inv_points) {
 		mg1_inventory_text = "    ???";
-		registry.colors.emplace(atp_icon) = { 0,0,0 };
+		ctx.registry.colors.emplace(atp_icon) = { 0,0,0 };
 	}
 	if (showGoal) {
 		mg1_inventory_text = mg1_inventory_text + "/" + std::to_string(MG1_ITEM_GOAL);
@@ -1520,7 +1618,7 @@ void WorldSystem::display_inventory() {
 	Entity lipid_inventory_icon = createBackground(renderer, TEXTURE_ASSET_ID::ITEM_LIPID, { 25 + spacingX, iconStartingY + spacingY * 1 }, { 20, -12 });
 	if (!mg2_inv_points) {
 		mg2_inventory_text = "    ???";
-		registry.colors.emplace(lipid_inventory_icon) = { 0,0,0 };
+		ctx.registry.colors.emplace(lipid_inventory_icon) = { 0,0,0 };
 	}
 	if (showGoal) {
 		mg2_inventory_text = mg2_inventory_text + "/" + std::to_string(MG2_ITEM_GOAL);
@@ -1531,7 +1629,7 @@ void WorldSystem::display_inventory() {
 	Entity gluce_inventory_icon = createBackground(renderer, TEXTURE_ASSET_ID::ITEM_GLUCOSE, { 25 + spacingX, iconStartingY + spacingY * 2 }, { 20,-20 });
 	if (!mg3_inv_points) {
 		mg3_inventory_text = "    ???";
-		registry.colors.emplace(gluce_inventory_icon) = { 0,0,0 };
+		ctx.registry.colors.emplace(gluce_inventory_icon) = { 0,0,0 };
 	}
 	if (showGoal) {
 		mg3_inventory_text = mg3_inventory_text + "/" + std::to_string(MG3_ITEM_GOAL);
@@ -1542,7 +1640,7 @@ void WorldSystem::display_inventory() {
 	Entity wbc_inventory_icon = createBackground(renderer, TEXTURE_ASSET_ID::IRON, { 25 + spacingX, iconStartingY + spacingY * 3 }, defaultScale);
 	if (!mg4_inv_points) {
 		mg4_inventory_text = "    ???";
-		registry.colors.emplace(wbc_inventory_icon) = { 0,0,0 };
+		ctx.registry.colors.emplace(wbc_inventory_icon) = { 0,0,0 };
 	}
 	if (showGoal) {
 		mg4_inventory_text = mg4_inventory_text + "/" + std::to_string(MG4_ITEM_GOAL);
@@ -1553,7 +1651,7 @@ void WorldSystem::display_inventory() {
 	Entity oxygen_inventory_icon = createBackground(renderer, TEXTURE_ASSET_ID::OXYGEN, { 25 + spacingX, iconStartingY + spacingY * 4 }, defaultScale);
 	if (!mg5_inv_points) {
 		mg5_inventory_text = "    ???";
-		registry.colors.emplace(oxygen_inventory_icon) = { 0,0,0 };
+		ctx.registry.colors.emplace(oxygen_inventory_icon) = { 0,0,0 };
 	}
 	if (showGoal) {
 		mg5_inventory_text = mg5_inventory_text + "/" + std::to_string(MG5_ITEM_GOAL);
@@ -1562,15 +1660,27 @@ void WorldSystem::display_inventory() {
 }
 
 // Should the game be over ?
+unsigned int WorldSystem::itemsCollected(GAME_STATES minigame) const {
+	switch (minigame) {
+	case GAME_STATES::MINIGAME_1: return mg1_inv_points;
+	case GAME_STATES::MINIGAME_2: return mg2_inv_points;
+	case GAME_STATES::MINIGAME_3: return mg3_inv_points;
+	case GAME_STATES::MINIGAME_4: return mg4_inv_points;
+	case GAME_STATES::MINIGAME_5: return mg5_inv_points;
+	default: return 0;
+	}
+}
+
 bool WorldSystem::is_over() const {
-	return bool(glfwWindowShouldClose(window));
+	// headless runs are stopped by their frame budget
+	return window != nullptr && bool(glfwWindowShouldClose(window));
 }
 
 void WorldSystem::minigame_win_lose_overlay(bool win, std::vector<Entity>& entities_to_remove, TEXTURE_ASSET_ID used_texture, int num_frames)
 {
 	for (Entity& entity : entities_to_remove)
 	{
-		registry.remove_all_components_of(entity);
+		ctx.registry.remove_all_components_of(entity);
 	}
 
 	if (win)
@@ -1578,9 +1688,13 @@ void WorldSystem::minigame_win_lose_overlay(bool win, std::vector<Entity>& entit
 	else
 		minigameOver = createTutorial(tutorialPos, TEXTURE_ASSET_ID::MINIGAME_OVER);
 
+	last_minigame.over = true;
+	last_minigame.won = win;
+	last_minigame.tick = ctx.clock.tick;
+
 	Entity level_cleared_animation = createAnimation(tutorialPos, used_texture, num_frames, { 650, 300 });
 	// Entity level_cleared_animation = createAnimation(renderer, tutorialPos, first_frame, last_frame);
-	pause_game_state = true;
+	ctx.pause_game_state = true;
 }
 
 void WorldSystem::load_game_saveFile() {
@@ -1598,8 +1712,8 @@ void WorldSystem::load_game_saveFile() {
 }
 
 void WorldSystem::save_game_saveFile(std::string message) {
-	game_state_system.saveStatePersistence["currentPositionX"] = registry.foregroundMotions.get(player).position.x;
-	game_state_system.saveStatePersistence["currentPositionY"] = registry.foregroundMotions.get(player).position.y;
+	game_state_system.saveStatePersistence["currentPositionX"] = ctx.registry.foregroundMotions.get(player).position.x;
+	game_state_system.saveStatePersistence["currentPositionY"] = ctx.registry.foregroundMotions.get(player).position.y;
 	game_state_system.saveStatePersistence["currentOrgan"] = currentOrgan;
 	game_state_system.saveStatePersistence["unlockedOrgan"] = completedOrgan;
 	game_state_system.saveStatePersistence["seenTutorials"] = tutorialChecklist;
@@ -1609,12 +1723,14 @@ void WorldSystem::save_game_saveFile(std::string message) {
 	game_state_system.saveStatePersistence["items"]["iron"] = mg4_inv_points;
 	game_state_system.saveStatePersistence["items"]["oxygen"] = mg5_inv_points;
 	Entity savedText = createText(message, { 10, 10 }, 1, { 1, 1, 1 });
-	registry.savedGameTimer.emplace(savedText);
+	ctx.registry.savedGameTimer.emplace(savedText);
 	game_state_system.write_save_state();
 }
 
 // On key callback
 void WorldSystem::on_key(int key, int, int action, int mod) {
+	recordInput(INPUT_EVENT_TYPE::KEY, key, action, mod);
+
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 	// key is of 'type' GLFW_KEY_
 	// action can be GLFW_PRESS GLFW_RELEASE GLFW_REPEAT
@@ -1624,21 +1740,21 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 	// Motion controls
 	if (key == GLFW_KEY_W || key == GLFW_KEY_S || key == GLFW_KEY_A || key == GLFW_KEY_D) {
 		// Global mapped keys
-		if (action == GLFW_PRESS) keymap[key] = true;
-		else if (action == GLFW_RELEASE) keymap[key] = false;
+		if (action == GLFW_PRESS) ctx.input.keys[key] = true;
+		else if (action == GLFW_RELEASE) ctx.input.keys[key] = false;
 
 	}
 
 	// W/S specific to title
-	if (!pause_game_state && game_state == (unsigned int)GAME_STATES::TITLE) {
+	if (!ctx.pause_game_state && ctx.game_state == (unsigned int)GAME_STATES::TITLE) {
 		if ((key == GLFW_KEY_W || key == GLFW_KEY_S) && action == GLFW_RELEASE) {
 			if (key == GLFW_KEY_W) {
-				registry.title.components[0].selectionOption = registry.title.components[0].selectionOption == 0 ? 0 : registry.title.components[0].selectionOption - 1;
+				ctx.registry.title.components[0].selectionOption = ctx.registry.title.components[0].selectionOption == 0 ? 0 : ctx.registry.title.components[0].selectionOption - 1;
 			}
 			else if (key == GLFW_KEY_S) {
-				registry.title.components[0].selectionOption = registry.title.components[0].selectionOption == 2 ? 2 : registry.title.components[0].selectionOption + 1;
+				ctx.registry.title.components[0].selectionOption = ctx.registry.title.components[0].selectionOption == 2 ? 2 : ctx.registry.title.components[0].selectionOption + 1;
 			}
-			if (registry.title.components[0].titleInPlace) {
+			if (ctx.registry.title.components[0].titleInPlace) {
 				Mix_PlayChannel(-1, title_select_sound, 0);
 			}
 		}
@@ -1646,18 +1762,18 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 
 	if (action == GLFW_PRESS && key == GLFW_KEY_SPACE)
 	{
-		if (game_state == (unsigned int)GAME_STATES::MINIGAME_3 && !pause_game_state) {
-			if (jump_count < 2)
+		if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_3 && !ctx.pause_game_state) {
+			if (ctx.minigames.jump_count < 2)
 			{
-				foregroundMotion& player_motion = registry.foregroundMotions.get(player_mg);
-				if (!registry.jump.has(player_mg))
+				foregroundMotion& player_motion = ctx.registry.foregroundMotions.get(player_mg);
+				if (!ctx.registry.jump.has(player_mg))
 				{
-					Jump& jump = registry.jump.emplace(player_mg);
+					Jump& jump = ctx.registry.jump.emplace(player_mg);
 				}
 				
 				player_motion.velocity.y = -175;
-				jump_count++;
-				on_platform = false;
+				ctx.minigames.jump_count++;
+				ctx.minigames.on_platform = false;
 			}
 		}
 	}
@@ -1665,14 +1781,14 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 	
 	// Action key
 	if (key == GLFW_KEY_SPACE && action == GLFW_RELEASE) {
-		if (pause_game_state && registry.overlayMotions.has(tutorial)) {
-			registry.overlayMotions.remove(tutorial);
-			registry.overlayRenderRequests.remove(tutorial);
-			pause_game_state = false;
+		if (ctx.pause_game_state && ctx.registry.overlayMotions.has(tutorial)) {
+			ctx.registry.overlayMotions.remove(tutorial);
+			ctx.registry.overlayRenderRequests.remove(tutorial);
+			ctx.pause_game_state = false;
 		}
 
-		if (registry.overlayMotions.has(minigameWin) || registry.overlayMotions.has(minigameOver)) {
-			pause_game_state = false;
+		if (ctx.registry.overlayMotions.has(minigameWin) || ctx.registry.overlayMotions.has(minigameOver)) {
+			ctx.pause_game_state = false;
 			change_game_states(currentOrgan);
 			save_game_saveFile("AUTO SAVED");
 			points = 0;
@@ -1680,88 +1796,88 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 
 		if (endingSceneFinished && !fadeOut) {
 			fadeOut = true;
-			pause_game_state = true;
+			ctx.pause_game_state = true;
 		}
 
-		if (game_state == (unsigned int)GAME_STATES::CREDITS && !fadeOut) {
-			if (registry.credits.components[0].creditsFinished) {
+		if (ctx.game_state == (unsigned int)GAME_STATES::CREDITS && !fadeOut) {
+			if (ctx.registry.credits.components[0].creditsFinished) {
 				fadeOut = true;
-				pause_game_state = true;
+				ctx.pause_game_state = true;
 			}
 		}
 
-		if (game_state == (unsigned int)GAME_STATES::TITLE && registry.title.components[0].titleInPlace) {
+		if (ctx.game_state == (unsigned int)GAME_STATES::TITLE && ctx.registry.title.components[0].titleInPlace) {
 			Mix_PlayChannel(-1, title_enter_sound, 0);
 			fadeOut = true;
-			pause_game_state = true;
+			ctx.pause_game_state = true;
 		}
-		else if (game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
-			game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
-			game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
-			game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
-			game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
-			game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-			game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		else if (ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
+			ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
+			ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
+			ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
+			ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
+			ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+			ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 			&& !fadeOut
 			) {
-			auto& collisionsRegistry = registry.collisions;
+			auto& collisionsRegistry = ctx.registry.collisions;
 			for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 				// The entity and its collider
 				Entity entity = collisionsRegistry.entities[i];
 				Entity entity_other = collisionsRegistry.components[i].other;
 
 				// Enter minigame actions
-				if (registry.gameNodes.has(entity_other))
+				if (ctx.registry.gameNodes.has(entity_other))
 				{
 					Mix_PlayChannel(-1, title_enter_sound, 0);
 					fadeOut = true;
-					pause_game_state = true;
+					ctx.pause_game_state = true;
 				}
 				// Transport node action
-				else if (registry.transportNodes.has(entity_other)) {
+				else if (ctx.registry.transportNodes.has(entity_other)) {
 					Mix_PlayChannel(-1, title_enter_sound, 0);
 					fadeOut = true;
-					pause_game_state = true;
+					ctx.pause_game_state = true;
 				}
-				else if (registry.brainItemCheckNode.has(entity_other) && !brainGateUnlocked && enoughItems) {
+				else if (ctx.registry.brainItemCheckNode.has(entity_other) && !brainGateUnlocked && enoughItems) {
 					brainGateUnlocked = true;
-					registry.overlayRenderRequests.remove(genericSpacebarTextBox);
-					registry.remove_all_components_of(genericTextBoxAccompanyingText);
+					ctx.registry.overlayRenderRequests.remove(genericSpacebarTextBox);
+					ctx.registry.remove_all_components_of(genericTextBoxAccompanyingText);
 					genericSpacebarTextBoxActive = false;
-					player_saved_pos = registry.foregroundMotions.get(player).position;
+					player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 					change_game_states(GAME_STATES::BRAIN_UNLOCKED);
 				}
-				else if (registry.brainEndingChoiceNode.has(entity_other)) {
+				else if (ctx.registry.brainEndingChoiceNode.has(entity_other)) {
 					Mix_PlayChannel(-1, title_enter_sound, 0);
 					fadeOut = true;
-					pause_game_state = true;
+					ctx.pause_game_state = true;
 				}
 			}
 		}
-		else if (game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
-			auto& collisionsRegistry = registry.collisions;
+		else if (ctx.game_state == (unsigned int)GAME_STATES::MINIGAME_4) {
+			auto& collisionsRegistry = ctx.registry.collisions;
 			for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 				// The entity and its collider
 				Entity& entity = collisionsRegistry.entities[i];
 				Entity& entity_other = collisionsRegistry.components[i].other;
-				if (registry.whackAMole.has(entity_other)) {
+				if (ctx.registry.whackAMole.has(entity_other)) {
 					points++;
-					registry.texts.get(remainingText).str = "REMAINING: " + std::to_string(20-points);
+					ctx.registry.texts.get(remainingText).str = "REMAINING: " + std::to_string(20-points);
 					Mix_PlayChannel(-1, mg3_whack_sound, 0);
-					registry.whackAMole.get(entity_other).whacked = true;
-					registry.whackAMole.get(entity_other).angerLevel = 0;
-					registry.collidables.remove(entity_other);
-					registry.collisions.clear();
+					ctx.registry.whackAMole.get(entity_other).whacked = true;
+					ctx.registry.whackAMole.get(entity_other).angerLevel = 0;
+					ctx.registry.collidables.remove(entity_other);
+					ctx.registry.collisions.clear();
 				}
 				if (points >= 20) {
 					std::vector<Entity> toRemove = { player_mg };
-					toRemove.insert(std::end(toRemove), std::begin(registry.whackAMole.entities), std::end(registry.whackAMole.entities));
-					toRemove.insert(std::end(toRemove), std::begin(registry.consumables.entities), std::end(registry.consumables.entities));
+					toRemove.insert(std::end(toRemove), std::begin(ctx.registry.whackAMole.entities), std::end(ctx.registry.whackAMole.entities));
+					toRemove.insert(std::end(toRemove), std::begin(ctx.registry.consumables.entities), std::end(ctx.registry.consumables.entities));
 					minigame_win_lose_overlay(true, toRemove, TEXTURE_ASSET_ID::MG4_WIN_SHEET, 12);
 					if ((unsigned int)completedOrgan < (unsigned int)GAME_STATES::ORGAN_4) {
 						completedOrgan = (unsigned int) GAME_STATES::ORGAN_4;
 					}
-					registry.remove_all_components_of(remainingText); //Cleanup
+					ctx.registry.remove_all_components_of(remainingText); //Cleanup
 					points = 0;
 				}
 			}
@@ -1778,35 +1894,35 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 
 	// Increase completed organ number
 	if ((mod & GLFW_MOD_SHIFT) && key == GLFW_KEY_EQUAL && action == GLFW_RELEASE && (
-		game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		)) {
-		if (pause_game_state) pause_game_state = false;
+		if (ctx.pause_game_state) ctx.pause_game_state = false;
 		completedOrgan = (unsigned int)currentOrgan;
 		change_game_states(currentOrgan);
 	}
 
 	// Give all required items
 	if ((mod & GLFW_MOD_SHIFT) && key == GLFW_KEY_MINUS && action == GLFW_RELEASE && (
-		game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		)) {
 		mg1_inv_points = MG1_ITEM_GOAL;
 		mg2_inv_points = MG2_ITEM_GOAL;
 		mg3_inv_points = MG3_ITEM_GOAL;
 		mg4_inv_points = MG4_ITEM_GOAL;
 		mg5_inv_points = MG5_ITEM_GOAL;
-		player_saved_pos = registry.foregroundMotions.get(player).position;
+		player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 		change_game_states(currentOrgan);
 	}
 
@@ -1816,6 +1932,13 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 		debugging.in_debug_mode = !debugging.in_debug_mode;
 	}
 
+	// Particle stress test, fills the pool with a million particles
+	if (debugging.in_debug_mode && key == GLFW_KEY_K && action == GLFW_RELEASE) {
+		renderer->particle_pool.toggleStress();
+		printf("Particle stress mode %s (%s)\n", renderer->particle_pool.inStressMode() ? "on" : "off",
+			renderer->particle_pool.usingGpu() ? "transform feedback" : "CPU fallback");
+	}
+
 	//// Accessing dev mode removed to avoid player mispresses
 	//if (key == GLFW_KEY_V && action == GLFW_RELEASE) {
 	//	debugging.in_dev_mode = !debugging.in_dev_mode;
@@ -1828,14 +1951,14 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 	//}
 
 	if (debugging.in_dev_mode && (
-		game_state == (unsigned int)GAME_STATES::TITLE||
-		game_state == (unsigned int)GAME_STATES::ORGAN_1||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		ctx.game_state == (unsigned int)GAME_STATES::TITLE||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		)) {
 		// Jump to organ 1
 		if (key == GLFW_KEY_1 && action == GLFW_RELEASE) {
@@ -1882,7 +2005,7 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 			mg3_inv_points = MG3_ITEM_GOAL;
 			mg4_inv_points = MG4_ITEM_GOAL;
 			mg5_inv_points = MG5_ITEM_GOAL;
-			player_saved_pos = registry.foregroundMotions.get(player).position;
+			player_saved_pos = ctx.registry.foregroundMotions.get(player).position;
 			change_game_states(currentOrgan);
 		}
 
@@ -1901,13 +2024,13 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 		}
 
 		//Print existing organ array for debugging. Commented out 
-		if (key == GLFW_KEY_P && action == GLFW_RELEASE && game_state != (int)GAME_STATES::MINIGAME_1) {
-			if (registry.walls.size() == 0) {
+		if (key == GLFW_KEY_P && action == GLFW_RELEASE && ctx.game_state != (int)GAME_STATES::MINIGAME_1) {
+			if (ctx.registry.walls.size() == 0) {
 				printf("\n");
 				for (int i = 0; i < 36; ++i) {
 					printf("{");
 					for (int j = 0; j < 64; ++j) {
-						switch (game_state) {
+						switch (ctx.game_state) {
 						case (int)GAME_STATES::ORGAN_1:
 							printf("%d", ORGAN_1_BOUNDARY[i][j]);
 							if (ORGAN_1_BOUNDARY[i][j]) createWall(renderer, vec2((25.0f / 2.0f) + 25 * j, (25.0f / 2.0f) + 25 * i), { 25,-25 });
@@ -1945,8 +2068,8 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 				printf("Done\n");
 			}
 			else {
-				while (registry.walls.entities.size() > 0) {
-					registry.remove_all_components_of(registry.walls.entities.back());
+				while (ctx.registry.walls.entities.size() > 0) {
+					ctx.registry.remove_all_components_of(ctx.registry.walls.entities.back());
 				}
 			}
 					if (key == GLFW_KEY_5 && action == GLFW_RELEASE) {
@@ -1958,13 +2081,13 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 
 	// SAVE KEY
 	if (key == GLFW_KEY_M && action == GLFW_RELEASE && (
-		game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
-		game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
-		game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_1 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_2 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_3 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_4 ||
+		ctx.game_state == (unsigned int)GAME_STATES::ORGAN_5 ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_LOCKED ||
+		ctx.game_state == (unsigned int)GAME_STATES::BRAIN_UNLOCKED
 		)) {
 		save_game_saveFile("SAVED GAME");
 		Mix_PlayChannel(-1, save_game_sound, 0);
@@ -1975,14 +2098,14 @@ void WorldSystem::on_key(int key, int, int action, int mod) {
 
 
 /* Debug stuff to draw the boundaries. Commented out for now*/
-void WorldSystem::on_mouse_click(int button, int action, int mod) {
+// The cursor comes from the window callback, or the recording on a replay
+void WorldSystem::on_mouse_click(int button, int action, int mod, vec2 cursor) {
+	recordInput(INPUT_EVENT_TYPE::MOUSE_CLICK, button, action, mod, cursor);
 	if (debugging.in_dev_mode) {
 		if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-			double xpos, ypos;
-			//getting cursor position
-			glfwGetCursorPos(window, &xpos, &ypos);
-			int xVal = (int)xpos / 25;
-			int yVal = (int)ypos / 25;
+			int xVal = (int)cursor.x / 25;
+			int yVal = (int)cursor.y / 25;
+			if (cursor.x < 0 || cursor.y < 0 || xVal >= 64 || yVal >= 36) return;
 			float ogX = (25.0f / 2.0f) + 25.0f * xVal;
 			float ogY = (25.0f / 2.0f) + 25.0f * yVal;
 			debugArray[yVal][xVal] = 1;
@@ -3,10 +3,11 @@
 // internal
 #include "common.hpp"
 #include "game_state.hpp"
+#include "sim_context.hpp"
+#include "input_recording.hpp"
 
 // stlib
 #include <vector>
-#include <random>
 #include <deque>
 
 #define SDL_MAIN_HANDLED
@@ -14,26 +15,45 @@
 #include <SDL_mixer.h>
 
 #include "render_system.hpp"
+#include "job_system.hpp"
+
+// How the last minigame ended, batch runs stop on it
+struct MinigameResult {
+	bool over = false;
+	bool won = false;
+	// SimClock tick it ended on
+	uint64_t tick = 0;
+};
 
 // Container for all our entities and game logic. Individual rendering / update is
 // deferred to the relative update() methods
 class WorldSystem
 {
 public:
-	WorldSystem();
+	WorldSystem(SimContext& ctx);
 
 	// Creates a window
 	GLFWwindow* create_window();
+	// Sets up everything but the window, for offscreen runs
+	bool create_headless();
 
 	// starts the game
 	void init(RenderSystem* renderer);
 
+	// Seeds the simulation's generators and threadRng, before init for a reproducible run
+	void seed(uint32_t seed);
+	// Delivers a recorded event as if the window had sent it
+	void applyInput(const InputEvent& event);
+
 	// Releases all associated resources
 	~WorldSystem();
 
 	// Steps the game ahead by ms milliseconds
 	bool step(float elapsed_ms);
 
+	// Adds the world work that runs before step (animations)
+	void scheduleTasks(TaskGraph& graph, float elapsed_ms);
+
 	// Check for collisions
 	void handle_collisions();
 
@@ -81,6 +101,9 @@ public:
 	// Should the game be over ?
 	bool is_over()const;
 
+	// Items in the inventory from a minigame, MINIGAME_1 to MINIGAME_5
+	unsigned int itemsCollected(GAME_STATES minigame) const;
+
 	// Save/Load game
 	void save_game_saveFile(std::string message);
 	void load_game_saveFile();
@@ -90,14 +113,27 @@ public:
 	// screen transitions
 	bool fadeOut = false;
 
+	// Every input event is added here while set
+	InputRecording* recording = nullptr;
+
+	// Reset whenever the game state changes
+	MinigameResult last_minigame;
+
 private:
+	// Loads music and sounds
+	bool init_audio();
+
+	void advanceAnimations(float elapsed_ms);
+	// Debug lines above the FPS text with the slowest profiler zones, hidden when not visible
+	void updateProfileText(bool visible);
+
 	// Input callback functions
 	void on_key(int key, int, int action, int mod);
 	void on_mouse_move(vec2 pos);
-	void on_mouse_click(int button, int action, int mod);
+	void on_mouse_click(int button, int action, int mod, vec2 cursor);
+	void recordInput(INPUT_EVENT_TYPE type, int code, int action, int mods, vec2 cursor = vec2(0, 0));
 
 	void minigame1_maze_gen();
-	void minigame1_carve_maze(vec2 pos, std::vector<vec2>& visited);
 
 	// restart level
 	void restart_game();
@@ -105,7 +141,10 @@ private:
 	// create minigame win / lose overlays + animations
 	void minigame_win_lose_overlay(bool win, std::vector<Entity>& entities_to_remove, TEXTURE_ASSET_ID used_texture, int num_frames);
 	// OpenGL window handle
-	GLFWwindow* window;
+	GLFWwindow* window = nullptr;
+
+	// The simulation this world runs in
+	SimContext& ctx;
 
 	// Number of points
 	int points;
@@ -125,6 +164,8 @@ private:
 	// used to space out when we update the fps counter text
 	int counter = 0;
 	Entity fpsTextEntity;
+	int profile_counter = 0;
+	std::vector<Entity> profileTextEntities;
 
 	// Game state
 	RenderSystem* renderer;
@@ -153,6 +194,8 @@ private:
 
 	// mg4 variables
 	float ALLOWED_TIME_TO_BE_ALIVE = 1.5;
+	const float SCREEN_SHAKE_MS = 300.f; // shake when a mole explodes
+	const float SCREEN_SHAKE_STRENGTH = 0.01f;
 	unsigned int explosionCount = 0;
 	Entity remainingText;
 
@@ -198,53 +241,49 @@ private:
 	Entity minigameOver;
 	Entity minigameWin;
 
-	// music references
+	// music references, null until init_audio
 	// Title
-	Mix_Music* title_background_music;
-	Mix_Chunk* title_select_sound;
-	Mix_Chunk* title_enter_sound;
+	Mix_Music* title_background_music = nullptr;
+	Mix_Chunk* title_select_sound = nullptr;
+	Mix_Chunk* title_enter_sound = nullptr;
 
 	// Organ/Minigame 1
-	Mix_Music* organ1_background_music;
-	Mix_Chunk* mg1_die_sound;
-	Mix_Chunk* mg1_pickup_atp_sound;
-	Mix_Music* mg1_background_music;
+	Mix_Music* organ1_background_music = nullptr;
+	Mix_Chunk* mg1_die_sound = nullptr;
+	Mix_Chunk* mg1_pickup_atp_sound = nullptr;
+	Mix_Music* mg1_background_music = nullptr;
 
 	// Organ/Minigame 2
-	Mix_Music* organ2_background_music;
-	Mix_Music* mg2_background_music;
+	Mix_Music* organ2_background_music = nullptr;
+	Mix_Music* mg2_background_music = nullptr;
 
 	// Organ/Minigame 3
-	Mix_Music* organ3_background_music;
-	Mix_Chunk* mg3_whack_sound;
-	Mix_Chunk* mg3_explosion_sound;
-	Mix_Music* mg3_background_music;
+	Mix_Music* organ3_background_music = nullptr;
+	Mix_Chunk* mg3_whack_sound = nullptr;
+	Mix_Chunk* mg3_explosion_sound = nullptr;
+	Mix_Music* mg3_background_music = nullptr;
 	
 	// Organ/Minigame 4
-	Mix_Music* organ4_background_music;
-	Mix_Music* mg4_background_music;
+	Mix_Music* organ4_background_music = nullptr;
+	Mix_Music* mg4_background_music = nullptr;
 	
 	// Misc
-	Mix_Chunk* overworld_on_node_sound;
-	Mix_Chunk* save_game_sound;
+	Mix_Chunk* overworld_on_node_sound = nullptr;
+	Mix_Chunk* save_game_sound = nullptr;
 
 	// Organ/Minigame 5
-	Mix_Music* organ5_background_music;
-	Mix_Music* mg5_background_music;
-	Mix_Chunk* mg5_paddle_increase_sound;
-	Mix_Chunk* mg5_x3_multiplier_sound;
+	Mix_Music* organ5_background_music = nullptr;
+	Mix_Music* mg5_background_music = nullptr;
+	Mix_Chunk* mg5_paddle_increase_sound = nullptr;
+	Mix_Chunk* mg5_x3_multiplier_sound = nullptr;
 
 	// Credits
-	Mix_Music* credits_background_music;
+	Mix_Music* credits_background_music = nullptr;
 	
 	// Brain
-	Mix_Music* brain_background_music;
-	Mix_Music* brain_kill_background_music;
-	Mix_Music* brain_help_background_music;
-	
-	// C++ random number generator
-	std::default_random_engine rng;
-	std::uniform_real_distribution<float> uniform_dist; // number between 0..1
+	Mix_Music* brain_background_music = nullptr;
+	Mix_Music* brain_kill_background_music = nullptr;
+	Mix_Music* brain_help_background_music = nullptr;
 };
 
 class RollingFps {
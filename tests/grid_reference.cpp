@@ -0,0 +1,53 @@
+// internal
+#include "grid_reference.hpp"
+
+// stlib
+#include <queue>
+
+GridMap randomGrid(int columns, int rows, float wall_chance, Rng& rng)
+{
+	GridMap map(columns, rows);
+	for (uint8_t& wall : map.walls)
+		wall = rng.uniform() < wall_chance;
+	return map;
+}
+
+std::vector<int> bfsDistances(const GridMap& map, int from)
+{
+	std::vector<int> distance(map.cells(), -1);
+	if (map.walls[from])
+		return distance;
+	std::queue<int> open;
+	distance[from] = 0;
+	open.push(from);
+	while (!open.empty()) {
+		int cell = open.front();
+		open.pop();
+		int column = cell % map.columns;
+		int row = cell / map.columns;
+		const int next[4][2] = { { column, row - 1 }, { column + 1, row }, { column, row + 1 }, { column - 1, row } };
+		for (const auto& n : next) {
+			if (!map.open(n[0], n[1]) || distance[map.index(n[0], n[1])] >= 0)
+				continue;
+			distance[map.index(n[0], n[1])] = distance[cell] + 1;
+			open.push(map.index(n[0], n[1]));
+		}
+	}
+	return distance;
+}
+
+bool walkPath(const GridMap& map, SearchPosition start, const std::vector<Direction>& dir, SearchPosition& end)
+{
+	end = start;
+	for (Direction step : dir) {
+		switch (step) {
+		case UP: end.y--; break;
+		case RIGHT: end.x++; break;
+		case DOWN: end.y++; break;
+		case LEFT: end.x--; break;
+		}
+		if (!map.open(end.x, end.y))
+			return false;
+	}
+	return true;
+}
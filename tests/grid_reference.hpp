@@ -0,0 +1,21 @@
+#pragma once
+
+// internal
+#include "grid_search.hpp"
+#include "random.hpp"
+
+// stlib
+#include <vector>
+
+// Slow, obviously right versions of what the grid searches work out, for the
+// tests to hold them up against
+
+// A grid with each cell a wall with the chance given
+GridMap randomGrid(int columns, int rows, float wall_chance, Rng& rng);
+
+// Steps from one cell (row * columns + column) to every other over the 4
+// connected open cells, -1 where there's no way or it's a wall
+std::vector<int> bfsDistances(const GridMap& map, int from);
+
+// Follows the steps from start, false if one goes into a wall or off the grid
+bool walkPath(const GridMap& map, SearchPosition start, const std::vector<Direction>& dir, SearchPosition& end);
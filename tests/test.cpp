@@ -0,0 +1,37 @@
+// internal
+#include "test.hpp"
+
+// stlib
+#include <cstdio>
+
+bool Test::check(bool passed, const char* expression, const char* file, int line)
+{
+	if (!passed) {
+		fprintf(stderr, "%s:%d: %s: CHECK(%s) failed\n", file, line, name.c_str(), expression);
+		failures++;
+	}
+	return passed;
+}
+
+void TestRunner::add(const std::string& name, Body body)
+{
+	tests.push_back({ name, std::move(body) });
+}
+
+bool TestRunner::run(const std::string& filter)
+{
+	int ran = 0, failed = 0;
+	for (const Entry& entry : tests) {
+		if (entry.name.find(filter) == std::string::npos)
+			continue;
+		Test test;
+		test.name = entry.name;
+		entry.body(test);
+		ran++;
+		if (test.failed())
+			failed++;
+		printf("%s %s\n", test.failed() ? "FAIL" : "ok  ", entry.name.c_str());
+	}
+	printf("%d of %d tests passed\n", ran - failed, ran);
+	return failed == 0;
+}
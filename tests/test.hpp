@@ -0,0 +1,55 @@
+#pragma once
+
+// stlib
+#include <functional>
+#include <string>
+#include <vector>
+
+// What a test body gets. A failed check prints where it was and fails the
+// test, the body carries on so one run shows every check that fails.
+//
+//     runner.add("grid/jps", [](Test& test) {
+//         CHECK(test, path.cost == 12);
+//     });
+class Test
+{
+public:
+	// False when the check failed
+	bool check(bool passed, const char* expression, const char* file, int line);
+	bool failed() const { return failures > 0; }
+
+private:
+	friend class TestRunner;
+
+	std::string name;
+	int failures = 0;
+};
+
+#define CHECK(test, condition) (test).check((condition), #condition, __FILE__, __LINE__)
+
+class TestRunner
+{
+public:
+	using Body = std::function<void(Test&)>;
+
+	void add(const std::string& name, Body body);
+
+	// Runs every test whose name contains filter, true when they all pass
+	bool run(const std::string& filter);
+
+private:
+	struct Entry {
+		std::string name;
+		Body body;
+	};
+
+	std::vector<Entry> tests;
+};
+
+// One per file in tests/
+void registerGridSearchTests(TestRunner& runner);
+void registerMazeGenTests(TestRunner& runner);
+void registerBehaviorTreeTests(TestRunner& runner);
+void registerPathCacheTests(TestRunner& runner);
+void registerNavTableTests(TestRunner& runner);
+void registerNavMeshTests(TestRunner& runner);
@@ -0,0 +1,181 @@
+// internal
+#include "behavior_tree.hpp"
+#include "test.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Leaf number "value" returns what the test put in its slot and counts its ticks
+const int LEAVES = 4;
+BT_STATUS leaf_status[LEAVES];
+int leaf_ticks[LEAVES];
+
+BT_STATUS scriptedLeaf(BehaviorCall& call)
+{
+	leaf_ticks[(int)call.value]++;
+	return leaf_status[(int)call.value];
+}
+
+json leaf(int number)
+{
+	return { { "type", "action" }, { "name", "leaf" }, { "value", number } };
+}
+
+// A tree around the leaves with an agent to tick it
+struct Harness {
+	SimContext ctx;
+	BehaviorLibrary library;
+	BehaviorTree tree;
+	Blackboard board;
+
+	bool compile(const json& root)
+	{
+		for (int i = 0; i < LEAVES; i++) {
+			leaf_status[i] = BT_STATUS::SUCCESS;
+			leaf_ticks[i] = 0;
+		}
+		library.addAction("leaf", scriptedLeaf);
+		if (!tree.compile({ { "root", root } }, library))
+			return false;
+		board = tree.blackboard();
+		return true;
+	}
+
+	BT_STATUS tick(float elapsed_ms = 0.f) { return tree.tick(ctx, Entity(), board, elapsed_ms); }
+};
+
+}
+
+void registerBehaviorTreeTests(TestRunner& runner)
+{
+	runner.add("bt/sequence_resumes", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "sequence" }, { "children", { leaf(0), leaf(1), leaf(2) } } }));
+		leaf_status[1] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		// picks up at the running child, the one before it isn't ticked again
+		CHECK(test, leaf_ticks[0] == 1 && leaf_ticks[1] == 2 && leaf_ticks[2] == 0);
+		leaf_status[1] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		CHECK(test, leaf_ticks[0] == 1 && leaf_ticks[2] == 1);
+		leaf_status[0] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::FAILURE);
+		CHECK(test, leaf_ticks[0] == 2 && leaf_ticks[1] == 3);
+	});
+	runner.add("bt/selector", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "selector" }, { "children", { leaf(0), leaf(1) } } }));
+		leaf_status[0] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		leaf_status[1] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::FAILURE);
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		CHECK(test, leaf_ticks[0] == 3 && leaf_ticks[1] == 2);
+	});
+	runner.add("bt/parallel", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "parallel" }, { "success", 2 }, { "children", { leaf(0), leaf(1), leaf(2) } } }));
+		leaf_status[0] = BT_STATUS::RUNNING;
+		leaf_status[1] = BT_STATUS::RUNNING;
+		leaf_status[2] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		leaf_status[1] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		// two can't succeed any more once two have failed
+		leaf_status[0] = BT_STATUS::FAILURE;
+		leaf_status[1] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick() == BT_STATUS::FAILURE);
+	});
+	runner.add("bt/inverter_succeeder", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "sequence" }, { "children", {
+			{ { "type", "inverter" }, { "child", leaf(0) } },
+			{ { "type", "succeeder" }, { "child", leaf(1) } } } } }));
+		leaf_status[0] = BT_STATUS::FAILURE;
+		leaf_status[1] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		leaf_status[1] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		leaf_status[1] = BT_STATUS::FAILURE;
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		// still picking up at the succeeder
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		CHECK(test, bt.tick() == BT_STATUS::FAILURE);
+		leaf_status[0] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+	});
+	runner.add("bt/repeat", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "repeat" }, { "count", 3 }, { "child", leaf(0) } }));
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		// a running child doesn't count as a time round
+		leaf_status[0] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+		// a failure ends it and starts the count over
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		leaf_status[0] = BT_STATUS::FAILURE;
+		CHECK(test, bt.tick() == BT_STATUS::FAILURE);
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick() == BT_STATUS::SUCCESS);
+	});
+	runner.add("bt/cooldown", [](Test& test) {
+		Harness bt;
+		CHECK(test, bt.compile({ { "type", "cooldown" }, { "ms", 100 }, { "child", leaf(0) } }));
+		CHECK(test, bt.tick(60.f) == BT_STATUS::FAILURE);
+		CHECK(test, bt.tick(30.f) == BT_STATUS::FAILURE);
+		CHECK(test, leaf_ticks[0] == 0);
+		CHECK(test, bt.tick(20.f) == BT_STATUS::SUCCESS);
+		CHECK(test, bt.tick(20.f) == BT_STATUS::FAILURE);
+		CHECK(test, leaf_ticks[0] == 1);
+
+		// a running child is ticked every time until it finishes, and the wait
+		// only starts over then
+		leaf_status[0] = BT_STATUS::RUNNING;
+		CHECK(test, bt.tick(100.f) == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick(10.f) == BT_STATUS::RUNNING);
+		CHECK(test, bt.tick(10.f) == BT_STATUS::RUNNING);
+		CHECK(test, leaf_ticks[0] == 4);
+		leaf_status[0] = BT_STATUS::SUCCESS;
+		CHECK(test, bt.tick(10.f) == BT_STATUS::SUCCESS);
+		CHECK(test, bt.tick(90.f) == BT_STATUS::FAILURE);
+		CHECK(test, bt.tick(20.f) == BT_STATUS::SUCCESS);
+		CHECK(test, leaf_ticks[0] == 6);
+	});
+	runner.add("bt/bad_definitions", [](Test& test) {
+		const json bad[] = {
+			json::array({ leaf(0) }),
+			{ { "type", 3 } },
+			{ { "type", "selector" }, { "children", leaf(0) } },
+			{ { "type", "selector" }, { "children", { 1, 2 } } },
+			{ { "type", "action" }, { "name", 7 } },
+			{ { "type", "action" }, { "name", "leaf" }, { "value", "two" } },
+			{ { "type", "action" }, { "name", "leaf" }, { "key", 0 } },
+			{ { "type", "cooldown" }, { "ms", "soon" }, { "child", leaf(0) } },
+			{ { "type", "repeat" }, { "count", true }, { "child", leaf(0) } },
+			{ { "type", "parallel" }, { "success", json::array() }, { "children", { leaf(0) } } },
+			{ { "type", "inverter" }, { "child", "leaf" } },
+		};
+		for (const json& root : bad) {
+			Harness bt;
+			CHECK(test, !bt.compile(root) && bt.tree.empty());
+		}
+		BehaviorLibrary library;
+		BehaviorTree tree;
+		CHECK(test, !tree.compile(json::array(), library));
+		CHECK(test, !tree.compile({ { "blackboard", { 1, 2 } }, { "root", leaf(0) } }, library));
+		CHECK(test, !tree.compile({ { "blackboard", { { "anger", "high" } } }, { "root", leaf(0) } }, library));
+	});
+}
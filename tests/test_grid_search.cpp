@@ -0,0 +1,93 @@
+// internal
+#include "grid_reference.hpp"
+#include "test.hpp"
+
+// stlib
+#include <functional>
+
+namespace {
+
+const int QUERIES = 300;
+
+// Random pairs of cells on grids of a few sizes and wall densities, with the
+// breadth first distance between them
+struct Query {
+	const GridMap* map;
+	// counts up with each new grid
+	int grid;
+	SearchPosition from, to;
+	int distance;
+};
+
+void forEachQuery(uint64_t seed, const std::function<void(const Query&)>& body)
+{
+	Rng rng(seed);
+	int grid = 0;
+	const int sizes[][2] = { { 16, 9 }, { 40, 30 }, { 64, 36 } };
+	for (const auto& size : sizes) {
+		for (float walls : { 0.f, 0.2f, 0.35f }) {
+			GridMap map = randomGrid(size[0], size[1], walls, rng);
+			for (int i = 0; i < QUERIES; i++) {
+				int from = (int)rng.below((uint32_t)map.cells());
+				int to = (int)rng.below((uint32_t)map.cells());
+				Query query = { &map, grid, SearchPosition(from % map.columns, from / map.columns),
+					SearchPosition(to % map.columns, to / map.columns), bfsDistances(map, from)[to] };
+				body(query);
+			}
+			grid++;
+		}
+	}
+}
+
+// A shortest path when there's one, nothing when there isn't
+void checkShortest(Test& test, const Query& query, const Search& path)
+{
+	if (query.distance < 0) {
+		CHECK(test, path.cost == -1 && path.dir.empty());
+		return;
+	}
+	SearchPosition end(0, 0);
+	CHECK(test, path.cost == query.distance);
+	CHECK(test, (int)path.dir.size() == query.distance);
+	CHECK(test, walkPath(*query.map, query.from, path.dir, end) && end == query.to);
+}
+
+}
+
+void registerGridSearchTests(TestRunner& runner)
+{
+	runner.add("grid/astar", [](Test& test) {
+		AStarPool pool;
+		forEachQuery(1, [&](const Query& query) {
+			checkShortest(test, query, gridAStar(*query.map, query.from, query.to, pool));
+		});
+	});
+	runner.add("grid/jps", [](Test& test) {
+		AStarPool pool;
+		forEachQuery(2, [&](const Query& query) {
+			checkShortest(test, query, jumpPointSearch(*query.map, query.from, query.to, pool));
+		});
+	});
+	// HPA* paths only have to be close to the shortest, but must exist exactly when one does
+	runner.add("grid/hpa", [](Test& test) {
+		for (int cluster_size : { 4, 8, 16 }) {
+			ClusterGraph graph;
+			int built = -1;
+			forEachQuery(3, [&](const Query& query) {
+				if (built != query.grid) {
+					graph.build(*query.map, cluster_size);
+					built = query.grid;
+				}
+				Search path = graph.findPath(query.from, query.to);
+				if (query.distance < 0) {
+					CHECK(test, path.cost == -1 && path.dir.empty());
+					return;
+				}
+				SearchPosition end(0, 0);
+				CHECK(test, path.cost >= query.distance);
+				CHECK(test, (int)path.dir.size() == path.cost);
+				CHECK(test, walkPath(*query.map, query.from, path.dir, end) && end == query.to);
+			});
+		}
+	});
+}
@@ -0,0 +1,21 @@
+// internal
+#include "test.hpp"
+
+// stlib
+#include <cstdlib>
+
+// Checks of the engine's algorithms against simple reference versions, run by ctest
+//   gen_tests
+//   gen_tests grid/
+int main(int argc, char* argv[])
+{
+	TestRunner runner;
+	registerGridSearchTests(runner);
+	registerMazeGenTests(runner);
+	registerBehaviorTreeTests(runner);
+	registerPathCacheTests(runner);
+	registerNavTableTests(runner);
+	registerNavMeshTests(runner);
+
+	return runner.run(argc > 1 ? argv[1] : "") ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,77 @@
+// internal
+#include "grid_reference.hpp"
+#include "maze_gen.hpp"
+#include "test.hpp"
+
+namespace {
+
+// Every room open and reachable, and no loops: a connected graph of open
+// cells with one edge fewer than it has cells is a tree
+void checkPerfect(Test& test, const GridMap& map)
+{
+	int open = 0, edges = 0, first = -1;
+	for (int row = 0; row < map.rows; row++) {
+		for (int column = 0; column < map.columns; column++) {
+			if (!map.open(column, row))
+				continue;
+			open++;
+			edges += map.open(column + 1, row) + map.open(column, row + 1);
+			if (first < 0)
+				first = map.index(column, row);
+		}
+	}
+	if (!CHECK(test, first >= 0))
+		return;
+	std::vector<int> distance = bfsDistances(map, first);
+	int reached = 0, rooms_missed = 0;
+	for (int row = 0; row < map.rows; row++) {
+		for (int column = 0; column < map.columns; column++) {
+			reached += distance[map.index(column, row)] >= 0;
+			rooms_missed += column % 2 == 0 && row % 2 == 0 && distance[map.index(column, row)] < 0;
+		}
+	}
+	CHECK(test, rooms_missed == 0);
+	CHECK(test, reached == open);
+	CHECK(test, edges == open - 1);
+}
+
+}
+
+void registerMazeGenTests(TestRunner& runner)
+{
+	const MAZE_ALGORITHM algorithms[] = { MAZE_ALGORITHM::BACKTRACKER, MAZE_ALGORITHM::WILSON, MAZE_ALGORITHM::ELLER };
+	const char* names[] = { "maze/backtracker", "maze/wilson", "maze/eller" };
+	for (int i = 0; i < 3; i++) {
+		MAZE_ALGORITHM algorithm = algorithms[i];
+		runner.add(names[i], [algorithm](Test& test) {
+			const int sizes[][2] = { { 1, 1 }, { 2, 3 }, { 16, 9 }, { 31, 21 }, { 64, 36 }, { 257, 129 } };
+			for (const auto& size : sizes) {
+				for (uint64_t seed = 1; seed <= 5; seed++) {
+					GridMap map(size[0], size[1], 1);
+					Rng rng(seed);
+					carveMaze(map, rng, algorithm);
+					checkPerfect(test, map);
+
+					GridMap again(size[0], size[1], 1);
+					Rng same(seed);
+					carveMaze(again, same, algorithm);
+					CHECK(test, again.walls == map.walls);
+				}
+			}
+		});
+	}
+	// rows streamed out one pair at a time make up a perfect maze too
+	runner.add("maze/eller_rows", [](Test& test) {
+		for (int columns : { 1, 2, 15, 64 }) {
+			for (uint64_t seed = 1; seed <= 5; seed++) {
+				const int PAIRS = 20;
+				GridMap map(columns, PAIRS * 2 + 1, 1);
+				EllerMaze maze(columns, Rng(seed));
+				for (int pair = 0; pair < PAIRS; pair++)
+					maze.nextRows(&map.walls[map.index(0, pair * 2)], &map.walls[map.index(0, pair * 2 + 1)]);
+				maze.lastRow(&map.walls[map.index(0, PAIRS * 2)]);
+				checkPerfect(test, map);
+			}
+		}
+	});
+}
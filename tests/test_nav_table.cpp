@@ -0,0 +1,65 @@
+// internal
+#include "grid_reference.hpp"
+#include "maze_gen.hpp"
+#include "nav_table.hpp"
+#include "test.hpp"
+
+// stlib
+#include <algorithm>
+
+void registerNavTableTests(TestRunner& runner)
+{
+	// every pair of cells, on random grids and the minigame 1 sized maze
+	runner.add("nav_table/all_pairs", [](Test& test) {
+		Rng rng(4);
+		std::vector<GridMap> maps = { randomGrid(16, 9, 0.3f, rng), randomGrid(40, 30, 0.25f, rng), GridMap(31, 17, 1) };
+		carveMaze(maps.back(), rng);
+		for (const GridMap& map : maps) {
+			NavTable table;
+			if (!CHECK(test, table.build(map, 3) && table.built(3) && !table.built(4)))
+				continue;
+			int wrong_distances = 0, wrong_steps = 0, wrong_paths = 0;
+			for (int from = 0; from < (int)map.cells(); from++) {
+				std::vector<int> distance = bfsDistances(map, from);
+				SearchPosition start(from % map.columns, from / map.columns);
+				for (int to = 0; to < (int)map.cells(); to++) {
+					wrong_distances += table.distance(from, to) != distance[to];
+					Direction dir = UP;
+					bool stepped = table.direction(from, to, dir);
+					SearchPosition next(0, 0);
+					if (stepped != (distance[to] > 0))
+						wrong_steps++;
+					else if (stepped && (!walkPath(map, start, { dir }, next) || table.distance(map.index(next.x, next.y), to) != distance[to] - 1))
+						wrong_steps++;
+					std::vector<Direction> path = table.path(from, to);
+					SearchPosition end(0, 0);
+					if ((int)path.size() != std::max(0, distance[to]) || !walkPath(map, start, path, end) || (distance[to] > 0 && map.index(end.x, end.y) != to))
+						wrong_paths++;
+				}
+			}
+			CHECK(test, wrong_distances == 0);
+			CHECK(test, wrong_steps == 0);
+			CHECK(test, wrong_paths == 0);
+		}
+	});
+	runner.add("nav_table/astar_heuristic", [](Test& test) {
+		Rng rng(5);
+		GridMap map = randomGrid(64, 36, 0.3f, rng);
+		NavTable table;
+		CHECK(test, table.build(map, 1));
+		AStarPool pool;
+		for (int i = 0; i < 500; i++) {
+			int from = (int)rng.below((uint32_t)map.cells());
+			int to = (int)rng.below((uint32_t)map.cells());
+			int distance = bfsDistances(map, from)[to];
+			Search path = gridAStar(map, SearchPosition(from % map.columns, from / map.columns), SearchPosition(to % map.columns, to / map.columns), pool, &table);
+			CHECK(test, path.cost == distance);
+		}
+	});
+	runner.add("nav_table/too_big", [](Test& test) {
+		NavTable table;
+		CHECK(test, !table.build(GridMap(65, 64), 1));
+		CHECK(test, !table.built(1));
+		CHECK(test, table.distance(0, 1) == -1);
+	});
+}
@@ -0,0 +1,113 @@
+// internal
+#include "components.hpp"
+#include "organ_navmesh.hpp"
+#include "random.hpp"
+#include "test.hpp"
+
+// stlib
+#include <cmath>
+#include <queue>
+
+namespace {
+
+const int WIDTH = ORGAN_BOUNDARY_COLUMNS * ORGAN_CELL_PX;
+const int HEIGHT = ORGAN_BOUNDARY_ROWS * ORGAN_CELL_PX;
+
+// Whether the square reaching clearance either side of a point misses every
+// wall, off the screen counts as wall. Touching one is fine.
+bool clearOfWalls(const GridMap& map, float clearance, vec2 point)
+{
+	const float SLACK = 1e-3f;
+	if (point.x < clearance - SLACK || point.y < clearance - SLACK || point.x > WIDTH - clearance + SLACK || point.y > HEIGHT - clearance + SLACK)
+		return false;
+	int first_column = (int)floorf((point.x - clearance + SLACK) / ORGAN_CELL_PX);
+	int last_column = (int)floorf((point.x + clearance - SLACK) / ORGAN_CELL_PX);
+	int first_row = (int)floorf((point.y - clearance + SLACK) / ORGAN_CELL_PX);
+	int last_row = (int)floorf((point.y + clearance - SLACK) / ORGAN_CELL_PX);
+	for (int row = first_row; row <= last_row; row++) {
+		for (int column = first_column; column <= last_column; column++) {
+			if (map.contains(column, row) && !map.open(column, row))
+				return false;
+		}
+	}
+	return true;
+}
+
+// Flood fill over the middles of the screen's pixels, the pixels a square
+// that size can get between share a label, -1 where it doesn't fit
+std::vector<int> pixelAreas(const GridMap& map, float clearance)
+{
+	std::vector<int> label(WIDTH * HEIGHT, -1);
+	auto fits = [&](int pixel) { return clearOfWalls(map, clearance, vec2(pixel % WIDTH + 0.5f, pixel / WIDTH + 0.5f)); };
+	int areas = 0;
+	for (int seed = 0; seed < WIDTH * HEIGHT; seed++) {
+		if (label[seed] >= 0 || !fits(seed))
+			continue;
+		std::queue<int> open;
+		label[seed] = areas;
+		open.push(seed);
+		while (!open.empty()) {
+			int pixel = open.front();
+			open.pop();
+			int x = pixel % WIDTH, y = pixel / WIDTH;
+			const int next[4] = { x > 0 ? pixel - 1 : -1, x + 1 < WIDTH ? pixel + 1 : -1, y > 0 ? pixel - WIDTH : -1, y + 1 < HEIGHT ? pixel + WIDTH : -1 };
+			for (int n : next) {
+				if (n >= 0 && label[n] < 0 && fits(n)) {
+					label[n] = areas;
+					open.push(n);
+				}
+			}
+		}
+		areas++;
+	}
+	return label;
+}
+
+}
+
+void registerNavMeshTests(TestRunner& runner)
+{
+	// a path exactly when the flood fill joins the two points, and every bit
+	// of it keeps the clearance
+	runner.add("navmesh/organs", [](Test& test) {
+		const GAME_STATES organs[] = { GAME_STATES::ORGAN_1, GAME_STATES::ORGAN_2, GAME_STATES::ORGAN_3, GAME_STATES::ORGAN_4,
+			GAME_STATES::ORGAN_5, GAME_STATES::BRAIN_LOCKED, GAME_STATES::BRAIN_UNLOCKED };
+		for (GAME_STATES organ : organs) {
+			GridMap map = GridMap::fromCells(&organBoundary((unsigned int)organ)[0][0], ORGAN_BOUNDARY_COLUMNS, ORGAN_BOUNDARY_ROWS);
+			for (float clearance : { 0.f, 10.f, 20.f }) {
+				std::shared_ptr<const NavMesh> mesh = organNavMesh((unsigned int)organ, clearance);
+				if (!CHECK(test, mesh && mesh->clearance() == clearance))
+					continue;
+				std::vector<int> areas = pixelAreas(map, clearance);
+				Rng rng((uint64_t)organ * 100 + (uint64_t)clearance);
+				std::vector<vec2> points;
+				int wrong = 0, too_close = 0;
+				for (int i = 0; i < 1000; i++) {
+					int from = (int)rng.below(WIDTH * HEIGHT);
+					int to = (int)rng.below(WIDTH * HEIGHT);
+					bool joined = areas[from] >= 0 && areas[from] == areas[to];
+					bool found = mesh->findPath(vec2(from % WIDTH + 0.5f, from / WIDTH + 0.5f), vec2(to % WIDTH + 0.5f, to / WIDTH + 0.5f), points);
+					wrong += joined != found;
+					for (size_t p = 1; p < points.size(); p++) {
+						for (int t = 0; t <= 32; t++) {
+							if (!clearOfWalls(map, clearance, points[p - 1] + (points[p] - points[p - 1]) * (t / 32.f)))
+								too_close++;
+						}
+					}
+				}
+				CHECK(test, wrong == 0);
+				CHECK(test, too_close == 0);
+			}
+		}
+	});
+	runner.add("navmesh/clearance", [](Test& test) {
+		std::shared_ptr<const NavMesh> mesh = organNavMesh((unsigned int)GAME_STATES::ORGAN_2, 20.f);
+		std::vector<vec2> points;
+		CHECK(test, mesh->findPath(vec2(926, 850), vec2(1026, 400), points));
+		CHECK(test, points.size() >= 2 && points.front() == vec2(926, 850) && points.back() == vec2(1026, 400));
+		// cached per clearance
+		CHECK(test, organNavMesh((unsigned int)GAME_STATES::ORGAN_2, 20.f) == mesh);
+		CHECK(test, organNavMesh((unsigned int)GAME_STATES::ORGAN_2) != mesh);
+		CHECK(test, organNavMesh((unsigned int)GAME_STATES::MINIGAME_1) == nullptr);
+	});
+}
@@ -0,0 +1,83 @@
+// internal
+#include "path_cache.hpp"
+#include "test.hpp"
+
+namespace {
+
+PathResult path(int x_start, int y_start, uint32_t maze_version, std::vector<Direction> steps)
+{
+	PathResult result;
+	result.maze_version = maze_version;
+	result.x_start = x_start;
+	result.y_start = y_start;
+	result.step_size = 10;
+	result.path = std::move(steps);
+	return result;
+}
+
+}
+
+void registerPathCacheTests(TestRunner& runner)
+{
+	runner.add("path_cache/exact", [](Test& test) {
+		PathCache cache(4);
+		PathResult found;
+		cache.insert(7, path(100, 100, 1, { RIGHT, RIGHT, DOWN }));
+		CHECK(test, cache.find(100, 100, 7, 1, found));
+		CHECK(test, found.path == std::vector<Direction>({ RIGHT, RIGHT, DOWN }) && found.step_size == 10);
+		// another goal or maze version is another search
+		CHECK(test, !cache.find(100, 100, 8, 1, found));
+		CHECK(test, !cache.find(100, 100, 7, 2, found));
+		// nothing to gain from keeping a failed search
+		cache.insert(9, path(0, 0, 1, {}));
+		CHECK(test, cache.size() == 1);
+		// the same key again replaces the path
+		cache.insert(7, path(100, 100, 1, { DOWN }));
+		CHECK(test, cache.size() == 1);
+		CHECK(test, cache.find(100, 100, 7, 1, found) && found.path == std::vector<Direction>({ DOWN }));
+	});
+	runner.add("path_cache/suffix", [](Test& test) {
+		PathCache cache(4);
+		PathResult found;
+		cache.insert(7, path(100, 100, 1, { RIGHT, RIGHT, DOWN, LEFT }));
+		// two steps along, at (120, 100)
+		CHECK(test, cache.find(120, 100, 7, 1, found));
+		CHECK(test, found.x_start == 120 && found.y_start == 100 && found.maze_version == 1 && found.step_size == 10);
+		CHECK(test, found.path == std::vector<Direction>({ DOWN, LEFT }));
+		CHECK(test, cache.find(120, 110, 7, 1, found) && found.path == std::vector<Direction>({ LEFT }));
+		// off the path, between its points, at its end or on another maze
+		CHECK(test, !cache.find(130, 100, 7, 1, found));
+		CHECK(test, !cache.find(105, 100, 7, 1, found));
+		CHECK(test, !cache.find(110, 110, 7, 1, found));
+		CHECK(test, !cache.find(120, 100, 7, 2, found));
+		CHECK(test, !cache.find(120, 100, 6, 1, found));
+	});
+	runner.add("path_cache/lru", [](Test& test) {
+		PathCache cache(3);
+		PathResult found;
+		for (int i = 0; i < 3; i++)
+			cache.insert(i, path(i * 10, 0, 1, { UP }));
+		// using the oldest makes the second one the next to go
+		CHECK(test, cache.find(0, 0, 0, 1, found));
+		cache.insert(3, path(30, 0, 1, { UP }));
+		CHECK(test, cache.size() == 3);
+		CHECK(test, !cache.find(10, 0, 1, 1, found));
+		CHECK(test, cache.find(0, 0, 0, 1, found));
+		CHECK(test, cache.find(20, 0, 2, 1, found));
+		CHECK(test, cache.find(30, 0, 3, 1, found));
+		// a suffix hit counts as a use too
+		cache.insert(4, path(40, 0, 1, { UP, UP }));
+		CHECK(test, !cache.find(0, 0, 0, 1, found));
+		CHECK(test, cache.find(20, 0, 2, 1, found));
+		CHECK(test, cache.find(40, -10, 4, 1, found));
+		cache.insert(5, path(50, 0, 1, { UP }));
+		CHECK(test, !cache.find(30, 0, 3, 1, found));
+		CHECK(test, cache.find(40, 0, 4, 1, found));
+
+		cache.clear();
+		CHECK(test, cache.size() == 0 && !cache.find(40, 0, 4, 1, found));
+		PathCache none(0);
+		none.insert(1, path(0, 0, 1, { UP }));
+		CHECK(test, none.size() == 0);
+	});
+}